@@ -60,6 +60,12 @@ enum_bvh_layouts = (
     ('EMBREE', "Embree", "", 4),
 )
 
+enum_bvh_quantization = (
+    ('NONE', "None", "Store full precision node bounds", 0),
+    ('8', "8 Bit", "Quantize node bounds to 8 bits, using least memory", 8),
+    ('16', "16 Bit", "Quantize node bounds to 16 bits, keeping most of the traversal performance", 16),
+)
+
 enum_bvh_types = (
     ('DYNAMIC_BVH', "Dynamic BVH", "Objects can be individually updated, at the cost of slower render time"),
     ('STATIC_BVH', "Static BVH", "Any object modification requires a complete BVH rebuild, but renders faster"),
@@ -694,6 +700,13 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         default=0,
         min=0, max=16,
     )
+    debug_bvh_quantization: EnumProperty(
+        name="BVH Quantization",
+        description="Store BVH node bounds with reduced precision, to lower memory usage in cost of render time "
+        "(only used for CPU rendering without Embree)",
+        items=enum_bvh_quantization,
+        default='NONE',
+    )
     tile_order: EnumProperty(
         name="Tile Order",
         description="Tile order for rendering",
@@ -801,6 +814,20 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_texture_limit
     )
 
+    use_texture_cache: BoolProperty(
+        name="Texture Cache",
+        description="Load tiled and mipmapped image files like .tx on demand while rendering, at the resolution "
+        "needed for the render, instead of loading full images into memory (only used for CPU rendering)",
+        default=False,
+    )
+
+    texture_cache_size: IntProperty(
+        name="Cache Size",
+        description="Maximum memory used by the texture cache, in megabytes",
+        default=4096,
+        min=64, max=1048576,
+    )
+
     ao_bounces: IntProperty(
         name="AO Bounces",
         default=0,
@@ -780,6 +780,7 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
   params.use_bvh_spatial_split = RNA_boolean_get(&cscene, "debug_use_spatial_splits");
   params.use_bvh_unaligned_nodes = RNA_boolean_get(&cscene, "debug_use_hair_bvh");
   params.num_bvh_time_steps = RNA_int_get(&cscene, "debug_bvh_time_steps");
+  params.num_bvh_quantized_node_bits = RNA_enum_get(&cscene, "debug_bvh_quantization");
 
   PointerRNA csscene = RNA_pointer_get(&b_scene.ptr, "cycles_curves");
   params.hair_subdivisions = get_int(csscene, "subdivisions");
@@ -805,6 +806,13 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
     params.texture_limit = 0;
   }
 
+  if (RNA_boolean_get(&cscene, "use_texture_cache")) {
+    params.texture_cache_size = RNA_int_get(&cscene, "texture_cache_size");
+  }
+  else {
+    params.texture_cache_size = 0;
+  }
+
   params.bvh_layout = DebugFlags().cpu.bvh_layout;
 
   params.background = background;
@@ -25,12 +25,16 @@
 #include "bvh/bvh_node.h"
 #include "bvh/bvh_unaligned.h"
 
+#include "kernel/bvh/bvh_quantized.h"
+
 #include "util/util_foreach.h"
 #include "util/util_progress.h"
+#include "util/util_time.h"
 
 CCL_NAMESPACE_BEGIN
 
-BVHStackEntry::BVHStackEntry(const BVHNode *n, int i) : node(n), idx(i)
+BVHStackEntry::BVHStackEntry(const BVHNode *n, int i, bool quantized)
+    : node(n), idx(i), is_quantized(quantized), bounds(BoundBox::empty)
 {
 }
 
@@ -42,7 +46,11 @@ int BVHStackEntry::encodeIdx() const
 BVH2::BVH2(const BVHParams &params_,
            const vector<Geometry *> &geometry_,
            const vector<Object *> &objects_)
-    : BVH(params_, geometry_, objects_)
+    : BVH(params_, geometry_, objects_),
+      num_aligned_nodes(0),
+      num_unaligned_nodes(0),
+      num_quantized_nodes(0),
+      build_time(0.0)
 {
 }
 
@@ -50,6 +58,9 @@ void BVH2::build(Progress &progress, Stats *)
 {
   progress.set_substatus("Building BVH");
 
+  const double start_time = time_dt();
+  build_time = 0.0;
+
   /* build nodes */
   BVHBuild bvh_build(objects,
                      pack.prim_type,
@@ -96,6 +107,8 @@ void BVH2::build(Progress &progress, Stats *)
 
   /* free build nodes */
   root->deleteSubtree();
+
+  build_time += time_dt() - start_time;
 }
 
 void BVH2::refit(Progress &progress)
@@ -130,7 +143,7 @@ void BVH2::pack_leaf(const BVHStackEntry &e, const LeafNode *leaf)
     data[0].x = __int_as_float(leaf->lo);
     data[0].y = __int_as_float(leaf->hi);
   }
-  data[0].z = __uint_as_float(leaf->visibility);
+  data[0].z = __uint_as_float(leaf->visibility & ~PATH_RAY_NODE_FLAGS);
   if (leaf->num_triangles() != 0) {
     data[0].w = __uint_as_float(pack.prim_type[leaf->lo]);
   }
@@ -138,20 +151,27 @@ void BVH2::pack_leaf(const BVHStackEntry &e, const LeafNode *leaf)
   memcpy(&pack.leaf_nodes[e.idx], data, sizeof(float4) * BVH_NODE_LEAF_SIZE);
 }
 
-void BVH2::pack_inner(const BVHStackEntry &e, const BVHStackEntry &e0, const BVHStackEntry &e1)
+void BVH2::pack_inner(const BVHStackEntry &e, BVHStackEntry &e0, BVHStackEntry &e1)
 {
   if (e0.node->is_unaligned || e1.node->is_unaligned) {
     pack_unaligned_inner(e, e0, e1);
+    num_unaligned_nodes++;
+  }
+  else if (e.is_quantized) {
+    pack_quantized_inner(e, e0, e1);
+    num_quantized_nodes++;
   }
   else {
     pack_aligned_inner(e, e0, e1);
+    num_aligned_nodes++;
   }
 }
 
-void BVH2::pack_aligned_inner(const BVHStackEntry &e,
-                              const BVHStackEntry &e0,
-                              const BVHStackEntry &e1)
+void BVH2::pack_aligned_inner(const BVHStackEntry &e, BVHStackEntry &e0, BVHStackEntry &e1)
 {
+  e0.bounds = e0.node->bounds;
+  e1.bounds = e1.node->bounds;
+
   pack_aligned_node(e.idx,
                     e0.node->bounds,
                     e1.node->bounds,
@@ -174,8 +194,7 @@ void BVH2::pack_aligned_node(int idx,
   assert(c1 < 0 || c1 < pack.nodes.size());
 
   int4 data[BVH_NODE_SIZE] = {
-      make_int4(
-          visibility0 & ~PATH_RAY_NODE_UNALIGNED, visibility1 & ~PATH_RAY_NODE_UNALIGNED, c0, c1),
+      make_int4(visibility0 & ~PATH_RAY_NODE_FLAGS, visibility1 & ~PATH_RAY_NODE_FLAGS, c0, c1),
       make_int4(__float_as_int(b0.min.x),
                 __float_as_int(b1.min.x),
                 __float_as_int(b0.max.x),
@@ -225,10 +244,11 @@ void BVH2::pack_unaligned_node(int idx,
   float4 data[BVH_UNALIGNED_NODE_SIZE];
   Transform space0 = BVHUnaligned::compute_node_transform(bounds0, aligned_space0);
   Transform space1 = BVHUnaligned::compute_node_transform(bounds1, aligned_space1);
-  data[0] = make_float4(__int_as_float(visibility0 | PATH_RAY_NODE_UNALIGNED),
-                        __int_as_float(visibility1 | PATH_RAY_NODE_UNALIGNED),
-                        __int_as_float(c0),
-                        __int_as_float(c1));
+  data[0] = make_float4(
+      __int_as_float((visibility0 & ~PATH_RAY_NODE_FLAGS) | PATH_RAY_NODE_UNALIGNED),
+      __int_as_float((visibility1 & ~PATH_RAY_NODE_FLAGS) | PATH_RAY_NODE_UNALIGNED),
+      __int_as_float(c0),
+      __int_as_float(c1));
 
   data[1] = space0.x;
   data[2] = space0.y;
@@ -240,6 +260,150 @@ void BVH2::pack_unaligned_node(int idx,
   memcpy(&pack.nodes[idx], data, sizeof(float4) * BVH_UNALIGNED_NODE_SIZE);
 }
 
+/* Quantized nodes */
+
+namespace {
+
+/* Padding of the quantized bounds, so that they stay conservative even when the kernel rounds
+ * differently when decoding, for example due to fused multiply-add. */
+float bvh_quantize_padding(const float lower, const float upper)
+{
+  return (fabsf(lower) + fabsf(upper)) * (4.0f * FLT_EPSILON);
+}
+
+uint bvh_quantize_lower(const float lower, const float upper, const float value, const uint max)
+{
+  const float target = value - bvh_quantize_padding(lower, upper);
+  if (!(upper > lower) || target <= lower) {
+    return 0;
+  }
+  uint q = (uint)clamp(
+      (int)floorf((target - lower) / (upper - lower) * (float)max), 0, (int)max);
+  while (q > 0 && bvh_quantized_decode(lower, upper, q, max) > target) {
+    q--;
+  }
+  return q;
+}
+
+uint bvh_quantize_upper(const float lower, const float upper, const float value, const uint max)
+{
+  const float target = value + bvh_quantize_padding(lower, upper);
+  if (!(upper > lower) || target >= upper) {
+    return max;
+  }
+  uint q = (uint)clamp((int)ceilf((target - lower) / (upper - lower) * (float)max), 0, (int)max);
+  while (q < max && bvh_quantized_decode(lower, upper, q, max) < target) {
+    q++;
+  }
+  return q;
+}
+
+}  // namespace
+
+bool BVH2::use_quantized_child(const BVHNode *node, const BVHNode *child) const
+{
+  /* Traversal only knows axis aligned bounds of children of aligned and quantized nodes. */
+  return params.num_quantized_node_bits != 0 && !child->is_leaf() && !node->has_unaligned() &&
+         !child->has_unaligned();
+}
+
+int BVH2::packed_node_size(const BVHNode *node, bool is_quantized) const
+{
+  if (node->has_unaligned()) {
+    return BVH_UNALIGNED_NODE_SIZE;
+  }
+  else if (is_quantized) {
+    return (params.num_quantized_node_bits == 16) ? BVH_QUANTIZED_NODE_SIZE_16 :
+                                                    BVH_QUANTIZED_NODE_SIZE_8;
+  }
+  return BVH_NODE_SIZE;
+}
+
+size_t BVH2::packed_subtree_size(const BVHNode *node, bool is_quantized) const
+{
+  if (node->is_leaf()) {
+    return 0;
+  }
+  size_t size = packed_node_size(node, is_quantized);
+  for (int i = 0; i < node->num_children(); ++i) {
+    const BVHNode *child = node->get_child(i);
+    size += packed_subtree_size(child, use_quantized_child(node, child));
+  }
+  return size;
+}
+
+void BVH2::pack_quantized_inner(const BVHStackEntry &e, BVHStackEntry &e0, BVHStackEntry &e1)
+{
+  pack_quantized_node(e.idx,
+                      e.bounds,
+                      e0.node->bounds,
+                      e1.node->bounds,
+                      e0.encodeIdx(),
+                      e1.encodeIdx(),
+                      e0.node->visibility,
+                      e1.node->visibility,
+                      e0.bounds,
+                      e1.bounds);
+}
+
+void BVH2::pack_quantized_node(int idx,
+                               const BoundBox &bounds,
+                               const BoundBox &b0,
+                               const BoundBox &b1,
+                               int c0,
+                               int c1,
+                               uint visibility0,
+                               uint visibility1,
+                               BoundBox &decoded_b0,
+                               BoundBox &decoded_b1)
+{
+  const int num_bits = params.num_quantized_node_bits;
+  const uint max = bvh_quantized_max_value(num_bits);
+  const int node_size = (num_bits == 16) ? BVH_QUANTIZED_NODE_SIZE_16 : BVH_QUANTIZED_NODE_SIZE_8;
+
+  assert(idx + node_size <= pack.nodes.size());
+  assert(c0 < 0 || c0 < pack.nodes.size());
+  assert(c1 < 0 || c1 < pack.nodes.size());
+
+  const BoundBox *child_bounds[2] = {&b0, &b1};
+  uint data[BVH_QUANTIZED_NUM_VALUES / 2] = {0};
+  for (int i = 0; i < 2; i++) {
+    for (int axis = 0; axis < 3; axis++) {
+      const float lower = bounds.min[axis], upper = bounds.max[axis];
+      const uint q_lower = bvh_quantize_lower(lower, upper, child_bounds[i]->min[axis], max);
+      const uint q_upper = bvh_quantize_upper(lower, upper, child_bounds[i]->max[axis], max);
+      const int index_lower = i * 6 + axis, index_upper = i * 6 + 3 + axis;
+      if (num_bits == 16) {
+        data[index_lower >> 1] |= q_lower << ((index_lower & 1) * 16);
+        data[index_upper >> 1] |= q_upper << ((index_upper & 1) * 16);
+      }
+      else {
+        data[index_lower >> 2] |= q_lower << ((index_lower & 3) * 8);
+        data[index_upper >> 2] |= q_upper << ((index_upper & 3) * 8);
+      }
+    }
+  }
+
+  /* Decode with the same code as the kernel, so the children are quantized relative to the exact
+   * same bounds the traversal will see. */
+  float3 child_lower[2], child_upper[2];
+  bvh_quantized_node_decode(data, num_bits, bounds.min, bounds.max, child_lower, child_upper);
+  decoded_b0 = BoundBox(child_lower[0], child_upper[0]);
+  decoded_b1 = BoundBox(child_lower[1], child_upper[1]);
+
+  const uint flag1 = (num_bits == 16) ? PATH_RAY_NODE_QUANTIZED : 0;
+  int4 node_data[BVH_QUANTIZED_NODE_SIZE_16] = {
+      make_int4((visibility0 & ~PATH_RAY_NODE_FLAGS) | PATH_RAY_NODE_QUANTIZED,
+                (visibility1 & ~PATH_RAY_NODE_FLAGS) | flag1,
+                c0,
+                c1),
+      make_int4(data[0], data[1], data[2], data[3]),
+      make_int4(data[4], data[5], 0, 0),
+  };
+
+  memcpy(&pack.nodes[idx], node_data, sizeof(int4) * node_size);
+}
+
 void BVH2::pack_nodes(const BVHNode *root)
 {
   const size_t num_nodes = root->getSubtreeSize(BVH_STAT_NODE_COUNT);
@@ -247,7 +411,10 @@ void BVH2::pack_nodes(const BVHNode *root)
   assert(num_leaf_nodes <= num_nodes);
   const size_t num_inner_nodes = num_nodes - num_leaf_nodes;
   size_t node_size;
-  if (params.use_unaligned_nodes) {
+  if (params.num_quantized_node_bits != 0) {
+    node_size = packed_subtree_size(root, false);
+  }
+  else if (params.use_unaligned_nodes) {
     const size_t num_unaligned_nodes = root->getSubtreeSize(BVH_STAT_UNALIGNED_INNER_COUNT);
     node_size = (num_unaligned_nodes * BVH_UNALIGNED_NODE_SIZE) +
                 (num_inner_nodes - num_unaligned_nodes) * BVH_NODE_SIZE;
@@ -255,6 +422,8 @@ void BVH2::pack_nodes(const BVHNode *root)
   else {
     node_size = num_inner_nodes * BVH_NODE_SIZE;
   }
+  num_aligned_nodes = num_unaligned_nodes = num_quantized_nodes = 0;
+
   /* Resize arrays */
   pack.nodes.clear();
   pack.leaf_nodes.clear();
@@ -291,19 +460,21 @@ void BVH2::pack_nodes(const BVHNode *root)
     else {
       /* inner node */
       int idx[2];
+      bool is_quantized[2];
       for (int i = 0; i < 2; ++i) {
-        if (e.node->get_child(i)->is_leaf()) {
+        const BVHNode *child = e.node->get_child(i);
+        is_quantized[i] = use_quantized_child(e.node, child);
+        if (child->is_leaf()) {
           idx[i] = nextLeafNodeIdx++;
         }
         else {
           idx[i] = nextNodeIdx;
-          nextNodeIdx += e.node->get_child(i)->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE :
-                                                                 BVH_NODE_SIZE;
+          nextNodeIdx += packed_node_size(child, is_quantized[i]);
         }
       }
 
-      stack.push_back(BVHStackEntry(e.node->get_child(0), idx[0]));
-      stack.push_back(BVHStackEntry(e.node->get_child(1), idx[1]));
+      stack.push_back(BVHStackEntry(e.node->get_child(0), idx[0], is_quantized[0]));
+      stack.push_back(BVHStackEntry(e.node->get_child(1), idx[1], is_quantized[1]));
 
       pack_inner(e, stack[stack.size() - 2], stack[stack.size() - 1]);
     }
@@ -319,10 +490,22 @@ void BVH2::refit_nodes()
 
   BoundBox bbox = BoundBox::empty;
   uint visibility = 0;
-  refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility);
+  unordered_map<int, RefitQuantizedNode> quantized_nodes;
+  const bool leaf = (pack.root_index == -1);
+  refit_node(0, leaf, bbox, visibility, quantized_nodes);
+
+  /* Quantized nodes are packed relative to their own bounds, which are only known once their
+   * parent was refitted, so pack them in a second top-down pass. */
+  if (!quantized_nodes.empty()) {
+    refit_quantized_nodes(0, leaf, BoundBox::empty, quantized_nodes);
+  }
 }
 
-void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
+void BVH2::refit_node(int idx,
+                      bool leaf,
+                      BoundBox &bbox,
+                      uint &visibility,
+                      unordered_map<int, RefitQuantizedNode> &quantized_nodes)
 {
   if (leaf) {
     /* refit leaf node */
@@ -337,29 +520,48 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     float4 leaf_data[BVH_NODE_LEAF_SIZE];
     leaf_data[0].x = __int_as_float(c0);
     leaf_data[0].y = __int_as_float(c1);
-    leaf_data[0].z = __uint_as_float(visibility);
+    leaf_data[0].z = __uint_as_float(visibility & ~PATH_RAY_NODE_FLAGS);
     leaf_data[0].w = __uint_as_float(data[0].w);
     memcpy(&pack.leaf_nodes[idx], leaf_data, sizeof(float4) * BVH_NODE_LEAF_SIZE);
   }
   else {
-    assert(idx + BVH_NODE_SIZE <= pack.nodes.size());
+    assert(idx < pack.nodes.size());
 
     const int4 *data = &pack.nodes[idx];
     const bool is_unaligned = (data[0].x & PATH_RAY_NODE_UNALIGNED) != 0;
+    const bool is_quantized = (data[0].x & PATH_RAY_NODE_QUANTIZED) != 0;
+#ifndef NDEBUG
+    int node_size = BVH_NODE_SIZE;
+    if (is_unaligned) {
+      node_size = BVH_UNALIGNED_NODE_SIZE;
+    }
+    else if (is_quantized) {
+      node_size = (params.num_quantized_node_bits == 16) ? BVH_QUANTIZED_NODE_SIZE_16 :
+                                                           BVH_QUANTIZED_NODE_SIZE_8;
+    }
+    assert(idx + node_size <= pack.nodes.size());
+#endif
     const int c0 = data[0].z;
     const int c1 = data[0].w;
     /* refit inner node, set bbox from children */
     BoundBox bbox0 = BoundBox::empty, bbox1 = BoundBox::empty;
     uint visibility0 = 0, visibility1 = 0;
 
-    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0);
-    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1);
+    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0, quantized_nodes);
+    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1, quantized_nodes);
 
     if (is_unaligned) {
       Transform aligned_space = transform_identity();
       pack_unaligned_node(
           idx, aligned_space, aligned_space, bbox0, bbox1, c0, c1, visibility0, visibility1);
     }
+    else if (is_quantized) {
+      RefitQuantizedNode &node = quantized_nodes[idx];
+      node.b0 = bbox0;
+      node.b1 = bbox1;
+      node.visibility0 = visibility0;
+      node.visibility1 = visibility1;
+    }
     else {
       pack_aligned_node(idx, bbox0, bbox1, c0, c1, visibility0, visibility1);
     }
@@ -370,6 +572,45 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
   }
 }
 
+void BVH2::refit_quantized_nodes(int idx,
+                                 bool leaf,
+                                 const BoundBox &bounds,
+                                 const unordered_map<int, RefitQuantizedNode> &quantized_nodes)
+{
+  if (leaf) {
+    return;
+  }
+
+  const int4 *data = &pack.nodes[idx];
+  const int c0 = data[0].z;
+  const int c1 = data[0].w;
+  BoundBox bbox0 = BoundBox::empty, bbox1 = BoundBox::empty;
+
+  if (data[0].x & PATH_RAY_NODE_QUANTIZED) {
+    const RefitQuantizedNode &node = quantized_nodes.at(idx);
+    pack_quantized_node(idx,
+                        bounds,
+                        node.b0,
+                        node.b1,
+                        c0,
+                        c1,
+                        node.visibility0,
+                        node.visibility1,
+                        bbox0,
+                        bbox1);
+  }
+  else if (!(data[0].x & PATH_RAY_NODE_UNALIGNED)) {
+    const float4 *fdata = (const float4 *)data;
+    bbox0 = BoundBox(make_float3(fdata[1].x, fdata[2].x, fdata[3].x),
+                     make_float3(fdata[1].z, fdata[2].z, fdata[3].z));
+    bbox1 = BoundBox(make_float3(fdata[1].y, fdata[2].y, fdata[3].y),
+                     make_float3(fdata[1].w, fdata[2].w, fdata[3].w));
+  }
+
+  refit_quantized_nodes((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, quantized_nodes);
+  refit_quantized_nodes((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, quantized_nodes);
+}
+
 /* Refitting */
 
 void BVH2::refit_primitives(int start, int end, BoundBox &bbox, uint &visibility)
@@ -591,6 +832,11 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
 
     BVH2 *bvh = static_cast<BVH2 *>(geom->bvh);
 
+    num_aligned_nodes += bvh->num_aligned_nodes;
+    num_unaligned_nodes += bvh->num_unaligned_nodes;
+    num_quantized_nodes += bvh->num_quantized_nodes;
+    build_time += bvh->build_time;
+
     int noffset = nodes_offset;
     int noffset_leaf = nodes_leaf_offset;
     int geom_prim_offset = geom->prim_offset;
@@ -668,6 +914,11 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
           nsize = BVH_UNALIGNED_NODE_SIZE;
           nsize_bbox = 0;
         }
+        else if (bvh_nodes[i].x & PATH_RAY_NODE_QUANTIZED) {
+          nsize = (bvh_nodes[i].y & PATH_RAY_NODE_QUANTIZED) ? BVH_QUANTIZED_NODE_SIZE_16 :
+                                                                BVH_QUANTIZED_NODE_SIZE_8;
+          nsize_bbox = 0;
+        }
         else {
           nsize = BVH_NODE_SIZE;
           nsize_bbox = 0;
@@ -21,6 +21,7 @@
 #include "bvh/bvh.h"
 #include "bvh/bvh_params.h"
 
+#include "util/util_map.h"
 #include "util/util_types.h"
 #include "util/util_vector.h"
 
@@ -29,19 +30,36 @@ CCL_NAMESPACE_BEGIN
 #define BVH_NODE_SIZE 4
 #define BVH_NODE_LEAF_SIZE 1
 #define BVH_UNALIGNED_NODE_SIZE 7
+#define BVH_QUANTIZED_NODE_SIZE_8 2
+#define BVH_QUANTIZED_NODE_SIZE_16 3
 
 /* Pack Utility */
 struct BVHStackEntry {
   const BVHNode *node;
   int idx;
+  bool is_quantized;
+  /* Bounds of the node as seen by the traversal, which are the decoded bounds for children of
+   * quantized nodes. Used as reference for quantized child bounds. */
+  BoundBox bounds;
 
-  BVHStackEntry(const BVHNode *n = 0, int i = 0);
+  BVHStackEntry(const BVHNode *n = 0, int i = 0, bool quantized = false);
   int encodeIdx() const;
 };
 
 /* BVH2
  *
  * Typical BVH with each node having two children.
+ *
+ * Inner nodes are stored in one of the following layouts, all starting with the visibility of
+ * both children and their indices:
+ *
+ * - Aligned: full precision axis aligned bounds of both children.
+ * - Unaligned: transformation to the oriented bounds space of both children.
+ * - Quantized: bounds of both children quantized relative to the bounds of the node itself.
+ *   The node is tagged with PATH_RAY_NODE_QUANTIZED in the visibility of the first child, and
+ *   also in the visibility of the second child when 16 bit values are used.
+ *   Root nodes and children of unaligned nodes are never quantized, since the traversal doesn't
+ *   know their axis aligned bounds.
  */
 class BVH2 : public BVH {
  public:
@@ -50,6 +68,12 @@ class BVH2 : public BVH {
 
   PackedBVH pack;
 
+  /* Statistics gathered when packing, including merged instance BVHs. */
+  size_t num_aligned_nodes;
+  size_t num_unaligned_nodes;
+  size_t num_quantized_nodes;
+  double build_time;
+
  protected:
   /* constructor */
   friend class BVH;
@@ -64,11 +88,9 @@ class BVH2 : public BVH {
   void pack_nodes(const BVHNode *root);
 
   void pack_leaf(const BVHStackEntry &e, const LeafNode *leaf);
-  void pack_inner(const BVHStackEntry &e, const BVHStackEntry &e0, const BVHStackEntry &e1);
+  void pack_inner(const BVHStackEntry &e, BVHStackEntry &e0, BVHStackEntry &e1);
 
-  void pack_aligned_inner(const BVHStackEntry &e,
-                          const BVHStackEntry &e0,
-                          const BVHStackEntry &e1);
+  void pack_aligned_inner(const BVHStackEntry &e, BVHStackEntry &e0, BVHStackEntry &e1);
   void pack_aligned_node(int idx,
                          const BoundBox &b0,
                          const BoundBox &b1,
@@ -90,9 +112,39 @@ class BVH2 : public BVH {
                            uint visibility0,
                            uint visibility1);
 
+  void pack_quantized_inner(const BVHStackEntry &e, BVHStackEntry &e0, BVHStackEntry &e1);
+  void pack_quantized_node(int idx,
+                           const BoundBox &bounds,
+                           const BoundBox &b0,
+                           const BoundBox &b1,
+                           int c0,
+                           int c1,
+                           uint visibility0,
+                           uint visibility1,
+                           BoundBox &decoded_b0,
+                           BoundBox &decoded_b1);
+
+  /* Quantized nodes. */
+  bool use_quantized_child(const BVHNode *node, const BVHNode *child) const;
+  int packed_node_size(const BVHNode *node, bool is_quantized) const;
+  size_t packed_subtree_size(const BVHNode *node, bool is_quantized) const;
+
   /* refit */
+  struct RefitQuantizedNode {
+    BoundBox b0, b1;
+    uint visibility0, visibility1;
+  };
+
   void refit_nodes();
-  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility);
+  void refit_node(int idx,
+                  bool leaf,
+                  BoundBox &bbox,
+                  uint &visibility,
+                  unordered_map<int, RefitQuantizedNode> &quantized_nodes);
+  void refit_quantized_nodes(int idx,
+                             bool leaf,
+                             const BoundBox &bounds,
+                             const unordered_map<int, RefitQuantizedNode> &quantized_nodes);
 
   /* Refit range of primitives. */
   void refit_primitives(int start, int end, BoundBox &bbox, uint &visibility);
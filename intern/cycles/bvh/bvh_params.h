@@ -74,6 +74,14 @@ class BVHParams {
    */
   bool use_unaligned_nodes;
 
+  /* Store child bounds of inner nodes quantized relative to the bounds of the node itself, using
+   * this number of bits per value (8 or 16). Zero keeps full precision bounds.
+   *
+   * Lowers memory usage of the nodes in the cost of slower traversal. Only supported by the CPU
+   * kernel.
+   */
+  int num_quantized_node_bits;
+
   /* Split time range to this number of steps and create leaf node for each
    * of this time steps.
    *
@@ -115,6 +123,7 @@ class BVHParams {
     top_level = false;
     bvh_layout = BVH_LAYOUT_BVH2;
     use_unaligned_nodes = false;
+    num_quantized_node_bits = 0;
 
     num_motion_curve_steps = 0;
     num_motion_triangle_steps = 0;
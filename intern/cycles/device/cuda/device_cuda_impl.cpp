@@ -931,7 +931,12 @@ CUDADevice::CUDAMem *CUDADevice::generic_alloc(device_memory &mem, size_t pitch_
 
 void CUDADevice::generic_copy_to(device_memory &mem)
 {
-  if (!mem.host_pointer || !mem.device_pointer) {
+  generic_copy_to(mem, 0, mem.memory_size());
+}
+
+void CUDADevice::generic_copy_to(device_memory &mem, size_t offset, size_t size)
+{
+  if (!mem.host_pointer || !mem.device_pointer || size == 0) {
     return;
   }
 
@@ -941,8 +946,9 @@ void CUDADevice::generic_copy_to(device_memory &mem)
   thread_scoped_lock lock(cuda_mem_map_mutex);
   if (!cuda_mem_map[&mem].use_mapped_host || mem.host_pointer != mem.shared_pointer) {
     const CUDAContextScope scope(this);
-    cuda_assert(
-        cuMemcpyHtoD((CUdeviceptr)mem.device_pointer, mem.host_pointer, mem.memory_size()));
+    cuda_assert(cuMemcpyHtoD((CUdeviceptr)mem.device_pointer + offset,
+                             (const char *)mem.host_pointer + offset,
+                             size));
   }
 }
 
@@ -1020,6 +1026,22 @@ void CUDADevice::mem_copy_to(device_memory &mem)
   }
 }
 
+void CUDADevice::mem_copy_to_range(device_memory &mem, size_t offset, size_t size)
+{
+  if (mem.type == MEM_GLOBAL && mem.device_pointer) {
+    /* Update in place, the pointer in kernel globals stays valid. */
+    if (mem.is_resident(this)) {
+      generic_copy_to(mem, offset, size);
+    }
+  }
+  else if ((mem.type == MEM_READ_ONLY || mem.type == MEM_READ_WRITE) && mem.device_pointer) {
+    generic_copy_to(mem, offset, size);
+  }
+  else {
+    mem_copy_to(mem);
+  }
+}
+
 void CUDADevice::mem_copy_from(device_memory &mem, int y, int w, int h, int elem)
 {
   if (mem.type == MEM_PIXELS && !background) {
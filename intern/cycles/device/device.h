@@ -493,6 +493,12 @@ class Device {
 
   virtual void mem_alloc(device_memory &mem) = 0;
   virtual void mem_copy_to(device_memory &mem) = 0;
+  /* Copy size bytes starting at offset to an existing device allocation of the same size as the
+   * host memory. Devices that can't update part of the memory copy all of it instead. */
+  virtual void mem_copy_to_range(device_memory &mem, size_t /*offset*/, size_t /*size*/)
+  {
+    mem_copy_to(mem);
+  }
   virtual void mem_copy_from(device_memory &mem, int y, int w, int h, int elem) = 0;
   virtual void mem_zero(device_memory &mem) = 0;
   virtual void mem_free(device_memory &mem) = 0;
@@ -488,6 +488,17 @@ class CPUDevice : public Device {
     }
   }
 
+  virtual void mem_copy_to_range(device_memory &mem,
+                                 size_t /*offset*/,
+                                 size_t /*size*/) override
+  {
+    /* Global and generic memory point to the host memory, so once allocated nothing needs to be
+     * copied. */
+    if (mem.type == MEM_TEXTURE || mem.type == MEM_PIXELS || !mem.device_pointer) {
+      mem_copy_to(mem);
+    }
+  }
+
   virtual void mem_copy_from(
       device_memory & /*mem*/, int /*y*/, int /*w*/, int /*h*/, int /*elem*/) override
   {
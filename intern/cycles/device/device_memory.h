@@ -22,7 +22,9 @@
  * Data types for allocating, copying and freeing device memory. */
 
 #include "util/util_array.h"
+#include "util/util_foreach.h"
 #include "util/util_half.h"
+#include "util/util_map.h"
 #include "util/util_string.h"
 #include "util/util_texture.h"
 #include "util/util_types.h"
@@ -197,7 +199,7 @@ template<> struct device_type_traits<uint64_t> {
 
 class device_memory {
  public:
-  size_t memory_size()
+  size_t memory_size() const
   {
     return data_size * data_elements * datatype_size(data_type);
   }
@@ -253,6 +255,7 @@ class device_memory {
   void device_alloc();
   void device_free();
   void device_copy_to();
+  void device_copy_to(size_t offset, size_t size);
   void device_copy_from(int y, int w, int h, int elem);
   void device_zero();
 
@@ -351,7 +354,7 @@ template<typename T> class device_vector : public device_memory {
       device_free();
       host_free();
       host_pointer = host_alloc(sizeof(T) * new_size);
-      modified = true;
+      tag_modified();
       assert(device_pointer == 0);
     }
 
@@ -380,6 +383,7 @@ template<typename T> class device_vector : public device_memory {
       device_free();
       host_free();
       host_pointer = new_ptr;
+      tag_modified();
       assert(device_pointer == 0);
     }
 
@@ -429,8 +433,7 @@ template<typename T> class device_vector : public device_memory {
     data_height = 0;
     data_depth = 0;
     host_pointer = 0;
-    modified = true;
-    need_realloc_ = true;
+    tag_realloc();
     assert(device_pointer == 0);
   }
 
@@ -454,6 +457,45 @@ template<typename T> class device_vector : public device_memory {
   void tag_modified()
   {
     modified = true;
+    modified_ranges.clear();
+  }
+
+  /* Tag num elements starting at offset as modified. Only those ranges are copied to the device
+   * by copy_to_device_if_modified(), unless the entire vector gets tagged as modified. */
+  void tag_modified(size_t offset, size_t num)
+  {
+    if (num == 0) {
+      return;
+    }
+
+    if (modified && modified_ranges.empty()) {
+      /* Already fully modified. */
+      return;
+    }
+
+    modified = true;
+
+    if (!modified_ranges.empty()) {
+      /* Ranges are usually tagged in increasing order, so try to extend the last one first. */
+      ModifiedRange &last = modified_ranges.back();
+      if (offset >= last.first && offset <= last.first + last.second) {
+        last.second = std::max(last.second, offset + num - last.first);
+        return;
+      }
+    }
+
+    modified_ranges.push_back(ModifiedRange(offset, num));
+
+    if (modified_ranges.size() > MAX_MODIFIED_RANGES) {
+      /* Avoid many small copies, merge everything into a single range. */
+      size_t range_begin = offset, range_end = offset + num;
+      foreach (const ModifiedRange &range, modified_ranges) {
+        range_begin = std::min(range_begin, range.first);
+        range_end = std::max(range_end, range.first + range.second);
+      }
+      modified_ranges.clear();
+      modified_ranges.push_back(ModifiedRange(range_begin, range_end - range_begin));
+    }
   }
 
   void tag_realloc()
@@ -491,13 +533,28 @@ template<typename T> class device_vector : public device_memory {
       return;
     }
 
-    copy_to_device();
+    /* Partial copies need the existing device allocation to be reused as is. */
+    if (modified_ranges.empty() || need_realloc_ || !device_pointer ||
+        device_size != memory_size()) {
+      copy_to_device();
+      return;
+    }
+
+    if (data_size != 0) {
+      foreach (const ModifiedRange &range, modified_ranges) {
+        const size_t num = std::min(range.second, data_size - std::min(range.first, data_size));
+        if (num != 0) {
+          device_copy_to(sizeof(T) * range.first, sizeof(T) * num);
+        }
+      }
+    }
   }
 
   void clear_modified()
   {
     modified = false;
     need_realloc_ = false;
+    modified_ranges.clear();
   }
 
   void copy_from_device()
@@ -528,6 +585,12 @@ template<typename T> class device_vector : public device_memory {
   {
     return width * ((height == 0) ? 1 : height) * ((depth == 0) ? 1 : depth);
   }
+
+  static const size_t MAX_MODIFIED_RANGES = 64;
+
+  /* Modified ranges of elements as (offset, num) pairs, empty when the whole vector is modified. */
+  typedef pair<size_t, size_t> ModifiedRange;
+  vector<ModifiedRange> modified_ranges;
 };
 
 /* Pixel Memory
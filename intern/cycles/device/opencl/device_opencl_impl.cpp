@@ -1008,6 +1008,28 @@ void OpenCLDevice::mem_copy_to(device_memory &mem)
   }
 }
 
+void OpenCLDevice::mem_copy_to_range(device_memory &mem, size_t offset, size_t size)
+{
+  /* Global memory is packed into shared buffers by the memory manager, always copy it fully. */
+  if (mem.type == MEM_GLOBAL || mem.type == MEM_TEXTURE || !mem.device_pointer) {
+    mem_copy_to(mem);
+    return;
+  }
+
+  /* this is blocking */
+  if (size != 0) {
+    opencl_assert(clEnqueueWriteBuffer(cqCommandQueue,
+                                       CL_MEM_PTR(mem.device_pointer),
+                                       CL_TRUE,
+                                       offset,
+                                       size,
+                                       (const char *)mem.host_pointer + offset,
+                                       0,
+                                       NULL,
+                                       NULL));
+  }
+}
+
 void OpenCLDevice::mem_copy_from(device_memory &mem, int y, int w, int h, int elem)
 {
   size_t offset = elem * y * w;
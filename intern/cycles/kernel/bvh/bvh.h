@@ -29,6 +29,10 @@
 #  include "kernel/bvh/bvh_embree.h"
 #endif
 
+#ifdef __BVH_QUANTIZED__
+#  include "kernel/bvh/bvh_quantized.h"
+#endif
+
 CCL_NAMESPACE_BEGIN
 
 #include "kernel/bvh/bvh_types.h"
@@ -129,6 +133,42 @@ CCL_NAMESPACE_BEGIN
 #    endif
 #  endif /* __VOLUME_RECORD_ALL__ */
 
+/* Quantized BVH traversal
+ *
+ * Quantized nodes are a debug option to reduce BVH memory, a single variant of each traversal
+ * with all features enabled is compiled for them, so other scenes don't pay for the bounds
+ * stack. */
+
+#  if defined(__BVH_QUANTIZED__)
+#    define BVH_FUNCTION_NAME bvh_intersect_quantized
+#    define BVH_FUNCTION_FEATURES BVH_HAIR | BVH_MOTION | BVH_QUANTIZED
+#    include "kernel/bvh/bvh_traversal.h"
+
+#    if defined(__BVH_LOCAL__)
+#      define BVH_FUNCTION_NAME bvh_intersect_local_quantized
+#      define BVH_FUNCTION_FEATURES BVH_MOTION | BVH_HAIR | BVH_QUANTIZED
+#      include "kernel/bvh/bvh_local.h"
+#    endif
+
+#    if defined(__VOLUME__)
+#      define BVH_FUNCTION_NAME bvh_intersect_volume_quantized
+#      define BVH_FUNCTION_FEATURES BVH_MOTION | BVH_HAIR | BVH_QUANTIZED
+#      include "kernel/bvh/bvh_volume.h"
+#    endif
+
+#    if defined(__SHADOW_RECORD_ALL__)
+#      define BVH_FUNCTION_NAME bvh_intersect_shadow_all_quantized
+#      define BVH_FUNCTION_FEATURES BVH_HAIR | BVH_MOTION | BVH_QUANTIZED
+#      include "kernel/bvh/bvh_shadow_all.h"
+#    endif
+
+#    if defined(__VOLUME_RECORD_ALL__)
+#      define BVH_FUNCTION_NAME bvh_intersect_volume_all_quantized
+#      define BVH_FUNCTION_FEATURES BVH_MOTION | BVH_HAIR | BVH_QUANTIZED
+#      include "kernel/bvh/bvh_volume_all.h"
+#    endif
+#  endif /* __BVH_QUANTIZED__ */
+
 #  undef BVH_FEATURE
 #  undef BVH_NAME_JOIN
 #  undef BVH_NAME_EVAL
@@ -214,6 +254,12 @@ ccl_device_intersect bool scene_intersect(KernelGlobals *kg,
   }
 #  endif /* __EMBREE__ */
 
+#  ifdef __BVH_QUANTIZED__
+  if (kernel_data.bvh.have_quantized) {
+    return bvh_intersect_quantized(kg, ray, isect, visibility);
+  }
+#  endif /* __BVH_QUANTIZED__ */
+
 #  ifdef __OBJECT_MOTION__
   if (kernel_data.bvh.have_motion) {
 #    ifdef __HAIR__
@@ -341,6 +387,12 @@ ccl_device_intersect bool scene_intersect_local(KernelGlobals *kg,
   }
 #    endif /* __EMBREE__ */
 
+#    ifdef __BVH_QUANTIZED__
+  if (kernel_data.bvh.have_quantized) {
+    return bvh_intersect_local_quantized(kg, ray, local_isect, local_object, lcg_state, max_hits);
+  }
+#    endif /* __BVH_QUANTIZED__ */
+
 #    ifdef __OBJECT_MOTION__
   if (kernel_data.bvh.have_motion) {
     return bvh_intersect_local_motion(kg, ray, local_isect, local_object, lcg_state, max_hits);
@@ -414,6 +466,12 @@ ccl_device_intersect bool scene_intersect_shadow_all(KernelGlobals *kg,
   }
 #    endif /* __EMBREE__ */
 
+#    ifdef __BVH_QUANTIZED__
+  if (kernel_data.bvh.have_quantized) {
+    return bvh_intersect_shadow_all_quantized(kg, ray, isect, visibility, max_hits, num_hits);
+  }
+#    endif /* __BVH_QUANTIZED__ */
+
 #    ifdef __OBJECT_MOTION__
   if (kernel_data.bvh.have_motion) {
 #      ifdef __HAIR__
@@ -485,6 +543,12 @@ ccl_device_intersect bool scene_intersect_volume(KernelGlobals *kg,
     return false;
   }
 
+#    ifdef __BVH_QUANTIZED__
+  if (kernel_data.bvh.have_quantized) {
+    return bvh_intersect_volume_quantized(kg, ray, isect, visibility);
+  }
+#    endif /* __BVH_QUANTIZED__ */
+
 #    ifdef __OBJECT_MOTION__
   if (kernel_data.bvh.have_motion) {
     return bvh_intersect_volume_motion(kg, ray, isect, visibility);
@@ -523,6 +587,12 @@ ccl_device_intersect uint scene_intersect_volume_all(KernelGlobals *kg,
   }
 #  endif /* __EMBREE__ */
 
+#  ifdef __BVH_QUANTIZED__
+  if (kernel_data.bvh.have_quantized) {
+    return bvh_intersect_volume_all_quantized(kg, ray, isect, max_hits, visibility);
+  }
+#  endif /* __BVH_QUANTIZED__ */
+
 #  ifdef __OBJECT_MOTION__
   if (kernel_data.bvh.have_motion) {
     return bvh_intersect_volume_all_motion(kg, ray, isect, max_hits, visibility);
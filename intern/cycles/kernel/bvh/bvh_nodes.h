@@ -151,3 +151,137 @@ ccl_device_forceinline int bvh_node_intersect(KernelGlobals *kg,
     return bvh_aligned_node_intersect(kg, P, idir, t, node_addr, visibility, dist);
   }
 }
+
+#ifdef __BVH_QUANTIZED__
+/* Intersection of nodes which might be quantized.
+ *
+ * Besides the regular intersection, these functions return bounds of the node children, which the
+ * traversal needs to decode child bounds once it gets to a quantized child. Children of unaligned
+ * nodes are never quantized, so no bounds are returned for them. */
+
+/* Bounds of a node as known to the traversal. */
+typedef struct BVHNodeBounds {
+  float3 lower, upper;
+} BVHNodeBounds;
+
+ccl_device_forceinline void bvh_aligned_node_fetch_bounds(KernelGlobals *kg,
+                                                          const int node_addr,
+                                                          BVHNodeBounds child_bounds[2])
+{
+  float4 node0 = kernel_tex_fetch(__bvh_nodes, node_addr + 1);
+  float4 node1 = kernel_tex_fetch(__bvh_nodes, node_addr + 2);
+  float4 node2 = kernel_tex_fetch(__bvh_nodes, node_addr + 3);
+
+  child_bounds[0].lower = make_float3(node0.x, node1.x, node2.x);
+  child_bounds[0].upper = make_float3(node0.z, node1.z, node2.z);
+  child_bounds[1].lower = make_float3(node0.y, node1.y, node2.y);
+  child_bounds[1].upper = make_float3(node0.w, node1.w, node2.w);
+}
+
+ccl_device_forceinline int bvh_quantized_node_intersect(KernelGlobals *kg,
+                                                        const float3 P,
+                                                        const float3 idir,
+                                                        const float t,
+                                                        const int node_addr,
+                                                        const uint visibility,
+                                                        const BVHNodeBounds *node_bounds,
+                                                        BVHNodeBounds child_bounds[2],
+                                                        float dist[2])
+{
+  float4 cnodes = kernel_tex_fetch(__bvh_nodes, node_addr + 0);
+
+  /* Nodes with 16 bit bounds are tagged in the visibility of the second child. */
+  const int num_bits = (__float_as_uint(cnodes.y) & PATH_RAY_NODE_QUANTIZED) ? 16 : 8;
+
+  uint data[6];
+  float4 node0 = kernel_tex_fetch(__bvh_nodes, node_addr + 1);
+  data[0] = __float_as_uint(node0.x);
+  data[1] = __float_as_uint(node0.y);
+  data[2] = __float_as_uint(node0.z);
+  data[3] = __float_as_uint(node0.w);
+  if (num_bits == 16) {
+    float4 node1 = kernel_tex_fetch(__bvh_nodes, node_addr + 2);
+    data[4] = __float_as_uint(node1.x);
+    data[5] = __float_as_uint(node1.y);
+  }
+  else {
+    data[4] = data[5] = 0;
+  }
+
+  float3 child_lower[2], child_upper[2];
+  bvh_quantized_node_decode(
+      data, num_bits, node_bounds->lower, node_bounds->upper, child_lower, child_upper);
+
+  int mask = 0;
+  for (int i = 0; i < 2; i++) {
+    child_bounds[i].lower = child_lower[i];
+    child_bounds[i].upper = child_upper[i];
+
+    /* intersect ray against child node */
+    const float3 lower_xyz = (child_lower[i] - P) * idir;
+    const float3 upper_xyz = (child_upper[i] - P) * idir;
+    const float near_x = min(lower_xyz.x, upper_xyz.x);
+    const float near_y = min(lower_xyz.y, upper_xyz.y);
+    const float near_z = min(lower_xyz.z, upper_xyz.z);
+    const float far_x = max(lower_xyz.x, upper_xyz.x);
+    const float far_y = max(lower_xyz.y, upper_xyz.y);
+    const float far_z = max(lower_xyz.z, upper_xyz.z);
+    const float tnear = max4(0.0f, near_x, near_y, near_z);
+    const float tfar = min4(t, far_x, far_y, far_z);
+    dist[i] = tnear;
+    mask |= (tfar >= tnear) ? (1 << i) : 0;
+  }
+
+#ifdef __VISIBILITY_FLAG__
+  if (!(__float_as_uint(cnodes.x) & visibility)) {
+    mask &= ~1;
+  }
+  if (!(__float_as_uint(cnodes.y) & visibility)) {
+    mask &= ~2;
+  }
+#endif
+  return mask;
+}
+
+ccl_device_forceinline int bvh_aligned_node_intersect_quantized(KernelGlobals *kg,
+                                                                const float3 P,
+                                                                const float3 idir,
+                                                                const float t,
+                                                                const int node_addr,
+                                                                const uint visibility,
+                                                                const BVHNodeBounds *node_bounds,
+                                                                BVHNodeBounds child_bounds[2],
+                                                                float dist[2])
+{
+  float4 node = kernel_tex_fetch(__bvh_nodes, node_addr);
+  if (__float_as_uint(node.x) & PATH_RAY_NODE_QUANTIZED) {
+    return bvh_quantized_node_intersect(
+        kg, P, idir, t, node_addr, visibility, node_bounds, child_bounds, dist);
+  }
+  else {
+    bvh_aligned_node_fetch_bounds(kg, node_addr, child_bounds);
+    return bvh_aligned_node_intersect(kg, P, idir, t, node_addr, visibility, dist);
+  }
+}
+
+ccl_device_forceinline int bvh_node_intersect_quantized(KernelGlobals *kg,
+                                                        const float3 P,
+                                                        const float3 dir,
+                                                        const float3 idir,
+                                                        const float t,
+                                                        const int node_addr,
+                                                        const uint visibility,
+                                                        const BVHNodeBounds *node_bounds,
+                                                        BVHNodeBounds child_bounds[2],
+                                                        float dist[2])
+{
+  float4 node = kernel_tex_fetch(__bvh_nodes, node_addr);
+  if (__float_as_uint(node.x) & PATH_RAY_NODE_UNALIGNED) {
+    return bvh_unaligned_node_intersect(kg, P, dir, idir, t, node_addr, visibility, dist);
+  }
+  else {
+    return bvh_aligned_node_intersect_quantized(
+        kg, P, idir, t, node_addr, visibility, node_bounds, child_bounds, dist);
+  }
+}
+#endif /* __BVH_QUANTIZED__ */
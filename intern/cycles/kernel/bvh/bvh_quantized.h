@@ -0,0 +1,93 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Quantized BVH nodes
+ *
+ * Child bounds of a quantized node are stored as 8 or 16 bit values relative to the bounds of
+ * the node itself. Those bounds are not stored in the node, they are known from the parent node
+ * at the time the traversal gets to the node.
+ *
+ * Decoding is shared between the kernel and the BVH packer, so that the packer works with the
+ * exact same conservative bounds as the traversal does. */
+
+#ifndef __BVH_QUANTIZED_H__
+#define __BVH_QUANTIZED_H__
+
+CCL_NAMESPACE_BEGIN
+
+/* Number of quantized values per node: lower and upper bounds of two children. */
+#define BVH_QUANTIZED_NUM_VALUES 12
+
+ccl_device_inline uint bvh_quantized_max_value(const int num_bits)
+{
+  return (num_bits == 16) ? 0xffff : 0xff;
+}
+
+/* Decode single value of the [lower, upper] range. Values are decoded relative to the nearest end
+ * of the range, so that the extreme values map exactly to the bounds of the range. */
+ccl_device_inline float bvh_quantized_decode(const float lower,
+                                             const float upper,
+                                             const uint value,
+                                             const uint max_value)
+{
+  const float scale = (upper - lower) * (1.0f / (float)max_value);
+  return (value * 2 <= max_value) ? lower + (float)value * scale :
+                                    upper - (float)(max_value - value) * scale;
+}
+
+/* Get value with the given index from the packed node data. */
+ccl_device_inline uint bvh_quantized_unpack(const uint *data, const int num_bits, const int index)
+{
+  if (num_bits == 16) {
+    return (data[index >> 1] >> ((index & 1) * 16)) & 0xffff;
+  }
+  return (data[index >> 2] >> ((index & 3) * 8)) & 0xff;
+}
+
+/* Decode bounds of both children of the node with the given bounds.
+ *
+ * Values are ordered as lower and upper bounds of the first child followed by lower and upper
+ * bounds of the second child. */
+ccl_device_inline void bvh_quantized_node_decode(const uint *data,
+                                                 const int num_bits,
+                                                 const float3 lower,
+                                                 const float3 upper,
+                                                 float3 child_lower[2],
+                                                 float3 child_upper[2])
+{
+  const uint max_value = bvh_quantized_max_value(num_bits);
+  for (int i = 0; i < 2; i++) {
+    const int offset = i * 6;
+    child_lower[i] = make_float3(
+        bvh_quantized_decode(
+            lower.x, upper.x, bvh_quantized_unpack(data, num_bits, offset + 0), max_value),
+        bvh_quantized_decode(
+            lower.y, upper.y, bvh_quantized_unpack(data, num_bits, offset + 1), max_value),
+        bvh_quantized_decode(
+            lower.z, upper.z, bvh_quantized_unpack(data, num_bits, offset + 2), max_value));
+    child_upper[i] = make_float3(
+        bvh_quantized_decode(
+            lower.x, upper.x, bvh_quantized_unpack(data, num_bits, offset + 3), max_value),
+        bvh_quantized_decode(
+            lower.y, upper.y, bvh_quantized_unpack(data, num_bits, offset + 4), max_value),
+        bvh_quantized_decode(
+            lower.z, upper.z, bvh_quantized_unpack(data, num_bits, offset + 5), max_value));
+  }
+}
+
+CCL_NAMESPACE_END
+
+#endif /* __BVH_QUANTIZED_H__ */
@@ -17,7 +17,13 @@
  * limitations under the License.
  */
 
-#if BVH_FEATURE(BVH_HAIR)
+#if BVH_FEATURE(BVH_QUANTIZED)
+#  if BVH_FEATURE(BVH_HAIR)
+#    define NODE_INTERSECT bvh_node_intersect_quantized
+#  else
+#    define NODE_INTERSECT bvh_aligned_node_intersect_quantized
+#  endif
+#elif BVH_FEATURE(BVH_HAIR)
 #  define NODE_INTERSECT bvh_node_intersect
 #else
 #  define NODE_INTERSECT bvh_aligned_node_intersect
@@ -29,6 +35,7 @@
  *
  * BVH_HAIR: hair curve rendering
  * BVH_MOTION: motion blur rendering
+ * BVH_QUANTIZED: quantized inner nodes
  */
 
 #ifndef __KERNEL_GPU__
@@ -51,6 +58,7 @@ ccl_device_inline
   /* traversal stack in CUDA thread-local memory */
   int traversal_stack[BVH_STACK_SIZE];
   traversal_stack[0] = ENTRYPOINT_SENTINEL;
+  BVH_QUANTIZED_STACK_DECLARE();
 
   /* traversal variables in registers */
   int stack_ptr = 0;
@@ -91,6 +99,10 @@ ccl_device_inline
                                        isect_t,
                                        node_addr,
                                        visibility,
+#if BVH_FEATURE(BVH_QUANTIZED)
+                                       &node_bounds,
+                                       child_bounds,
+#endif
                                        dist);
 
         node_addr = __float_as_int(cnodes.z);
@@ -108,17 +120,24 @@ ccl_device_inline
           ++stack_ptr;
           kernel_assert(stack_ptr < BVH_STACK_SIZE);
           traversal_stack[stack_ptr] = node_addr_child1;
+          BVH_QUANTIZED_PUSH(is_closest_child1 ? 0 : 1);
+          BVH_QUANTIZED_SELECT(is_closest_child1 ? 1 : 0);
         }
         else {
           /* One child was intersected. */
           if (traverse_mask == 2) {
             node_addr = node_addr_child1;
+            BVH_QUANTIZED_SELECT(1);
           }
           else if (traverse_mask == 0) {
             /* Neither child was intersected. */
             node_addr = traversal_stack[stack_ptr];
+            BVH_QUANTIZED_POP();
             --stack_ptr;
           }
+          else {
+            BVH_QUANTIZED_SELECT(0);
+          }
         }
       }
 
@@ -134,6 +153,7 @@ ccl_device_inline
 
           /* pop */
           node_addr = traversal_stack[stack_ptr];
+          BVH_QUANTIZED_POP();
           --stack_ptr;
 
           /* primitive intersection */
@@ -270,6 +290,7 @@ ccl_device_inline
 
       object = OBJECT_NONE;
       node_addr = traversal_stack[stack_ptr];
+      BVH_QUANTIZED_POP();
       --stack_ptr;
     }
   } while (node_addr != ENTRYPOINT_SENTINEL);
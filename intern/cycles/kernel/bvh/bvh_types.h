@@ -35,6 +35,7 @@ CCL_NAMESPACE_BEGIN
 
 #define BVH_MOTION 1
 #define BVH_HAIR 2
+#define BVH_QUANTIZED 4
 
 #define BVH_NAME_JOIN(x, y) x##_##y
 #define BVH_NAME_EVAL(x, y) BVH_NAME_JOIN(x, y)
@@ -69,6 +70,41 @@ CCL_NAMESPACE_BEGIN
 #  define BVH_DEBUG_NEXT_INSTANCE()
 #endif /* __KERNEL_DEBUG__ */
 
+/* Quantized nodes helpers.
+ *
+ * Child bounds of quantized nodes are stored relative to the bounds of the node itself, so the
+ * traversal keeps bounds of the current node and of the nodes on the stack. Only variants with
+ * the BVH_QUANTIZED feature use them, other variants get a single element stack which is
+ * optimized out. */
+#ifdef __BVH_QUANTIZED__
+#  define BVH_QUANTIZED_STACK_DECLARE() \
+    BVHNodeBounds traversal_stack_bounds[BVH_FEATURE(BVH_QUANTIZED) ? BVH_STACK_SIZE : 1]; \
+    BVHNodeBounds node_bounds, child_bounds[2]
+#  define BVH_QUANTIZED_PUSH(child) \
+    do { \
+      if (BVH_FEATURE(BVH_QUANTIZED)) { \
+        traversal_stack_bounds[stack_ptr] = child_bounds[child]; \
+      } \
+    } while (0)
+#  define BVH_QUANTIZED_SELECT(child) \
+    do { \
+      if (BVH_FEATURE(BVH_QUANTIZED)) { \
+        node_bounds = child_bounds[child]; \
+      } \
+    } while (0)
+#  define BVH_QUANTIZED_POP() \
+    do { \
+      if (BVH_FEATURE(BVH_QUANTIZED)) { \
+        node_bounds = traversal_stack_bounds[stack_ptr]; \
+      } \
+    } while (0)
+#else /* __BVH_QUANTIZED__ */
+#  define BVH_QUANTIZED_STACK_DECLARE()
+#  define BVH_QUANTIZED_PUSH(child)
+#  define BVH_QUANTIZED_SELECT(child)
+#  define BVH_QUANTIZED_POP()
+#endif /* __BVH_QUANTIZED__ */
+
 CCL_NAMESPACE_END
 
 #endif /* __BVH_TYPES__ */
@@ -129,6 +129,8 @@ CCL_NAMESPACE_BEGIN
 #  endif
 #  define __VOLUME_DECOUPLED__
 #  define __VOLUME_RECORD_ALL__
+#  define __BVH_QUANTIZED__
+#  define __TEXTURE_CACHE__
 #endif /* __KERNEL_CPU__ */
 
 #ifdef __KERNEL_CUDA__
@@ -288,8 +290,8 @@ enum PathRayFlag {
                                  PATH_RAY_SHADOW_TRANSPARENT_NON_CATCHER),
   PATH_RAY_SHADOW = (PATH_RAY_SHADOW_OPAQUE | PATH_RAY_SHADOW_TRANSPARENT),
 
-  /* Unused, free to reuse. */
-  PATH_RAY_UNUSED = (1 << 11),
+  /* Special flag to tag quantized BVH nodes. */
+  PATH_RAY_NODE_QUANTIZED = (1 << 11),
 
   /* Ray visibility for volume scattering. */
   PATH_RAY_VOLUME_SCATTER = (1 << 12),
@@ -297,6 +299,10 @@ enum PathRayFlag {
   /* Special flag to tag unaligned BVH nodes. */
   PATH_RAY_NODE_UNALIGNED = (1 << 13),
 
+  /* Node layout flags, cleared from object visibility when packing BVH nodes. Objects visible to
+   * all rays have them set, but they are not a ray type. */
+  PATH_RAY_NODE_FLAGS = (PATH_RAY_NODE_QUANTIZED | PATH_RAY_NODE_UNALIGNED),
+
   PATH_RAY_ALL_VISIBILITY = ((1 << 14) - 1),
 
   /* Don't apply multiple importance sampling weights to emission from
@@ -1435,6 +1441,8 @@ typedef struct KernelBVH {
   int bvh_layout;
   int use_bvh_steps;
   int curve_subdivisions;
+  int have_quantized;
+  int pad1, pad2, pad3;
 
   /* Custom BVH */
 #ifdef __KERNEL_OPTIX__
@@ -1443,10 +1451,10 @@ typedef struct KernelBVH {
 #  ifdef __EMBREE__
   RTCScene scene;
 #    ifndef __KERNEL_64_BIT__
-  int pad2;
+  int pad4;
 #    endif
 #  else
-  int scene, pad2;
+  int scene, pad4;
 #  endif
 #endif
 } KernelBVH;
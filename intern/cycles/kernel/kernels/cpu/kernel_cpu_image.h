@@ -23,6 +23,10 @@
 #  include <nanovdb/util/SampleFromVoxels.h>
 #endif
 
+#ifdef __TEXTURE_CACHE__
+#  include "util/util_texture_cache.h"
+#endif
+
 CCL_NAMESPACE_BEGIN
 
 /* Make template functions private so symbols don't conflict between kernels with different
@@ -584,10 +588,33 @@ template<typename T> struct NanoVDBInterpolator {
 
 #undef SET_CUBIC_SPLINE_WEIGHTS
 
+#ifdef __TEXTURE_CACHE__
+ccl_device float4 kernel_tex_image_cache_lookup(
+    const TextureInfo &info, float x, float y, float2 dx, float2 dy)
+{
+  const TextureCacheImage *image = (const TextureCacheImage *)info.cache_image;
+  float4 r;
+
+  if (!image->lookup(x, y, dx.x, dx.y, dy.x, dy.y, &r)) {
+    return make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+  }
+
+  return r;
+}
+#endif
+
 ccl_device float4 kernel_tex_image_interp(KernelGlobals *kg, int id, float x, float y)
 {
   const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
 
+#ifdef __TEXTURE_CACHE__
+  if (info.cache_image) {
+    /* Without derivatives, sample the full resolution. */
+    return kernel_tex_image_cache_lookup(info, x, y, zero_float2(), zero_float2());
+  }
+#endif
+
   switch (info.data_type) {
     case IMAGE_DATA_TYPE_HALF:
       return TextureInterpolator<half>::interp(info, x, y);
@@ -612,6 +639,22 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals *kg, int id, float x, fl
   }
 }
 
+#ifdef __TEXTURE_CACHE__
+/* Lookup with derivatives of the image coordinates, used to select the resolution of images in
+ * the texture cache. Images in device memory are always sampled at full resolution. */
+ccl_device float4 kernel_tex_image_interp_derivatives(
+    KernelGlobals *kg, int id, float x, float y, float2 dx, float2 dy)
+{
+  const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
+
+  if (info.cache_image) {
+    return kernel_tex_image_cache_lookup(info, x, y, dx, dy);
+  }
+
+  return kernel_tex_image_interp(kg, id, x, y);
+}
+#endif
+
 ccl_device float4 kernel_tex_image_interp_3d(KernelGlobals *kg,
                                              int id,
                                              float3 P,
@@ -16,14 +16,8 @@
 
 CCL_NAMESPACE_BEGIN
 
-ccl_device float4 svm_image_texture(KernelGlobals *kg, int id, float x, float y, uint flags)
+ccl_device float4 svm_image_texture_flags(float4 r, uint flags)
 {
-  if (id == -1) {
-    return make_float4(
-        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
-  }
-
-  float4 r = kernel_tex_image_interp(kg, id, x, y);
   const float alpha = r.w;
 
   if ((flags & NODE_IMAGE_ALPHA_UNASSOCIATE) && alpha != 1.0f && alpha != 0.0f) {
@@ -38,12 +32,49 @@ ccl_device float4 svm_image_texture(KernelGlobals *kg, int id, float x, float y,
   return r;
 }
 
+ccl_device float4 svm_image_texture(KernelGlobals *kg, int id, float x, float y, uint flags)
+{
+  if (id == -1) {
+    return make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+  }
+
+  return svm_image_texture_flags(kernel_tex_image_interp(kg, id, x, y), flags);
+}
+
+#ifdef __TEXTURE_CACHE__
+ccl_device float4 svm_image_texture_derivatives(
+    KernelGlobals *kg, int id, float x, float y, float2 dx, float2 dy, uint flags)
+{
+  if (id == -1) {
+    return make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+  }
+
+  return svm_image_texture_flags(kernel_tex_image_interp_derivatives(kg, id, x, y, dx, dy),
+                                 flags);
+}
+#endif
+
 /* Remap coordinate from 0..1 box to -1..-1 */
 ccl_device_inline float3 texco_remap_square(float3 co)
 {
   return (co - make_float3(0.5f, 0.5f, 0.5f)) * 2.0f;
 }
 
+ccl_device_inline float2 svm_image_map(float3 co, uint projection)
+{
+  if (projection == NODE_IMAGE_PROJ_SPHERE) {
+    return map_to_sphere(texco_remap_square(co));
+  }
+  else if (projection == NODE_IMAGE_PROJ_TUBE) {
+    return map_to_tube(texco_remap_square(co));
+  }
+  else {
+    return make_float2(co.x, co.y);
+  }
+}
+
 ccl_device void svm_node_tex_image(
     KernelGlobals *kg, ShaderData *sd, float *stack, uint4 node, int *offset)
 {
@@ -52,17 +83,21 @@ ccl_device void svm_node_tex_image(
   svm_unpack_node_uchar4(node.z, &co_offset, &out_offset, &alpha_offset, &flags);
 
   float3 co = stack_load_float3(stack, co_offset);
-  float2 tex_co;
-  if (node.w == NODE_IMAGE_PROJ_SPHERE) {
-    co = texco_remap_square(co);
-    tex_co = map_to_sphere(co);
-  }
-  else if (node.w == NODE_IMAGE_PROJ_TUBE) {
-    co = texco_remap_square(co);
-    tex_co = map_to_tube(co);
-  }
-  else {
-    tex_co = make_float2(co.x, co.y);
+  float2 tex_co = svm_image_map(co, node.w);
+
+  /* Texture coordinates offset along the ray differentials, compiled for images that may be
+   * paged in from the texture cache at a lower resolution. */
+#ifdef __TEXTURE_CACHE__
+  float2 tex_co_dx = zero_float2(), tex_co_dy = zero_float2();
+#endif
+  if (flags & NODE_IMAGE_DERIVATIVES) {
+    uint4 derivatives_node = read_node(kg, offset);
+#ifdef __TEXTURE_CACHE__
+    tex_co_dx = svm_image_map(stack_load_float3(stack, derivatives_node.x), node.w) - tex_co;
+    tex_co_dy = svm_image_map(stack_load_float3(stack, derivatives_node.y), node.w) - tex_co;
+#else
+    (void)derivatives_node;
+#endif
   }
 
   /* TODO(lukas): Consider moving tile information out of the SVM node.
@@ -108,7 +143,12 @@ ccl_device void svm_node_tex_image(
     id = -num_nodes;
   }
 
+#ifdef __TEXTURE_CACHE__
+  float4 f = svm_image_texture_derivatives(
+      kg, id, tex_co.x, tex_co.y, tex_co_dx, tex_co_dy, flags);
+#else
   float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, flags);
+#endif
 
   if (stack_valid(out_offset))
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
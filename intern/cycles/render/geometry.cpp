@@ -232,6 +232,9 @@ void Geometry::compute_bvh(
                                     params->use_bvh_unaligned_nodes;
       bparams.num_motion_triangle_steps = params->num_bvh_time_steps;
       bparams.num_motion_curve_steps = params->num_bvh_time_steps;
+      bparams.num_quantized_node_bits = (device->info.type == DEVICE_CPU) ?
+                                            params->num_bvh_quantized_node_bits :
+                                            0;
       bparams.bvh_type = params->bvh_type;
       bparams.curve_subdivisions = params->curve_subdivisions();
 
@@ -538,13 +541,22 @@ void GeometryManager::update_svm_attributes(Device *,
   dscene->attributes_map.copy_to_device();
 }
 
-static void update_attribute_element_size(Geometry *geom,
+/* Number of elements in each of the attribute arrays. */
+struct AttributeSizes {
+  size_t float_size = 0;
+  size_t float2_size = 0;
+  size_t float3_size = 0;
+  size_t uchar4_size = 0;
+};
+
+/* Add the size of the attribute to the array it is stored in, and tag the range it is stored at
+ * when the attribute was modified. Must match the offsets update_attribute_element_offset()
+ * stores attributes at. */
+static void update_attribute_element_size(DeviceScene *dscene,
+                                          Geometry *geom,
                                           Attribute *mattr,
                                           AttributePrimitive prim,
-                                          size_t *attr_float_size,
-                                          size_t *attr_float2_size,
-                                          size_t *attr_float3_size,
-                                          size_t *attr_uchar4_size)
+                                          AttributeSizes &attr_size)
 {
   if (mattr) {
     size_t size = mattr->element_size(geom, prim);
@@ -553,19 +565,34 @@ static void update_attribute_element_size(Geometry *geom,
       /* pass */
     }
     else if (mattr->element == ATTR_ELEMENT_CORNER_BYTE) {
-      *attr_uchar4_size += size;
+      if (mattr->modified) {
+        dscene->attributes_uchar4.tag_modified(attr_size.uchar4_size, size);
+      }
+      attr_size.uchar4_size += size;
     }
     else if (mattr->type == TypeDesc::TypeFloat) {
-      *attr_float_size += size;
+      if (mattr->modified) {
+        dscene->attributes_float.tag_modified(attr_size.float_size, size);
+      }
+      attr_size.float_size += size;
     }
     else if (mattr->type == TypeFloat2) {
-      *attr_float2_size += size;
+      if (mattr->modified) {
+        dscene->attributes_float2.tag_modified(attr_size.float2_size, size);
+      }
+      attr_size.float2_size += size;
     }
     else if (mattr->type == TypeDesc::TypeMatrix) {
-      *attr_float3_size += size * 4;
+      if (mattr->modified) {
+        dscene->attributes_float3.tag_modified(attr_size.float3_size, size * 3);
+      }
+      attr_size.float3_size += size * 3;
     }
     else {
-      *attr_float3_size += size;
+      if (mattr->modified) {
+        dscene->attributes_float3.tag_modified(attr_size.float3_size, size);
+      }
+      attr_size.float3_size += size;
     }
   }
 }
@@ -705,6 +732,18 @@ void GeometryManager::update_attribute_element_offset(Geometry *geom,
   }
 }
 
+/* Run func for every item in parallel. Items are expected to write to disjoint parts of arrays,
+ * at offsets computed before. */
+template<typename T, typename Func>
+static void parallel_foreach(const vector<T *> &items, const Func &func)
+{
+  parallel_for(blocked_range<size_t>(0, items.size(), 1), [&](const blocked_range<size_t> &r) {
+    for (size_t i = r.begin(); i != r.end(); i++) {
+      func(items[i]);
+    }
+  });
+}
+
 void GeometryManager::device_update_attributes(Device *device,
                                                DeviceScene *dscene,
                                                Scene *scene,
@@ -766,159 +805,168 @@ void GeometryManager::device_update_attributes(Device *device,
    * those arrays, and set the offset and element type to create attribute
    * maps next */
 
-  /* Pre-allocate attributes to avoid arrays re-allocation which would
-   * take 2x of overall attribute memory usage.
-   */
-  size_t attr_float_size = 0;
-  size_t attr_float2_size = 0;
-  size_t attr_float3_size = 0;
-  size_t attr_uchar4_size = 0;
+  const bool copy_all_data = dscene->attributes_float.need_realloc() ||
+                             dscene->attributes_float2.need_realloc() ||
+                             dscene->attributes_float3.need_realloc() ||
+                             dscene->attributes_uchar4.need_realloc();
 
-  for (size_t i = 0; i < scene->geometry.size(); i++) {
-    Geometry *geom = scene->geometry[i];
-    AttributeRequestSet &attributes = geom_attributes[i];
-    foreach (AttributeRequest &req, attributes.requests) {
-      Attribute *attr = geom->attributes.find(req);
+  /* Offsets into the attribute arrays at which the attributes of each geometry and object
+   * start. */
+  vector<AttributeSizes> geom_attr_offsets(scene->geometry.size());
+  vector<AttributeSizes> object_attr_offsets(scene->objects.size());
+
+  {
+    /* Offsets are computed serially, so that the arrays can be filled in parallel next. */
+    scoped_callback_timer timer([scene](double time) {
+      if (scene->update_stats) {
+        scene->update_stats->geometry.phases.add_entry({"attributes: compute offsets", time});
+      }
+    });
 
-      update_attribute_element_size(geom,
-                                    attr,
-                                    ATTR_PRIM_GEOMETRY,
-                                    &attr_float_size,
-                                    &attr_float2_size,
-                                    &attr_float3_size,
-                                    &attr_uchar4_size);
+    AttributeSizes attr_size;
 
-      if (geom->is_mesh()) {
-        Mesh *mesh = static_cast<Mesh *>(geom);
-        Attribute *subd_attr = mesh->subd_attributes.find(req);
+    for (size_t i = 0; i < scene->geometry.size(); i++) {
+      Geometry *geom = scene->geometry[i];
+      AttributeRequestSet &attributes = geom_attributes[i];
+
+      geom_attr_offsets[i] = attr_size;
 
-        update_attribute_element_size(mesh,
-                                      subd_attr,
-                                      ATTR_PRIM_SUBD,
-                                      &attr_float_size,
-                                      &attr_float2_size,
-                                      &attr_float3_size,
-                                      &attr_uchar4_size);
+      foreach (AttributeRequest &req, attributes.requests) {
+        Attribute *attr = geom->attributes.find(req);
+
+        if (attr) {
+          /* force a copy if we need to reallocate all the data */
+          attr->modified |= copy_all_data;
+        }
+
+        update_attribute_element_size(dscene, geom, attr, ATTR_PRIM_GEOMETRY, attr_size);
+
+        if (geom->is_mesh()) {
+          Mesh *mesh = static_cast<Mesh *>(geom);
+          Attribute *subd_attr = mesh->subd_attributes.find(req);
+
+          if (subd_attr) {
+            /* force a copy if we need to reallocate all the data */
+            subd_attr->modified |= copy_all_data;
+          }
+
+          update_attribute_element_size(dscene, mesh, subd_attr, ATTR_PRIM_SUBD, attr_size);
+        }
       }
     }
-  }
 
-  for (size_t i = 0; i < scene->objects.size(); i++) {
-    Object *object = scene->objects[i];
+    for (size_t i = 0; i < scene->objects.size(); i++) {
+      Object *object = scene->objects[i];
+      AttributeRequestSet &attributes = object_attributes[i];
+      AttributeSet &values = object_attribute_values[i];
 
-    foreach (Attribute &attr, object_attribute_values[i].attributes) {
-      update_attribute_element_size(object->geometry,
-                                    &attr,
-                                    ATTR_PRIM_GEOMETRY,
-                                    &attr_float_size,
-                                    &attr_float2_size,
-                                    &attr_float3_size,
-                                    &attr_uchar4_size);
+      object_attr_offsets[i] = attr_size;
+
+      foreach (AttributeRequest &req, attributes.requests) {
+        Attribute *attr = values.find(req);
+        update_attribute_element_size(
+            dscene, object->geometry, attr, ATTR_PRIM_GEOMETRY, attr_size);
+      }
     }
+
+    /* Pre-allocate attributes to avoid arrays re-allocation which would
+     * take 2x of overall attribute memory usage.
+     */
+    dscene->attributes_float.alloc(attr_size.float_size);
+    dscene->attributes_float2.alloc(attr_size.float2_size);
+    dscene->attributes_float3.alloc(attr_size.float3_size);
+    dscene->attributes_uchar4.alloc(attr_size.uchar4_size);
   }
 
-  dscene->attributes_float.alloc(attr_float_size);
-  dscene->attributes_float2.alloc(attr_float2_size);
-  dscene->attributes_float3.alloc(attr_float3_size);
-  dscene->attributes_uchar4.alloc(attr_uchar4_size);
+  {
+    /* Fill in attributes. */
+    scoped_callback_timer timer([scene](double time) {
+      if (scene->update_stats) {
+        scene->update_stats->geometry.phases.add_entry({"attributes: pack", time});
+      }
+    });
 
-  const bool copy_all_data = dscene->attributes_float.need_realloc() ||
-                             dscene->attributes_float2.need_realloc() ||
-                             dscene->attributes_float3.need_realloc() ||
-                             dscene->attributes_uchar4.need_realloc();
+    parallel_foreach(scene->geometry, [&](Geometry *geom) {
+      if (progress.get_cancel()) {
+        return;
+      }
 
-  size_t attr_float_offset = 0;
-  size_t attr_float2_offset = 0;
-  size_t attr_float3_offset = 0;
-  size_t attr_uchar4_offset = 0;
+      AttributeRequestSet &attributes = geom_attributes[geom->index];
+      AttributeSizes attr_offset = geom_attr_offsets[geom->index];
 
-  /* Fill in attributes. */
-  for (size_t i = 0; i < scene->geometry.size(); i++) {
-    Geometry *geom = scene->geometry[i];
-    AttributeRequestSet &attributes = geom_attributes[i];
+      /* todo: we now store std and name attributes from requests even if
+       * they actually refer to the same mesh attributes, optimize */
+      foreach (AttributeRequest &req, attributes.requests) {
+        Attribute *attr = geom->attributes.find(req);
 
-    /* todo: we now store std and name attributes from requests even if
-     * they actually refer to the same mesh attributes, optimize */
-    foreach (AttributeRequest &req, attributes.requests) {
-      Attribute *attr = geom->attributes.find(req);
-
-      if (attr) {
-        /* force a copy if we need to reallocate all the data */
-        attr->modified |= copy_all_data;
-      }
-
-      update_attribute_element_offset(geom,
-                                      dscene->attributes_float,
-                                      attr_float_offset,
-                                      dscene->attributes_float2,
-                                      attr_float2_offset,
-                                      dscene->attributes_float3,
-                                      attr_float3_offset,
-                                      dscene->attributes_uchar4,
-                                      attr_uchar4_offset,
-                                      attr,
-                                      ATTR_PRIM_GEOMETRY,
-                                      req.type,
-                                      req.desc);
-
-      if (geom->is_mesh()) {
-        Mesh *mesh = static_cast<Mesh *>(geom);
-        Attribute *subd_attr = mesh->subd_attributes.find(req);
+        update_attribute_element_offset(geom,
+                                        dscene->attributes_float,
+                                        attr_offset.float_size,
+                                        dscene->attributes_float2,
+                                        attr_offset.float2_size,
+                                        dscene->attributes_float3,
+                                        attr_offset.float3_size,
+                                        dscene->attributes_uchar4,
+                                        attr_offset.uchar4_size,
+                                        attr,
+                                        ATTR_PRIM_GEOMETRY,
+                                        req.type,
+                                        req.desc);
 
-        if (subd_attr) {
-          /* force a copy if we need to reallocate all the data */
-          subd_attr->modified |= copy_all_data;
+        if (geom->is_mesh()) {
+          Mesh *mesh = static_cast<Mesh *>(geom);
+          Attribute *subd_attr = mesh->subd_attributes.find(req);
+
+          update_attribute_element_offset(mesh,
+                                          dscene->attributes_float,
+                                          attr_offset.float_size,
+                                          dscene->attributes_float2,
+                                          attr_offset.float2_size,
+                                          dscene->attributes_float3,
+                                          attr_offset.float3_size,
+                                          dscene->attributes_uchar4,
+                                          attr_offset.uchar4_size,
+                                          subd_attr,
+                                          ATTR_PRIM_SUBD,
+                                          req.subd_type,
+                                          req.subd_desc);
         }
+      }
+    });
 
-        update_attribute_element_offset(mesh,
+    if (progress.get_cancel())
+      return;
+
+    parallel_foreach(scene->objects, [&](Object *object) {
+      AttributeRequestSet &attributes = object_attributes[object->index];
+      AttributeSet &values = object_attribute_values[object->index];
+      AttributeSizes attr_offset = object_attr_offsets[object->index];
+
+      foreach (AttributeRequest &req, attributes.requests) {
+        Attribute *attr = values.find(req);
+
+        update_attribute_element_offset(object->geometry,
                                         dscene->attributes_float,
-                                        attr_float_offset,
+                                        attr_offset.float_size,
                                         dscene->attributes_float2,
-                                        attr_float2_offset,
+                                        attr_offset.float2_size,
                                         dscene->attributes_float3,
-                                        attr_float3_offset,
+                                        attr_offset.float3_size,
                                         dscene->attributes_uchar4,
-                                        attr_uchar4_offset,
-                                        subd_attr,
-                                        ATTR_PRIM_SUBD,
-                                        req.subd_type,
-                                        req.subd_desc);
+                                        attr_offset.uchar4_size,
+                                        attr,
+                                        ATTR_PRIM_GEOMETRY,
+                                        req.type,
+                                        req.desc);
+
+        /* object attributes don't care about subdivision */
+        req.subd_type = req.type;
+        req.subd_desc = req.desc;
       }
+    });
 
-      if (progress.get_cancel())
-        return;
-    }
-  }
-
-  for (size_t i = 0; i < scene->objects.size(); i++) {
-    Object *object = scene->objects[i];
-    AttributeRequestSet &attributes = object_attributes[i];
-    AttributeSet &values = object_attribute_values[i];
-
-    foreach (AttributeRequest &req, attributes.requests) {
-      Attribute *attr = values.find(req);
-
-      update_attribute_element_offset(object->geometry,
-                                      dscene->attributes_float,
-                                      attr_float_offset,
-                                      dscene->attributes_float2,
-                                      attr_float2_offset,
-                                      dscene->attributes_float3,
-                                      attr_float3_offset,
-                                      dscene->attributes_uchar4,
-                                      attr_uchar4_offset,
-                                      attr,
-                                      ATTR_PRIM_GEOMETRY,
-                                      req.type,
-                                      req.desc);
-
-      /* object attributes don't care about subdivision */
-      req.subd_type = req.type;
-      req.subd_desc = req.desc;
-
-      if (progress.get_cancel())
-        return;
-    }
+    if (progress.get_cancel())
+      return;
   }
 
   /* create attribute lookup maps */
@@ -933,10 +981,18 @@ void GeometryManager::device_update_attributes(Device *device,
   /* copy to device */
   progress.set_status("Updating Mesh", "Copying Attributes to device");
 
-  dscene->attributes_float.copy_to_device();
-  dscene->attributes_float2.copy_to_device();
-  dscene->attributes_float3.copy_to_device();
-  dscene->attributes_uchar4.copy_to_device();
+  {
+    scoped_callback_timer timer([scene](double time) {
+      if (scene->update_stats) {
+        scene->update_stats->geometry.phases.add_entry({"attributes: copy to device", time});
+      }
+    });
+
+    dscene->attributes_float.copy_to_device_if_modified();
+    dscene->attributes_float2.copy_to_device_if_modified();
+    dscene->attributes_float3.copy_to_device_if_modified();
+    dscene->attributes_uchar4.copy_to_device_if_modified();
+  }
 
   if (progress.get_cancel())
     return;
@@ -1053,6 +1109,9 @@ void GeometryManager::device_update_mesh(
     }
   }
 
+  /* Offsets of all geometry are known at this point, so each geometry is packed into its own
+   * part of the arrays in parallel. */
+
   /* Create mapping from triangle to primitive triangle array. */
   vector<uint> tri_prim_index(tri_size);
   if (for_displacement) {
@@ -1061,14 +1120,14 @@ void GeometryManager::device_update_mesh(
      * from final render kernels since we don't have BVH yet, so can't
      * really use same semantic of arrays.
      */
-    foreach (Geometry *geom, scene->geometry) {
+    parallel_foreach(scene->geometry, [&](Geometry *geom) {
       if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
         Mesh *mesh = static_cast<Mesh *>(geom);
         for (size_t i = 0; i < mesh->num_triangles(); ++i) {
           tri_prim_index[i + mesh->prim_offset] = 3 * (i + mesh->prim_offset);
         }
       }
-    }
+    });
   }
   else {
     for (size_t i = 0; i < dscene->prim_index.size(); ++i) {
@@ -1095,8 +1154,22 @@ void GeometryManager::device_update_mesh(
                                dscene->tri_patch.need_realloc() ||
                                dscene->tri_patch_uv.need_realloc();
 
-    foreach (Geometry *geom, scene->geometry) {
-      if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
+    {
+      scoped_callback_timer timer([scene](double time) {
+        if (scene->update_stats) {
+          scene->update_stats->geometry.phases.add_entry({"mesh: pack triangles", time});
+        }
+      });
+
+      parallel_foreach(scene->geometry, [&](Geometry *geom) {
+        if (geom->geometry_type != Geometry::MESH && geom->geometry_type != Geometry::VOLUME) {
+          return;
+        }
+
+        if (progress.get_cancel()) {
+          return;
+        }
+
         Mesh *mesh = static_cast<Mesh *>(geom);
 
         if (mesh->shader_is_modified() || mesh->smooth_is_modified() ||
@@ -1116,15 +1189,21 @@ void GeometryManager::device_update_mesh(
                            mesh->vert_offset,
                            mesh->prim_offset);
         }
-
-        if (progress.get_cancel())
-          return;
-      }
+      });
     }
 
+    if (progress.get_cancel())
+      return;
+
     /* vertex coordinates */
     progress.set_status("Updating Mesh", "Copying Mesh to device");
 
+    scoped_callback_timer timer([scene](double time) {
+      if (scene->update_stats) {
+        scene->update_stats->geometry.phases.add_entry({"mesh: copy triangles to device", time});
+      }
+    });
+
     dscene->tri_shader.copy_to_device_if_modified();
     dscene->tri_vnormal.copy_to_device_if_modified();
     dscene->tri_vindex.copy_to_device_if_modified();
@@ -1140,8 +1219,22 @@ void GeometryManager::device_update_mesh(
 
     const bool copy_all_data = dscene->curve_keys.need_realloc() || dscene->curves.need_realloc();
 
-    foreach (Geometry *geom, scene->geometry) {
-      if (geom->is_hair()) {
+    {
+      scoped_callback_timer timer([scene](double time) {
+        if (scene->update_stats) {
+          scene->update_stats->geometry.phases.add_entry({"mesh: pack curves", time});
+        }
+      });
+
+      parallel_foreach(scene->geometry, [&](Geometry *geom) {
+        if (!geom->is_hair()) {
+          return;
+        }
+
+        if (progress.get_cancel()) {
+          return;
+        }
+
         Hair *hair = static_cast<Hair *>(geom);
 
         bool curve_keys_co_modified = hair->curve_radius_is_modified() ||
@@ -1150,18 +1243,25 @@ void GeometryManager::device_update_mesh(
                                    hair->curve_first_key_is_modified();
 
         if (!curve_keys_co_modified && !curve_data_modified && !copy_all_data) {
-          continue;
+          return;
         }
 
         hair->pack_curves(scene,
                           &curve_keys[hair->curvekey_offset],
                           &curves[hair->prim_offset],
                           hair->curvekey_offset);
-        if (progress.get_cancel())
-          return;
-      }
+      });
     }
 
+    if (progress.get_cancel())
+      return;
+
+    scoped_callback_timer timer([scene](double time) {
+      if (scene->update_stats) {
+        scene->update_stats->geometry.phases.add_entry({"mesh: copy curves to device", time});
+      }
+    });
+
     dscene->curve_keys.copy_to_device_if_modified();
     dscene->curves.copy_to_device_if_modified();
   }
@@ -1169,32 +1269,44 @@ void GeometryManager::device_update_mesh(
   if (patch_size != 0 && dscene->patches.need_realloc()) {
     progress.set_status("Updating Mesh", "Copying Patches to device");
 
+    scoped_callback_timer timer([scene](double time) {
+      if (scene->update_stats) {
+        scene->update_stats->geometry.phases.add_entry({"mesh: patches", time});
+      }
+    });
+
     uint *patch_data = dscene->patches.alloc(patch_size);
 
-    foreach (Geometry *geom, scene->geometry) {
-      if (geom->is_mesh()) {
-        Mesh *mesh = static_cast<Mesh *>(geom);
-        mesh->pack_patches(&patch_data[mesh->patch_offset],
-                           mesh->vert_offset,
-                           mesh->face_offset,
-                           mesh->corner_offset);
+    parallel_foreach(scene->geometry, [&](Geometry *geom) {
+      if (!geom->is_mesh()) {
+        return;
+      }
 
-        if (mesh->patch_table) {
-          mesh->patch_table->copy_adjusting_offsets(&patch_data[mesh->patch_table_offset],
-                                                    mesh->patch_table_offset);
-        }
+      if (progress.get_cancel()) {
+        return;
+      }
 
-        if (progress.get_cancel())
-          return;
+      Mesh *mesh = static_cast<Mesh *>(geom);
+      mesh->pack_patches(&patch_data[mesh->patch_offset],
+                         mesh->vert_offset,
+                         mesh->face_offset,
+                         mesh->corner_offset);
+
+      if (mesh->patch_table) {
+        mesh->patch_table->copy_adjusting_offsets(&patch_data[mesh->patch_table_offset],
+                                                  mesh->patch_table_offset);
       }
-    }
+    });
+
+    if (progress.get_cancel())
+      return;
 
     dscene->patches.copy_to_device();
   }
 
   if (for_displacement) {
     float4 *prim_tri_verts = dscene->prim_tri_verts.alloc(tri_size * 3);
-    foreach (Geometry *geom, scene->geometry) {
+    parallel_foreach(scene->geometry, [&](Geometry *geom) {
       if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
         Mesh *mesh = static_cast<Mesh *>(geom);
         for (size_t i = 0; i < mesh->num_triangles(); ++i) {
@@ -1205,7 +1317,7 @@ void GeometryManager::device_update_mesh(
           prim_tri_verts[offset + 2] = float3_to_float4(mesh->verts[t.v[2]]);
         }
       }
-    }
+    });
     dscene->prim_tri_verts.copy_to_device();
   }
 }
@@ -1227,6 +1339,9 @@ void GeometryManager::device_update_bvh(Device *device,
                                 scene->params.use_bvh_unaligned_nodes;
   bparams.num_motion_triangle_steps = scene->params.num_bvh_time_steps;
   bparams.num_motion_curve_steps = scene->params.num_bvh_time_steps;
+  bparams.num_quantized_node_bits = (device->info.type == DEVICE_CPU) ?
+                                        scene->params.num_bvh_quantized_node_bits :
+                                        0;
   bparams.bvh_type = scene->params.bvh_type;
   bparams.curve_subdivisions = scene->params.curve_subdivisions();
 
@@ -1366,6 +1481,7 @@ void GeometryManager::device_update_bvh(Device *device,
   dscene->data.bvh.bvh_layout = bparams.bvh_layout;
   dscene->data.bvh.use_bvh_steps = (scene->params.num_bvh_time_steps != 0);
   dscene->data.bvh.curve_subdivisions = scene->params.curve_subdivisions();
+  dscene->data.bvh.have_quantized = has_bvh2_layout && (bparams.num_quantized_node_bits != 0);
   /* The scene handle is set in 'CPUDevice::const_copy_to' and 'OptiXDevice::const_copy_to' */
   dscene->data.bvh.scene = NULL;
 }
@@ -1595,37 +1711,27 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
     }
   }
 
+  /* Modified attributes tag the ranges they are stored at when filling in the arrays, so that
+   * only those are copied to the device. */
   if (device_update_flags & ATTR_FLOAT_NEEDS_REALLOC) {
     dscene->attributes_map.tag_realloc();
     dscene->attributes_float.tag_realloc();
   }
-  else if (device_update_flags & ATTR_FLOAT_MODIFIED) {
-    dscene->attributes_float.tag_modified();
-  }
 
   if (device_update_flags & ATTR_FLOAT2_NEEDS_REALLOC) {
     dscene->attributes_map.tag_realloc();
     dscene->attributes_float2.tag_realloc();
   }
-  else if (device_update_flags & ATTR_FLOAT2_MODIFIED) {
-    dscene->attributes_float2.tag_modified();
-  }
 
   if (device_update_flags & ATTR_FLOAT3_NEEDS_REALLOC) {
     dscene->attributes_map.tag_realloc();
     dscene->attributes_float3.tag_realloc();
   }
-  else if (device_update_flags & ATTR_FLOAT3_MODIFIED) {
-    dscene->attributes_float3.tag_modified();
-  }
 
   if (device_update_flags & ATTR_UCHAR4_NEEDS_REALLOC) {
     dscene->attributes_map.tag_realloc();
     dscene->attributes_uchar4.tag_realloc();
   }
-  else if (device_update_flags & ATTR_UCHAR4_MODIFIED) {
-    dscene->attributes_uchar4.tag_modified();
-  }
 
   if (device_update_flags & DEVICE_MESH_DATA_MODIFIED) {
     /* if anything else than vertices or shaders are modified, we would need to reallocate, so
@@ -2107,6 +2213,31 @@ void GeometryManager::collect_statistics(const Scene *scene, RenderStats *stats)
     stats->mesh.geometry.add_entry(
         NamedSizeEntry(string(geometry->name.c_str()), geometry->get_total_size_in_bytes()));
   }
+
+  const DeviceScene *dscene = &scene->dscene;
+  stats->bvh.memory.add_entry(NamedSizeEntry("Inner nodes", dscene->bvh_nodes.memory_size()));
+  stats->bvh.memory.add_entry(NamedSizeEntry("Leaf nodes", dscene->bvh_leaf_nodes.memory_size()));
+  stats->bvh.memory.add_entry(
+      NamedSizeEntry("Triangle vertices", dscene->prim_tri_verts.memory_size()));
+  stats->bvh.memory.add_entry(NamedSizeEntry("Primitive indices",
+                                             dscene->prim_tri_index.memory_size() +
+                                                 dscene->prim_type.memory_size() +
+                                                 dscene->prim_visibility.memory_size() +
+                                                 dscene->prim_index.memory_size() +
+                                                 dscene->prim_object.memory_size()));
+
+  if (scene->bvh && scene->bvh->params.bvh_layout == BVH_LAYOUT_BVH2) {
+    const BVH2 *bvh = static_cast<const BVH2 *>(scene->bvh);
+    stats->bvh.num_aligned_nodes = bvh->num_aligned_nodes;
+    stats->bvh.num_unaligned_nodes = bvh->num_unaligned_nodes;
+    stats->bvh.num_quantized_nodes = bvh->num_quantized_nodes;
+    const size_t quantized_node_size = (bvh->params.num_quantized_node_bits == 16) ?
+                                           BVH_QUANTIZED_NODE_SIZE_16 :
+                                           BVH_QUANTIZED_NODE_SIZE_8;
+    stats->bvh.quantized_saved_size = bvh->num_quantized_nodes *
+                                      (BVH_NODE_SIZE - quantized_node_size) * sizeof(int4);
+    stats->bvh.build_time = bvh->build_time;
+  }
 }
 
 CCL_NAMESPACE_END
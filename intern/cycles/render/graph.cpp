@@ -367,6 +367,10 @@ void ShaderGraph::simplify(Scene *scene)
     clean(scene);
     refine_bump_nodes();
 
+    if (!scene->shader_manager->use_osl() && scene->image_manager->use_texture_cache(scene)) {
+      refine_image_derivatives();
+    }
+
     simplified = true;
   }
 }
@@ -743,27 +747,18 @@ void ShaderGraph::break_cycles(ShaderNode *node, vector<bool> &visited, vector<b
   on_stack[node->id] = false;
 }
 
-void ShaderGraph::compute_displacement_hash()
+string ShaderGraph::compute_hash(ShaderInput *input)
 {
-  /* Compute hash of all nodes linked to displacement, to detect if we need
-   * to recompute displacement when shader nodes change. */
-  ShaderInput *displacement_in = output()->input("Displacement");
-
-  if (!displacement_in->link) {
-    displacement_hash = "";
-    return;
-  }
-
-  ShaderNodeSet nodes_displace;
-  find_dependencies(nodes_displace, displacement_in);
+  ShaderNodeSet dependencies;
+  find_dependencies(dependencies, input);
 
   MD5Hash md5;
-  foreach (ShaderNode *node, nodes_displace) {
+  foreach (ShaderNode *node, dependencies) {
     node->hash(md5);
-    foreach (ShaderInput *input, node->inputs) {
-      int link_id = (input->link) ? input->link->parent->id : 0;
+    foreach (ShaderInput *node_input, node->inputs) {
+      int link_id = (node_input->link) ? node_input->link->parent->id : 0;
       md5.append((uint8_t *)&link_id, sizeof(link_id));
-      md5.append((input->link) ? input->link->name().c_str() : "");
+      md5.append((node_input->link) ? node_input->link->name().c_str() : "");
     }
 
     if (node->special_type == SHADER_SPECIAL_TYPE_OSL) {
@@ -772,9 +767,31 @@ void ShaderGraph::compute_displacement_hash()
       OSLNode *oslnode = static_cast<OSLNode *>(node);
       md5.append(oslnode->bytecode_hash);
     }
+    else if (node->special_type == SHADER_SPECIAL_TYPE_IMAGE_SLOT) {
+      /* Same image file may be loaded into a different slot, with different pixels. */
+      ImageSlotTextureNode *image_node = static_cast<ImageSlotTextureNode *>(node);
+      for (int i = 0; i < image_node->handle.num_tiles(); i++) {
+        const int slot = image_node->handle.svm_slot(i);
+        md5.append((uint8_t *)&slot, sizeof(slot));
+      }
+    }
   }
 
-  displacement_hash = md5.get_hex();
+  return md5.get_hex();
+}
+
+void ShaderGraph::compute_displacement_hash()
+{
+  /* Compute hash of all nodes linked to displacement, to detect if we need
+   * to recompute displacement when shader nodes change. */
+  ShaderInput *displacement_in = output()->input("Displacement");
+
+  if (!displacement_in->link) {
+    displacement_hash = "";
+    return;
+  }
+
+  displacement_hash = compute_hash(displacement_in);
 }
 
 void ShaderGraph::clean(Scene *scene)
@@ -967,6 +984,49 @@ void ShaderGraph::refine_bump_nodes()
   }
 }
 
+void ShaderGraph::refine_image_derivatives()
+{
+  /* Images in the texture cache are sampled at the resolution matching the ray footprint. To
+   * find it, we copy the sub-graph defined by the vector input of image textures twice, like
+   * refine_bump_nodes() does, so it is evaluated at positions shifted by the ray differentials.
+   * The image node then uses the difference to the center as texture coordinate derivatives. */
+
+  foreach (ShaderNode *node, nodes) {
+    if (node->type != ImageTextureNode::node_type || node->bump != SHADER_BUMP_NONE) {
+      continue;
+    }
+
+    ImageTextureNode *image_node = static_cast<ImageTextureNode *>(node);
+    ShaderInput *vector_input = node->input("Vector");
+    if (image_node->get_projection() == NODE_IMAGE_PROJ_BOX || !vector_input->link) {
+      continue;
+    }
+
+    ShaderNodeSet nodes_vector;
+    ShaderNodeMap nodes_dx;
+    ShaderNodeMap nodes_dy;
+
+    find_dependencies(nodes_vector, vector_input);
+
+    copy_nodes(nodes_vector, nodes_dx);
+    copy_nodes(nodes_vector, nodes_dy);
+
+    foreach (NodePair &pair, nodes_dx)
+      pair.second->bump = SHADER_BUMP_DX;
+    foreach (NodePair &pair, nodes_dy)
+      pair.second->bump = SHADER_BUMP_DY;
+
+    ShaderOutput *out = vector_input->link;
+    connect(nodes_dx[out->parent]->output(out->name()), node->input("VectorDx"));
+    connect(nodes_dy[out->parent]->output(out->name()), node->input("VectorDy"));
+
+    foreach (NodePair &pair, nodes_dx)
+      add(pair.second);
+    foreach (NodePair &pair, nodes_dy)
+      add(pair.second);
+  }
+}
+
 void ShaderGraph::bump_from_displacement(bool use_object_space)
 {
   /* generate bump mapping automatically from displacement. bump mapping is
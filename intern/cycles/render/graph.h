@@ -334,6 +334,8 @@ class ShaderGraph : public NodeOwner {
   void relink(ShaderNode *node, ShaderOutput *from, ShaderOutput *to);
 
   void remove_proxy_nodes();
+  /* Hash of all nodes the input depends on, to detect changes in that part of the graph. */
+  string compute_hash(ShaderInput *input);
   void compute_displacement_hash();
   void simplify(Scene *scene);
   void finalize(Scene *scene,
@@ -373,6 +375,7 @@ class ShaderGraph : public NodeOwner {
   void break_cycles(ShaderNode *node, vector<bool> &visited, vector<bool> &on_stack);
   void bump_from_displacement(bool use_object_space);
   void refine_bump_nodes();
+  void refine_image_derivatives();
   void expand();
   void default_inputs(bool do_osl, bool spectral_rendering);
   void transform_multi_closure(ShaderNode *node, ShaderOutput *weight_out, bool volume);
@@ -21,7 +21,9 @@
 #include "render/image_vdb.h"
 #include "render/scene.h"
 #include "render/stats.h"
+#include "render/texture_cache_oiio.h"
 
+#include "util/util_atomic.h"
 #include "util/util_foreach.h"
 #include "util/util_image.h"
 #include "util/util_image_impl.h"
@@ -167,6 +169,16 @@ int ImageHandle::svm_slot(const int tile_index) const
   return tile_slots[tile_index];
 }
 
+uint64_t ImageHandle::load_stamp(const int tile_index) const
+{
+  if (tile_index >= tile_slots.size()) {
+    return 0;
+  }
+
+  ImageManager::Image *img = manager->images[tile_slots[tile_index]];
+  return img ? img->load_stamp : 0;
+}
+
 device_texture *ImageHandle::image_memory(const int tile_index) const
 {
   if (tile_index >= tile_slots.size()) {
@@ -301,9 +313,13 @@ ImageManager::ImageManager(const DeviceInfo &info)
   need_update_ = true;
   osl_texture_system = NULL;
   animation_frame = 0;
+  load_counter = 0;
 
   /* Set image limits */
   has_half_images = info.has_half_images;
+
+  /* Texture cache lookups are only implemented in CPU kernels. */
+  has_texture_cache = (info.type == DEVICE_CPU);
 }
 
 ImageManager::~ImageManager()
@@ -446,8 +462,10 @@ int ImageManager::add_image_slot(ImageLoader *loader,
   img->need_metadata = true;
   img->need_load = !(osl_texture_system && !img->loader->osl_filepath().empty());
   img->builtin = builtin;
+  img->load_stamp = 0;
   img->users = 1;
   img->mem = NULL;
+  img->cache_image = NULL;
 
   images[slot] = img;
 
@@ -653,6 +671,7 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
   }
 
   Image *img = images[slot];
+  img->load_stamp = atomic_add_and_fetch_uint64(&load_counter, 1);
 
   progress->set_status("Updating Images", "Loading " + img->loader->name());
 
@@ -670,14 +689,35 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
     delete img->mem;
     img->mem = NULL;
   }
+  device_free_cache_image(img);
+
+  if (use_texture_cache(scene)) {
+    {
+      thread_scoped_lock device_lock(device_mutex);
+      if (!texture_cache) {
+        texture_cache.reset(
+            new OIIOTextureCache((size_t)scene->params.texture_cache_size * 1024 * 1024));
+      }
+    }
+
+    img->cache_image = texture_cache->add_image(
+        img->loader->osl_filepath(), img->params, img->metadata, image_associate_alpha(img));
+  }
 
   img->mem = new device_texture(
       device, img->mem_name.c_str(), slot, type, img->params.interpolation, img->params.extension);
   img->mem->info.use_transform_3d = img->metadata.use_transform_3d;
   img->mem->info.transform_3d = img->metadata.transform_3d;
+  img->mem->info.cache_image = (uint64_t)img->cache_image;
 
   /* Create new texture. */
-  if (type == IMAGE_DATA_TYPE_FLOAT4) {
+  if (img->cache_image) {
+    /* Pixels are paged in by the texture cache, only allocate a single placeholder pixel. */
+    thread_scoped_lock device_lock(device_mutex);
+    void *pixels = img->mem->alloc(1, 1);
+    memset(pixels, 0, img->mem->memory_size());
+  }
+  else if (type == IMAGE_DATA_TYPE_FLOAT4) {
     if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
@@ -802,12 +842,22 @@ void ImageManager::device_free_image(Device *, int slot)
     thread_scoped_lock device_lock(device_mutex);
     delete img->mem;
   }
+  device_free_cache_image(img);
 
   delete img->loader;
   delete img;
   images[slot] = NULL;
 }
 
+void ImageManager::device_free_cache_image(Image *img)
+{
+  if (img->cache_image) {
+    thread_scoped_lock device_lock(device_mutex);
+    texture_cache->remove_image(img->cache_image);
+    img->cache_image = NULL;
+  }
+}
+
 void ImageManager::device_update(Device *device, Scene *scene, Progress &progress)
 {
   if (!need_update()) {
@@ -886,6 +936,7 @@ void ImageManager::device_free(Device *device)
     device_free_image(device, slot);
   }
   images.clear();
+  texture_cache.reset();
 }
 
 void ImageManager::collect_statistics(RenderStats *stats)
@@ -894,6 +945,10 @@ void ImageManager::collect_statistics(RenderStats *stats)
     stats->image.textures.add_entry(
         NamedSizeEntry(image->loader->name(), image->mem->memory_size()));
   }
+
+  if (texture_cache) {
+    texture_cache->collect_statistics(&stats->image);
+  }
 }
 
 void ImageManager::tag_update()
@@ -906,4 +961,9 @@ bool ImageManager::need_update() const
   return need_update_;
 }
 
+bool ImageManager::use_texture_cache(const Scene *scene) const
+{
+  return has_texture_cache && scene->params.texture_cache_size > 0;
+}
+
 CCL_NAMESPACE_END
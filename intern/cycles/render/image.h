@@ -39,6 +39,8 @@ class Progress;
 class RenderStats;
 class Scene;
 class ColorSpaceProcessor;
+class TextureCache;
+class TextureCacheImage;
 class VDBImageLoader;
 
 /* Image Parameters */
@@ -116,7 +118,7 @@ class ImageLoader {
   /* Name for logs and stats. */
   virtual string name() const = 0;
 
-  /* Optional for OSL texture cache. */
+  /* Optional for OSL texture cache and the SVM texture cache. */
   virtual ustring osl_filepath() const;
 
   /* Free any memory used for loading metadata and pixels. */
@@ -152,6 +154,7 @@ class ImageHandle {
   ImageMetaData metadata();
   int svm_slot(const int tile_index = 0) const;
   device_texture *image_memory(const int tile_index = 0) const;
+  uint64_t load_stamp(const int tile_index = 0) const;
 
   VDBImageLoader *vdb_loader(const int tile_index = 0) const;
 
@@ -193,6 +196,9 @@ class ImageManager {
 
   bool need_update() const;
 
+  /* Page in tiled and mip-mapped image files on demand instead of loading them fully. */
+  bool use_texture_cache(const Scene *scene) const;
+
   struct Image {
     ImageParams params;
     ImageMetaData metadata;
@@ -202,9 +208,12 @@ class ImageManager {
     bool need_metadata;
     bool need_load;
     bool builtin;
+    /* Changes every time the image is loaded into the slot. */
+    uint64_t load_stamp;
 
     string mem_name;
     device_texture *mem;
+    TextureCacheImage *cache_image;
 
     int users;
     thread_mutex mutex;
@@ -213,13 +222,16 @@ class ImageManager {
  private:
   bool need_update_;
   bool has_half_images;
+  bool has_texture_cache;
 
   thread_mutex device_mutex;
   thread_mutex images_mutex;
   int animation_frame;
+  uint64_t load_counter;
 
   vector<Image *> images;
   void *osl_texture_system;
+  unique_ptr<TextureCache> texture_cache;
 
   int add_image_slot(ImageLoader *loader, const ImageParams &params, const bool builtin);
   void add_image_user(int slot);
@@ -232,6 +244,7 @@ class ImageManager {
 
   void device_load_image(Device *device, Scene *scene, int slot, Progress *progress);
   void device_free_image(Device *device, int slot);
+  void device_free_cache_image(Image *img);
 
   friend class ImageHandle;
 };
@@ -49,15 +49,19 @@ static void shade_background_pixels(Device *device,
 
   uint4 *d_input_data = d_input.alloc(width * height);
 
-  for (int y = 0; y < height; y++) {
-    for (int x = 0; x < width; x++) {
-      float u = (x + 0.5f) / width;
-      float v = (y + 0.5f) / height;
-
-      uint4 in = make_uint4(__float_as_int(u), __float_as_int(v), 0, 0);
-      d_input_data[x + y * width] = in;
-    }
-  }
+  const int rows_per_task = divide_up(10240, width);
+  parallel_for(blocked_range<size_t>(0, height, rows_per_task),
+               [&](const blocked_range<size_t> &r) {
+                 for (int y = r.begin(); y < (int)r.end(); y++) {
+                   for (int x = 0; x < width; x++) {
+                     float u = (x + 0.5f) / width;
+                     float v = (y + 0.5f) / height;
+
+                     uint4 in = make_uint4(__float_as_int(u), __float_as_int(v), 0, 0);
+                     d_input_data[x + y * width] = in;
+                   }
+                 }
+               });
 
   /* compute on device */
   d_output.alloc(width * height);
@@ -91,13 +95,16 @@ static void shade_background_pixels(Device *device,
 
   pixels.resize(width * height);
 
-  for (int y = 0; y < height; y++) {
-    for (int x = 0; x < width; x++) {
-      pixels[y * width + x].x = d_output_data[y * width + x].x;
-      pixels[y * width + x].y = d_output_data[y * width + x].y;
-      pixels[y * width + x].z = d_output_data[y * width + x].z;
-    }
-  }
+  parallel_for(blocked_range<size_t>(0, height, rows_per_task),
+               [&](const blocked_range<size_t> &r) {
+                 for (int y = r.begin(); y < (int)r.end(); y++) {
+                   for (int x = 0; x < width; x++) {
+                     pixels[y * width + x].x = d_output_data[y * width + x].x;
+                     pixels[y * width + x].y = d_output_data[y * width + x].y;
+                     pixels[y * width + x].z = d_output_data[y * width + x].z;
+                   }
+                 }
+               });
 
   d_output.free();
 }
@@ -282,6 +289,98 @@ bool LightManager::object_usable_as_light(Object *object)
   return false;
 }
 
+string LightManager::background_hash(Scene *scene)
+{
+  Shader *shader = scene->background->get_shader(scene);
+  string hash = shader->graph->compute_hash(shader->graph->output()->input("Surface"));
+
+  /* Reloading an image doesn't change the nodes, so include when the images were loaded. */
+  foreach (ShaderNode *node, shader->graph->nodes) {
+    if (node->special_type == SHADER_SPECIAL_TYPE_IMAGE_SLOT) {
+      ImageHandle &handle = static_cast<ImageSlotTextureNode *>(node)->handle;
+      for (int i = 0; i < handle.num_tiles(); i++) {
+        hash += string_printf(" %llu", (unsigned long long)handle.load_stamp(i));
+      }
+    }
+  }
+
+  return hash;
+}
+
+void LightManager::compute_object_distribution(Scene *scene,
+                                               Object *object,
+                                               ObjectLightDistribution &distribution)
+{
+  Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
+  bool transform_applied = mesh->transform_applied;
+  Transform tfm = object->get_tfm();
+  float totarea = 0.0f;
+
+  distribution.triangles.clear();
+  distribution.areas.clear();
+
+  size_t mesh_num_triangles = mesh->num_triangles();
+  for (size_t i = 0; i < mesh_num_triangles; i++) {
+    int shader_index = mesh->get_shader()[i];
+    Shader *shader = (shader_index < mesh->get_used_shaders().size()) ?
+                         static_cast<Shader *>(mesh->get_used_shaders()[shader_index]) :
+                         scene->default_surface;
+
+    if (shader->get_use_mis() && shader->has_surface_emission) {
+      distribution.triangles.push_back(i);
+      distribution.areas.push_back(totarea);
+
+      Mesh::Triangle t = mesh->get_triangle(i);
+      if (!t.valid(&mesh->get_verts()[0])) {
+        continue;
+      }
+      float3 p1 = mesh->get_verts()[t.v[0]];
+      float3 p2 = mesh->get_verts()[t.v[1]];
+      float3 p3 = mesh->get_verts()[t.v[2]];
+
+      if (!transform_applied) {
+        p1 = transform_point(&tfm, p1);
+        p2 = transform_point(&tfm, p2);
+        p3 = transform_point(&tfm, p3);
+      }
+
+      totarea += triangle_area(p1, p2, p3);
+    }
+  }
+
+  distribution.total_area = totarea;
+}
+
+void LightManager::device_update_preprocess(Scene *scene)
+{
+  /* Emissive triangles and their areas change with the object transform and visibility, and the
+   * geometry. Shader changes invalidate everything, as they can change which triangles emit. */
+  if (update_flags & (SHADER_COMPILED | SHADER_MODIFIED)) {
+    object_distributions.clear();
+    return;
+  }
+
+  if (object_distributions.empty()) {
+    return;
+  }
+
+  /* Only keep objects that still exist, a new object may reuse the address of a removed one. */
+  unordered_map<const Object *, ObjectLightDistribution> distributions;
+
+  foreach (Object *object, scene->objects) {
+    if (object->is_modified() || object->get_geometry()->is_modified()) {
+      continue;
+    }
+
+    auto it = object_distributions.find(object);
+    if (it != object_distributions.end()) {
+      distributions[object] = std::move(it->second);
+    }
+  }
+
+  object_distributions.swap(distributions);
+}
+
 void LightManager::device_update_distribution(Device *,
                                               DeviceScene *dscene,
                                               Scene *scene,
@@ -306,26 +405,52 @@ void LightManager::device_update_distribution(Device *,
     }
   }
 
-  foreach (Object *object, scene->objects) {
-    if (progress.get_cancel())
-      return;
+  /* Compute emissive triangles of objects that were modified, reusing the ones of all other
+   * objects. Each object is handled independently, so this is done in parallel. */
+  vector<ObjectLightDistribution *> object_distribution(scene->objects.size(), NULL);
+  vector<pair<Object *, ObjectLightDistribution *>> modified_objects;
+
+  for (size_t i = 0; i < scene->objects.size(); i++) {
+    Object *object = scene->objects[i];
 
     if (!object_usable_as_light(object)) {
       continue;
     }
 
-    /* Count triangles. */
-    Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
-    size_t mesh_num_triangles = mesh->num_triangles();
-    for (size_t i = 0; i < mesh_num_triangles; i++) {
-      int shader_index = mesh->get_shader()[i];
-      Shader *shader = (shader_index < mesh->get_used_shaders().size()) ?
-                           static_cast<Shader *>(mesh->get_used_shaders()[shader_index]) :
-                           scene->default_surface;
-
-      if (shader->get_use_mis() && shader->has_surface_emission) {
-        num_triangles++;
-      }
+    auto it = object_distributions.find(object);
+    if (it == object_distributions.end()) {
+      it = object_distributions.insert(std::make_pair(object, ObjectLightDistribution())).first;
+      modified_objects.push_back(std::make_pair(object, &it->second));
+    }
+
+    object_distribution[i] = &it->second;
+  }
+
+  VLOG(1) << "Computing light distribution of " << modified_objects.size() << " modified objects.";
+
+  parallel_for(blocked_range<size_t>(0, modified_objects.size(), 1),
+               [&](const blocked_range<size_t> &r) {
+                 for (size_t i = r.begin(); i != r.end(); i++) {
+                   if (progress.get_cancel()) {
+                     return;
+                   }
+
+                   compute_object_distribution(
+                       scene, modified_objects[i].first, *modified_objects[i].second);
+                 }
+               });
+
+  if (progress.get_cancel()) {
+    /* Don't keep partially computed objects. */
+    for (size_t i = 0; i < modified_objects.size(); i++) {
+      object_distributions.erase(modified_objects[i].first);
+    }
+    return;
+  }
+
+  foreach (ObjectLightDistribution *distribution, object_distribution) {
+    if (distribution) {
+      num_triangles += distribution->triangles.size();
     }
   }
 
@@ -338,20 +463,15 @@ void LightManager::device_update_distribution(Device *,
 
   /* triangles */
   size_t offset = 0;
-  int j = 0;
 
-  foreach (Object *object, scene->objects) {
-    if (progress.get_cancel())
-      return;
-
-    if (!object_usable_as_light(object)) {
-      j++;
+  for (size_t j = 0; j < scene->objects.size(); j++) {
+    const ObjectLightDistribution *object_light = object_distribution[j];
+    if (object_light == NULL) {
       continue;
     }
-    /* Sum area. */
+
+    Object *object = scene->objects[j];
     Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
-    bool transform_applied = mesh->transform_applied;
-    Transform tfm = object->get_tfm();
     int object_id = j;
     int shader_flag = 0;
 
@@ -372,39 +492,16 @@ void LightManager::device_update_distribution(Device *,
       use_light_visibility = true;
     }
 
-    size_t mesh_num_triangles = mesh->num_triangles();
-    for (size_t i = 0; i < mesh_num_triangles; i++) {
-      int shader_index = mesh->get_shader()[i];
-      Shader *shader = (shader_index < mesh->get_used_shaders().size()) ?
-                           static_cast<Shader *>(mesh->get_used_shaders()[shader_index]) :
-                           scene->default_surface;
-
-      if (shader->get_use_mis() && shader->has_surface_emission) {
-        distribution[offset].totarea = totarea;
-        distribution[offset].prim = i + mesh->prim_offset;
-        distribution[offset].mesh_light.shader_flag = shader_flag;
-        distribution[offset].mesh_light.object_id = object_id;
-        offset++;
-
-        Mesh::Triangle t = mesh->get_triangle(i);
-        if (!t.valid(&mesh->get_verts()[0])) {
-          continue;
-        }
-        float3 p1 = mesh->get_verts()[t.v[0]];
-        float3 p2 = mesh->get_verts()[t.v[1]];
-        float3 p3 = mesh->get_verts()[t.v[2]];
-
-        if (!transform_applied) {
-          p1 = transform_point(&tfm, p1);
-          p2 = transform_point(&tfm, p2);
-          p3 = transform_point(&tfm, p3);
-        }
-
-        totarea += triangle_area(p1, p2, p3);
-      }
+    const size_t object_num_triangles = object_light->triangles.size();
+    for (size_t i = 0; i < object_num_triangles; i++) {
+      distribution[offset].totarea = totarea + object_light->areas[i];
+      distribution[offset].prim = object_light->triangles[i] + mesh->prim_offset;
+      distribution[offset].mesh_light.shader_flag = shader_flag;
+      distribution[offset].mesh_light.object_id = object_id;
+      offset++;
     }
 
-    j++;
+    totarea += object_light->total_area;
   }
 
   float trianglearea = totarea;
@@ -578,7 +675,8 @@ static void background_cdf(
 void LightManager::device_update_background(Device *device,
                                             DeviceScene *dscene,
                                             Scene *scene,
-                                            Progress &progress)
+                                            Progress &progress,
+                                            const bool update_map)
 {
   KernelBackground *kbackground = &dscene->data.background;
   Light *background_light = NULL;
@@ -601,8 +699,6 @@ void LightManager::device_update_background(Device *device,
     return;
   }
 
-  progress.set_status("Updating Lights", "Importance map");
-
   assert(dscene->data.integrator.use_direct_light);
 
   int2 environment_res = make_int2(0, 0);
@@ -720,6 +816,13 @@ void LightManager::device_update_background(Device *device,
   kbackground->map_res_x = res.x;
   kbackground->map_res_y = res.y;
 
+  /* The importance map is kept when the nodes it is computed from did not change. */
+  if (!update_map) {
+    return;
+  }
+
+  progress.set_status("Updating Lights", "Importance map");
+
   vector<float3> pixels;
   shade_background_pixels(device, dscene, res.x, res.y, pixels, progress);
 
@@ -1015,6 +1118,17 @@ void LightManager::device_update(Device *device,
 
   VLOG(1) << "Total " << scene->lights.size() << " lights.";
 
+  /* The world shader gets tagged for any change to the world, skip rebuilding the importance map
+   * when the nodes it is computed from did not change. The background kernel data is still
+   * updated, since the light points and distribution reset parts of it. */
+  if (need_update_background) {
+    const string hash = background_hash(scene);
+    if (hash == last_background_hash && dscene->light_background_conditional_cdf.size() != 0) {
+      need_update_background = false;
+    }
+    last_background_hash = hash;
+  }
+
   /* Detect which lights are enabled, also determines if we need to update the background. */
   test_enabled_lights(scene);
 
@@ -1030,11 +1144,9 @@ void LightManager::device_update(Device *device,
   if (progress.get_cancel())
     return;
 
-  if (need_update_background) {
-    device_update_background(device, dscene, scene, progress);
-    if (progress.get_cancel())
-      return;
-  }
+  device_update_background(device, dscene, scene, progress, need_update_background);
+  if (progress.get_cancel())
+    return;
 
   device_update_ies(dscene);
   if (progress.get_cancel())
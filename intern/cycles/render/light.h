@@ -26,6 +26,7 @@
 #include "render/shader.h"
 
 #include "util/util_ies.h"
+#include "util/util_map.h"
 #include "util/util_thread.h"
 #include "util/util_types.h"
 #include "util/util_vector.h"
@@ -120,6 +121,9 @@ class LightManager {
   int add_ies_from_file(const string &filename);
   void remove_ies(int slot);
 
+  /* Invalidate cached emissive triangles of modified objects, must be called while the objects and
+   * geometry still have their modified tags. */
+  void device_update_preprocess(Scene *scene);
   void device_update(Device *device, DeviceScene *dscene, Scene *scene, Progress &progress);
   void device_free(Device *device, DeviceScene *dscene, const bool free_background = true);
 
@@ -145,12 +149,32 @@ class LightManager {
   void device_update_background(Device *device,
                                 DeviceScene *dscene,
                                 Scene *scene,
-                                Progress &progress);
+                                Progress &progress,
+                                const bool update_map);
   void device_update_ies(DeviceScene *dscene);
 
   /* Check whether light manager can use the object as a light-emissive. */
   bool object_usable_as_light(Object *object);
 
+  /* Hash of the background shader nodes the importance map is computed from. */
+  string background_hash(Scene *scene);
+
+  /* Emissive triangles of an object, reused for the light distribution as long as the object and
+   * its geometry are not modified. */
+  struct ObjectLightDistribution {
+    /* Triangle indices local to the geometry. */
+    vector<uint> triangles;
+    /* Area of the emissive triangles of the object before each triangle. */
+    vector<float> areas;
+    float total_area;
+  };
+
+  void compute_object_distribution(Scene *scene,
+                                   Object *object,
+                                   ObjectLightDistribution &distribution);
+
+  unordered_map<const Object *, ObjectLightDistribution> object_distributions;
+
   struct IESSlot {
     IESFile ies;
     uint hash;
@@ -162,6 +186,7 @@ class LightManager {
 
   bool last_background_enabled;
   int last_background_resolution;
+  string last_background_hash;
 
   uint32_t update_flags;
 };
@@ -251,6 +251,9 @@ NODE_DEFINE(ImageTextureNode)
   SOCKET_BOOLEAN(animated, "Animated", false);
 
   SOCKET_IN_POINT(vector, "Vector", zero_float3(), SocketType::LINK_TEXTURE_UV);
+  /* Vector offset along the ray differentials, for texture cache lookups. */
+  SOCKET_IN_POINT(vector_dx, "VectorDx", zero_float3(), SocketType::SVM_INTERNAL);
+  SOCKET_IN_POINT(vector_dy, "VectorDy", zero_float3(), SocketType::SVM_INTERNAL);
 
   SOCKET_OUT_COLOR(color, "Color");
   SOCKET_OUT_FLOAT(alpha, "Alpha");
@@ -393,6 +396,19 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
     }
   }
 
+  /* Derivatives of the texture coordinate, only linked when using the texture cache. */
+  ShaderInput *vector_dx_in = input("VectorDx");
+  ShaderInput *vector_dy_in = input("VectorDy");
+  const bool use_derivatives = vector_dx_in->link && vector_dy_in->link &&
+                               projection != NODE_IMAGE_PROJ_BOX;
+  int vector_dx_offset = SVM_STACK_INVALID, vector_dy_offset = SVM_STACK_INVALID;
+
+  if (use_derivatives) {
+    vector_dx_offset = tex_mapping.compile_begin(compiler, vector_dx_in);
+    vector_dy_offset = tex_mapping.compile_begin(compiler, vector_dy_in);
+    flags |= NODE_IMAGE_DERIVATIVES;
+  }
+
   if (projection != NODE_IMAGE_PROJ_BOX) {
     /* If there only is one image (a very common case), we encode it as a negative value. */
     int num_nodes;
@@ -411,6 +427,10 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
                                              flags),
                       projection);
 
+    if (use_derivatives) {
+      compiler.add_node(vector_dx_offset, vector_dy_offset);
+    }
+
     if (num_nodes > 0) {
       for (int i = 0; i < num_nodes; i++) {
         int4 node;
@@ -440,6 +460,10 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
   }
 
   tex_mapping.compile_end(compiler, vector_in, vector_offset);
+  if (use_derivatives) {
+    tex_mapping.compile_end(compiler, vector_dx_in, vector_dx_offset);
+    tex_mapping.compile_end(compiler, vector_dy_in, vector_dy_offset);
+  }
 }
 
 void ImageTextureNode::compile(OSLCompiler &compiler)
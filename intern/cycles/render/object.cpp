@@ -58,6 +58,10 @@ struct UpdateObjectTransformState {
   /* Motion offsets for each object. */
   array<uint> motion_offset;
 
+  /* Motion offsets of some objects differ from the previous update, so all decomposed
+   * transforms are written again. */
+  bool motion_offset_modified;
+
   /* Packed object arrays. Those will be filled in. */
   uint *object_flag;
   KernelObject *objects;
@@ -481,7 +485,7 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
       kobject.motion_offset = state->motion_offset[ob->index];
 
       /* Decompose transforms for interpolation. */
-      if (ob->tfm_is_modified() || update_all) {
+      if (ob->tfm_is_modified() || update_all || state->motion_offset_modified) {
         DecomposedTransform *decomp = state->object_motion + kobject.motion_offset;
         transform_motion_decompose(decomp, ob->motion.data(), ob->motion.size());
       }
@@ -506,8 +510,13 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
                       geom->geometry_type == Geometry::VOLUME) ?
                          static_cast<Mesh *>(geom)->get_verts().size() :
                          0;
-  kobject.patch_map_offset = 0;
-  kobject.attribute_map_offset = 0;
+
+  /* Offsets are filled in by device_update_mesh_offsets(), keep the existing values so only the
+   * objects for which they change get copied to the device again. */
+  if (update_all) {
+    kobject.patch_map_offset = 0;
+    kobject.attribute_map_offset = 0;
+  }
 
   if (ob->asset_name_is_modified() || update_all) {
     uint32_t hash_name = util_murmur_hash3(ob->name.c_str(), ob->name.length(), 0);
@@ -545,6 +554,10 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
   state.object_volume_step = dscene->object_volume_step.alloc(scene->objects.size());
   state.object_motion = NULL;
   state.object_motion_pass = NULL;
+  state.motion_offset_modified = false;
+
+  /* as all the arrays are the same size, checking only dscene.objects is sufficient */
+  const bool update_all = dscene->objects.need_realloc();
 
   if (state.need_motion == Scene::MOTION_PASS) {
     state.object_motion_pass = dscene->object_motion_pass.alloc(OBJECT_MOTION_PASS_SIZE *
@@ -561,10 +574,27 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
 
       /* Clear motion array if there is no actual motion. */
       ob->update_motion();
+
+      /* Offsets are a prefix sum over all objects, so a change in one object shifts the offsets
+       * of all objects after it, including ones that were not modified themselves. */
+      const uint kernel_motion_offset = (ob->use_motion()) ? motion_offset : 0;
+      if (!update_all && state.objects[ob->index].motion_offset != kernel_motion_offset) {
+        state.motion_offset_modified = true;
+      }
+
       motion_offset += ob->motion.size();
     }
 
+    if (dscene->object_motion.size() != motion_offset) {
+      state.motion_offset_modified = true;
+    }
+
     state.object_motion = dscene->object_motion.alloc(motion_offset);
+
+    if (state.motion_offset_modified) {
+      dscene->objects.tag_modified();
+      dscene->object_motion.tag_modified();
+    }
   }
 
   /* Particle system device offsets
@@ -576,9 +606,6 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
     numparticles += psys->particles.size();
   }
 
-  /* as all the arrays are the same size, checking only dscene.objects is sufficient */
-  const bool update_all = dscene->objects.need_realloc();
-
   /* Parallel object update, with grain size to avoid too much threading overhead
    * for individual objects. */
   static const int OBJECTS_PER_TASK = 32;
@@ -596,7 +623,7 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
 
   dscene->objects.copy_to_device_if_modified();
   if (state.need_motion == Scene::MOTION_PASS) {
-    dscene->object_motion_pass.copy_to_device();
+    dscene->object_motion_pass.copy_to_device_if_modified();
   }
   else if (state.need_motion == Scene::MOTION_BLUR) {
     dscene->object_motion.copy_to_device();
@@ -651,13 +678,18 @@ void ObjectManager::device_update(Device *device,
 
     int index = 0;
     foreach (Object *object, scene->objects) {
+      const bool index_modified = (object->index != index);
       object->index = index++;
 
       /* this is a bit too broad, however a bigger refactor might be needed to properly separate
        * update each type of data (transform, flags, etc.) */
-      if (object->is_modified()) {
-        dscene->objects.tag_modified();
-        dscene->object_motion_pass.tag_modified();
+      if (object->is_modified() || object->geometry->is_modified() || index_modified) {
+        /* Only the data of this object is copied to the device again, unless the arrays get
+         * reallocated. Motion offsets depend on all objects, device_update_transforms() tags the
+         * entire objects array when they shift. */
+        dscene->objects.tag_modified(object->index, 1);
+        dscene->object_motion_pass.tag_modified(object->index * OBJECT_MOTION_PASS_SIZE,
+                                                OBJECT_MOTION_PASS_SIZE);
         dscene->object_motion.tag_modified();
         dscene->object_flag.tag_modified();
         dscene->object_volume_step.tag_modified();
@@ -795,22 +827,16 @@ void ObjectManager::device_update_mesh_offsets(Device *, DeviceScene *dscene, Sc
 
   KernelObject *kobjects = dscene->objects.data();
 
-  bool update = false;
-
   foreach (Object *object, scene->objects) {
     Geometry *geom = object->geometry;
+    uint patch_map_offset = 0;
 
     if (geom->geometry_type == Geometry::MESH) {
       Mesh *mesh = static_cast<Mesh *>(geom);
       if (mesh->patch_table) {
-        uint patch_map_offset = 2 * (mesh->patch_table_offset + mesh->patch_table->total_size() -
-                                     mesh->patch_table->num_nodes * PATCH_NODE_SIZE) -
-                                mesh->patch_offset;
-
-        if (kobjects[object->index].patch_map_offset != patch_map_offset) {
-          kobjects[object->index].patch_map_offset = patch_map_offset;
-          update = true;
-        }
+        patch_map_offset = 2 * (mesh->patch_table_offset + mesh->patch_table->total_size() -
+                                mesh->patch_table->num_nodes * PATCH_NODE_SIZE) -
+                           mesh->patch_offset;
       }
     }
 
@@ -821,15 +847,18 @@ void ObjectManager::device_update_mesh_offsets(Device *, DeviceScene *dscene, Sc
       attr_map_offset = geom->attr_map_offset;
     }
 
-    if (kobjects[object->index].attribute_map_offset != attr_map_offset) {
-      kobjects[object->index].attribute_map_offset = attr_map_offset;
-      update = true;
+    KernelObject &kobject = kobjects[object->index];
+
+    if (kobject.patch_map_offset != patch_map_offset ||
+        kobject.attribute_map_offset != attr_map_offset) {
+      kobject.patch_map_offset = patch_map_offset;
+      kobject.attribute_map_offset = attr_map_offset;
+      dscene->objects.tag_modified(object->index, 1);
     }
   }
 
-  if (update) {
-    dscene->objects.copy_to_device();
-  }
+  dscene->objects.copy_to_device_if_modified();
+  dscene->objects.clear_modified();
 }
 
 void ObjectManager::device_free(Device *, DeviceScene *dscene, bool force_free)
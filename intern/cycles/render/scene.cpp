@@ -262,6 +262,7 @@ void Scene::device_update(Device *device_, Progress &progress)
     return;
 
   geometry_manager->device_update_preprocess(device, this, progress);
+  light_manager->device_update_preprocess(this);
 
   if (progress.get_cancel() || device->have_error())
     return;
@@ -176,10 +176,14 @@ class SceneParams {
   bool use_bvh_spatial_split;
   bool use_bvh_unaligned_nodes;
   int num_bvh_time_steps;
+  int num_bvh_quantized_node_bits;
   int hair_subdivisions;
   CurveShapeType hair_shape;
   bool persistent_data;
   int texture_limit;
+  /* Memory budget in megabytes for paging in tiled and mip-mapped image files on demand when
+   * rendering on the CPU, zero to load all images fully. */
+  int texture_cache_size;
 
   bool background;
 
@@ -191,10 +195,12 @@ class SceneParams {
     use_bvh_spatial_split = false;
     use_bvh_unaligned_nodes = true;
     num_bvh_time_steps = 0;
+    num_bvh_quantized_node_bits = 0;
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
     persistent_data = false;
     texture_limit = 0;
+    texture_cache_size = 0;
     background = true;
   }
 
@@ -205,8 +211,10 @@ class SceneParams {
              use_bvh_spatial_split == params.use_bvh_spatial_split &&
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
+             num_bvh_quantized_node_bits == params.num_bvh_quantized_node_bits &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             persistent_data == params.persistent_data && texture_limit == params.texture_limit);
+             persistent_data == params.persistent_data && texture_limit == params.texture_limit &&
+             texture_cache_size == params.texture_cache_size);
   }
 
   int curve_subdivisions()
@@ -238,17 +238,73 @@ string MeshStats::full_report(int indent_level)
   return result;
 }
 
+/* BVH statistics. */
+
+BVHStats::BVHStats()
+    : num_aligned_nodes(0),
+      num_unaligned_nodes(0),
+      num_quantized_nodes(0),
+      quantized_saved_size(0),
+      build_time(0.0)
+{
+}
+
+string BVHStats::full_report(int indent_level)
+{
+  const string indent(indent_level * kIndentNumSpaces, ' ');
+  const string double_indent = indent + indent;
+  string result = "";
+  result += indent + "Memory:\n" + memory.full_report(indent_level + 1);
+  result += indent + "Inner nodes:\n";
+  result += string_printf("%s%-32s %s\n",
+                          double_indent.c_str(),
+                          "Aligned",
+                          string_human_readable_number(num_aligned_nodes).c_str());
+  result += string_printf("%s%-32s %s\n",
+                          double_indent.c_str(),
+                          "Unaligned",
+                          string_human_readable_number(num_unaligned_nodes).c_str());
+  result += string_printf("%s%-32s %s\n",
+                          double_indent.c_str(),
+                          "Quantized",
+                          string_human_readable_number(num_quantized_nodes).c_str());
+  if (num_quantized_nodes != 0) {
+    result += string_printf("%s%-32s %s\n",
+                            double_indent.c_str(),
+                            "Saved by quantization",
+                            string_human_readable_size(quantized_saved_size).c_str());
+  }
+  result += string_printf("%sBuild time: %fs\n", indent.c_str(), build_time);
+  return result;
+}
+
 /* Image statistics. */
 
-ImageStats::ImageStats()
+ImageStats::ImageStats() : cache_memory_limit(0), cache_memory_used(0), cache_bytes_read(0)
 {
 }
 
 string ImageStats::full_report(int indent_level)
 {
   const string indent(indent_level * kIndentNumSpaces, ' ');
+  const string double_indent = indent + indent;
   string result = "";
   result += indent + "Textures:\n" + textures.full_report(indent_level + 1);
+  if (cache_memory_limit != 0) {
+    result += indent + "Texture cache:\n";
+    result += string_printf("%s%-32s %s\n",
+                            double_indent.c_str(),
+                            "Memory limit",
+                            string_human_readable_size(cache_memory_limit).c_str());
+    result += string_printf("%s%-32s %s\n",
+                            double_indent.c_str(),
+                            "Memory used",
+                            string_human_readable_size(cache_memory_used).c_str());
+    result += string_printf("%s%-32s %s\n",
+                            double_indent.c_str(),
+                            "Read from disk",
+                            string_human_readable_size(cache_bytes_read).c_str());
+  }
   return result;
 }
 
@@ -333,6 +389,7 @@ string RenderStats::full_report()
 {
   string result = "";
   result += "Mesh statistics:\n" + mesh.full_report(1);
+  result += "BVH statistics:\n" + bvh.full_report(1);
   result += "Image statistics:\n" + image.full_report(1);
   if (has_profiling) {
     result += "Kernel statistics:\n" + kernel.full_report(1);
@@ -351,7 +408,12 @@ NamedTimeStats::NamedTimeStats() : total_time(0.0)
 
 string UpdateTimeStats::full_report(int indent_level)
 {
-  return times.full_report(indent_level + 1);
+  string result = times.full_report(indent_level + 1);
+  if (!phases.entries.empty()) {
+    const string indent((indent_level + 1) * kIndentNumSpaces, ' ');
+    result += indent + "Phases:\n" + phases.full_report(indent_level + 2);
+  }
+  return result;
 }
 
 SceneUpdateStats::SceneUpdateStats()
@@ -382,6 +444,7 @@ string SceneUpdateStats::full_report()
 void SceneUpdateStats::clear()
 {
   geometry.times.clear();
+  geometry.phases.clear();
   image.times.clear();
   light.times.clear();
   object.times.clear();
@@ -162,6 +162,29 @@ class MeshStats {
   NamedSizeStats geometry;
 };
 
+/* Statistics about the BVH in the render database. */
+class BVHStats {
+ public:
+  BVHStats();
+
+  /* Generate full human-readable report. */
+  string full_report(int indent_level = 0);
+
+  /* Device memory used by the packed BVH arrays. */
+  NamedSizeStats memory;
+
+  /* Number of inner nodes of each layout, only known for BVH2. */
+  size_t num_aligned_nodes;
+  size_t num_unaligned_nodes;
+  size_t num_quantized_nodes;
+
+  /* Memory saved by quantized nodes compared to full precision nodes. */
+  size_t quantized_saved_size;
+
+  /* Time spent building and packing the BVH, including instanced BVHs. */
+  double build_time;
+};
+
 /* Statistics about images held in memory. */
 class ImageStats {
  public:
@@ -171,6 +194,11 @@ class ImageStats {
   string full_report(int indent_level = 0);
 
   NamedSizeStats textures;
+
+  /* Texture cache, for images paged in on demand. */
+  size_t cache_memory_limit;
+  size_t cache_memory_used;
+  size_t cache_bytes_read;
 };
 
 /* Render process statistics. */
@@ -187,6 +215,7 @@ class RenderStats {
   bool has_profiling;
 
   MeshStats mesh;
+  BVHStats bvh;
   ImageStats image;
   NamedNestedSampleStats kernel;
   NamedSampleCountStats shaders;
@@ -199,6 +228,10 @@ class UpdateTimeStats {
   string full_report(int indent_level = 0);
 
   NamedTimeStats times;
+
+  /* Breakdown of some of the entries above into the phases they consist of, already included
+   * in the total time of the entries. */
+  NamedTimeStats phases;
 };
 
 class SceneUpdateStats {
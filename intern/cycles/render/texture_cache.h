@@ -0,0 +1,61 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TEXTURE_CACHE_H__
+#define __TEXTURE_CACHE_H__
+
+#include "render/image.h"
+
+#include "util/util_texture_cache.h"
+
+CCL_NAMESPACE_BEGIN
+
+class ImageStats;
+
+/* Texture Cache
+ *
+ * On demand storage of image files for CPU rendering. Rather than loading images fully into
+ * device memory, pixels are paged in as the kernel looks them up, at the resolution matching
+ * the ray footprint and within a fixed memory budget, evicting the least recently used pixels
+ * when it is exceeded.
+ *
+ * Can be subclassed to implement the cache on top of different tile stores. Images which the
+ * cache can not handle efficiently are loaded fully by the image manager as usual. */
+class TextureCache {
+ public:
+  explicit TextureCache(const size_t memory_limit) : memory_limit(memory_limit)
+  {
+  }
+  virtual ~TextureCache()
+  {
+  }
+
+  /* Create image for the file, or return NULL if the image should be fully loaded instead. */
+  virtual TextureCacheImage *add_image(ustring filepath,
+                                       const ImageParams &params,
+                                       const ImageMetaData &metadata,
+                                       const bool associate_alpha) = 0;
+  virtual void remove_image(TextureCacheImage *image) = 0;
+
+  virtual void collect_statistics(ImageStats *stats) = 0;
+
+ protected:
+  size_t memory_limit;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __TEXTURE_CACHE_H__ */
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/texture_cache_oiio.h"
+#include "render/colorspace.h"
+#include "render/stats.h"
+
+#include "util/util_image.h"
+#include "util/util_logging.h"
+
+CCL_NAMESPACE_BEGIN
+
+static ustring u_miplevels("miplevels");
+
+class OIIOTextureCacheImage : public TextureCacheImage {
+ public:
+  OIIOTextureCacheImage(TextureSystem *texture_system,
+                        ustring filepath,
+                        TextureSystem::TextureHandle *handle,
+                        const TextureOpt &options,
+                        ColorSpaceProcessor *processor)
+      : texture_system(texture_system),
+        filepath(filepath),
+        handle(handle),
+        options(options),
+        processor(processor)
+  {
+  }
+
+  bool lookup(float x,
+              float y,
+              float dxdx,
+              float dydx,
+              float dxdy,
+              float dydy,
+              float4 *result) const override
+  {
+    /* Options are modified by the lookup, so use a copy for thread safety. */
+    TextureOpt lookup_options = options;
+    float rgba[4];
+
+    /* Image coordinates have their origin at the bottom left, OpenImageIO ones at the top left.
+     * The texture system finds the thread data on its own when none is passed in. */
+    if (!texture_system->texture(handle,
+                                 NULL,
+                                 lookup_options,
+                                 x,
+                                 1.0f - y,
+                                 dxdx,
+                                 -dydx,
+                                 dxdy,
+                                 -dydy,
+                                 4,
+                                 rgba)) {
+      /* Clear error, to avoid them accumulating in the texture system. */
+      texture_system->geterror();
+      return false;
+    }
+
+    if (processor) {
+      ColorSpaceManager::to_scene_linear(processor, rgba, 4);
+    }
+
+    *result = make_float4(rgba[0], rgba[1], rgba[2], rgba[3]);
+    return true;
+  }
+
+  TextureSystem *texture_system;
+  ustring filepath;
+  TextureSystem::TextureHandle *handle;
+  TextureOpt options;
+  ColorSpaceProcessor *processor;
+};
+
+OIIOTextureCache::OIIOTextureCache(const size_t memory_limit) : TextureCache(memory_limit)
+{
+  /* Not shared with OSL, so the memory budget only covers images rendered with SVM. */
+  texture_system = TextureSystem::create(false);
+  texture_system->attribute("max_memory_MB", (float)(memory_limit / (1024 * 1024)));
+  /* Files are opened on demand throughout rendering, keep many of them open. */
+  texture_system->attribute("max_open_files", 1000);
+  /* Only files with tiles and mip-maps are added, so never generate them on the fly. */
+  texture_system->attribute("automip", 0);
+  texture_system->attribute("autotile", 0);
+  texture_system->attribute("gray_to_rgb", 1);
+}
+
+OIIOTextureCache::~OIIOTextureCache()
+{
+  VLOG(1) << "Texture cache statistics:\n" << texture_system->getstats();
+  TextureSystem::destroy(texture_system);
+}
+
+TextureCacheImage *OIIOTextureCache::add_image(ustring filepath,
+                                               const ImageParams &params,
+                                               const ImageMetaData &metadata,
+                                               const bool associate_alpha)
+{
+  if (filepath.empty() || metadata.depth > 1 || metadata.channels <= 0) {
+    return NULL;
+  }
+
+  /* The texture system associates alpha for all files, images that must keep it unassociated
+   * are loaded fully. Same for 8 bit images that the kernel expects to be stored as sRGB, but
+   * which need another color space conversion first. */
+  const bool has_alpha = (metadata.channels == 2 || metadata.channels == 4);
+  if ((has_alpha && !associate_alpha) ||
+      (metadata.compress_as_srgb && metadata.colorspace != u_colorspace_srgb)) {
+    return NULL;
+  }
+
+  /* Paging in pixels on demand only saves memory and loading time for files of which tiles
+   * can be read individually at the needed resolution. Other files would be read fully on the
+   * first lookup, so those are loaded up front instead. */
+  ImageSpec spec;
+  int num_mip_levels = 0;
+  if (!texture_system->get_imagespec(filepath, 0, spec) ||
+      !texture_system->get_texture_info(filepath, 0, u_miplevels, TypeDesc::INT, &num_mip_levels)) {
+    texture_system->geterror();
+    return NULL;
+  }
+  if (spec.tile_width == 0 || num_mip_levels < 2) {
+    VLOG(1) << "Texture cache not used for " << filepath << ", file is not tiled and mip-mapped.";
+    return NULL;
+  }
+
+  TextureSystem::TextureHandle *handle = texture_system->get_texture_handle(filepath);
+  if (handle == NULL) {
+    texture_system->geterror();
+    return NULL;
+  }
+
+  TextureOpt options;
+  /* Fill missing alpha channel. */
+  options.fill = 1.0f;
+
+  switch (params.extension) {
+    case EXTENSION_REPEAT:
+      options.swrap = options.twrap = TextureOpt::WrapPeriodic;
+      break;
+    case EXTENSION_EXTEND:
+      options.swrap = options.twrap = TextureOpt::WrapClamp;
+      break;
+    case EXTENSION_CLIP:
+    case EXTENSION_NUM_TYPES:
+      options.swrap = options.twrap = TextureOpt::WrapBlack;
+      break;
+  }
+
+  switch (params.interpolation) {
+    case INTERPOLATION_CLOSEST:
+      options.interpmode = TextureOpt::InterpClosest;
+      break;
+    case INTERPOLATION_CUBIC:
+      options.interpmode = TextureOpt::InterpBicubic;
+      break;
+    case INTERPOLATION_SMART:
+      options.interpmode = TextureOpt::InterpSmartBicubic;
+      break;
+    default:
+      options.interpmode = TextureOpt::InterpBilinear;
+      break;
+  }
+
+  ColorSpaceProcessor *processor = NULL;
+  if (metadata.colorspace != u_colorspace_raw && metadata.colorspace != u_colorspace_srgb) {
+    processor = ColorSpaceManager::get_processor(metadata.colorspace);
+  }
+
+  VLOG(1) << "Texture cache used for " << filepath << ", " << spec.width << "x" << spec.height
+          << " with " << num_mip_levels << " mip levels.";
+
+  return new OIIOTextureCacheImage(texture_system, filepath, handle, options, processor);
+}
+
+void OIIOTextureCache::remove_image(TextureCacheImage *image)
+{
+  OIIOTextureCacheImage *oiio_image = static_cast<OIIOTextureCacheImage *>(image);
+  /* Free tiles, the file may have changed when the image is added again. */
+  texture_system->invalidate(oiio_image->filepath);
+  delete oiio_image;
+}
+
+void OIIOTextureCache::collect_statistics(ImageStats *stats)
+{
+  long long memory_used = 0, bytes_read = 0;
+  texture_system->getattribute("stat:cache_memory_used", TypeDesc::INT64, &memory_used);
+  texture_system->getattribute("stat:bytes_read", TypeDesc::INT64, &bytes_read);
+
+  stats->cache_memory_limit = memory_limit;
+  stats->cache_memory_used = memory_used;
+  stats->cache_bytes_read = bytes_read;
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TEXTURE_CACHE_OIIO_H__
+#define __TEXTURE_CACHE_OIIO_H__
+
+#include "render/texture_cache.h"
+
+#include <OpenImageIO/texture.h>
+
+CCL_NAMESPACE_BEGIN
+
+/* Texture cache on top of the OpenImageIO texture system, which pages in tiles of tiled and
+ * mip-mapped files like .tx and tiled OpenEXR. */
+class OIIOTextureCache : public TextureCache {
+ public:
+  explicit OIIOTextureCache(const size_t memory_limit);
+  ~OIIOTextureCache();
+
+  TextureCacheImage *add_image(ustring filepath,
+                               const ImageParams &params,
+                               const ImageMetaData &metadata,
+                               const bool associate_alpha) override;
+  void remove_image(TextureCacheImage *image) override;
+
+  void collect_statistics(ImageStats *stats) override;
+
+ protected:
+  OIIO::TextureSystem *texture_system;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __TEXTURE_CACHE_OIIO_H__ */
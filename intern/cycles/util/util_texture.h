@@ -106,6 +106,8 @@ typedef struct TextureInfo {
   /* Transform for 3D textures. */
   uint use_transform_3d;
   Transform transform_3d;
+  /* Texture cache image for images paged in on demand, CPU only. */
+  uint64_t cache_image;
 } TextureInfo;
 
 CCL_NAMESPACE_END
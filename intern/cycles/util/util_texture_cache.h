@@ -0,0 +1,49 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __UTIL_TEXTURE_CACHE_H__
+#define __UTIL_TEXTURE_CACHE_H__
+
+#include "util/util_types.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Texture Cache Image
+ *
+ * Image which pixels are not stored in device memory, but paged in on demand by a texture cache
+ * on the host. Referenced from TextureInfo, and only accessed by CPU kernels. */
+class TextureCacheImage {
+ public:
+  virtual ~TextureCacheImage()
+  {
+  }
+
+  /* Filtered lookup at image coordinates (x, y), with the footprint given by the derivatives of
+   * the coordinates along the ray differentials. Zero derivatives sample the full resolution.
+   *
+   * Returns scene linear RGBA with associated alpha, or false if no pixels could be read. */
+  virtual bool lookup(float x,
+                      float y,
+                      float dxdx,
+                      float dydx,
+                      float dxdy,
+                      float dydy,
+                      float4 *result) const = 0;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __UTIL_TEXTURE_CACHE_H__ */
@@ -268,6 +268,32 @@ void EIG_linear_solver_right_hand_side_add(LinearSolver *solver, int rhs, int in
 
 /* Solve */
 
+static bool linear_solver_factorize(LinearSolver *solver)
+{
+  /* create matrix from triplets */
+  solver->M.resize(solver->m, solver->n);
+  solver->M.setFromTriplets(solver->Mtriplets.begin(), solver->Mtriplets.end());
+  solver->Mtriplets.clear();
+
+  /* create least squares matrix */
+  if (solver->least_squares)
+    solver->MtM = solver->M.transpose() * solver->M;
+
+  /* convert M to compressed column format */
+  EigenSparseMatrix &M = (solver->least_squares) ? solver->MtM : solver->M;
+  M.makeCompressed();
+
+  /* perform sparse LU factorization */
+  EigenSparseLU *sparseLU = new EigenSparseLU();
+  solver->sparseLU = sparseLU;
+
+  sparseLU->compute(M);
+
+  solver->state = LinearSolver::STATE_MATRIX_SOLVED;
+
+  return (sparseLU->info() == Eigen::Success);
+}
+
 bool EIG_linear_solver_solve(LinearSolver *solver)
 {
   /* nothing to solve, perhaps all variables were locked */
@@ -279,27 +305,7 @@ bool EIG_linear_solver_solve(LinearSolver *solver)
   assert(solver->state != LinearSolver::STATE_VARIABLES_CONSTRUCT);
 
   if (solver->state == LinearSolver::STATE_MATRIX_CONSTRUCT) {
-    /* create matrix from triplets */
-    solver->M.resize(solver->m, solver->n);
-    solver->M.setFromTriplets(solver->Mtriplets.begin(), solver->Mtriplets.end());
-    solver->Mtriplets.clear();
-
-    /* create least squares matrix */
-    if (solver->least_squares)
-      solver->MtM = solver->M.transpose() * solver->M;
-
-    /* convert M to compressed column format */
-    EigenSparseMatrix &M = (solver->least_squares) ? solver->MtM : solver->M;
-    M.makeCompressed();
-
-    /* perform sparse LU factorization */
-    EigenSparseLU *sparseLU = new EigenSparseLU();
-    solver->sparseLU = sparseLU;
-
-    sparseLU->compute(M);
-    result = (sparseLU->info() == Eigen::Success);
-
-    solver->state = LinearSolver::STATE_MATRIX_SOLVED;
+    result = linear_solver_factorize(solver);
   }
 
   if (result) {
@@ -344,6 +350,35 @@ bool EIG_linear_solver_solve(LinearSolver *solver)
   return result;
 }
 
+bool EIG_linear_solver_factorize(LinearSolver *solver)
+{
+  /* nothing to solve, perhaps all variables were locked */
+  if (solver->m == 0 || solver->n == 0)
+    return true;
+
+  assert(solver->state != LinearSolver::STATE_VARIABLES_CONSTRUCT);
+
+  if (solver->state == LinearSolver::STATE_MATRIX_CONSTRUCT)
+    return linear_solver_factorize(solver);
+
+  return (solver->sparseLU->info() == Eigen::Success);
+}
+
+bool EIG_linear_solver_solve_vector(const LinearSolver *solver, const double *b, double *x)
+{
+  if (solver->m == 0 || solver->n == 0)
+    return true;
+
+  assert(solver->state == LinearSolver::STATE_MATRIX_SOLVED);
+  assert(!solver->least_squares && solver->m == solver->n);
+
+  Eigen::Map<const EigenVectorX> b_vec(b, solver->m);
+  Eigen::Map<EigenVectorX> x_vec(x, solver->n);
+  x_vec = solver->sparseLU->solve(b_vec);
+
+  return (solver->sparseLU->info() == Eigen::Success);
+}
+
 /* Debugging */
 
 void EIG_linear_solver_print_matrix(LinearSolver *solver)
@@ -58,6 +58,14 @@ void EIG_linear_solver_right_hand_side_add(LinearSolver *solver, int rhs, int in
 
 bool EIG_linear_solver_solve(LinearSolver *solver);
 
+/* Solve for many right hand sides, possibly from multiple threads. The matrix is factorized once
+ * by EIG_linear_solver_factorize, after which each solve only reads the solver. The right hand
+ * side b and solution x are dense vectors over all variables. Only for square systems without
+ * locked variables. */
+
+bool EIG_linear_solver_factorize(LinearSolver *solver);
+bool EIG_linear_solver_solve_vector(const LinearSolver *solver, const double *b, double *x);
+
 /* Debugging */
 
 void EIG_linear_solver_print_matrix(LinearSolver *solver);
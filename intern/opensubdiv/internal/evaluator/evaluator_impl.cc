@@ -35,6 +35,12 @@
 #include <opensubdiv/osd/types.h>
 #include <opensubdiv/version.h>
 
+#if defined(OPENSUBDIV_HAS_TBB)
+#  include <opensubdiv/osd/tbbEvaluator.h>
+#elif defined(OPENSUBDIV_HAS_OPENMP)
+#  include <opensubdiv/osd/ompEvaluator.h>
+#endif
+
 #include "MEM_guardedalloc.h"
 
 #include "internal/base/type.h"
@@ -53,6 +59,17 @@ using OpenSubdiv::Osd::CpuPatchTable;
 using OpenSubdiv::Osd::CpuVertexBuffer;
 using OpenSubdiv::Osd::PatchCoord;
 
+// Evaluator used for the stencils when refining coarse positions. All refined vertices are
+// evaluated at once there, which is worth threading. Patches keep using the CPU evaluator,
+// they are evaluated from Blender's own threads, often a single point at a time.
+#if defined(OPENSUBDIV_HAS_TBB)
+typedef OpenSubdiv::Osd::TbbEvaluator CpuStencilEvaluator;
+#elif defined(OPENSUBDIV_HAS_OPENMP)
+typedef OpenSubdiv::Osd::OmpEvaluator CpuStencilEvaluator;
+#else
+typedef OpenSubdiv::Osd::CpuEvaluator CpuStencilEvaluator;
+#endif
+
 namespace blender {
 namespace opensubdiv {
 
@@ -183,11 +200,14 @@ class ConstPatchCoordWrapperBuffer : public RawDataWrapperVertexBuffer<const Pat
   }
 };
 
+// STENCIL_EVALUATOR is used to refine the data, it must be an evaluator that works without an
+// instance (such as the CPU, OpenMP and TBB evaluators).
 template<typename EVAL_VERTEX_BUFFER,
          typename STENCIL_TABLE,
          typename PATCH_TABLE,
          typename EVALUATOR,
-         typename DEVICE_CONTEXT = void>
+         typename DEVICE_CONTEXT = void,
+         typename STENCIL_EVALUATOR = EVALUATOR>
 class FaceVaryingVolatileEval {
  public:
   typedef OpenSubdiv::Osd::EvaluatorCacheT<EVALUATOR> EvaluatorCache;
@@ -230,17 +250,15 @@ class FaceVaryingVolatileEval {
     BufferDescriptor dst_face_varying_desc = src_face_varying_desc_;
     dst_face_varying_desc.offset += num_coarse_face_varying_vertices_ *
                                     src_face_varying_desc_.stride;
-    const EVALUATOR *eval_instance = OpenSubdiv::Osd::GetEvaluator<EVALUATOR>(
-        evaluator_cache_, src_face_varying_desc_, dst_face_varying_desc, device_context_);
     // in and out points to same buffer so output is put directly after coarse vertices, needed in
     // adaptive mode
-    EVALUATOR::EvalStencils(src_face_varying_data_,
-                            src_face_varying_desc_,
-                            src_face_varying_data_,
-                            dst_face_varying_desc,
-                            face_varying_stencils_,
-                            eval_instance,
-                            device_context_);
+    STENCIL_EVALUATOR::EvalStencils(src_face_varying_data_,
+                                    src_face_varying_desc_,
+                                    src_face_varying_data_,
+                                    dst_face_varying_desc,
+                                    face_varying_stencils_,
+                                    (const STENCIL_EVALUATOR *)NULL,
+                                    device_context_);
   }
 
   // NOTE: face_varying must point to a memory of at least float[2]*num_patch_coords.
@@ -303,7 +321,8 @@ template<typename SRC_VERTEX_BUFFER,
          typename STENCIL_TABLE,
          typename PATCH_TABLE,
          typename EVALUATOR,
-         typename DEVICE_CONTEXT = void>
+         typename DEVICE_CONTEXT = void,
+         typename STENCIL_EVALUATOR = EVALUATOR>
 class VolatileEvalOutput {
  public:
   typedef OpenSubdiv::Osd::EvaluatorCacheT<EVALUATOR> EvaluatorCache;
@@ -311,7 +330,8 @@ class VolatileEvalOutput {
                                   STENCIL_TABLE,
                                   PATCH_TABLE,
                                   EVALUATOR,
-                                  DEVICE_CONTEXT>
+                                  DEVICE_CONTEXT,
+                                  STENCIL_EVALUATOR>
       FaceVaryingEval;
 
   VolatileEvalOutput(const StencilTable *vertex_stencils,
@@ -404,28 +424,24 @@ class VolatileEvalOutput {
     // Evaluate vertex positions.
     BufferDescriptor dst_desc = src_desc_;
     dst_desc.offset += num_coarse_vertices_ * src_desc_.stride;
-    const EVALUATOR *eval_instance = OpenSubdiv::Osd::GetEvaluator<EVALUATOR>(
-        evaluator_cache_, src_desc_, dst_desc, device_context_);
-    EVALUATOR::EvalStencils(src_data_,
-                            src_desc_,
-                            src_data_,
-                            dst_desc,
-                            vertex_stencils_,
-                            eval_instance,
-                            device_context_);
+    STENCIL_EVALUATOR::EvalStencils(src_data_,
+                                    src_desc_,
+                                    src_data_,
+                                    dst_desc,
+                                    vertex_stencils_,
+                                    (const STENCIL_EVALUATOR *)NULL,
+                                    device_context_);
     // Evaluate varying data.
     if (hasVaryingData()) {
       BufferDescriptor dst_varying_desc = src_varying_desc_;
       dst_varying_desc.offset += num_coarse_vertices_ * src_varying_desc_.stride;
-      eval_instance = OpenSubdiv::Osd::GetEvaluator<EVALUATOR>(
-          evaluator_cache_, src_varying_desc_, dst_varying_desc, device_context_);
-      EVALUATOR::EvalStencils(src_varying_data_,
-                              src_varying_desc_,
-                              src_varying_data_,
-                              dst_varying_desc,
-                              varying_stencils_,
-                              eval_instance,
-                              device_context_);
+      STENCIL_EVALUATOR::EvalStencils(src_varying_data_,
+                                      src_varying_desc_,
+                                      src_varying_data_,
+                                      dst_varying_desc,
+                                      varying_stencils_,
+                                      (const STENCIL_EVALUATOR *)NULL,
+                                      device_context_);
     }
     // Evaluate face-varying data.
     if (hasFaceVaryingData()) {
@@ -559,7 +575,9 @@ class CpuEvalOutput : public VolatileEvalOutput<CpuVertexBuffer,
                                                 CpuVertexBuffer,
                                                 StencilTable,
                                                 CpuPatchTable,
-                                                CpuEvaluator> {
+                                                CpuEvaluator,
+                                                void,
+                                                CpuStencilEvaluator> {
  public:
   CpuEvalOutput(const StencilTable *vertex_stencils,
                 const StencilTable *varying_stencils,
@@ -571,12 +589,14 @@ class CpuEvalOutput : public VolatileEvalOutput<CpuVertexBuffer,
                            CpuVertexBuffer,
                            StencilTable,
                            CpuPatchTable,
-                           CpuEvaluator>(vertex_stencils,
-                                         varying_stencils,
-                                         all_face_varying_stencils,
-                                         face_varying_width,
-                                         patch_table,
-                                         evaluator_cache)
+                           CpuEvaluator,
+                           void,
+                           CpuStencilEvaluator>(vertex_stencils,
+                                                varying_stencils,
+                                                all_face_varying_stencils,
+                                                face_varying_width,
+                                                patch_table,
+                                                evaluator_cache)
   {
   }
 };
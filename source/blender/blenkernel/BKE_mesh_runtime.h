@@ -38,9 +38,20 @@ struct MLoop;
 struct MLoopTri;
 struct MVertTri;
 struct Mesh;
+struct MeshElemMap;
+struct MeshTopologyCache;
 struct Object;
 struct Scene;
 
+/** Adjacency maps cached by #BKE_mesh_runtime_topology_map_ensure. */
+typedef enum eMeshTopologyMapType {
+  MESH_TOPOLOGY_MAP_VERT_EDGE = 0,
+  MESH_TOPOLOGY_MAP_VERT_POLY = 1,
+  MESH_TOPOLOGY_MAP_VERT_LOOP = 2,
+  MESH_TOPOLOGY_MAP_EDGE_POLY = 3,
+} eMeshTopologyMapType;
+#define MESH_TOPOLOGY_MAP_TYPE_NUM 4
+
 void BKE_mesh_runtime_reset(struct Mesh *mesh);
 void BKE_mesh_runtime_reset_on_copy(struct Mesh *mesh, const int flag);
 int BKE_mesh_runtime_looptri_len(const struct Mesh *mesh);
@@ -52,6 +63,11 @@ bool BKE_mesh_runtime_reset_edit_data(struct Mesh *mesh);
 void BKE_mesh_runtime_clear_geometry(struct Mesh *mesh);
 void BKE_mesh_runtime_clear_cache(struct Mesh *mesh);
 
+const struct MeshElemMap *BKE_mesh_runtime_topology_map_ensure(struct Mesh *mesh,
+                                                               const eMeshTopologyMapType type);
+struct MeshTopologyCache *BKE_mesh_runtime_topology_cache_backup(struct Mesh *mesh);
+void BKE_mesh_runtime_topology_cache_restore(struct Mesh *mesh, struct MeshTopologyCache *cache);
+
 void BKE_mesh_runtime_verttri_from_looptri(struct MVertTri *r_verttri,
                                            const struct MLoop *mloop,
                                            const struct MLoopTri *looptri,
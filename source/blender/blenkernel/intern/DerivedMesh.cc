@@ -1891,6 +1891,68 @@ static void mesh_runtime_check_normals_valid(const Mesh *mesh)
   BLI_assert(!(mesh->runtime.cd_dirty_poly & CD_MASK_NORMAL));
 }
 
+/**
+ * Check whether the evaluated mesh uses the topology arrays of the (copy-on-write) mesh as-is,
+ * which is the case when only deform modifiers are used.
+ */
+static bool mesh_eval_is_deformed_from(const Mesh *mesh_eval, const Mesh *mesh)
+{
+  return mesh_eval->runtime.deformed_only && mesh_eval->totvert == mesh->totvert &&
+         mesh_eval->totedge == mesh->totedge && mesh_eval->totloop == mesh->totloop &&
+         mesh_eval->totpoly == mesh->totpoly && mesh_eval->medge == mesh->medge &&
+         mesh_eval->mloop == mesh->mloop && mesh_eval->mpoly == mesh->mpoly;
+}
+
+/**
+ * Detach the previous evaluated mesh from the object so it is not freed with the other
+ * derived caches, its batch cache may be reused by #mesh_build_batch_cache_reuse.
+ */
+static Mesh *mesh_build_previous_take(Object *ob)
+{
+  ID *data_eval = ob->runtime.data_eval;
+  if (data_eval == nullptr || !ob->runtime.is_data_eval_owned || GS(data_eval->name) != ID_ME) {
+    return nullptr;
+  }
+  Mesh *mesh = (Mesh *)ob->runtime.data_orig;
+  Mesh *mesh_eval_prev = (Mesh *)data_eval;
+  /* Meshes with a CCG have modifiers other than deform ones, and must be freed as usual so
+   * sculpted changes are applied to the original mesh. */
+  if (mesh_eval_prev->runtime.batch_cache == nullptr ||
+      mesh_eval_prev->runtime.subdiv_ccg != nullptr || mesh == nullptr ||
+      !mesh_eval_is_deformed_from(mesh_eval_prev, mesh)) {
+    return nullptr;
+  }
+  ob->runtime.data_eval = nullptr;
+  return mesh_eval_prev;
+}
+
+/**
+ * When both the previous and the new evaluated mesh only deform the same topology, move the
+ * batch cache over so the draw code keeps the index buffers and other topology dependent data,
+ * and only extracts the deformed positions and normals again.
+ */
+static void mesh_build_batch_cache_reuse(const Mesh *mesh,
+                                         Mesh *mesh_eval_prev,
+                                         Mesh *mesh_eval,
+                                         const bool is_mesh_eval_owned)
+{
+  if (!is_mesh_eval_owned || mesh_eval->runtime.batch_cache != nullptr) {
+    return;
+  }
+  /* The topology arrays are only known to be unchanged when the mesh was not copied again. */
+  if (mesh->id.recalc & ID_RECALC_COPY_ON_WRITE) {
+    return;
+  }
+  if (!mesh_eval_is_deformed_from(mesh_eval_prev, mesh) ||
+      !mesh_eval_is_deformed_from(mesh_eval, mesh)) {
+    return;
+  }
+
+  mesh_eval->runtime.batch_cache = mesh_eval_prev->runtime.batch_cache;
+  mesh_eval->runtime.batch_cache_deform_only = true;
+  mesh_eval_prev->runtime.batch_cache = nullptr;
+}
+
 static void mesh_build_data(struct Depsgraph *depsgraph,
                             Scene *scene,
                             Object *ob,
@@ -1903,6 +1965,8 @@ static void mesh_build_data(struct Depsgraph *depsgraph,
    * they aren't cleaned up properly on mode switch, causing crashes, e.g T58150. */
   BLI_assert(ob->id.tag & LIB_TAG_COPIED_ON_WRITE);
 
+  Mesh *mesh_eval_prev = mesh_build_previous_take(ob);
+
   BKE_object_free_derived_caches(ob);
   if (DEG_is_active(depsgraph)) {
     BKE_sculpt_update_object_before_eval(ob);
@@ -1942,6 +2006,11 @@ static void mesh_build_data(struct Depsgraph *depsgraph,
   const bool is_mesh_eval_owned = (mesh_eval != mesh->runtime.mesh_eval);
   BKE_object_eval_assign_data(ob, &mesh_eval->id, is_mesh_eval_owned);
 
+  if (mesh_eval_prev != nullptr) {
+    mesh_build_batch_cache_reuse(mesh, mesh_eval_prev, mesh_eval, is_mesh_eval_owned);
+    BKE_mesh_eval_delete(mesh_eval_prev);
+  }
+
   /* Add the final mesh as read-only non-owning component to the geometry set. */
   MeshComponent &mesh_component = geometry_set_eval->get_component_for_write<MeshComponent>();
   mesh_component.replace_mesh_but_keep_vertex_group_names(mesh_eval,
@@ -52,55 +52,45 @@
 #include "BKE_lattice.h"
 
 #include "DEG_depsgraph_build.h"
+#include "DEG_depsgraph_query.h"
 
 #include "CLG_log.h"
 
+#include "atomic_ops.h"
+
 static CLG_LogRef LOG = {"bke.armature_deform"};
 
 /* -------------------------------------------------------------------- */
 /** \name Armature Deform Internal Utilities
  * \{ */
 
-/* Add the effect of one bone or B-Bone segment to the accumulated result. */
+/* Add the effect of one bone or B-Bone segment to the accumulated result.
+ *
+ * Without dual quaternions the deform matrices are blended, and the blended matrix is applied to
+ * the coordinate once all bones are accumulated. Its rotation and scale part is the blended
+ * deform matrix. */
 static void pchan_deform_accumulate(const DualQuat *deform_dq,
                                     const float deform_mat[4][4],
-                                    const float co_in[3],
                                     float weight,
-                                    float co_accum[3],
-                                    DualQuat *dq_accum,
-                                    float mat_accum[3][3])
+                                    float mat_accum[4][4],
+                                    DualQuat *dq_accum)
 {
   if (weight == 0.0f) {
     return;
   }
 
   if (dq_accum) {
-    BLI_assert(!co_accum);
+    BLI_assert(!mat_accum);
 
     add_weighted_dq_dq(dq_accum, deform_dq, weight);
   }
   else {
-    float tmp[3];
-    mul_v3_m4v3(tmp, deform_mat, co_in);
-
-    sub_v3_v3(tmp, co_in);
-    madd_v3_v3fl(co_accum, tmp, weight);
-
-    if (mat_accum) {
-      float tmpmat[3][3];
-      copy_m3_m4(tmpmat, deform_mat);
-
-      madd_m3_m3m3fl(mat_accum, mat_accum, tmpmat, weight);
-    }
+    madd_m4_m4m4fl(mat_accum, mat_accum, deform_mat, weight);
   }
 }
 
-static void b_bone_deform(const bPoseChannel *pchan,
-                          const float co[3],
-                          float weight,
-                          float vec[3],
-                          DualQuat *dq,
-                          float defmat[3][3])
+static void b_bone_deform(
+    const bPoseChannel *pchan, const float co[3], float weight, float defmat[4][4], DualQuat *dq)
 {
   const DualQuat *quats = pchan->runtime.bbone_dual_quats;
   const Mat4 *mats = pchan->runtime.bbone_deform_mats;
@@ -114,10 +104,8 @@ static void b_bone_deform(const bPoseChannel *pchan,
   /* Calculate the indices of the 2 affecting b_bone segments. */
   BKE_pchan_bbone_deform_segment_index(pchan, y / pchan->bone->length, &index, &blend);
 
-  pchan_deform_accumulate(
-      &quats[index], mats[index + 1].mat, co, weight * (1.0f - blend), vec, dq, defmat);
-  pchan_deform_accumulate(
-      &quats[index + 1], mats[index + 2].mat, co, weight * blend, vec, dq, defmat);
+  pchan_deform_accumulate(&quats[index], mats[index + 1].mat, weight * (1.0f - blend), defmat, dq);
+  pchan_deform_accumulate(&quats[index + 1], mats[index + 2].mat, weight * blend, defmat, dq);
 }
 
 /* using vec with dist to bone b1 - b2 */
@@ -175,7 +163,7 @@ float distfactor_to_bone(
 }
 
 static float dist_bone_deform(
-    bPoseChannel *pchan, float vec[3], DualQuat *dq, float mat[3][3], const float co[3])
+    bPoseChannel *pchan, float mat[4][4], DualQuat *dq, const float co[3])
 {
   Bone *bone = pchan->bone;
   float fac, contrib = 0.0;
@@ -192,11 +180,10 @@ static float dist_bone_deform(
     contrib = fac;
     if (contrib > 0.0f) {
       if (bone->segments > 1 && pchan->runtime.bbone_segments == bone->segments) {
-        b_bone_deform(pchan, co, fac, vec, dq, mat);
+        b_bone_deform(pchan, co, fac, mat, dq);
       }
       else {
-        pchan_deform_accumulate(
-            &pchan->runtime.deform_dual_quat, pchan->chan_mat, co, fac, vec, dq, mat);
+        pchan_deform_accumulate(&pchan->runtime.deform_dual_quat, pchan->chan_mat, fac, mat, dq);
       }
     }
   }
@@ -206,9 +193,8 @@ static float dist_bone_deform(
 
 static void pchan_bone_deform(bPoseChannel *pchan,
                               float weight,
-                              float vec[3],
+                              float mat[4][4],
                               DualQuat *dq,
-                              float mat[3][3],
                               const float co[3],
                               float *contrib)
 {
@@ -219,11 +205,10 @@ static void pchan_bone_deform(bPoseChannel *pchan,
   }
 
   if (bone->segments > 1 && pchan->runtime.bbone_segments == bone->segments) {
-    b_bone_deform(pchan, co, weight, vec, dq, mat);
+    b_bone_deform(pchan, co, weight, mat, dq);
   }
   else {
-    pchan_deform_accumulate(
-        &pchan->runtime.deform_dual_quat, pchan->chan_mat, co, weight, vec, dq, mat);
+    pchan_deform_accumulate(&pchan->runtime.deform_dual_quat, pchan->chan_mat, weight, mat, dq);
   }
 
   (*contrib) += weight;
@@ -231,6 +216,133 @@ static void pchan_bone_deform(bPoseChannel *pchan,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Armature Deform Weights
+ *
+ * Copy of the vertex weights of a mesh in one contiguous array, so deforming doesn't have to
+ * follow the separately allocated weights of every #MDeformVert. It is stored in the runtime of
+ * the evaluated mesh and reused until the mesh is evaluated again, which during playback of an
+ * animated armature typically doesn't happen.
+ *
+ * The copy is only checked against the address and number of the deform vertices, weights
+ * edited in place are not detected. Edits of the weights tag the geometry of the mesh for an
+ * update though, which copies the evaluated mesh again and frees its runtime data with
+ * #BKE_mesh_runtime_clear_geometry, including these weights.
+ * \{ */
+
+typedef struct ArmatureDeformWeights {
+  /** Deform vertices the weights were copied from, to detect when they are outdated. */
+  const MDeformVert *dverts;
+  int dverts_len;
+  /** Weights of vertex `i` are `dw[dw_offsets[i]]` up to `dw[dw_offsets[i + 1]]`. */
+  int *dw_offsets;
+  MDeformWeight *dw;
+} ArmatureDeformWeights;
+
+static void armature_deform_weights_copy_task(void *__restrict userdata,
+                                              const int i,
+                                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ArmatureDeformWeights *weights = userdata;
+  const MDeformVert *dvert = &weights->dverts[i];
+  if (dvert->totweight != 0) {
+    memcpy(&weights->dw[weights->dw_offsets[i]],
+           dvert->dw,
+           sizeof(*weights->dw) * (size_t)dvert->totweight);
+  }
+}
+
+static ArmatureDeformWeights *armature_deform_weights_create(const MDeformVert *dverts,
+                                                             const int dverts_len)
+{
+  ArmatureDeformWeights *weights = MEM_callocN(sizeof(*weights), __func__);
+  weights->dverts = dverts;
+  weights->dverts_len = dverts_len;
+  weights->dw_offsets = MEM_malloc_arrayN(
+      (size_t)dverts_len + 1, sizeof(*weights->dw_offsets), __func__);
+
+  int dw_len = 0;
+  for (int i = 0; i < dverts_len; i++) {
+    weights->dw_offsets[i] = dw_len;
+    dw_len += dverts[i].totweight;
+  }
+  weights->dw_offsets[dverts_len] = dw_len;
+  weights->dw = MEM_malloc_arrayN(max_ii(dw_len, 1), sizeof(*weights->dw), __func__);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, dverts_len, weights, armature_deform_weights_copy_task, &settings);
+
+  return weights;
+}
+
+static void armature_deform_weights_free(ArmatureDeformWeights *weights)
+{
+  MEM_freeN(weights->dw_offsets);
+  MEM_freeN(weights->dw);
+  MEM_freeN(weights);
+}
+
+static bool armature_deform_weights_match(const ArmatureDeformWeights *weights,
+                                          const MDeformVert *dverts,
+                                          const int dverts_len)
+{
+  return weights->dverts == dverts && weights->dverts_len == dverts_len;
+}
+
+void BKE_armature_deform_discard_weights(Mesh *mesh)
+{
+  ArmatureDeformWeights *weights = mesh->runtime.armature_deform_weights;
+
+  if (weights != NULL) {
+    armature_deform_weights_free(weights);
+  }
+
+  mesh->runtime.armature_deform_weights = NULL;
+}
+
+/* Get the compact weights of the given deform vertices, or NULL when they can not be cached.
+ *
+ * Only the weights of the evaluated object data are cached. Meshes created by previous modifiers
+ * are temporary, but unless those modifiers changed the weights, they reference the same deform
+ * vertices as the object data. */
+static const ArmatureDeformWeights *armature_deform_weights_ensure(const Object *ob_target,
+                                                                   const MDeformVert *dverts,
+                                                                   const int dverts_len)
+{
+  if (ob_target->type != OB_MESH || dverts == NULL) {
+    return NULL;
+  }
+  Mesh *mesh = ob_target->data;
+  if (!DEG_is_evaluated_id(&mesh->id) || mesh->dvert != dverts || mesh->totvert != dverts_len) {
+    return NULL;
+  }
+
+  ArmatureDeformWeights *weights = mesh->runtime.armature_deform_weights;
+  if (weights != NULL && armature_deform_weights_match(weights, dverts, dverts_len)) {
+    return weights;
+  }
+
+  /* The object data may be shared by several objects which are deformed in parallel. The copy is
+   * created in parallel too, so it's done without holding a lock and only published atomically,
+   * when two objects create it at the same time one of the copies is discarded. */
+  ArmatureDeformWeights *weights_new = armature_deform_weights_create(dverts, dverts_len);
+  ArmatureDeformWeights *weights_prev = atomic_cas_ptr(
+      (void **)&mesh->runtime.armature_deform_weights, weights, weights_new);
+  if (weights_prev == weights) {
+    if (weights != NULL) {
+      armature_deform_weights_free(weights);
+    }
+    return weights_new;
+  }
+
+  armature_deform_weights_free(weights_new);
+  return armature_deform_weights_match(weights_prev, dverts, dverts_len) ? weights_prev : NULL;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Armature Deform #BKE_armature_deform_coords API
  *
@@ -255,6 +367,9 @@ typedef struct ArmatureUserdata {
   const MDeformVert *dverts;
   int dverts_len;
 
+  /** Compact copy of the weights of the deform vertices, when available. */
+  const ArmatureDeformWeights *weights;
+
   bPoseChannel **pchan_from_defbase;
   int defbase_len;
 
@@ -282,8 +397,8 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
   DualQuat sumdq, *dq = NULL;
   bPoseChannel *pchan;
   float *co, dco[3];
-  float sumvec[3], summat[3][3];
-  float *vec = NULL, (*smat)[3] = NULL;
+  float summat4[4][4], summat[3][3];
+  float(*mat)[4] = NULL, (*smat)[3] = NULL;
   float contrib = 0.0f;
   float armature_weight = 1.0f; /* default to 1 if no overall def group */
   float prevco_weight = 1.0f;   /* weight for optional cached vertexcos */
@@ -293,13 +408,8 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
     dq = &sumdq;
   }
   else {
-    zero_v3(sumvec);
-    vec = sumvec;
-
-    if (vert_deform_mats) {
-      zero_m3(summat);
-      smat = summat;
-    }
+    zero_m4(summat4);
+    mat = summat4;
   }
 
   if (armature_def_nr != -1 && dvert) {
@@ -344,14 +454,14 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
               co, bone->arm_head, bone->arm_tail, bone->rad_head, bone->rad_tail, bone->dist);
         }
 
-        pchan_bone_deform(pchan, weight, vec, dq, smat, co, &contrib);
+        pchan_bone_deform(pchan, weight, mat, dq, co, &contrib);
       }
     }
     /* If there are vertex-groups but not groups with bones (like for soft-body groups). */
     if (deformed == 0 && use_envelope) {
       for (pchan = data->ob_arm->pose->chanbase.first; pchan; pchan = pchan->next) {
         if (!(pchan->bone->flag & BONE_NO_DEFORM)) {
-          contrib += dist_bone_deform(pchan, vec, dq, smat, co);
+          contrib += dist_bone_deform(pchan, mat, dq, co);
         }
       }
     }
@@ -359,7 +469,7 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
   else if (use_envelope) {
     for (pchan = data->ob_arm->pose->chanbase.first; pchan; pchan = pchan->next) {
       if (!(pchan->bone->flag & BONE_NO_DEFORM)) {
-        contrib += dist_bone_deform(pchan, vec, dq, smat, co);
+        contrib += dist_bone_deform(pchan, mat, dq, co);
       }
     }
   }
@@ -383,8 +493,15 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
       smat = summat;
     }
     else {
-      mul_v3_fl(vec, armature_weight / contrib);
-      add_v3_v3v3(co, vec, co);
+      /* Offset of the blended transform, relative to the total weight. */
+      mul_v3_m4v3(dco, summat4, co);
+      madd_v3_v3fl(dco, co, -contrib);
+      madd_v3_v3fl(co, dco, armature_weight / contrib);
+
+      if (vert_deform_mats) {
+        copy_m3_m4(summat, summat4);
+        smat = summat;
+      }
     }
 
     if (vert_deform_mats) {
@@ -420,8 +537,22 @@ static void armature_vert_task(void *__restrict userdata,
 {
   const ArmatureUserdata *data = userdata;
   const MDeformVert *dvert;
+  MDeformVert dvert_compact;
   if (data->use_dverts || data->armature_def_nr != -1) {
-    if (data->me_target) {
+    if (data->weights) {
+      /* Deform vertex referencing the compact weights. */
+      if (i < data->weights->dverts_len) {
+        const int dw_offset = data->weights->dw_offsets[i];
+        dvert_compact.dw = &data->weights->dw[dw_offset];
+        dvert_compact.totweight = data->weights->dw_offsets[i + 1] - dw_offset;
+        dvert_compact.flag = 0;
+        dvert = &dvert_compact;
+      }
+      else {
+        dvert = NULL;
+      }
+    }
+    else if (data->me_target) {
       BLI_assert(i < data->me_target->totvert);
       if (data->me_target->dvert != NULL) {
         dvert = data->me_target->dvert + i;
@@ -560,6 +691,16 @@ static void armature_deform_coords_impl(const Object *ob_arm,
     }
   }
 
+  const ArmatureDeformWeights *weights = NULL;
+  if ((use_dverts || armature_def_nr != -1) && em_target == NULL) {
+    if (me_target) {
+      weights = armature_deform_weights_ensure(ob_target, me_target->dvert, me_target->totvert);
+    }
+    else {
+      weights = armature_deform_weights_ensure(ob_target, dverts, dverts_len);
+    }
+  }
+
   ArmatureUserdata data = {
       .ob_arm = ob_arm,
       .ob_target = ob_target,
@@ -574,6 +715,7 @@ static void armature_deform_coords_impl(const Object *ob_arm,
       .armature_def_nr = armature_def_nr,
       .dverts = dverts,
       .dverts_len = dverts_len,
+      .weights = weights,
       .pchan_from_defbase = pchan_from_defbase,
       .defbase_len = defbase_len,
       .bmesh =
@@ -32,13 +32,211 @@
 #include "BLI_math_geom.h"
 #include "BLI_threads.h"
 
+#include "BKE_armature.h"
 #include "BKE_bvhutils.h"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
 #include "BKE_mesh_runtime.h"
 #include "BKE_shrinkwrap.h"
 #include "BKE_subdiv_ccg.h"
 
+/* -------------------------------------------------------------------- */
+/** \name Mesh Topology Cache
+ *
+ * Adjacency maps which only depend on the topology of the mesh, shared by all modifiers which
+ * need them. Modifiers usually get a temporary copy of the mesh which references the topology of
+ * the evaluated object data, so the maps are stored there and kept between evaluations. When the
+ * data-block is copied-on-write again the cache is only restored when the topology is unchanged.
+ * \{ */
+
+typedef struct MeshTopologyCache {
+  /* Topology the maps were created for. */
+  const MEdge *medge;
+  const MPoly *mpoly;
+  const MLoop *mloop;
+  int totvert, totedge, totpoly, totloop;
+  /* Copy of the topology, compared with the one of the mesh the cache is restored to. */
+  uint (*edge_verts)[2];
+  int (*poly_loops)[2];
+  MLoop *loops;
+
+  MeshElemMap *maps[MESH_TOPOLOGY_MAP_TYPE_NUM];
+  int *maps_mem[MESH_TOPOLOGY_MAP_TYPE_NUM];
+} MeshTopologyCache;
+
+static void mesh_topology_copy(MeshTopologyCache *cache, const Mesh *mesh)
+{
+  cache->edge_verts = MEM_malloc_arrayN(
+      (size_t)mesh->totedge, sizeof(*cache->edge_verts), __func__);
+  for (int i = 0; i < mesh->totedge; i++) {
+    cache->edge_verts[i][0] = mesh->medge[i].v1;
+    cache->edge_verts[i][1] = mesh->medge[i].v2;
+  }
+  cache->poly_loops = MEM_malloc_arrayN(
+      (size_t)mesh->totpoly, sizeof(*cache->poly_loops), __func__);
+  for (int i = 0; i < mesh->totpoly; i++) {
+    cache->poly_loops[i][0] = mesh->mpoly[i].loopstart;
+    cache->poly_loops[i][1] = mesh->mpoly[i].totloop;
+  }
+  cache->loops = MEM_malloc_arrayN((size_t)mesh->totloop, sizeof(*cache->loops), __func__);
+  memcpy(cache->loops, mesh->mloop, sizeof(*cache->loops) * (size_t)mesh->totloop);
+}
+
+static bool mesh_topology_equals(const MeshTopologyCache *cache, const Mesh *mesh)
+{
+  if (cache->totvert != mesh->totvert || cache->totedge != mesh->totedge ||
+      cache->totpoly != mesh->totpoly || cache->totloop != mesh->totloop) {
+    return false;
+  }
+  for (int i = 0; i < mesh->totedge; i++) {
+    if (cache->edge_verts[i][0] != mesh->medge[i].v1 ||
+        cache->edge_verts[i][1] != mesh->medge[i].v2) {
+      return false;
+    }
+  }
+  for (int i = 0; i < mesh->totpoly; i++) {
+    if (cache->poly_loops[i][0] != mesh->mpoly[i].loopstart ||
+        cache->poly_loops[i][1] != mesh->mpoly[i].totloop) {
+      return false;
+    }
+  }
+  return memcmp(cache->loops, mesh->mloop, sizeof(*cache->loops) * (size_t)mesh->totloop) == 0;
+}
+
+static void mesh_topology_cache_key_set(MeshTopologyCache *cache, const Mesh *mesh)
+{
+  cache->medge = mesh->medge;
+  cache->mpoly = mesh->mpoly;
+  cache->mloop = mesh->mloop;
+  cache->totvert = mesh->totvert;
+  cache->totedge = mesh->totedge;
+  cache->totpoly = mesh->totpoly;
+  cache->totloop = mesh->totloop;
+}
+
+static bool mesh_topology_cache_matches(const MeshTopologyCache *cache, const Mesh *mesh)
+{
+  return (cache->medge == mesh->medge) && (cache->mpoly == mesh->mpoly) &&
+         (cache->mloop == mesh->mloop) && (cache->totvert == mesh->totvert) &&
+         (cache->totedge == mesh->totedge) && (cache->totpoly == mesh->totpoly) &&
+         (cache->totloop == mesh->totloop);
+}
+
+static void mesh_topology_cache_free(MeshTopologyCache *cache)
+{
+  for (int i = 0; i < MESH_TOPOLOGY_MAP_TYPE_NUM; i++) {
+    MEM_SAFE_FREE(cache->maps[i]);
+    MEM_SAFE_FREE(cache->maps_mem[i]);
+  }
+  MEM_SAFE_FREE(cache->edge_verts);
+  MEM_SAFE_FREE(cache->poly_loops);
+  MEM_SAFE_FREE(cache->loops);
+  MEM_freeN(cache);
+}
+
+static void mesh_topology_map_create(const Mesh *mesh,
+                                     const eMeshTopologyMapType type,
+                                     MeshElemMap **r_map,
+                                     int **r_mem)
+{
+  switch (type) {
+    case MESH_TOPOLOGY_MAP_VERT_EDGE:
+      BKE_mesh_vert_edge_map_create(r_map, r_mem, mesh->medge, mesh->totvert, mesh->totedge);
+      break;
+    case MESH_TOPOLOGY_MAP_VERT_POLY:
+      BKE_mesh_vert_poly_map_create(r_map,
+                                    r_mem,
+                                    mesh->mpoly,
+                                    mesh->mloop,
+                                    mesh->totvert,
+                                    mesh->totpoly,
+                                    mesh->totloop);
+      break;
+    case MESH_TOPOLOGY_MAP_VERT_LOOP:
+      BKE_mesh_vert_loop_map_create(r_map,
+                                    r_mem,
+                                    mesh->mpoly,
+                                    mesh->mloop,
+                                    mesh->totvert,
+                                    mesh->totpoly,
+                                    mesh->totloop);
+      break;
+    case MESH_TOPOLOGY_MAP_EDGE_POLY:
+      BKE_mesh_edge_poly_map_create(r_map,
+                                    r_mem,
+                                    mesh->medge,
+                                    mesh->totedge,
+                                    mesh->mpoly,
+                                    mesh->totpoly,
+                                    mesh->mloop,
+                                    mesh->totloop);
+      break;
+  }
+}
+
+/**
+ * Get an adjacency map of the mesh, created on first use and cached until the topology changes.
+ * The map is owned by the mesh and must not be freed.
+ */
+const MeshElemMap *BKE_mesh_runtime_topology_map_ensure(Mesh *mesh,
+                                                        const eMeshTopologyMapType type)
+{
+  BLI_assert(type < MESH_TOPOLOGY_MAP_TYPE_NUM);
+
+  ThreadMutex *mesh_eval_mutex = (ThreadMutex *)mesh->runtime.eval_mutex;
+  BLI_mutex_lock(mesh_eval_mutex);
+
+  MeshTopologyCache *cache = mesh->runtime.topology_cache;
+  if (cache != NULL && !mesh_topology_cache_matches(cache, mesh)) {
+    mesh_topology_cache_free(cache);
+    cache = NULL;
+  }
+  if (cache == NULL) {
+    cache = MEM_callocN(sizeof(*cache), __func__);
+    mesh_topology_cache_key_set(cache, mesh);
+    mesh_topology_copy(cache, mesh);
+    mesh->runtime.topology_cache = cache;
+  }
+  if (cache->maps[type] == NULL) {
+    mesh_topology_map_create(mesh, type, &cache->maps[type], &cache->maps_mem[type]);
+  }
+  const MeshElemMap *map = cache->maps[type];
+
+  BLI_mutex_unlock(mesh_eval_mutex);
+
+  return map;
+}
+
+/**
+ * Take the topology cache out of the mesh, so it survives the mesh being freed.
+ * Used by the dependency graph to keep the cache when the data-block is copied-on-write again.
+ */
+MeshTopologyCache *BKE_mesh_runtime_topology_cache_backup(Mesh *mesh)
+{
+  MeshTopologyCache *cache = mesh->runtime.topology_cache;
+  mesh->runtime.topology_cache = NULL;
+  return cache;
+}
+
+/**
+ * Give a cache taken with #BKE_mesh_runtime_topology_cache_backup back to the mesh, which may
+ * have been copied again in the meantime. The cache is freed when the topology has changed.
+ */
+void BKE_mesh_runtime_topology_cache_restore(Mesh *mesh, MeshTopologyCache *cache)
+{
+  BLI_assert(mesh->runtime.topology_cache == NULL);
+
+  if (!mesh_topology_equals(cache, mesh)) {
+    mesh_topology_cache_free(cache);
+    return;
+  }
+  mesh_topology_cache_key_set(cache, mesh);
+  mesh->runtime.topology_cache = cache;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Mesh Runtime Struct Utils
  * \{ */
@@ -67,6 +265,8 @@ void BKE_mesh_runtime_reset_on_copy(Mesh *mesh, const int UNUSED(flag))
   memset(&runtime->looptris, 0, sizeof(runtime->looptris));
   runtime->bvh_cache = NULL;
   runtime->shrinkwrap_data = NULL;
+  runtime->armature_deform_weights = NULL;
+  runtime->topology_cache = NULL;
 
   mesh->runtime.eval_mutex = MEM_mallocN(sizeof(ThreadMutex), "mesh runtime eval_mutex");
   BLI_mutex_init(mesh->runtime.eval_mutex);
@@ -236,6 +436,11 @@ void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
     mesh->runtime.subdiv_ccg = NULL;
   }
   BKE_shrinkwrap_discard_boundary_data(mesh);
+  BKE_armature_deform_discard_weights(mesh);
+  if (mesh->runtime.topology_cache != NULL) {
+    mesh_topology_cache_free(mesh->runtime.topology_cache);
+    mesh->runtime.topology_cache = NULL;
+  }
 }
 
 /** \} */
@@ -343,9 +343,17 @@ void BKE_object_eval_uber_transform(Depsgraph *depsgraph, Object *object)
 void BKE_object_batch_cache_dirty_tag(Object *ob)
 {
   switch (ob->type) {
-    case OB_MESH:
-      BKE_mesh_batch_cache_dirty_tag(ob->data, BKE_MESH_BATCH_DIRTY_ALL);
+    case OB_MESH: {
+      Mesh *mesh = ob->data;
+      if (mesh->runtime.batch_cache_deform_only) {
+        BKE_mesh_batch_cache_dirty_tag(mesh, BKE_MESH_BATCH_DIRTY_DEFORM);
+        mesh->runtime.batch_cache_deform_only = false;
+      }
+      else {
+        BKE_mesh_batch_cache_dirty_tag(mesh, BKE_MESH_BATCH_DIRTY_ALL);
+      }
       break;
+    }
     case OB_LATTICE:
       BKE_lattice_batch_cache_dirty_tag(ob->data, BKE_LATTICE_BATCH_DIRTY_ALL);
       break;
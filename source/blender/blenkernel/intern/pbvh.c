@@ -27,6 +27,7 @@
 #include "BLI_math.h"
 #include "BLI_rand.h"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -252,16 +253,19 @@ void pbvh_grow_nodes(PBVH *pbvh, int totnode)
 
 /* Add a vertex to the map, with a positive value for unique vertices and
  * a negative value for additional vertices */
-static int map_insert_vert(
-    PBVH *pbvh, GHash *map, unsigned int *face_verts, unsigned int *uniq_verts, int vertex)
+static int map_insert_vert(PBVH *pbvh,
+                           GHash *map,
+                           unsigned int *face_verts,
+                           unsigned int *uniq_verts,
+                           int node_index,
+                           int vertex)
 {
   void *key, **value_p;
 
   key = POINTER_FROM_INT(vertex);
   if (!BLI_ghash_ensure_p(map, key, &value_p)) {
     int value_i;
-    if (BLI_BITMAP_TEST(pbvh->vert_bitmap, vertex) == 0) {
-      BLI_BITMAP_ENABLE(pbvh->vert_bitmap, vertex);
+    if (pbvh->vert_owner[vertex] == node_index) {
       value_i = *uniq_verts;
       (*uniq_verts)++;
     }
@@ -280,6 +284,7 @@ static int map_insert_vert(
 static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
 {
   bool has_visible = false;
+  const int node_index = (int)(node - pbvh->nodes);
 
   node->uniq_verts = node->face_verts = 0;
   const int totface = node->totprim;
@@ -298,8 +303,12 @@ static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
   for (int i = 0; i < totface; i++) {
     const MLoopTri *lt = &pbvh->looptri[node->prim_indices[i]];
     for (int j = 0; j < 3; j++) {
-      face_vert_indices[i][j] = map_insert_vert(
-          pbvh, map, &node->face_verts, &node->uniq_verts, pbvh->mloop[lt->tri[j]].v);
+      face_vert_indices[i][j] = map_insert_vert(pbvh,
+                                                map,
+                                                &node->face_verts,
+                                                &node->uniq_verts,
+                                                node_index,
+                                                pbvh->mloop[lt->tri[j]].v);
     }
 
     if (has_visible == false) {
@@ -343,15 +352,6 @@ static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
   BLI_ghash_free(map, NULL, NULL);
 }
 
-static void update_vb(PBVH *pbvh, PBVHNode *node, BBC *prim_bbc, int offset, int count)
-{
-  BB_reset(&node->vb);
-  for (int i = offset + count - 1; i >= offset; i--) {
-    BB_expand_with_bb(&node->vb, (BB *)(&prim_bbc[pbvh->prim_indices[i]]));
-  }
-  node->orig_vb = node->vb;
-}
-
 /* Returns the number of visible quads in the nodes' grids. */
 int BKE_pbvh_count_grid_quads(BLI_bitmap **grid_hidden,
                               const int *grid_indices,
@@ -413,24 +413,6 @@ static void build_grid_leaf_node(PBVH *pbvh, PBVHNode *node)
   BKE_pbvh_node_mark_rebuild_draw(node);
 }
 
-static void build_leaf(PBVH *pbvh, int node_index, BBC *prim_bbc, int offset, int count)
-{
-  pbvh->nodes[node_index].flag |= PBVH_Leaf;
-
-  pbvh->nodes[node_index].prim_indices = pbvh->prim_indices + offset;
-  pbvh->nodes[node_index].totprim = count;
-
-  /* Still need vb for searches */
-  update_vb(pbvh, &pbvh->nodes[node_index], prim_bbc, offset, count);
-
-  if (pbvh->looptri) {
-    build_mesh_leaf_node(pbvh, pbvh->nodes + node_index);
-  }
-  else {
-    build_grid_leaf_node(pbvh, pbvh->nodes + node_index);
-  }
-}
-
 /* Return zero if all primitives in the node can be drawn with the
  * same material (including flat/smooth shading), non-zero otherwise */
 static bool leaf_needs_material_split(PBVH *pbvh, int offset, int count)
@@ -465,78 +447,520 @@ static bool leaf_needs_material_split(PBVH *pbvh, int offset, int count)
   return false;
 }
 
-/* Recursively build a node in the tree
+/* -------------------------------------------------------------------- */
+/** \name Tree Building
  *
- * vb is the voxel box around all of the primitives contained in
- * this node.
+ * The tree is built in three steps:
+ * - The upper levels are split on the calling thread, until the primitive ranges are small
+ *   enough to be built as independent subtrees.
+ * - Subtrees are built in parallel, each in its own node array. These are appended to the
+ *   nodes of the upper levels once done.
+ * - Leaf nodes gather their vertices and visibility in parallel.
  *
- * cb is the bounding box around all the centroids of the primitives
- * contained in this node
+ * Nodes are split with binned surface area heuristic (SAH) splits along the widest axis of the
+ * primitive centroids. Bins also store the bounds of their primitives, so the bounds of the
+ * children are known without iterating over their primitives again.
+ * \{ */
+
+/* Number of bins used to evaluate the split candidates of a node. */
+#define PBVH_BUILD_BINS 16
+/* Ranges with more primitives than this are binned by multiple threads. */
+#define PBVH_BUILD_PARALLEL_BIN_LIMIT 100000
+/* Number of subtrees built for each thread, more subtrees balance the work better. */
+#define PBVH_BUILD_SUBTREES_PER_THREAD 8
+
+/* Bounds of a range of primitives. */
+typedef struct PBVHBuildBounds {
+  /* Bounds of the primitives. */
+  BB vb;
+  /* Bounds of the primitive centroids. */
+  BB cb;
+} PBVHBuildBounds;
+
+typedef struct PBVHBuildBin {
+  PBVHBuildBounds bounds;
+  int count;
+} PBVHBuildBin;
+
+/* Nodes of a tree, or of a subtree that is built separately. */
+typedef struct PBVHBuildNodes {
+  PBVHNode *nodes;
+  int totnode;
+  int node_mem_count;
+} PBVHBuildNodes;
+
+/* Range of primitives that is built as an independent subtree. */
+typedef struct PBVHBuildSubtree {
+  /* Node of the upper levels replaced by the root of the subtree. */
+  int node_index;
+  int offset;
+  int count;
+  PBVHBuildBounds bounds;
+  bool has_bounds;
+
+  PBVHBuildNodes nodes;
+} PBVHBuildSubtree;
+
+typedef struct PBVHBuildData {
+  PBVH *pbvh;
+  const BBC *prim_bbc;
+
+  /* Ranges with no more primitives than this are deferred to subtrees,
+   * zero while building a subtree. */
+  int subtree_limit;
+  PBVHBuildSubtree *subtrees;
+  int totsubtree;
+  int subtree_mem_count;
+} PBVHBuildData;
+
+static void build_bounds_reset(PBVHBuildBounds *bounds)
+{
+  BB_reset(&bounds->vb);
+  BB_reset(&bounds->cb);
+}
+
+static void build_bounds_expand(PBVHBuildBounds *bounds, const BBC *bbc)
+{
+  BB_expand_with_bb(&bounds->vb, (BB *)bbc);
+  BB_expand(&bounds->cb, bbc->bcentroid);
+}
+
+static void build_bounds_expand_with_bounds(PBVHBuildBounds *bounds, PBVHBuildBounds *other)
+{
+  BB_expand_with_bb(&bounds->vb, &other->vb);
+  BB_expand_with_bb(&bounds->cb, &other->cb);
+}
+
+static void build_bounds_calc(PBVH *pbvh,
+                              const BBC *prim_bbc,
+                              int offset,
+                              int count,
+                              PBVHBuildBounds *r_bounds)
+{
+  build_bounds_reset(r_bounds);
+  for (int i = offset + count - 1; i >= offset; i--) {
+    build_bounds_expand(r_bounds, &prim_bbc[pbvh->prim_indices[i]]);
+  }
+}
+
+/* Half of the surface area of the bounding box, used as the cost of a split candidate. */
+static float build_bb_half_area(const BB *bb)
+{
+  const float x = bb->bmax[0] - bb->bmin[0];
+  const float y = bb->bmax[1] - bb->bmin[1];
+  const float z = bb->bmax[2] - bb->bmin[2];
+  return x * y + y * z + z * x;
+}
+
+static int build_nodes_add(PBVHBuildNodes *storage, int totnode)
+{
+  const int offset = storage->totnode;
+  if (offset + totnode > storage->node_mem_count) {
+    storage->node_mem_count = max_ii(offset + totnode, storage->node_mem_count * 2);
+    storage->nodes = MEM_recallocN(storage->nodes, sizeof(PBVHNode) * storage->node_mem_count);
+  }
+  storage->totnode += totnode;
+  return offset;
+}
+
+typedef struct PBVHBuildBinData {
+  const int *prim_indices;
+  const BBC *prim_bbc;
+  int axis;
+  float min;
+  float scale;
+} PBVHBuildBinData;
+
+BLI_INLINE int build_bin_index(const PBVHBuildBinData *data, const BBC *bbc)
+{
+  const int bin = (int)((bbc->bcentroid[data->axis] - data->min) * data->scale);
+  return clamp_i(bin, 0, PBVH_BUILD_BINS - 1);
+}
+
+static void build_bins_task_cb(void *__restrict userdata,
+                               const int i,
+                               const TaskParallelTLS *__restrict tls)
+{
+  const PBVHBuildBinData *data = userdata;
+  PBVHBuildBin *bins = tls->userdata_chunk;
+  const BBC *bbc = &data->prim_bbc[data->prim_indices[i]];
+  PBVHBuildBin *bin = &bins[build_bin_index(data, bbc)];
+
+  build_bounds_expand(&bin->bounds, bbc);
+  bin->count++;
+}
+
+static void build_bins_reduce(const void *__restrict UNUSED(userdata),
+                              void *__restrict chunk_join,
+                              void *__restrict chunk)
+{
+  PBVHBuildBin *bins_join = chunk_join;
+  PBVHBuildBin *bins = chunk;
+
+  for (int i = 0; i < PBVH_BUILD_BINS; i++) {
+    build_bounds_expand_with_bounds(&bins_join[i].bounds, &bins[i].bounds);
+    bins_join[i].count += bins[i].count;
+  }
+}
+
+/* Returns the index of the first element on the right of the partition */
+static int partition_indices_bin(
+    int *prim_indices, int lo, int hi, const PBVHBuildBinData *data, int split_bin)
+{
+  const BBC *prim_bbc = data->prim_bbc;
+  int i = lo, j = hi;
+  for (;;) {
+    for (; i <= hi && build_bin_index(data, &prim_bbc[prim_indices[i]]) <= split_bin; i++) {
+      /* pass */
+    }
+    for (; j >= lo && build_bin_index(data, &prim_bbc[prim_indices[j]]) > split_bin; j--) {
+      /* pass */
+    }
+
+    if (!(i < j)) {
+      return i;
+    }
+
+    SWAP(int, prim_indices[i], prim_indices[j]);
+    i++;
+    j--;
+  }
+}
+
+/**
+ * Partition the primitives with the binned split of lowest cost.
+ *
+ * \return The index of the first primitive on the right of the partition, or -1 when no split
+ * was found, for example when all primitive centroids are at the same location.
+ */
+static int partition_indices_binned(PBVHBuildData *data,
+                                    int offset,
+                                    int count,
+                                    const PBVHBuildBounds *bounds,
+                                    PBVHBuildBounds r_child_bounds[2])
+{
+  PBVH *pbvh = data->pbvh;
+  const BB *cb = &bounds->cb;
+  const int axis = BB_widest_axis(cb);
+  const float extent = cb->bmax[axis] - cb->bmin[axis];
+
+  if (!(extent > 0.0f)) {
+    return -1;
+  }
+
+  PBVHBuildBinData bin_data = {
+      .prim_indices = pbvh->prim_indices,
+      .prim_bbc = data->prim_bbc,
+      .axis = axis,
+      .min = cb->bmin[axis],
+      .scale = (float)PBVH_BUILD_BINS / extent,
+  };
+
+  PBVHBuildBin bins[PBVH_BUILD_BINS];
+  for (int i = 0; i < PBVH_BUILD_BINS; i++) {
+    build_bounds_reset(&bins[i].bounds);
+    bins[i].count = 0;
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = count > PBVH_BUILD_PARALLEL_BIN_LIMIT;
+  settings.min_iter_per_thread = PBVH_BUILD_PARALLEL_BIN_LIMIT / 8;
+  settings.userdata_chunk = bins;
+  settings.userdata_chunk_size = sizeof(bins);
+  settings.func_reduce = build_bins_reduce;
+  BLI_task_parallel_range(offset, offset + count, &bin_data, build_bins_task_cb, &settings);
+
+  /* Accumulate the bins from the right, so the cost of each split is known in a single sweep
+   * from the left. */
+  float right_area[PBVH_BUILD_BINS];
+  int right_count[PBVH_BUILD_BINS];
+  PBVHBuildBounds accum;
+  build_bounds_reset(&accum);
+  int accum_count = 0;
+  for (int i = PBVH_BUILD_BINS - 1; i > 0; i--) {
+    if (bins[i].count) {
+      build_bounds_expand_with_bounds(&accum, &bins[i].bounds);
+      accum_count += bins[i].count;
+    }
+    right_area[i] = accum_count ? build_bb_half_area(&accum.vb) : 0.0f;
+    right_count[i] = accum_count;
+  }
+
+  /* Avoid splits that only cut off a sliver of the primitives, these add nodes without making
+   * the tree any shallower. */
+  const int min_count = max_ii(count / PBVH_BUILD_BINS, 1);
+  float best_cost = FLT_MAX;
+  int best_bin = -1;
+
+  build_bounds_reset(&accum);
+  accum_count = 0;
+  for (int i = 0; i < PBVH_BUILD_BINS - 1; i++) {
+    if (bins[i].count) {
+      build_bounds_expand_with_bounds(&accum, &bins[i].bounds);
+      accum_count += bins[i].count;
+    }
+    if (accum_count < min_count || right_count[i + 1] < min_count) {
+      continue;
+    }
+    const float cost = build_bb_half_area(&accum.vb) * accum_count +
+                       right_area[i + 1] * right_count[i + 1];
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_bin = i;
+    }
+  }
+
+  if (best_bin == -1) {
+    return -1;
+  }
+
+  build_bounds_reset(&r_child_bounds[0]);
+  build_bounds_reset(&r_child_bounds[1]);
+  for (int i = 0; i < PBVH_BUILD_BINS; i++) {
+    if (bins[i].count) {
+      build_bounds_expand_with_bounds(&r_child_bounds[(i <= best_bin) ? 0 : 1], &bins[i].bounds);
+    }
+  }
+
+  return partition_indices_bin(
+      pbvh->prim_indices, offset, offset + count - 1, &bin_data, best_bin);
+}
+
+static void build_subtree_defer(PBVHBuildData *data,
+                                int node_index,
+                                const PBVHBuildBounds *bounds,
+                                int offset,
+                                int count)
+{
+  if (data->totsubtree == data->subtree_mem_count) {
+    data->subtree_mem_count = max_ii(data->subtree_mem_count * 2, 64);
+    data->subtrees = MEM_recallocN(data->subtrees,
+                                   sizeof(PBVHBuildSubtree) * data->subtree_mem_count);
+  }
+
+  PBVHBuildSubtree *subtree = &data->subtrees[data->totsubtree++];
+  subtree->node_index = node_index;
+  subtree->offset = offset;
+  subtree->count = count;
+  subtree->has_bounds = (bounds != NULL);
+  if (bounds) {
+    subtree->bounds = *bounds;
+  }
+}
+
+/* Recursively build a node in the tree
+ *
+ * bounds are the bounds of the primitives contained in this node and of their centroids,
+ * or NULL when they still have to be calculated.
  *
  * offset and start indicate a range in the array of primitive indices
  */
 
-static void build_sub(PBVH *pbvh, int node_index, BB *cb, BBC *prim_bbc, int offset, int count)
+static void build_sub(PBVHBuildData *data,
+                      PBVHBuildNodes *storage,
+                      int node_index,
+                      const PBVHBuildBounds *bounds,
+                      int offset,
+                      int count)
 {
+  PBVH *pbvh = data->pbvh;
+  PBVHBuildBounds bounds_backing;
+  PBVHBuildBounds child_bounds[2];
+  bool has_child_bounds = false;
   int end;
-  BB cb_backing;
+
+  if (count <= data->subtree_limit) {
+    build_subtree_defer(data, node_index, bounds, offset, count);
+    return;
+  }
+
+  if (!bounds) {
+    build_bounds_calc(pbvh, data->prim_bbc, offset, count, &bounds_backing);
+    bounds = &bounds_backing;
+  }
+
+  /* Update node bounding box, leaves still need it for searches */
+  PBVHNode *node = &storage->nodes[node_index];
+  node->vb = bounds->vb;
+  node->orig_vb = bounds->vb;
 
   /* Decide whether this is a leaf or not */
   const bool below_leaf_limit = count <= pbvh->leaf_limit;
   if (below_leaf_limit) {
     if (!leaf_needs_material_split(pbvh, offset, count)) {
-      build_leaf(pbvh, node_index, prim_bbc, offset, count);
+      /* Vertices and draw buffers are handled once the whole tree is built. */
+      node->flag |= PBVH_Leaf;
+      node->prim_indices = pbvh->prim_indices + offset;
+      node->totprim = count;
       return;
     }
   }
 
-  /* Add two child nodes */
-  pbvh->nodes[node_index].children_offset = pbvh->totnode;
-  pbvh_grow_nodes(pbvh, pbvh->totnode + 2);
-
-  /* Update parent node bounding box */
-  update_vb(pbvh, &pbvh->nodes[node_index], prim_bbc, offset, count);
-
   if (!below_leaf_limit) {
-    /* Find axis with widest range of primitive centroids */
-    if (!cb) {
-      cb = &cb_backing;
-      BB_reset(cb);
-      for (int i = offset + count - 1; i >= offset; i--) {
-        BB_expand(cb, prim_bbc[pbvh->prim_indices[i]].bcentroid);
-      }
+    end = partition_indices_binned(data, offset, count, bounds, child_bounds);
+    if (end != -1) {
+      has_child_bounds = true;
+    }
+    else {
+      /* Partition primitives at the middle of the axis with widest range of centroids */
+      const int axis = BB_widest_axis(&bounds->cb);
+      end = partition_indices(pbvh->prim_indices,
+                              offset,
+                              offset + count - 1,
+                              axis,
+                              (bounds->cb.bmax[axis] + bounds->cb.bmin[axis]) * 0.5f,
+                              (BBC *)data->prim_bbc);
     }
-    const int axis = BB_widest_axis(cb);
-
-    /* Partition primitives along that axis */
-    end = partition_indices(pbvh->prim_indices,
-                            offset,
-                            offset + count - 1,
-                            axis,
-                            (cb->bmax[axis] + cb->bmin[axis]) * 0.5f,
-                            prim_bbc);
   }
   else {
     /* Partition primitives by material */
     end = partition_indices_material(pbvh, offset, offset + count - 1);
   }
 
+  /* Add two child nodes, this may reallocate the nodes. */
+  const int children_offset = build_nodes_add(storage, 2);
+  storage->nodes[node_index].children_offset = children_offset;
+
   /* Build children */
-  build_sub(pbvh, pbvh->nodes[node_index].children_offset, NULL, prim_bbc, offset, end - offset);
-  build_sub(pbvh,
-            pbvh->nodes[node_index].children_offset + 1,
-            NULL,
-            prim_bbc,
+  build_sub(data,
+            storage,
+            children_offset,
+            has_child_bounds ? &child_bounds[0] : NULL,
+            offset,
+            end - offset);
+  build_sub(data,
+            storage,
+            children_offset + 1,
+            has_child_bounds ? &child_bounds[1] : NULL,
             end,
             offset + count - end);
 }
 
-static void pbvh_build(PBVH *pbvh, BB *cb, BBC *prim_bbc, int totprim)
+static void build_subtree_task_cb(void *__restrict userdata,
+                                  const int n,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHBuildData *data = userdata;
+  PBVHBuildSubtree *subtree = &data->subtrees[n];
+
+  /* Subtrees are built completely, without deferring ranges again. */
+  PBVHBuildData subtree_data = {
+      .pbvh = data->pbvh,
+      .prim_bbc = data->prim_bbc,
+  };
+
+  build_nodes_add(&subtree->nodes, 1);
+  build_sub(&subtree_data,
+            &subtree->nodes,
+            0,
+            subtree->has_bounds ? &subtree->bounds : NULL,
+            subtree->offset,
+            subtree->count);
+}
+
+/* Copy the nodes of a subtree, its root replaces the deferred node and its other nodes are
+ * appended at the given offset. */
+static void build_subtree_copy(PBVH *pbvh, const PBVHBuildSubtree *subtree, int offset)
+{
+  const PBVHBuildNodes *storage = &subtree->nodes;
+
+  for (int i = 0; i < storage->totnode; i++) {
+    PBVHNode *node = (i == 0) ? &pbvh->nodes[subtree->node_index] :
+                                &pbvh->nodes[offset + i - 1];
+    *node = storage->nodes[i];
+    if (!(node->flag & PBVH_Leaf)) {
+      node->children_offset += offset - 1;
+    }
+  }
+}
+
+typedef struct PBVHBuildLeafData {
+  PBVH *pbvh;
+  const int *leaves;
+} PBVHBuildLeafData;
+
+/* Lowest leaf index wins, so vertex ownership doesn't depend on the order leaves are built in. */
+static void build_vert_owner_claim(int *owner, int node_index)
+{
+  int old = *owner;
+  while (old > node_index) {
+    const int prev = atomic_cas_int32(owner, old, node_index);
+    if (prev == old) {
+      break;
+    }
+    old = prev;
+  }
+}
+
+static void build_vert_owner_task_cb(void *__restrict userdata,
+                                     const int n,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHBuildLeafData *data = userdata;
+  PBVH *pbvh = data->pbvh;
+  const int node_index = data->leaves[n];
+  const PBVHNode *node = &pbvh->nodes[node_index];
+  const int totface = node->totprim;
+
+  for (int i = 0; i < totface; i++) {
+    const MLoopTri *lt = &pbvh->looptri[node->prim_indices[i]];
+    for (int j = 0; j < 3; j++) {
+      build_vert_owner_claim(&pbvh->vert_owner[pbvh->mloop[lt->tri[j]].v], node_index);
+    }
+  }
+}
+
+static void build_leaf_task_cb(void *__restrict userdata,
+                               const int n,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHBuildLeafData *data = userdata;
+  PBVH *pbvh = data->pbvh;
+  PBVHNode *node = &pbvh->nodes[data->leaves[n]];
+
+  if (pbvh->looptri) {
+    build_mesh_leaf_node(pbvh, node);
+  }
+  else {
+    build_grid_leaf_node(pbvh, node);
+  }
+}
+
+static void build_leaves(PBVH *pbvh)
+{
+  int *leaves = MEM_mallocN(sizeof(int) * pbvh->totnode, __func__);
+  int totleaf = 0;
+  for (int i = 0; i < pbvh->totnode; i++) {
+    if (pbvh->nodes[i].flag & PBVH_Leaf) {
+      leaves[totleaf++] = i;
+    }
+  }
+
+  PBVHBuildLeafData data = {
+      .pbvh = pbvh,
+      .leaves = leaves,
+  };
+
+  TaskParallelSettings settings;
+  BKE_pbvh_parallel_range_settings(&settings, true, totleaf);
+
+  if (pbvh->looptri) {
+    BLI_task_parallel_range(0, totleaf, &data, build_vert_owner_task_cb, &settings);
+  }
+  BLI_task_parallel_range(0, totleaf, &data, build_leaf_task_cb, &settings);
+
+  MEM_freeN(leaves);
+}
+
+static void pbvh_build(PBVH *pbvh, const PBVHBuildBounds *bounds, const BBC *prim_bbc, int totprim)
 {
   if (totprim != pbvh->totprim) {
     pbvh->totprim = totprim;
     if (pbvh->nodes) {
       MEM_freeN(pbvh->nodes);
+      pbvh->nodes = NULL;
+      pbvh->node_mem_count = 0;
     }
     if (pbvh->prim_indices) {
       MEM_freeN(pbvh->prim_indices);
@@ -545,17 +969,123 @@ static void pbvh_build(PBVH *pbvh, BB *cb, BBC *prim_bbc, int totprim)
     for (int i = 0; i < totprim; i++) {
       pbvh->prim_indices[i] = i;
     }
-    pbvh->totnode = 0;
-    if (pbvh->node_mem_count < 100) {
-      pbvh->node_mem_count = 100;
-      pbvh->nodes = MEM_callocN(sizeof(PBVHNode) * pbvh->node_mem_count, "bvh initial nodes");
-    }
   }
 
-  pbvh->totnode = 1;
-  build_sub(pbvh, 0, cb, prim_bbc, 0, totprim);
+  PBVHBuildData data = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+      .subtree_limit = max_ii(
+          totprim / (BLI_system_thread_count() * PBVH_BUILD_SUBTREES_PER_THREAD),
+          pbvh->leaf_limit),
+  };
+
+  /* Split the upper levels, deferring smaller ranges to subtrees. */
+  PBVHBuildNodes storage = {NULL};
+  build_nodes_add(&storage, 1);
+  build_sub(&data, &storage, 0, bounds, 0, totprim);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = data.totsubtree > 1;
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, data.totsubtree, &data, build_subtree_task_cb, &settings);
+
+  int totnode = storage.totnode;
+  for (int i = 0; i < data.totsubtree; i++) {
+    totnode += data.subtrees[i].nodes.totnode - 1;
+  }
+
+  pbvh->totnode = 0;
+  pbvh_grow_nodes(pbvh, totnode);
+  memcpy(pbvh->nodes, storage.nodes, sizeof(PBVHNode) * storage.totnode);
+  MEM_freeN(storage.nodes);
+
+  int offset = storage.totnode;
+  for (int i = 0; i < data.totsubtree; i++) {
+    PBVHBuildSubtree *subtree = &data.subtrees[i];
+    build_subtree_copy(pbvh, subtree, offset);
+    offset += subtree->nodes.totnode - 1;
+    MEM_freeN(subtree->nodes.nodes);
+  }
+  MEM_SAFE_FREE(data.subtrees);
+
+  build_leaves(pbvh);
+}
+
+typedef struct PBVHBuildPrimData {
+  PBVH *pbvh;
+  BBC *prim_bbc;
+  CCGElem **grids;
+  const CCGKey *key;
+} PBVHBuildPrimData;
+
+static void build_prim_bounds_reduce(const void *__restrict UNUSED(userdata),
+                                     void *__restrict chunk_join,
+                                     void *__restrict chunk)
+{
+  build_bounds_expand_with_bounds(chunk_join, chunk);
+}
+
+static void build_looptri_bounds_task_cb(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict tls)
+{
+  PBVHBuildPrimData *data = userdata;
+  PBVH *pbvh = data->pbvh;
+  const MLoopTri *lt = &pbvh->looptri[i];
+  const int sides = 3;
+  BBC *bbc = data->prim_bbc + i;
+
+  BB_reset((BB *)bbc);
+
+  for (int j = 0; j < sides; j++) {
+    BB_expand((BB *)bbc, pbvh->verts[pbvh->mloop[lt->tri[j]].v].co);
+  }
+
+  BBC_update_centroid(bbc);
+
+  build_bounds_expand(tls->userdata_chunk, bbc);
+}
+
+static void build_grid_bounds_task_cb(void *__restrict userdata,
+                                      const int i,
+                                      const TaskParallelTLS *__restrict tls)
+{
+  PBVHBuildPrimData *data = userdata;
+  const CCGKey *key = data->key;
+  CCGElem *grid = data->grids[i];
+  BBC *bbc = data->prim_bbc + i;
+
+  BB_reset((BB *)bbc);
+
+  for (int j = 0; j < key->grid_area; j++) {
+    BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
+  }
+
+  BBC_update_centroid(bbc);
+
+  build_bounds_expand(tls->userdata_chunk, bbc);
 }
 
+/* For each primitive, store the AABB and the AABB centroid */
+static void build_prim_bounds(PBVHBuildPrimData *data,
+                              TaskParallelRangeFunc func,
+                              int totprim,
+                              PBVHBuildBounds *r_bounds)
+{
+  build_bounds_reset(r_bounds);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  settings.userdata_chunk = r_bounds;
+  settings.userdata_chunk_size = sizeof(*r_bounds);
+  settings.func_reduce = build_prim_bounds_reduce;
+  BLI_task_parallel_range(0, totprim, data, func, &settings);
+}
+
+/** \} */
+
 /**
  * Do a full rebuild with on Mesh data structure.
  *
@@ -574,16 +1104,12 @@ void BKE_pbvh_build_mesh(PBVH *pbvh,
                          const MLoopTri *looptri,
                          int looptri_num)
 {
-  BBC *prim_bbc = NULL;
-  BB cb;
-
   pbvh->mesh = mesh;
   pbvh->type = PBVH_FACES;
   pbvh->mpoly = mpoly;
   pbvh->mloop = mloop;
   pbvh->looptri = looptri;
   pbvh->verts = verts;
-  pbvh->vert_bitmap = BLI_BITMAP_NEW(totvert, "bvh->vert_bitmap");
   pbvh->totvert = totvert;
   pbvh->leaf_limit = LEAF_LIMIT;
   pbvh->vdata = vdata;
@@ -593,33 +1119,26 @@ void BKE_pbvh_build_mesh(PBVH *pbvh,
   pbvh->face_sets_color_seed = mesh->face_sets_color_seed;
   pbvh->face_sets_color_default = mesh->face_sets_color_default;
 
-  BB_reset(&cb);
+  pbvh->vert_owner = MEM_mallocN(sizeof(int) * totvert, "bvh->vert_owner");
+  copy_vn_i(pbvh->vert_owner, totvert, INT_MAX);
 
   /* For each face, store the AABB and the AABB centroid */
-  prim_bbc = MEM_mallocN(sizeof(BBC) * looptri_num, "prim_bbc");
+  BBC *prim_bbc = MEM_mallocN(sizeof(BBC) * looptri_num, "prim_bbc");
 
-  for (int i = 0; i < looptri_num; i++) {
-    const MLoopTri *lt = &looptri[i];
-    const int sides = 3;
-    BBC *bbc = prim_bbc + i;
-
-    BB_reset((BB *)bbc);
-
-    for (int j = 0; j < sides; j++) {
-      BB_expand((BB *)bbc, verts[pbvh->mloop[lt->tri[j]].v].co);
-    }
-
-    BBC_update_centroid(bbc);
-
-    BB_expand(&cb, bbc->bcentroid);
-  }
+  PBVHBuildPrimData data = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+  };
+  PBVHBuildBounds bounds;
+  build_prim_bounds(&data, build_looptri_bounds_task_cb, looptri_num, &bounds);
 
   if (looptri_num) {
-    pbvh_build(pbvh, &cb, prim_bbc, looptri_num);
+    pbvh_build(pbvh, &bounds, prim_bbc, looptri_num);
   }
 
   MEM_freeN(prim_bbc);
-  MEM_freeN(pbvh->vert_bitmap);
+  MEM_freeN(pbvh->vert_owner);
+  pbvh->vert_owner = NULL;
 }
 
 /* Do a full rebuild with on Grids data structure */
@@ -642,29 +1161,20 @@ void BKE_pbvh_build_grids(PBVH *pbvh,
   pbvh->grid_hidden = grid_hidden;
   pbvh->leaf_limit = max_ii(LEAF_LIMIT / (gridsize * gridsize), 1);
 
-  BB cb;
-  BB_reset(&cb);
-
   /* For each grid, store the AABB and the AABB centroid */
   BBC *prim_bbc = MEM_mallocN(sizeof(BBC) * totgrid, "prim_bbc");
 
-  for (int i = 0; i < totgrid; i++) {
-    CCGElem *grid = grids[i];
-    BBC *bbc = prim_bbc + i;
-
-    BB_reset((BB *)bbc);
-
-    for (int j = 0; j < gridsize * gridsize; j++) {
-      BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
-    }
-
-    BBC_update_centroid(bbc);
-
-    BB_expand(&cb, bbc->bcentroid);
-  }
+  PBVHBuildPrimData data = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+      .grids = grids,
+      .key = key,
+  };
+  PBVHBuildBounds bounds;
+  build_prim_bounds(&data, build_grid_bounds_task_cb, totgrid, &bounds);
 
   if (totgrid) {
-    pbvh_build(pbvh, &cb, prim_bbc, totgrid);
+    pbvh_build(pbvh, &bounds, prim_bbc, totgrid);
   }
 
   MEM_freeN(prim_bbc);
@@ -1013,6 +1523,9 @@ typedef struct PBVHUpdateData {
   int totnode;
 
   float (*vnors)[3];
+  /* Normals accumulated by each node, indexed like its vert_indices. */
+  float (*node_vnors)[3];
+  const int *node_vnors_offset;
   int flag;
   bool show_sculpt_face_sets;
 } PBVHUpdateData;
@@ -1028,6 +1541,7 @@ static void pbvh_update_normals_accum_task_cb(void *__restrict userdata,
   float(*vnors)[3] = data->vnors;
 
   if ((node->flag & PBVH_UpdateNormals)) {
+    float(*node_vnors)[3] = data->node_vnors + data->node_vnors_offset[n];
     unsigned int mpoly_prev = UINT_MAX;
     float fn[3];
 
@@ -1054,13 +1568,52 @@ static void pbvh_update_normals_accum_task_cb(void *__restrict userdata,
         const int v = vtri[j];
 
         if (pbvh->verts[v].flag & ME_VERT_PBVH_UPDATE) {
-          /* Note: This avoids `lock, add_v3_v3, unlock`
-           * and is five to ten times quicker than a spin-lock.
-           * Not exact equivalent though, since atomicity is only ensured for one component
-           * of the vector at a time, but here it shall not make any sensible difference. */
-          for (int k = 3; k--;) {
-            atomic_add_and_fetch_fl(&vnors[v][k], fn[k]);
-          }
+          /* No atomics necessary, the sums are local to this node. */
+          add_v3_v3(node_vnors[node->face_vert_indices[i][j]], fn);
+        }
+      }
+    }
+
+    /* Only this node stores the unique vertices, other nodes add their sums
+     * for these vertices once all nodes are done. */
+    const int *verts = node->vert_indices;
+    const int totvert = node->uniq_verts;
+
+    for (int i = 0; i < totvert; i++) {
+      const int v = verts[i];
+      if (pbvh->verts[v].flag & ME_VERT_PBVH_UPDATE) {
+        copy_v3_v3(vnors[v], node_vnors[i]);
+      }
+    }
+  }
+}
+
+static void pbvh_update_normals_border_task_cb(void *__restrict userdata,
+                                               const int n,
+                                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHUpdateData *data = userdata;
+
+  PBVH *pbvh = data->pbvh;
+  PBVHNode *node = data->nodes[n];
+  float(*vnors)[3] = data->vnors;
+
+  if ((node->flag & PBVH_UpdateNormals)) {
+    const float(*node_vnors)[3] = data->node_vnors + data->node_vnors_offset[n];
+    const int *verts = node->vert_indices;
+    const int totvert = node->uniq_verts + node->face_verts;
+
+    /* Vertices on the border of the node, stored by another node. */
+    for (int i = node->uniq_verts; i < totvert; i++) {
+      const int v = verts[i];
+
+      if (pbvh->verts[v].flag & ME_VERT_PBVH_UPDATE) {
+        /* Note: This avoids `lock, add_v3_v3, unlock`
+         * and is five to ten times quicker than a spin-lock.
+         * Not exact equivalent though, since atomicity is only ensured for one component
+         * of the vector at a time, but here it shall not make any sensible difference. */
+        for (int k = 3; k--;) {
+          atomic_add_and_fetch_fl(&vnors[v][k], node_vnors[i][k]);
         }
       }
     }
@@ -1099,9 +1652,21 @@ static void pbvh_update_normals_store_task_cb(void *__restrict userdata,
 
 static void pbvh_faces_update_normals(PBVH *pbvh, PBVHNode **nodes, int totnode)
 {
-  /* could be per node to save some memory, but also means
-   * we have to store for each vertex which node it is in */
-  float(*vnors)[3] = MEM_callocN(sizeof(*vnors) * pbvh->totvert, __func__);
+  /* Not initialized, updated vertices are always stored by the node that has them as unique
+   * vertices before other nodes add to them. */
+  float(*vnors)[3] = MEM_mallocN(sizeof(*vnors) * pbvh->totvert, __func__);
+
+  /* Nodes accumulate normals without atomics, only vertices shared with other nodes are
+   * reduced in a separate pass. */
+  int *node_vnors_offset = MEM_mallocN(sizeof(int) * totnode, __func__);
+  int tot_node_vnors = 0;
+  for (int n = 0; n < totnode; n++) {
+    node_vnors_offset[n] = tot_node_vnors;
+    if (nodes[n]->flag & PBVH_UpdateNormals) {
+      tot_node_vnors += nodes[n]->uniq_verts + nodes[n]->face_verts;
+    }
+  }
+  float(*node_vnors)[3] = MEM_callocN(sizeof(*node_vnors) * tot_node_vnors, __func__);
 
   /* subtle assumptions:
    * - We know that for all edited vertices, the nodes with faces
@@ -1117,14 +1682,19 @@ static void pbvh_faces_update_normals(PBVH *pbvh, PBVHNode **nodes, int totnode)
       .pbvh = pbvh,
       .nodes = nodes,
       .vnors = vnors,
+      .node_vnors = node_vnors,
+      .node_vnors_offset = node_vnors_offset,
   };
 
   TaskParallelSettings settings;
   BKE_pbvh_parallel_range_settings(&settings, true, totnode);
 
   BLI_task_parallel_range(0, totnode, &data, pbvh_update_normals_accum_task_cb, &settings);
+  BLI_task_parallel_range(0, totnode, &data, pbvh_update_normals_border_task_cb, &settings);
   BLI_task_parallel_range(0, totnode, &data, pbvh_update_normals_store_task_cb, &settings);
 
+  MEM_freeN(node_vnors);
+  MEM_freeN(node_vnors_offset);
   MEM_freeN(vnors);
 }
 
@@ -152,7 +152,8 @@ struct PBVH {
 
   /* Only used during BVH build and update,
    * don't need to remain valid after */
-  BLI_bitmap *vert_bitmap;
+  /* Index of the leaf node that stores each vertex as one of its unique vertices. */
+  int *vert_owner;
 
 #ifdef PERFCNTRS
   int perf_modified;
@@ -35,6 +35,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "opensubdiv_capi_type.h"
 #include "opensubdiv_evaluator_capi.h"
 #include "opensubdiv_topology_refiner_capi.h"
 
@@ -80,8 +81,12 @@ static void set_coarse_positions(Subdiv *subdiv,
       BLI_BITMAP_ENABLE(vertex_used_map, loop->v);
     }
   }
-  for (int vertex_index = 0, manifold_vertex_index = 0; vertex_index < mesh->totvert;
-       vertex_index++) {
+  /* Gather coordinates of manifold vertices, so they are passed to the evaluator at once
+   * instead of one vertex at a time. */
+  float(*manifold_vertex_cos)[3] = MEM_malloc_arrayN(
+      mesh->totvert, sizeof(*manifold_vertex_cos), "manifold vertex cos");
+  int num_manifold_vertices = 0;
+  for (int vertex_index = 0; vertex_index < mesh->totvert; vertex_index++) {
     if (!BLI_BITMAP_TEST_BOOL(vertex_used_map, vertex_index)) {
       continue;
     }
@@ -93,9 +98,12 @@ static void set_coarse_positions(Subdiv *subdiv,
       const MVert *vertex = &mvert[vertex_index];
       vertex_co = vertex->co;
     }
-    subdiv->evaluator->setCoarsePositions(subdiv->evaluator, vertex_co, manifold_vertex_index, 1);
-    manifold_vertex_index++;
+    copy_v3_v3(manifold_vertex_cos[num_manifold_vertices], vertex_co);
+    num_manifold_vertices++;
   }
+  subdiv->evaluator->setCoarsePositions(
+      subdiv->evaluator, &manifold_vertex_cos[0][0], 0, num_manifold_vertices);
+  MEM_freeN(manifold_vertex_cos);
   MEM_freeN(vertex_used_map);
 }
 
@@ -168,13 +176,17 @@ void BKE_subdiv_eval_init_displacement(Subdiv *subdiv)
 
 /* ========================== Single point queries ========================== */
 
-void BKE_subdiv_eval_limit_point(
-    Subdiv *subdiv, const int ptex_face_index, const float u, const float v, float r_P[3])
-{
-  BKE_subdiv_eval_limit_point_and_derivatives(subdiv, ptex_face_index, u, v, r_P, NULL, NULL);
-}
-
-void BKE_subdiv_eval_limit_point_and_derivatives(Subdiv *subdiv,
+/* NOTE: In a very rare occasions derivatives are evaluated to zeros or are exactly equal.
+ * This happens, for example, in single vertex on Suzannne's nose (where two quads have 2 common
+ * edges).
+ *
+ * This makes tangent space displacement (such as multires) impossible to be used in those
+ * vertices, so those needs to be addressed in one way or another.
+ *
+ * Simplest thing to do: step inside of the face a little bit, where there is known patch at
+ * which there must be proper derivatives. This might break continuity of normals, but is better
+ * that giving totally unusable derivatives. */
+static void subdiv_eval_ensure_valid_derivatives(Subdiv *subdiv,
                                                  const int ptex_face_index,
                                                  const float u,
                                                  const float v,
@@ -182,19 +194,6 @@ void BKE_subdiv_eval_limit_point_and_derivatives(Subdiv *subdiv,
                                                  float r_dPdu[3],
                                                  float r_dPdv[3])
 {
-  subdiv->evaluator->evaluateLimit(subdiv->evaluator, ptex_face_index, u, v, r_P, r_dPdu, r_dPdv);
-
-  /* NOTE: In a very rare occasions derivatives are evaluated to zeros or are exactly equal.
-   * This happens, for example, in single vertex on Suzannne's nose (where two quads have 2 common
-   * edges).
-   *
-   * This makes tangent space displacement (such as multires) impossible to be used in those
-   * vertices, so those needs to be addressed in one way or another.
-   *
-   * Simplest thing to do: step inside of the face a little bit, where there is known patch at
-   * which there must be proper derivatives. This might break continuity of normals, but is better
-   * that giving totally unusable derivatives. */
-
   if (r_dPdu != NULL && r_dPdv != NULL) {
     if ((is_zero_v3(r_dPdu) || is_zero_v3(r_dPdv)) || equals_v3v3(r_dPdu, r_dPdv)) {
       subdiv->evaluator->evaluateLimit(subdiv->evaluator,
@@ -208,6 +207,24 @@ void BKE_subdiv_eval_limit_point_and_derivatives(Subdiv *subdiv,
   }
 }
 
+void BKE_subdiv_eval_limit_point(
+    Subdiv *subdiv, const int ptex_face_index, const float u, const float v, float r_P[3])
+{
+  BKE_subdiv_eval_limit_point_and_derivatives(subdiv, ptex_face_index, u, v, r_P, NULL, NULL);
+}
+
+void BKE_subdiv_eval_limit_point_and_derivatives(Subdiv *subdiv,
+                                                 const int ptex_face_index,
+                                                 const float u,
+                                                 const float v,
+                                                 float r_P[3],
+                                                 float r_dPdu[3],
+                                                 float r_dPdv[3])
+{
+  subdiv->evaluator->evaluateLimit(subdiv->evaluator, ptex_face_index, u, v, r_P, r_dPdu, r_dPdv);
+  subdiv_eval_ensure_valid_derivatives(subdiv, ptex_face_index, u, v, r_P, r_dPdu, r_dPdv);
+}
+
 void BKE_subdiv_eval_limit_point_and_normal(Subdiv *subdiv,
                                             const int ptex_face_index,
                                             const float u,
@@ -233,6 +250,36 @@ void BKE_subdiv_eval_limit_point_and_short_normal(Subdiv *subdiv,
   normal_float_to_short_v3(r_N, N_float);
 }
 
+/* ============================ Batched queries ============================= */
+
+void BKE_subdiv_eval_limit_points_and_derivatives(Subdiv *subdiv,
+                                                  const OpenSubdiv_PatchCoord *patch_coords,
+                                                  const int num_patch_coords,
+                                                  float (*r_P)[3],
+                                                  float (*r_dPdu)[3],
+                                                  float (*r_dPdv)[3])
+{
+  subdiv->evaluator->evaluatePatchesLimit(subdiv->evaluator,
+                                          patch_coords,
+                                          num_patch_coords,
+                                          &r_P[0][0],
+                                          r_dPdu ? &r_dPdu[0][0] : NULL,
+                                          r_dPdv ? &r_dPdv[0][0] : NULL);
+  if (r_dPdu == NULL || r_dPdv == NULL) {
+    return;
+  }
+  for (int i = 0; i < num_patch_coords; i++) {
+    const OpenSubdiv_PatchCoord *patch_coord = &patch_coords[i];
+    subdiv_eval_ensure_valid_derivatives(subdiv,
+                                         patch_coord->ptex_face,
+                                         patch_coord->u,
+                                         patch_coord->v,
+                                         r_P[i],
+                                         r_dPdu[i],
+                                         r_dPdv[i]);
+  }
+}
+
 void BKE_subdiv_eval_face_varying(Subdiv *subdiv,
                                   const int face_varying_channel,
                                   const int ptex_face_index,
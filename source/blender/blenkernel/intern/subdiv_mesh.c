@@ -41,6 +41,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "opensubdiv_capi_type.h"
+
 /* -------------------------------------------------------------------- */
 /** \name Subdivision Context
  * \{ */
@@ -421,11 +423,91 @@ static void loop_interpolation_end(LoopsForInterpolation *loop_interpolation)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Evaluation helper functions
+ * \{ */
+
+/* Number of inner vertices which are evaluated at once. */
+#define SUBDIV_MESH_EVAL_BATCH_SIZE 256
+
+/* Inner vertices which are waiting for their limit position and normal to be evaluated. */
+typedef struct SubdivMeshEvalBatch {
+  int num_vertices;
+  OpenSubdiv_PatchCoord *patch_coords;
+  int *subdiv_vertex_indices;
+  float (*P)[3];
+  float (*dPdu)[3];
+  float (*dPdv)[3];
+} SubdivMeshEvalBatch;
+
+static void subdiv_mesh_eval_batch_flush(SubdivMeshContext *ctx, SubdivMeshEvalBatch *batch)
+{
+  if (batch->num_vertices == 0) {
+    return;
+  }
+  BKE_subdiv_eval_limit_points_and_derivatives(ctx->subdiv,
+                                               batch->patch_coords,
+                                               batch->num_vertices,
+                                               batch->P,
+                                               batch->dPdu,
+                                               batch->dPdv);
+  MVert *subdiv_mvert = ctx->subdiv_mesh->mvert;
+  for (int i = 0; i < batch->num_vertices; i++) {
+    MVert *subdiv_vert = &subdiv_mvert[batch->subdiv_vertex_indices[i]];
+    float N[3];
+    copy_v3_v3(subdiv_vert->co, batch->P[i]);
+    cross_v3_v3v3(N, batch->dPdu[i], batch->dPdv[i]);
+    normalize_v3(N);
+    normal_float_to_short_v3(subdiv_vert->no, N);
+  }
+  batch->num_vertices = 0;
+}
+
+static void subdiv_mesh_eval_batch_add(SubdivMeshContext *ctx,
+                                       SubdivMeshEvalBatch *batch,
+                                       const int ptex_face_index,
+                                       const float u,
+                                       const float v,
+                                       const int subdiv_vertex_index)
+{
+  if (batch->patch_coords == NULL) {
+    const int size = SUBDIV_MESH_EVAL_BATCH_SIZE;
+    batch->patch_coords = MEM_malloc_arrayN(size, sizeof(*batch->patch_coords), __func__);
+    batch->subdiv_vertex_indices = MEM_malloc_arrayN(
+        size, sizeof(*batch->subdiv_vertex_indices), __func__);
+    batch->P = MEM_malloc_arrayN(size, sizeof(*batch->P), __func__);
+    batch->dPdu = MEM_malloc_arrayN(size, sizeof(*batch->dPdu), __func__);
+    batch->dPdv = MEM_malloc_arrayN(size, sizeof(*batch->dPdv), __func__);
+  }
+  OpenSubdiv_PatchCoord *patch_coord = &batch->patch_coords[batch->num_vertices];
+  patch_coord->ptex_face = ptex_face_index;
+  patch_coord->u = u;
+  patch_coord->v = v;
+  batch->subdiv_vertex_indices[batch->num_vertices] = subdiv_vertex_index;
+  batch->num_vertices++;
+  if (batch->num_vertices == SUBDIV_MESH_EVAL_BATCH_SIZE) {
+    subdiv_mesh_eval_batch_flush(ctx, batch);
+  }
+}
+
+static void subdiv_mesh_eval_batch_free(SubdivMeshEvalBatch *batch)
+{
+  MEM_SAFE_FREE(batch->patch_coords);
+  MEM_SAFE_FREE(batch->subdiv_vertex_indices);
+  MEM_SAFE_FREE(batch->P);
+  MEM_SAFE_FREE(batch->dPdu);
+  MEM_SAFE_FREE(batch->dPdv);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name TLS
  * \{ */
 
 typedef struct SubdivMeshTLS {
+  SubdivMeshContext *ctx;
+
   bool vertex_interpolation_initialized;
   VerticesForInterpolation vertex_interpolation;
   const MPoly *vertex_interpolation_coarse_poly;
@@ -435,37 +517,25 @@ typedef struct SubdivMeshTLS {
   LoopsForInterpolation loop_interpolation;
   const MPoly *loop_interpolation_coarse_poly;
   int loop_interpolation_coarse_corner;
+
+  SubdivMeshEvalBatch inner_vertices_batch;
 } SubdivMeshTLS;
 
+/* NOTE: Is called once the thread is done with its part of the traversal, so it also evaluates
+ * the inner vertices which are still pending. Without threading the same TLS is used by all the
+ * traversal passes, so it is left in its initial state. */
 static void subdiv_mesh_tls_free(void *tls_v)
 {
   SubdivMeshTLS *tls = tls_v;
+  subdiv_mesh_eval_batch_flush(tls->ctx, &tls->inner_vertices_batch);
+  subdiv_mesh_eval_batch_free(&tls->inner_vertices_batch);
   if (tls->vertex_interpolation_initialized) {
     vertex_interpolation_end(&tls->vertex_interpolation);
+    tls->vertex_interpolation_initialized = false;
   }
   if (tls->loop_interpolation_initialized) {
     loop_interpolation_end(&tls->loop_interpolation);
-  }
-}
-
-/** \} */
-
-/* -------------------------------------------------------------------- */
-/** \name Evaluation helper functions
- * \{ */
-
-static void eval_final_point_and_vertex_normal(Subdiv *subdiv,
-                                               const int ptex_face_index,
-                                               const float u,
-                                               const float v,
-                                               float r_P[3],
-                                               short r_N[3])
-{
-  if (subdiv->displacement_evaluator == NULL) {
-    BKE_subdiv_eval_limit_point_and_short_normal(subdiv, ptex_face_index, u, v, r_P, r_N);
-  }
-  else {
-    BKE_subdiv_eval_final_point(subdiv, ptex_face_index, u, v, r_P);
+    tls->loop_interpolation_initialized = false;
   }
 }
 
@@ -792,8 +862,15 @@ static void subdiv_mesh_vertex_inner(const SubdivForeachContext *foreach_context
   MVert *subdiv_vert = &subdiv_mvert[subdiv_vertex_index];
   subdiv_mesh_ensure_vertex_interpolation(ctx, tls, coarse_poly, coarse_corner);
   subdiv_vertex_data_interpolate(ctx, subdiv_vert, &tls->vertex_interpolation, u, v);
-  eval_final_point_and_vertex_normal(
-      subdiv, ptex_face_index, u, v, subdiv_vert->co, subdiv_vert->no);
+  if (subdiv->displacement_evaluator == NULL) {
+    /* Limit surface of inner vertices is evaluated in batches, position and normal are written
+     * once the batch is full or the traversal of this thread is done. */
+    subdiv_mesh_eval_batch_add(
+        ctx, &tls->inner_vertices_batch, ptex_face_index, u, v, subdiv_vertex_index);
+  }
+  else {
+    BKE_subdiv_eval_final_point(subdiv, ptex_face_index, u, v, subdiv_vert->co);
+  }
   subdiv_mesh_tag_center_vertex(coarse_poly, subdiv_vert, u, v);
 }
 
@@ -1223,6 +1300,7 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
   SubdivForeachContext foreach_context;
   setup_foreach_callbacks(&subdiv_context, &foreach_context);
   SubdivMeshTLS tls = {0};
+  tls.ctx = &subdiv_context;
   foreach_context.user_data = &subdiv_context;
   foreach_context.user_data_tls_size = sizeof(SubdivMeshTLS);
   foreach_context.user_data_tls = &tls;
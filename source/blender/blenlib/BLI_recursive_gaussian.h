@@ -0,0 +1,49 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ *
+ * Young/van Vliet recursive gaussian with Triggs/Sdika border corrections.
+ * Unlike a convolution the cost per pixel doesn't depend on the size of the blur.
+ */
+
+#include "BLI_compiler_attrs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void BLI_recursive_gaussian_blur_fl(float *buffer,
+                                    const int width,
+                                    const int height,
+                                    const int pixel_stride,
+                                    const int channels,
+                                    const float sigma_x,
+                                    const float sigma_y) ATTR_NONNULL();
+void BLI_recursive_gaussian_blur_uchar(unsigned char *buffer,
+                                       const int width,
+                                       const int height,
+                                       const int pixel_stride,
+                                       const int channels,
+                                       const float sigma_x,
+                                       const float sigma_y) ATTR_NONNULL();
+
+#ifdef __cplusplus
+}
+#endif
@@ -1068,6 +1068,13 @@ void madd_m3_m3m3fl(float R[3][3], const float A[3][3], const float B[3][3], con
 
 void madd_m4_m4m4fl(float R[4][4], const float A[4][4], const float B[4][4], const float f)
 {
+#ifdef BLI_HAVE_SSE2
+  __m128 F = _mm_set1_ps(f);
+
+  for (int i = 0; i < 4; i++) {
+    _mm_storeu_ps(R[i], _mm_add_ps(_mm_loadu_ps(A[i]), _mm_mul_ps(_mm_loadu_ps(B[i]), F)));
+  }
+#else
   int i, j;
 
   for (i = 0; i < 4; i++) {
@@ -1075,6 +1082,7 @@ void madd_m4_m4m4fl(float R[4][4], const float A[4][4], const float B[4][4], con
       R[i][j] = A[i][j] + B[i][j] * f;
     }
   }
+#endif
 }
 
 void sub_m3_m3m3(float R[3][3], const float A[3][3], const float B[3][3])
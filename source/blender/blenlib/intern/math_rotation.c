@@ -2054,6 +2054,15 @@ void add_weighted_dq_dq(DualQuat *dq_sum, const DualQuat *dq, float weight)
   }
 
   /* interpolate rotation and translation */
+#ifdef BLI_HAVE_SSE2
+  {
+    const __m128 W = _mm_set1_ps(weight);
+    _mm_storeu_ps(dq_sum->quat,
+                  _mm_add_ps(_mm_loadu_ps(dq_sum->quat), _mm_mul_ps(_mm_loadu_ps(dq->quat), W)));
+    _mm_storeu_ps(dq_sum->trans,
+                  _mm_add_ps(_mm_loadu_ps(dq_sum->trans), _mm_mul_ps(_mm_loadu_ps(dq->trans), W)));
+  }
+#else
   dq_sum->quat[0] += weight * dq->quat[0];
   dq_sum->quat[1] += weight * dq->quat[1];
   dq_sum->quat[2] += weight * dq->quat[2];
@@ -2063,21 +2072,18 @@ void add_weighted_dq_dq(DualQuat *dq_sum, const DualQuat *dq, float weight)
   dq_sum->trans[1] += weight * dq->trans[1];
   dq_sum->trans[2] += weight * dq->trans[2];
   dq_sum->trans[3] += weight * dq->trans[3];
+#endif
 
   /* Interpolate scale - but only if there is scale present. If any dual
    * quaternions without scale are added, they will be compensated for in
    * normalize_dq. */
   if (dq->scale_weight) {
-    float wmat[4][4];
-
     if (flipped) {
       /* we don't want negative weights for scaling */
       weight = -weight;
     }
 
-    copy_m4_m4(wmat, (float(*)[4])dq->scale);
-    mul_m4_fl(wmat, weight);
-    add_m4_m4m4(dq_sum->scale, dq_sum->scale, wmat);
+    madd_m4_m4m4fl(dq_sum->scale, dq_sum->scale, dq->scale, weight);
     dq_sum->scale_weight += weight;
   }
 }
@@ -0,0 +1,335 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bli
+ *
+ * Recursive gaussian blur of interleaved image buffers, shared by the compositor and imbuf.
+ *
+ * Rows are filtered one per iteration. Columns are filtered in blocks of adjacent columns: the
+ * rows of a block are loaded into one interleaved line buffer, so the loads stay within a few
+ * cache lines and the inner loops of the filter run over all values of a block at once.
+ */
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_math_base.h"
+#include "BLI_recursive_gaussian.h"
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+
+#include "BLI_strict_flags.h"
+
+/* Number of adjacent columns filtered together by the vertical pass. */
+#define COLUMN_BLOCK_SIZE 16
+
+typedef struct RecursiveGaussianCoefficients {
+  double cf[4];
+  double tsM[9];
+} RecursiveGaussianCoefficients;
+
+typedef struct RecursiveGaussianData {
+  RecursiveGaussianCoefficients coef;
+  float *buffer_fl;
+  unsigned char *buffer_uchar;
+  int width, height;
+  int pixel_stride, channels;
+  /* Filter the columns instead of the rows. */
+  bool vertical;
+  /* Number of doubles in each of the X, W and Y line buffers. */
+  size_t line_buffer_len;
+} RecursiveGaussianData;
+
+typedef struct RecursiveGaussianTLSData {
+  /* Line buffers, allocated on first use by each thread. */
+  double *X;
+} RecursiveGaussianTLSData;
+
+static void recursive_gaussian_coefficients(const float sigma,
+                                            RecursiveGaussianCoefficients *coef)
+{
+  double *cf = coef->cf;
+  double *tsM = coef->tsM;
+  double q, q2, sc;
+
+  /* See "Recursive Gabor Filtering" by Young/van Vliet. All factors here in double precision,
+   * required because in single precision it seems to blow up if sigma > ~200. */
+  if (sigma >= 3.556f) {
+    q = 0.9804f * (sigma - 3.556f) + 2.5091f;
+  }
+  else { /* sigma >= 0.5 */
+    q = (0.0561f * sigma + 0.5784f) * sigma - 0.2568f;
+  }
+  q2 = q * q;
+  sc = (1.1668 + q) * (3.203729649 + (2.21566 + q) * q);
+  /* No gabor filtering here, so no complex multiplies, just the regular coefficients.
+   * All negated here, so as not to have to recalculate the Triggs/Sdika matrix. */
+  cf[1] = q * (5.788961737 + (6.76492 + 3.0 * q) * q) / sc;
+  cf[2] = -q2 * (3.38246 + 3.0 * q) / sc;
+  /* 0 & 3 unchanged. */
+  cf[3] = q2 * q / sc;
+  cf[0] = 1.0 - cf[1] - cf[2] - cf[3];
+
+  /* Triggs/Sdika border corrections,
+   * it seems to work, not entirely sure if it is actually totally correct,
+   * Besides J.M.Geusebroek's anigauss.c (see http://www.science.uva.nl/~mark),
+   * found one other implementation by Cristoph Lampert,
+   * but neither seem to be quite the same, result seems to be ok so far anyway.
+   * Extra scale factor here to not have to do it in filter,
+   * though maybe this had something to with the precision errors. */
+  sc = cf[0] / ((1.0 + cf[1] - cf[2] + cf[3]) * (1.0 - cf[1] - cf[2] - cf[3]) *
+                (1.0 + cf[2] + (cf[1] - cf[3]) * cf[3]));
+  tsM[0] = sc * (-cf[3] * cf[1] + 1.0 - cf[3] * cf[3] - cf[2]);
+  tsM[1] = sc * ((cf[3] + cf[1]) * (cf[2] + cf[3] * cf[1]));
+  tsM[2] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
+  tsM[3] = sc * (cf[1] + cf[3] * cf[2]);
+  tsM[4] = sc * (-(cf[2] - 1.0) * (cf[2] + cf[3] * cf[1]));
+  tsM[5] = sc * (-(cf[3] * cf[1] + cf[3] * cf[3] + cf[2] - 1.0) * cf[3]);
+  tsM[6] = sc * (cf[3] * cf[1] + cf[2] + cf[1] * cf[1] - cf[2] * cf[2]);
+  tsM[7] = sc * (cf[1] * cf[2] + cf[3] * cf[2] * cf[2] - cf[1] * cf[3] * cf[3] -
+                 cf[3] * cf[3] * cf[3] - cf[3] * cf[2] + cf[3]);
+  tsM[8] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
+}
+
+/**
+ * Filter a line of \a len elements forward and backward. The elements have \a n interleaved
+ * values which are filtered independently.
+ */
+static void recursive_gaussian_line(const RecursiveGaussianCoefficients *coef,
+                                    const double *X,
+                                    double *W,
+                                    double *Y,
+                                    const int len,
+                                    const int n)
+{
+  const double *cf = coef->cf;
+  const double *tsM = coef->tsM;
+  const int l1 = (len - 1) * n;
+  const int l2 = (len - 2) * n;
+  const int l3 = (len - 3) * n;
+  int i, c;
+
+  for (c = 0; c < n; c++) {
+    W[c] = cf[0] * X[c] + cf[1] * X[c] + cf[2] * X[c] + cf[3] * X[c];
+    W[n + c] = cf[0] * X[n + c] + cf[1] * W[c] + cf[2] * X[c] + cf[3] * X[c];
+    W[2 * n + c] = cf[0] * X[2 * n + c] + cf[1] * W[n + c] + cf[2] * W[c] + cf[3] * X[c];
+  }
+  for (i = 3 * n; i < len * n; i += n) {
+    for (c = 0; c < n; c++) {
+      W[i + c] = cf[0] * X[i + c] + cf[1] * W[i - n + c] + cf[2] * W[i - 2 * n + c] +
+                 cf[3] * W[i - 3 * n + c];
+    }
+  }
+
+  for (c = 0; c < n; c++) {
+    const double tsu0 = W[l1 + c] - X[l1 + c];
+    const double tsu1 = W[l2 + c] - X[l1 + c];
+    const double tsu2 = W[l3 + c] - X[l1 + c];
+    const double tsv0 = tsM[0] * tsu0 + tsM[1] * tsu1 + tsM[2] * tsu2 + X[l1 + c];
+    const double tsv1 = tsM[3] * tsu0 + tsM[4] * tsu1 + tsM[5] * tsu2 + X[l1 + c];
+    const double tsv2 = tsM[6] * tsu0 + tsM[7] * tsu1 + tsM[8] * tsu2 + X[l1 + c];
+    Y[l1 + c] = cf[0] * W[l1 + c] + cf[1] * tsv0 + cf[2] * tsv1 + cf[3] * tsv2;
+    Y[l2 + c] = cf[0] * W[l2 + c] + cf[1] * Y[l1 + c] + cf[2] * tsv0 + cf[3] * tsv1;
+    Y[l3 + c] = cf[0] * W[l3 + c] + cf[1] * Y[l2 + c] + cf[2] * Y[l1 + c] + cf[3] * tsv0;
+  }
+  for (i = (len - 4) * n; i >= 0; i -= n) {
+    for (c = 0; c < n; c++) {
+      Y[i + c] = cf[0] * W[i + c] + cf[1] * Y[i + n + c] + cf[2] * Y[i + 2 * n + c] +
+                 cf[3] * Y[i + 3 * n + c];
+    }
+  }
+}
+
+/**
+ * Filter one row, or one block of up to #COLUMN_BLOCK_SIZE columns.
+ */
+static void recursive_gaussian_task(void *__restrict userdata,
+                                    const int index,
+                                    const TaskParallelTLS *__restrict tls)
+{
+  const RecursiveGaussianData *data = userdata;
+  RecursiveGaussianTLSData *tls_data = tls->userdata_chunk;
+  const int channels = data->channels;
+  int len, num_columns;
+  size_t first_pixel, pixel_step;
+
+  if (data->vertical) {
+    const int first_column = index * COLUMN_BLOCK_SIZE;
+    len = data->height;
+    num_columns = min_ii(COLUMN_BLOCK_SIZE, data->width - first_column);
+    first_pixel = (size_t)first_column;
+    pixel_step = (size_t)data->width;
+  }
+  else {
+    len = data->width;
+    num_columns = 1;
+    first_pixel = (size_t)index * (size_t)data->width;
+    pixel_step = 1;
+  }
+
+  if (tls_data->X == NULL) {
+    tls_data->X = MEM_mallocN(sizeof(double) * 3 * data->line_buffer_len, __func__);
+  }
+  double *X = tls_data->X;
+  double *W = X + data->line_buffer_len;
+  double *Y = W + data->line_buffer_len;
+
+  /* Values of all columns of the block, interleaved per element of the line. */
+  const int n = num_columns * channels;
+  const size_t elem_stride = pixel_step * (size_t)data->pixel_stride;
+  int i, col, c;
+
+  if (data->buffer_fl) {
+    float *first = data->buffer_fl + first_pixel * (size_t)data->pixel_stride;
+    for (i = 0; i < len; i++) {
+      const float *fp = first + (size_t)i * elem_stride;
+      double *x = X + i * n;
+      for (col = 0; col < num_columns; col++, fp += data->pixel_stride) {
+        for (c = 0; c < channels; c++) {
+          *x++ = fp[c];
+        }
+      }
+    }
+    recursive_gaussian_line(&data->coef, X, W, Y, len, n);
+    for (i = 0; i < len; i++) {
+      float *fp = first + (size_t)i * elem_stride;
+      const double *y = Y + i * n;
+      for (col = 0; col < num_columns; col++, fp += data->pixel_stride) {
+        for (c = 0; c < channels; c++) {
+          fp[c] = (float)*y++;
+        }
+      }
+    }
+  }
+  else {
+    unsigned char *first = data->buffer_uchar + first_pixel * (size_t)data->pixel_stride;
+    for (i = 0; i < len; i++) {
+      const unsigned char *cp = first + (size_t)i * elem_stride;
+      double *x = X + i * n;
+      for (col = 0; col < num_columns; col++, cp += data->pixel_stride) {
+        for (c = 0; c < channels; c++) {
+          *x++ = cp[c];
+        }
+      }
+    }
+    recursive_gaussian_line(&data->coef, X, W, Y, len, n);
+    for (i = 0; i < len; i++) {
+      unsigned char *cp = first + (size_t)i * elem_stride;
+      const double *y = Y + i * n;
+      for (col = 0; col < num_columns; col++, cp += data->pixel_stride) {
+        for (c = 0; c < channels; c++) {
+          cp[c] = (unsigned char)clamp_i((int)(*y++ + 0.5), 0, 255);
+        }
+      }
+    }
+  }
+}
+
+static void recursive_gaussian_free(const void *__restrict UNUSED(userdata),
+                                    void *__restrict chunk)
+{
+  RecursiveGaussianTLSData *tls_data = chunk;
+  MEM_SAFE_FREE(tls_data->X);
+}
+
+static void recursive_gaussian_pass(RecursiveGaussianData *data, const float sigma)
+{
+  int num_tasks, min_iter_per_thread;
+
+  recursive_gaussian_coefficients(sigma, &data->coef);
+  if (data->vertical) {
+    num_tasks = (int)divide_ceil_u((uint)data->width, COLUMN_BLOCK_SIZE);
+    min_iter_per_thread = 1;
+    data->line_buffer_len = (size_t)data->height * COLUMN_BLOCK_SIZE * (size_t)data->channels;
+  }
+  else {
+    num_tasks = data->height;
+    min_iter_per_thread = 8;
+    data->line_buffer_len = (size_t)data->width * (size_t)data->channels;
+  }
+
+  RecursiveGaussianTLSData tls_data = {NULL};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.userdata_chunk = &tls_data;
+  settings.userdata_chunk_size = sizeof(tls_data);
+  settings.func_free = recursive_gaussian_free;
+  settings.min_iter_per_thread = min_iter_per_thread;
+  BLI_task_parallel_range(0, num_tasks, data, recursive_gaussian_task, &settings);
+}
+
+static void recursive_gaussian_blur(RecursiveGaussianData *data,
+                                    const float sigma_x,
+                                    const float sigma_y)
+{
+  /* Sigma below 0.5 is not valid, though it can have a possibly useful sort of sharpening
+   * effect. The line filter expects lines of at least 3 pixels, so directions below that are
+   * skipped as well. */
+  if (sigma_x >= 0.5f && data->width >= 3) {
+    data->vertical = false;
+    recursive_gaussian_pass(data, sigma_x);
+  }
+  if (sigma_y >= 0.5f && data->height >= 3) {
+    data->vertical = true;
+    recursive_gaussian_pass(data, sigma_y);
+  }
+}
+
+/**
+ * Gaussian blur of a float buffer in place, with standard deviations in pixels along x and y.
+ * The first \a channels of every pixel are blurred, pixels being \a pixel_stride floats apart.
+ * Directions with a sigma below 0.5 or less than 3 pixels are not blurred.
+ */
+void BLI_recursive_gaussian_blur_fl(float *buffer,
+                                    const int width,
+                                    const int height,
+                                    const int pixel_stride,
+                                    const int channels,
+                                    const float sigma_x,
+                                    const float sigma_y)
+{
+  BLI_assert(channels <= pixel_stride);
+  RecursiveGaussianData data = {
+      .buffer_fl = buffer,
+      .width = width,
+      .height = height,
+      .pixel_stride = pixel_stride,
+      .channels = channels,
+  };
+  recursive_gaussian_blur(&data, sigma_x, sigma_y);
+}
+
+/**
+ * Byte buffer version of #BLI_recursive_gaussian_blur_fl, results are rounded and clamped.
+ */
+void BLI_recursive_gaussian_blur_uchar(unsigned char *buffer,
+                                       const int width,
+                                       const int height,
+                                       const int pixel_stride,
+                                       const int channels,
+                                       const float sigma_x,
+                                       const float sigma_y)
+{
+  BLI_assert(channels <= pixel_stride);
+  RecursiveGaussianData data = {
+      .buffer_uchar = buffer,
+      .width = width,
+      .height = height,
+      .pixel_stride = pixel_stride,
+      .channels = channels,
+  };
+  recursive_gaussian_blur(&data, sigma_x, sigma_y);
+}
@@ -58,6 +58,18 @@ typedef enum CompositorPriority {
   COM_PRIORITY_LOW = 0,
 } CompositorPriority;
 
+/**
+ * \brief Possible execution models
+ * \see CompositorContext.executionModel
+ * \ingroup Execution
+ */
+typedef enum ExecutionModel {
+  /** \brief Operations are executed from the outputs, a chunk at a time */
+  COM_EXECUTION_MODEL_TILED = 0,
+  /** \brief Operations are executed one after the other, a full frame buffer at a time */
+  COM_EXECUTION_MODEL_FULL_FRAME = 1,
+} ExecutionModel;
+
 // configurable items
 
 // chunk size determination
@@ -107,3 +119,9 @@ typedef enum OrderOfChunks {
 #define COM_NUM_CHANNELS_COLOR 4
 
 #define COM_BLUR_BOKEH_PIXELS 512
+
+/**
+ * \brief maximum size in bytes of the buffers kept between executions
+ * \see BufferCache
+ */
+#define COM_BUFFER_CACHE_LIMIT ((size_t)1024 * 1024 * 1024)
@@ -0,0 +1,110 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include <iterator>
+#include <list>
+#include <unordered_map>
+
+#include "COM_BufferCache.h"
+#include "COM_MemoryBuffer.h"
+#include "COM_defines.h"
+
+struct CacheEntry {
+  uint64_t key;
+  MemoryBuffer *buffer;
+  size_t size;
+};
+
+using CacheEntries = std::list<CacheEntry>;
+
+static struct {
+  /** \brief cached buffers, most recently used first */
+  CacheEntries entries;
+  std::unordered_map<uint64_t, CacheEntries::iterator> lookup;
+  /** \brief total size in bytes of the cached buffers */
+  size_t size = 0;
+} g_buffer_cache;
+
+static size_t buffer_size(MemoryBuffer *buffer)
+{
+  const size_t num_elems = buffer->is_a_single_elem() ?
+                               1 :
+                               (size_t)buffer->getWidth() * buffer->getHeight();
+  return num_elems * buffer->get_num_channels() * sizeof(float);
+}
+
+static void remove_entry(CacheEntries::iterator entry)
+{
+  g_buffer_cache.size -= entry->size;
+  g_buffer_cache.lookup.erase(entry->key);
+  delete entry->buffer;
+  g_buffer_cache.entries.erase(entry);
+}
+
+uint64_t BufferCache::hash(uint64_t hash, const void *data, size_t size)
+{
+  /* FNV-1a, 64 bit. */
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+MemoryBuffer *BufferCache::find(uint64_t key)
+{
+  auto found = g_buffer_cache.lookup.find(key);
+  if (found == g_buffer_cache.lookup.end()) {
+    return nullptr;
+  }
+  CacheEntries::iterator entry = found->second;
+  g_buffer_cache.entries.splice(g_buffer_cache.entries.begin(), g_buffer_cache.entries, entry);
+  return entry->buffer;
+}
+
+void BufferCache::add(uint64_t key, MemoryBuffer *buffer)
+{
+  auto found = g_buffer_cache.lookup.find(key);
+  if (found != g_buffer_cache.lookup.end()) {
+    remove_entry(found->second);
+  }
+
+  const size_t size = buffer_size(buffer);
+  if (size > COM_BUFFER_CACHE_LIMIT) {
+    delete buffer;
+    return;
+  }
+  while (g_buffer_cache.size + size > COM_BUFFER_CACHE_LIMIT) {
+    remove_entry(std::prev(g_buffer_cache.entries.end()));
+  }
+
+  g_buffer_cache.entries.push_front({key, buffer, size});
+  g_buffer_cache.lookup[key] = g_buffer_cache.entries.begin();
+  g_buffer_cache.size += size;
+}
+
+void BufferCache::clear()
+{
+  for (CacheEntry &entry : g_buffer_cache.entries) {
+    delete entry.buffer;
+  }
+  g_buffer_cache.entries.clear();
+  g_buffer_cache.lookup.clear();
+  g_buffer_cache.size = 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class MemoryBuffer;
+
+/**
+ * \brief cache of the outputs of ExecutionGroup's between executions of the compositor
+ *
+ * Buffers are identified by a hash of the operations they depend on, see
+ * NodeOperation.get_params_hash. When the settings and inputs of a group didn't change since a
+ * previous execution, its output is copied from the cache instead of being calculated again.
+ *
+ * The least recently used buffers are freed when the cache grows beyond COM_BUFFER_CACHE_LIMIT.
+ * \note not thread safe, only accessed from the thread executing the compositor.
+ * \ingroup Memory
+ */
+struct BufferCache {
+  /** \brief initial value of hashes, passed to the first call of BufferCache.hash */
+  static const uint64_t HASH_SEED = 0xcbf29ce484222325ULL;
+
+  /**
+   * \brief combine a hash with the given data
+   */
+  static uint64_t hash(uint64_t hash, const void *data, size_t size);
+
+  /**
+   * \brief find the buffer stored with the given key and mark it as recently used
+   * \return the buffer owned by the cache, or nullptr when not cached
+   */
+  static MemoryBuffer *find(uint64_t key);
+
+  /**
+   * \brief store a buffer, the cache takes ownership of it
+   * Least recently used buffers are freed to stay within the memory limit.
+   */
+  static void add(uint64_t key, MemoryBuffer *buffer);
+
+  /**
+   * \brief free all cached buffers
+   */
+  static void clear();
+};
@@ -0,0 +1,136 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "BLI_assert.h"
+#include "BLI_rect.h"
+
+#include "COM_MemoryBuffer.h"
+
+/**
+ * \brief Iterates the elements of an area of an output buffer row by row, together with the
+ * elements at the same coordinates in the input buffers.
+ *
+ * Used by operations in full frame execution to process a whole area in a tight loop:
+ *
+ * \code{.cpp}
+ * for (; !it.is_end(); ++it) {
+ *   it.out[0] = it.in(0)[0] + it.in(1)[0];
+ * }
+ * \endcode
+ *
+ * Input buffers holding a single element return that element for all coordinates.
+ * \ingroup Execution
+ */
+class BuffersIterator {
+ public:
+  /** \brief maximum number of input buffers that can be iterated */
+  static const int MAX_INPUTS = 4;
+
+  /** \brief current element of the output buffer */
+  float *out;
+
+ private:
+  MemoryBuffer *m_output;
+  MemoryBuffer *m_inputs[MAX_INPUTS];
+  const float *m_in[MAX_INPUTS];
+  int m_in_stride[MAX_INPUTS];
+  int m_out_stride;
+  int m_num_inputs;
+
+  int m_x;
+  int m_y;
+  int m_xmin;
+  int m_xmax;
+  int m_ymax;
+
+ public:
+  BuffersIterator(MemoryBuffer *output, const rcti &area, MemoryBuffer **inputs, int num_inputs)
+      : m_output(output),
+        m_num_inputs(num_inputs),
+        m_x(area.xmin),
+        m_y(area.ymin),
+        m_xmin(area.xmin),
+        m_xmax(area.xmax),
+        m_ymax(area.ymax)
+  {
+    BLI_assert(num_inputs <= MAX_INPUTS);
+    m_out_stride = output ? output->get_elem_stride() : 0;
+    for (int i = 0; i < num_inputs; i++) {
+      m_inputs[i] = inputs[i];
+      m_in_stride[i] = inputs[i]->get_elem_stride();
+    }
+    if (BLI_rcti_is_empty(&area)) {
+      m_y = m_ymax;
+      out = nullptr;
+      return;
+    }
+    begin_row();
+  }
+
+  bool is_end() const
+  {
+    return m_y >= m_ymax;
+  }
+
+  BuffersIterator &operator++()
+  {
+    m_x++;
+    if (m_x < m_xmax) {
+      out += m_out_stride;
+      for (int i = 0; i < m_num_inputs; i++) {
+        m_in[i] += m_in_stride[i];
+      }
+    }
+    else {
+      m_x = m_xmin;
+      m_y++;
+      if (m_y < m_ymax) {
+        begin_row();
+      }
+    }
+    return *this;
+  }
+
+  /** \brief current element of the input buffer with the given index */
+  const float *in(int index) const
+  {
+    BLI_assert(index < m_num_inputs);
+    return m_in[index];
+  }
+
+  int x() const
+  {
+    return m_x;
+  }
+
+  int y() const
+  {
+    return m_y;
+  }
+
+ private:
+  void begin_row()
+  {
+    out = m_output ? m_output->getElem(m_x, m_y) : nullptr;
+    for (int i = 0; i < m_num_inputs; i++) {
+      m_in[i] = m_inputs[i]->getElem(m_x, m_y);
+    }
+  }
+};
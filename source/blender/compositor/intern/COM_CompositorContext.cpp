@@ -27,6 +27,7 @@ CompositorContext::CompositorContext()
   this->m_quality = COM_QUALITY_HIGH;
   this->m_hasActiveOpenCLDevices = false;
   this->m_fastCalculation = false;
+  this->m_executionModel = COM_EXECUTION_MODEL_TILED;
   this->m_viewSettings = nullptr;
   this->m_displaySettings = nullptr;
 }
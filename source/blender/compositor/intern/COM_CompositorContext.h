@@ -77,6 +77,12 @@ class CompositorContext {
    */
   bool m_fastCalculation;
 
+  /**
+   * \brief how the operations are executed
+   * \see ExecutionModel
+   */
+  ExecutionModel m_executionModel;
+
   /* \brief color management settings */
   const ColorManagedViewSettings *m_viewSettings;
   const ColorManagedDisplaySettings *m_displaySettings;
@@ -263,6 +269,14 @@ class CompositorContext {
   {
     return this->m_fastCalculation;
   }
+  void setExecutionModel(ExecutionModel executionModel)
+  {
+    this->m_executionModel = executionModel;
+  }
+  ExecutionModel getExecutionModel() const
+  {
+    return this->m_executionModel;
+  }
   bool isGroupnodeBufferEnabled() const
   {
     return (this->getbNodeTree()->flag & NTREE_COM_GROUPNODE_BUFFER) != 0;
@@ -48,6 +48,8 @@ DebugInfo::NodeNameMap DebugInfo::m_node_names;
 DebugInfo::OpNameMap DebugInfo::m_op_names;
 std::string DebugInfo::m_current_node_name;
 std::string DebugInfo::m_current_op_name;
+int DebugInfo::m_num_folded = 0;
+int DebugInfo::m_num_removed = 0;
 DebugInfo::GroupStateMap DebugInfo::m_group_states;
 
 std::string DebugInfo::node_name(const Node *node)
@@ -108,6 +110,15 @@ void DebugInfo::operation_read_write_buffer(const NodeOperation *operation)
   m_current_op_name = m_op_names[operation];
 }
 
+void DebugInfo::operations_optimized(int num_folded, int num_removed)
+{
+  m_num_folded = num_folded;
+  m_num_removed = num_removed;
+  printf("Compositor: folded %d constant operations, removed %d identity operations\n",
+         num_folded,
+         num_removed);
+}
+
 void DebugInfo::execution_group_started(const ExecutionGroup *group)
 {
   m_group_states[group] = EG_RUNNING;
@@ -303,6 +314,17 @@ int DebugInfo::graphviz_legend(char *str, int maxlen)
   len += graphviz_legend_group(
       "Group Finished", "chartreuse4", "solid", str + len, maxlen > len ? maxlen - len : 0);
 
+  len += snprintf(str + len, maxlen > len ? maxlen - len : 0, "<TR><TD></TD></TR>\r\n");
+
+  len += snprintf(str + len,
+                  maxlen > len ? maxlen - len : 0,
+                  "<TR><TD>Folded Constants</TD><TD>%d</TD></TR>\r\n",
+                  m_num_folded);
+  len += snprintf(str + len,
+                  maxlen > len ? maxlen - len : 0,
+                  "<TR><TD>Removed Identities</TD><TD>%d</TD></TR>\r\n",
+                  m_num_removed);
+
   len += snprintf(str + len, maxlen > len ? maxlen - len : 0, "</TABLE>\r\n");
   len += snprintf(str + len, maxlen > len ? maxlen - len : 0, ">];\r\n");
   len += snprintf(str + len, maxlen > len ? maxlen - len : 0, "}\r\n");
@@ -519,6 +541,9 @@ void DebugInfo::operation_added(const NodeOperation * /*operation*/)
 void DebugInfo::operation_read_write_buffer(const NodeOperation * /*operation*/)
 {
 }
+void DebugInfo::operations_optimized(int /*num_folded*/, int /*num_removed*/)
+{
+}
 void DebugInfo::execution_group_started(const ExecutionGroup * /*group*/)
 {
 }
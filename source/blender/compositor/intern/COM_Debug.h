@@ -46,6 +46,7 @@ class DebugInfo {
   static void node_to_operations(const Node *node);
   static void operation_added(const NodeOperation *operation);
   static void operation_read_write_buffer(const NodeOperation *operation);
+  static void operations_optimized(int num_folded, int num_removed);
 
   static void execution_group_started(const ExecutionGroup *group);
   static void execution_group_finished(const ExecutionGroup *group);
@@ -74,5 +75,7 @@ class DebugInfo {
   static std::string m_current_node_name; /**< base name for all operations added by a node */
   static std::string m_current_op_name;   /**< base name for automatic sub-operations */
   static GroupStateMap m_group_states;    /**< for visualizing group states */
+  static int m_num_folded;  /**< constant operations folded by the last conversion */
+  static int m_num_removed; /**< identity operations removed by the last conversion */
 #endif
 };
@@ -601,6 +601,31 @@ bool ExecutionGroup::isOpenCL()
   return this->m_openCL;
 }
 
+bool ExecutionGroup::is_fully_executed() const
+{
+  if (this->m_chunkExecutionStates == nullptr) {
+    return false;
+  }
+  if (this->m_viewerBorder.xmin != 0 || this->m_viewerBorder.ymin != 0 ||
+      this->m_viewerBorder.xmax != (int)this->m_width ||
+      this->m_viewerBorder.ymax != (int)this->m_height) {
+    return false;
+  }
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    if (this->m_chunkExecutionStates[index] != COM_ES_EXECUTED) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ExecutionGroup::mark_executed()
+{
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    this->m_chunkExecutionStates[index] = COM_ES_EXECUTED;
+  }
+}
+
 void ExecutionGroup::setViewerBorder(float xmin, float xmax, float ymin, float ymax)
 {
   NodeOperation *operation = this->getOutputOperation();
@@ -439,6 +439,18 @@ class ExecutionGroup {
 
   void setRenderBorder(float xmin, float xmax, float ymin, float ymax);
 
+  /**
+   * \brief are all chunks of the whole output of this ExecutionGroup executed
+   * \note false when the output is limited by a border.
+   */
+  bool is_fully_executed() const;
+
+  /**
+   * \brief mark all chunks as executed, without executing them
+   * Used when the output buffer is filled from the BufferCache.
+   */
+  void mark_executed();
+
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
 
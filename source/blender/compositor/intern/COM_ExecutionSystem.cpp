@@ -18,6 +18,13 @@
 
 #include "COM_ExecutionSystem.h"
 
+#include <map>
+#include <set>
+
+#include "BLI_math_base.h"
+#include "BLI_rect.h"
+#include "BLI_string.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 #include "PIL_time.h"
 
@@ -25,6 +32,7 @@
 
 #include "BLT_translation.h"
 
+#include "COM_BufferCache.h"
 #include "COM_Converter.h"
 #include "COM_Debug.h"
 #include "COM_ExecutionGroup.h"
@@ -32,6 +40,7 @@
 #include "COM_NodeOperationBuilder.h"
 #include "COM_ReadBufferOperation.h"
 #include "COM_WorkScheduler.h"
+#include "COM_WriteBufferOperation.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
 #  include "MEM_guardedalloc.h"
@@ -62,6 +71,10 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
   this->m_context.setHasActiveOpenCLDevices(WorkScheduler::has_gpu_devices() &&
                                             (editingtree->flag & NTREE_COM_OPENCL));
 
+  this->m_context.setExecutionModel((editingtree->flag & NTREE_COM_FULL_FRAME) ?
+                                        COM_EXECUTION_MODEL_FULL_FRAME :
+                                        COM_EXECUTION_MODEL_TILED);
+
   this->m_context.setRenderData(rd);
   this->m_context.setViewSettings(viewSettings);
   this->m_context.setDisplaySettings(displaySettings);
@@ -134,6 +147,26 @@ void ExecutionSystem::execute()
 
   DebugInfo::execute_started(this);
 
+  if (this->m_context.getExecutionModel() == COM_EXECUTION_MODEL_FULL_FRAME) {
+    execute_full_frame();
+  }
+  else {
+    execute_tiled();
+  }
+
+  editingtree->stats_draw(editingtree->sdh, TIP_("Compositing | De-initializing execution"));
+  for (unsigned int index = 0; index < this->m_operations.size(); index++) {
+    NodeOperation *operation = this->m_operations[index];
+    operation->deinitExecution();
+  }
+  for (unsigned int index = 0; index < this->m_groups.size(); index++) {
+    ExecutionGroup *executionGroup = this->m_groups[index];
+    executionGroup->deinitExecution();
+  }
+}
+
+void ExecutionSystem::execute_tiled()
+{
   unsigned int order = 0;
   for (vector<NodeOperation *>::iterator iter = this->m_operations.begin();
        iter != this->m_operations.end();
@@ -177,6 +210,13 @@ void ExecutionSystem::execute()
     executionGroup->initExecution();
   }
 
+  /* results of a final render are not reused, only cache while editing */
+  const bool use_cache = !this->m_context.isRendering();
+  GroupKeys groups_to_cache;
+  if (use_cache) {
+    read_buffer_cache(groups_to_cache);
+  }
+
   WorkScheduler::start(this->m_context);
 
   executeGroups(COM_PRIORITY_HIGH);
@@ -188,15 +228,250 @@ void ExecutionSystem::execute()
   WorkScheduler::finish();
   WorkScheduler::stop();
 
-  editingtree->stats_draw(editingtree->sdh, TIP_("Compositing | De-initializing execution"));
+  const bNodeTree *editingtree = this->m_context.getbNodeTree();
+  if (use_cache && !(editingtree->test_break && editingtree->test_break(editingtree->tbh))) {
+    write_buffer_cache(groups_to_cache);
+  }
+}
+
+using OperationKeys = std::map<NodeOperation *, std::pair<bool, uint64_t>>;
+
+/**
+ * Get the key identifying the output of an operation in the BufferCache, from the hash of the
+ * operation and the keys of all operations it depends on.
+ * \return false when the output can't be identified.
+ */
+static bool get_operation_key(NodeOperation *operation, OperationKeys &keys, uint64_t *r_key)
+{
+  OperationKeys::iterator found = keys.find(operation);
+  if (found != keys.end()) {
+    *r_key = found->second.second;
+    return found->second.first;
+  }
+  /* inputs depending on this operation can't be identified while its key is being generated */
+  keys[operation] = std::make_pair(false, (uint64_t)0);
+
+  uint64_t key = 0;
+  bool valid = operation->get_params_hash(&key);
+  if (valid && operation->isReadBufferOperation()) {
+    MemoryProxy *proxy = ((ReadBufferOperation *)operation)->getMemoryProxy();
+    uint64_t input_key = 0;
+    valid = get_operation_key(proxy->getWriteBufferOperation(), keys, &input_key);
+    key = BufferCache::hash(key, &input_key, sizeof(input_key));
+  }
+  for (unsigned int index = 0; valid && index < operation->getNumberOfInputSockets(); index++) {
+    NodeOperationInput *input = operation->getInputSocket(index);
+    uint64_t input_key = 0;
+    valid = input->isConnected() &&
+            get_operation_key(&input->getLink()->getOperation(), keys, &input_key);
+    key = BufferCache::hash(key, &input_key, sizeof(input_key));
+  }
+
+  keys[operation] = std::make_pair(valid, key);
+  *r_key = key;
+  return valid;
+}
+
+void ExecutionSystem::read_buffer_cache(GroupKeys &r_groups_to_cache)
+{
+  /* settings of the context that change the outputs of operations */
+  const CompositorQuality quality = this->m_context.getQuality();
+  const bool fast_calculation = this->m_context.isFastCalculation();
+
+  OperationKeys keys;
+  for (unsigned int index = 0; index < this->m_groups.size(); index++) {
+    ExecutionGroup *group = this->m_groups[index];
+    NodeOperation *output = group->getOutputOperation();
+    /* outputs of output groups are not buffers the other groups read from */
+    if (group->isOutputExecutionGroup() || !output->isWriteBufferOperation()) {
+      continue;
+    }
+
+    uint64_t key;
+    if (!get_operation_key(output, keys, &key)) {
+      continue;
+    }
+    key = BufferCache::hash(key, &quality, sizeof(quality));
+    key = BufferCache::hash(key, &fast_calculation, sizeof(fast_calculation));
+
+    MemoryBuffer *buffer = ((WriteBufferOperation *)output)->getMemoryProxy()->getBuffer();
+    MemoryBuffer *cached_buffer = BufferCache::find(key);
+    if (cached_buffer && cached_buffer->getWidth() == buffer->getWidth() &&
+        cached_buffer->getHeight() == buffer->getHeight() &&
+        cached_buffer->get_num_channels() == buffer->get_num_channels()) {
+      buffer->copyContentFrom(cached_buffer);
+      group->mark_executed();
+    }
+    else {
+      r_groups_to_cache.push_back(std::make_pair(group, key));
+    }
+  }
+}
+
+void ExecutionSystem::write_buffer_cache(const GroupKeys &groups_to_cache)
+{
+  for (unsigned int index = 0; index < groups_to_cache.size(); index++) {
+    ExecutionGroup *group = groups_to_cache[index].first;
+    if (!group->is_fully_executed()) {
+      continue;
+    }
+
+    MemoryProxy *proxy = ((WriteBufferOperation *)group->getOutputOperation())->getMemoryProxy();
+    MemoryBuffer *buffer = proxy->getBuffer();
+    MemoryBuffer *cached_buffer = new MemoryBuffer(proxy->getDataType(), buffer->getRect());
+    cached_buffer->copyContentFrom(buffer);
+    BufferCache::add(groups_to_cache[index].second, cached_buffer);
+  }
+}
+
+/* depth-first ordering of the operations needed to calculate an output operation */
+static void add_full_frame_operations_recursive(ExecutionSystem::Operations &order,
+                                                std::set<NodeOperation *> &visited,
+                                                NodeOperation *operation)
+{
+  if (visited.find(operation) != visited.end()) {
+    return;
+  }
+  visited.insert(operation);
+
+  for (unsigned int index = 0; index < operation->getNumberOfInputSockets(); index++) {
+    NodeOperationInput *input = operation->getInputSocket(index);
+    add_full_frame_operations_recursive(order, visited, &input->getLink()->getOperation());
+  }
+
+  order.push_back(operation);
+}
+
+void ExecutionSystem::execute_full_frame()
+{
+  const bNodeTree *editingtree = this->m_context.getbNodeTree();
+  unsigned int index;
+
   for (index = 0; index < this->m_operations.size(); index++) {
     NodeOperation *operation = this->m_operations[index];
-    operation->deinitExecution();
+    operation->setbNodeTree(editingtree);
+    operation->initExecution();
   }
-  for (index = 0; index < this->m_groups.size(); index++) {
-    ExecutionGroup *executionGroup = this->m_groups[index];
-    executionGroup->deinitExecution();
+
+  /* Outputs of higher priority are calculated first,
+   * inputs are always calculated before the operations reading them. */
+  const CompositorPriority priorities[] = {
+      COM_PRIORITY_HIGH, COM_PRIORITY_MEDIUM, COM_PRIORITY_LOW};
+  const int num_priorities = this->m_context.isFastCalculation() ? 1 : 3;
+  const bool rendering = this->m_context.isRendering();
+
+  Operations order;
+  std::set<NodeOperation *> visited;
+  for (int priority = 0; priority < num_priorities; priority++) {
+    for (index = 0; index < this->m_operations.size(); index++) {
+      NodeOperation *operation = this->m_operations[index];
+      if (operation->isOutputOperation(rendering) &&
+          operation->getRenderPriority() == priorities[priority]) {
+        add_full_frame_operations_recursive(order, visited, operation);
+      }
+    }
+  }
+
+  /* Output buffers are freed as soon as all the operations reading them are executed. */
+  std::map<NodeOperation *, int> num_readers;
+  for (index = 0; index < order.size(); index++) {
+    NodeOperation *operation = order[index];
+    for (unsigned int i = 0; i < operation->getNumberOfInputSockets(); i++) {
+      num_readers[&operation->getInputSocket(i)->getLink()->getOperation()]++;
+    }
   }
+
+  std::map<NodeOperation *, MemoryBuffer *> buffers;
+  std::vector<MemoryBuffer *> inputs;
+  for (index = 0; index < order.size(); index++) {
+    NodeOperation *operation = order[index];
+    if (operation->isBraked()) {
+      break;
+    }
+
+    const unsigned int num_inputs = operation->getNumberOfInputSockets();
+    inputs.resize(num_inputs);
+    for (unsigned int i = 0; i < num_inputs; i++) {
+      inputs[i] = buffers[&operation->getInputSocket(i)->getLink()->getOperation()];
+    }
+
+    rcti area;
+    BLI_rcti_init(&area, 0, operation->getWidth(), 0, operation->getHeight());
+
+    MemoryBuffer *output = nullptr;
+    if (operation->getNumberOfOutputSockets() > 0) {
+      output = new MemoryBuffer(
+          operation->getOutputSocket()->getDataType(), area, operation->isSetOperation());
+      buffers[operation] = output;
+    }
+
+    execute_full_frame_operation(operation, output, area, inputs.data());
+
+    for (unsigned int i = 0; i < num_inputs; i++) {
+      NodeOperation *input_operation = &operation->getInputSocket(i)->getLink()->getOperation();
+      if (--num_readers[input_operation] == 0) {
+        delete buffers[input_operation];
+        buffers.erase(input_operation);
+      }
+    }
+
+    float progress = (float)(index + 1) / order.size();
+    editingtree->progress(editingtree->prh, progress);
+
+    char buf[128];
+    BLI_snprintf(buf,
+                 sizeof(buf),
+                 TIP_("Compositing | Operation %u-%u"),
+                 index + 1,
+                 (unsigned int)order.size());
+    editingtree->stats_draw(editingtree->sdh, buf);
+  }
+
+  /* buffers of canceled executions and of operations nothing reads from */
+  for (std::map<NodeOperation *, MemoryBuffer *>::iterator it = buffers.begin();
+       it != buffers.end();
+       ++it) {
+    delete it->second;
+  }
+}
+
+void ExecutionSystem::execute_full_frame_operation(NodeOperation *operation,
+                                                   MemoryBuffer *output,
+                                                   const rcti &area,
+                                                   MemoryBuffer **inputs)
+{
+  if (BLI_rcti_is_empty(&area)) {
+    return;
+  }
+
+  if (output && output->is_a_single_elem()) {
+    /* constant results are only calculated once */
+    rcti elem_area;
+    BLI_rcti_init(&elem_area, area.xmin, area.xmin + 1, area.ymin, area.ymin + 1);
+    operation->update_memory_buffer(output, elem_area, inputs);
+    return;
+  }
+
+  if (operation->isSingleThreaded()) {
+    operation->update_memory_buffer(output, area, inputs);
+    return;
+  }
+
+  /* split the area in bands of rows, each about the size of a chunk */
+  const int chunksize = this->m_context.getChunksize();
+  const int64_t rows_per_task = max_ii(1, chunksize * chunksize / BLI_rcti_size_x(&area));
+
+  blender::parallel_for(blender::IndexRange(area.ymin, BLI_rcti_size_y(&area)),
+                        rows_per_task,
+                        [&](const blender::IndexRange rows) {
+                          rcti sub_area;
+                          BLI_rcti_init(&sub_area,
+                                        area.xmin,
+                                        area.xmax,
+                                        (int)rows.first(),
+                                        (int)rows.one_after_last());
+                          operation->update_memory_buffer(output, sub_area, inputs);
+                        });
 }
 
 void ExecutionSystem::executeGroups(CompositorPriority priority)
@@ -116,6 +116,7 @@ class ExecutionSystem {
  public:
   typedef std::vector<NodeOperation *> Operations;
   typedef std::vector<ExecutionGroup *> Groups;
+  typedef std::vector<std::pair<ExecutionGroup *, uint64_t>> GroupKeys;
 
  private:
   /**
@@ -169,6 +170,16 @@ class ExecutionSystem {
 
   void set_operations(const Operations &operations, const Groups &groups);
 
+  /**
+   * \brief set how the operations of this system are executed
+   * \note used by the NodeOperationBuilder to fall back to tiled execution when not all
+   * operations support full frame execution.
+   */
+  void set_execution_model(ExecutionModel executionModel)
+  {
+    this->m_context.setExecutionModel(executionModel);
+  }
+
   /**
    * \brief execute this system
    * - initialize the NodeOperation's and ExecutionGroup's
@@ -188,6 +199,36 @@ class ExecutionSystem {
  private:
   void executeGroups(CompositorPriority priority);
 
+  /**
+   * \brief execute the ExecutionGroup's a chunk at a time
+   */
+  void execute_tiled();
+
+  /**
+   * \brief fill the outputs of ExecutionGroup's from the BufferCache when their result didn't
+   * change since a previous execution
+   * \param r_groups_to_cache: groups that aren't cached yet, with their cache keys
+   */
+  void read_buffer_cache(GroupKeys &r_groups_to_cache);
+
+  /**
+   * \brief store the outputs of the executed ExecutionGroup's in the BufferCache
+   */
+  void write_buffer_cache(const GroupKeys &groups_to_cache);
+
+  /**
+   * \brief execute the operations one after the other, each on its whole output buffer
+   */
+  void execute_full_frame();
+
+  /**
+   * \brief calculate an area of the output of a full frame operation, using multiple threads
+   */
+  void execute_full_frame_operation(NodeOperation *operation,
+                                    MemoryBuffer *output,
+                                    const rcti &area,
+                                    MemoryBuffer **inputs);
+
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
 
@@ -38,6 +38,9 @@ static unsigned int determine_num_channels(DataType datatype)
 
 unsigned int MemoryBuffer::determineBufferSize()
 {
+  if (this->m_is_a_single_elem) {
+    return 1;
+  }
   return getWidth() * getHeight();
 }
 
@@ -57,6 +60,7 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, r
   this->m_height = BLI_rcti_size_y(&this->m_rect);
   this->m_memoryProxy = memoryProxy;
   this->m_chunkNumber = chunkNumber;
+  this->m_is_a_single_elem = false;
   this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
   this->m_buffer = (float *)MEM_mallocN_aligned(
       sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
@@ -71,6 +75,7 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, rcti *rect)
   this->m_height = BLI_rcti_size_y(&this->m_rect);
   this->m_memoryProxy = memoryProxy;
   this->m_chunkNumber = -1;
+  this->m_is_a_single_elem = false;
   this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
   this->m_buffer = (float *)MEM_mallocN_aligned(
       sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
@@ -85,12 +90,39 @@ MemoryBuffer::MemoryBuffer(DataType dataType, rcti *rect)
   this->m_height = this->m_rect.ymax - this->m_rect.ymin;
   this->m_memoryProxy = nullptr;
   this->m_chunkNumber = -1;
+  this->m_is_a_single_elem = false;
   this->m_num_channels = determine_num_channels(dataType);
   this->m_buffer = (float *)MEM_mallocN_aligned(
       sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
   this->m_state = COM_MB_TEMPORARILY;
   this->m_datatype = dataType;
 }
+
+MemoryBuffer::MemoryBuffer(DataType dataType, const rcti &rect, bool is_a_single_elem)
+{
+  this->m_rect = rect;
+  this->m_width = BLI_rcti_size_x(&this->m_rect);
+  this->m_height = BLI_rcti_size_y(&this->m_rect);
+  this->m_is_a_single_elem = is_a_single_elem;
+  this->m_memoryProxy = nullptr;
+  this->m_chunkNumber = -1;
+  this->m_num_channels = determine_num_channels(dataType);
+  this->m_buffer = (float *)MEM_mallocN_aligned(
+      sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+  this->m_state = COM_MB_TEMPORARILY;
+  this->m_datatype = dataType;
+}
+
+void MemoryBuffer::read_elem_checked(int x, int y, float *out) const
+{
+  if (!this->m_is_a_single_elem && (x < this->m_rect.xmin || x >= this->m_rect.xmax ||
+                                    y < this->m_rect.ymin || y >= this->m_rect.ymax)) {
+    memset(out, 0, sizeof(float) * this->m_num_channels);
+    return;
+  }
+  memcpy(out, getElem(x, y), sizeof(float) * this->m_num_channels);
+}
+
 MemoryBuffer *MemoryBuffer::duplicate()
 {
   MemoryBuffer *result = new MemoryBuffer(this->m_memoryProxy, &this->m_rect);
@@ -94,6 +94,11 @@ class MemoryBuffer {
   int m_width;
   int m_height;
 
+  /**
+   * \brief whether the buffer holds a single element used for all pixels of its rect
+   */
+  bool m_is_a_single_elem;
+
  public:
   /**
    * \brief construct new MemoryBuffer for a chunk
@@ -110,6 +115,13 @@ class MemoryBuffer {
    */
   MemoryBuffer(DataType datatype, rcti *rect);
 
+  /**
+   * \brief construct new full frame buffer for an area
+   * \param is_a_single_elem: store a single element that is used for all pixels of the area,
+   * for constant results.
+   */
+  MemoryBuffer(DataType datatype, const rcti &rect, bool is_a_single_elem);
+
   /**
    * \brief destructor
    */
@@ -137,6 +149,43 @@ class MemoryBuffer {
     return this->m_buffer;
   }
 
+  /**
+   * \brief whether this buffer holds a single element used for all pixels of its rect
+   */
+  bool is_a_single_elem() const
+  {
+    return this->m_is_a_single_elem;
+  }
+
+  /**
+   * \brief distance in floats between two horizontally neighboring elements,
+   * zero for single element buffers
+   */
+  int get_elem_stride() const
+  {
+    return this->m_is_a_single_elem ? 0 : this->m_num_channels;
+  }
+
+  /**
+   * \brief get a pointer to the element at the given coordinates
+   * \note coordinates are not checked, they should be inside of the rect of this buffer
+   */
+  float *getElem(int x, int y) const
+  {
+    if (this->m_is_a_single_elem) {
+      return this->m_buffer;
+    }
+    BLI_assert(x >= this->m_rect.xmin && x < this->m_rect.xmax);
+    BLI_assert(y >= this->m_rect.ymin && y < this->m_rect.ymax);
+    return this->m_buffer + ((y - this->m_rect.ymin) * this->m_width + (x - this->m_rect.xmin)) *
+                                this->m_num_channels;
+  }
+
+  /**
+   * \brief read the element at the given coordinates, result is zero outside of the rect
+   */
+  void read_elem_checked(int x, int y, float *out) const;
+
   /**
    * \brief after execution the state will be set to available by calling this method
    */
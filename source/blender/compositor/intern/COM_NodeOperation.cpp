@@ -17,8 +17,11 @@
  */
 
 #include <cstdio>
+#include <cstring>
 #include <typeinfo>
 
+#include "COM_BufferCache.h"
+#include "COM_BuffersIterator.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_defines.h"
 
@@ -36,6 +39,9 @@ NodeOperation::NodeOperation()
   this->m_height = 0;
   this->m_isResolutionSet = false;
   this->m_openCL = false;
+  this->m_fullFrame = false;
+  this->m_canBeConstant = false;
+  this->m_params_hash = 0;
   this->m_btree = nullptr;
 }
 
@@ -134,6 +140,38 @@ void NodeOperation::deinitExecution()
 {
   /* pass */
 }
+
+void NodeOperation::update_memory_buffer(MemoryBuffer *output,
+                                         const rcti &area,
+                                         MemoryBuffer **inputs)
+{
+  BuffersIterator it(output, area, inputs, getNumberOfInputSockets());
+  update_memory_buffer_partial(it);
+}
+
+bool NodeOperation::get_params_hash(uint64_t *r_hash)
+{
+  this->m_params_hash = BufferCache::HASH_SEED;
+  const char *type_name = typeid(*this).name();
+  hash_param_data(type_name, strlen(type_name));
+  if (!hash_output_params()) {
+    return false;
+  }
+
+  hash_param(this->m_width);
+  hash_param(this->m_height);
+  for (unsigned int index = 0; index < getNumberOfOutputSockets(); index++) {
+    hash_param(getOutputSocket(index)->getDataType());
+  }
+  *r_hash = this->m_params_hash;
+  return true;
+}
+
+void NodeOperation::hash_param_data(const void *data, size_t size)
+{
+  this->m_params_hash = BufferCache::hash(this->m_params_hash, data, size);
+}
+
 SocketReader *NodeOperation::getInputSocketReader(unsigned int inputSocketIndex)
 {
   return this->getInputSocket(inputSocketIndex)->getReader();
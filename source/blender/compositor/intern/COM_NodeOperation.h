@@ -37,6 +37,7 @@ using std::list;
 using std::max;
 using std::min;
 
+class BuffersIterator;
 class OpenCLDevice;
 class ReadBufferOperation;
 class WriteBufferOperation;
@@ -102,6 +103,23 @@ class NodeOperation : public SocketReader {
    */
   bool m_openCL;
 
+  /**
+   * \brief can this operation be executed a full frame buffer at a time.
+   * \see NodeOperation.update_memory_buffer
+   */
+  bool m_fullFrame;
+
+  /**
+   * \brief is the output constant when all inputs are constant
+   * \see NodeOperation.canBeConstant
+   */
+  bool m_canBeConstant;
+
+  /**
+   * \brief hash of the settings of this operation, see NodeOperation.get_params_hash
+   */
+  uint64_t m_params_hash;
+
   /**
    * \brief mutex reference for very special node initializations
    * \note only use when you really know what you are doing.
@@ -245,6 +263,38 @@ class NodeOperation : public SocketReader {
   }
   virtual void deinitExecution();
 
+  /**
+   * \brief when executing full frame, this method is called to calculate an area of the output
+   * \ingroup execution
+   * \note only called for operations that are full frame operations. Can be called from multiple
+   * threads at once for different areas of the same output buffer.
+   * \param output: buffer of the whole output of the operation, nullptr for output operations
+   * \param area: the area of the output to calculate
+   * \param inputs: buffers of the whole outputs of the input operations, in socket order
+   */
+  virtual void update_memory_buffer(MemoryBuffer *output,
+                                    const rcti &area,
+                                    MemoryBuffer **inputs);
+
+  /**
+   * \brief calculate all the elements of the given iterator
+   * \ingroup execution
+   * \note called by the default implementation of update_memory_buffer.
+   */
+  virtual void update_memory_buffer_partial(BuffersIterator & /*it*/)
+  {
+  }
+
+  /**
+   * \brief get a hash of the type, resolution and settings of this operation
+   * Together with the hashes of the input operations it identifies the output of the operation,
+   * which is used to cache results between executions.
+   * \note must be called after initExecution.
+   * \return false when the output can't be identified by a hash.
+   * \see NodeOperation.hash_output_params
+   */
+  bool get_params_hash(uint64_t *r_hash);
+
   bool isResolutionSet()
   {
     return this->m_isResolutionSet;
@@ -276,6 +326,40 @@ class NodeOperation : public SocketReader {
     return this->m_complex;
   }
 
+  /**
+   * \brief can this operation be executed a full frame buffer at a time
+   * \see NodeOperation.update_memory_buffer
+   */
+  bool isFullFrameOperation() const
+  {
+    return this->m_fullFrame;
+  }
+
+  /**
+   * \brief is the output of this operation constant when all its inputs are constant
+   * Operations for which this is true only read their inputs at the position of the element
+   * they calculate, and don't depend on the resolution. They are replaced by constant operations
+   * by NodeOperationBuilder when all their inputs are constant.
+   * \note only applicable to full frame operations, which are used to calculate the constant.
+   */
+  bool canBeConstant() const
+  {
+    return this->m_canBeConstant;
+  }
+
+  /**
+   * \brief get the input socket whose value this operation outputs unchanged
+   * Used by NodeOperationBuilder to remove operations that don't change their input, like adding
+   * zero.
+   * \param constant_inputs: for every input socket the constant element it is linked to, or
+   * nullptr when the input is not constant
+   * \return index of the input socket, or -1 when the output is not equal to one of the inputs
+   */
+  virtual int get_identity_input(const float *const * /*constant_inputs*/) const
+  {
+    return -1;
+  }
+
   virtual bool isSetOperation() const
   {
     return false;
@@ -322,6 +406,10 @@ class NodeOperation : public SocketReader {
    * \param index: the index to set
    */
   void setResolutionInputSocketIndex(unsigned int index);
+  unsigned int getResolutionInputSocketIndex() const
+  {
+    return this->m_resolutionInputSocketIndex;
+  }
 
   /**
    * \brief get the render priority of this node.
@@ -420,6 +508,42 @@ class NodeOperation : public SocketReader {
     this->m_openCL = openCL;
   }
 
+  /**
+   * \brief set if this NodeOperation implements full frame execution
+   * \see NodeOperation.update_memory_buffer
+   */
+  void setFullFrameOperation(bool fullFrame)
+  {
+    this->m_fullFrame = fullFrame;
+  }
+
+  /**
+   * \brief set if the output of this NodeOperation is constant when all inputs are constant
+   * \see NodeOperation.canBeConstant
+   */
+  void setCanBeConstant(bool canBeConstant)
+  {
+    this->m_canBeConstant = canBeConstant;
+  }
+
+  /**
+   * \brief hash the settings the output of this operation depends on, other than its inputs
+   * Use NodeOperation.hash_param for every setting.
+   * \return false when the output can't be identified by a hash (the default), for example
+   * because it depends on data that can change between executions. Outputs of these operations
+   * and of all operations depending on them are never cached.
+   */
+  virtual bool hash_output_params()
+  {
+    return false;
+  }
+
+  template<typename T> void hash_param(const T &param)
+  {
+    hash_param_data(&param, sizeof(T));
+  }
+  void hash_param_data(const void *data, size_t size);
+
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
 
@@ -16,6 +16,9 @@
  * Copyright 2013, Blender Foundation.
  */
 
+#include <vector>
+
+#include "BLI_rect.h"
 #include "BLI_utildefines.h"
 
 #include "COM_Converter.h"
@@ -102,8 +105,28 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 
   add_datatype_conversions();
 
+  /* replace constant chains */
+  const int num_folded = fold_constant_operations();
+
   determineResolutions();
 
+  /* remove operations that don't change their input, needs the resolutions */
+  const int num_removed = remove_identity_operations();
+  DebugInfo::operations_optimized(num_folded, num_removed);
+
+  if (m_context->getExecutionModel() == COM_EXECUTION_MODEL_FULL_FRAME) {
+    if (is_full_frame_supported()) {
+      /* operations are executed one after the other,
+       * no read/write buffers or execution groups are needed */
+      m_links.clear();
+      prune_operations();
+      system->set_operations(m_operations, m_groups);
+      return;
+    }
+    /* some operations can only be executed per chunk */
+    system->set_execution_model(COM_EXECUTION_MODEL_TILED);
+  }
+
   /* surround complex ops with read/write buffer */
   add_complex_operation_buffers();
 
@@ -405,6 +428,178 @@ void NodeOperationBuilder::resolve_proxies()
   }
 }
 
+/* Constant operations output the same element everywhere. */
+static bool is_constant_operation(const NodeOperation *operation)
+{
+  return operation->isSetOperation() && operation->isFullFrameOperation();
+}
+
+static NodeOperation *find_constant_input(const NodeOperation *operation, unsigned int index)
+{
+  NodeOperationOutput *link = operation->getInputSocket(index)->getLink();
+  if (link && is_constant_operation(&link->getOperation())) {
+    return &link->getOperation();
+  }
+  return nullptr;
+}
+
+/* Calculate the single element output of an operation whose inputs are all constant. */
+static MemoryBuffer *calculate_constant_output(NodeOperation *operation)
+{
+  rcti area;
+  BLI_rcti_init(&area, 0, 1, 0, 1);
+
+  const unsigned int num_inputs = operation->getNumberOfInputSockets();
+  std::vector<MemoryBuffer *> inputs(num_inputs);
+  for (unsigned int index = 0; index < num_inputs; index++) {
+    inputs[index] = calculate_constant_output(find_constant_input(operation, index));
+  }
+
+  MemoryBuffer *output = new MemoryBuffer(
+      operation->getOutputSocket()->getDataType(), area, true);
+  operation->initExecution();
+  operation->update_memory_buffer(output, area, inputs.data());
+  operation->deinitExecution();
+
+  for (unsigned int index = 0; index < num_inputs; index++) {
+    delete inputs[index];
+  }
+  return output;
+}
+
+static NodeOperation *make_constant_operation(DataType datatype, const float *elem)
+{
+  switch (datatype) {
+    case COM_DT_VALUE: {
+      SetValueOperation *operation = new SetValueOperation();
+      operation->setValue(elem[0]);
+      return operation;
+    }
+    case COM_DT_VECTOR: {
+      SetVectorOperation *operation = new SetVectorOperation();
+      operation->setVector(elem);
+      return operation;
+    }
+    case COM_DT_COLOR: {
+      SetColorOperation *operation = new SetColorOperation();
+      operation->setChannels(elem);
+      return operation;
+    }
+  }
+  BLI_assert(!"Unknown data type");
+  return nullptr;
+}
+
+void NodeOperationBuilder::replace_output_links(NodeOperationOutput *output,
+                                                NodeOperationOutput *new_output)
+{
+  OpInputs inputs = cache_output_links(output);
+  for (OpInputs::const_iterator it = inputs.begin(); it != inputs.end(); ++it) {
+    NodeOperationInput *input = *it;
+    removeInputLink(input);
+    addLink(new_output, input);
+  }
+}
+
+int NodeOperationBuilder::fold_constant_operations()
+{
+  int num_folded = 0;
+  /* folding an operation can make the operations reading it constant,
+   * repeat until no operation is folded anymore */
+  bool folded = true;
+  while (folded) {
+    folded = false;
+    /* copy, folding adds operations */
+    Operations operations = m_operations;
+    for (Operations::const_iterator it = operations.begin(); it != operations.end(); ++it) {
+      NodeOperation *op = *it;
+      if (!op->canBeConstant() || !op->isFullFrameOperation() ||
+          op->getNumberOfOutputSockets() != 1) {
+        continue;
+      }
+      /* unused operations, including the already folded ones, are removed later */
+      if (cache_output_links(op->getOutputSocket()).empty()) {
+        continue;
+      }
+      bool is_constant = true;
+      for (unsigned int index = 0; index < op->getNumberOfInputSockets(); index++) {
+        if (!find_constant_input(op, index)) {
+          is_constant = false;
+          break;
+        }
+      }
+      if (!is_constant) {
+        continue;
+      }
+
+      MemoryBuffer *output = calculate_constant_output(op);
+      NodeOperation *constant = make_constant_operation(op->getOutputSocket()->getDataType(),
+                                                        output->getBuffer());
+      delete output;
+
+      addOperation(constant);
+      replace_output_links(op->getOutputSocket(), constant->getOutputSocket());
+      num_folded++;
+      folded = true;
+    }
+  }
+  return num_folded;
+}
+
+int NodeOperationBuilder::remove_identity_operations()
+{
+  int num_removed = 0;
+  for (Operations::const_iterator it = m_operations.begin(); it != m_operations.end(); ++it) {
+    NodeOperation *op = *it;
+    const unsigned int num_inputs = op->getNumberOfInputSockets();
+    if (num_inputs == 0 || op->getNumberOfOutputSockets() != 1) {
+      continue;
+    }
+    if (cache_output_links(op->getOutputSocket()).empty()) {
+      continue;
+    }
+
+    std::vector<MemoryBuffer *> constants(num_inputs, nullptr);
+    std::vector<const float *> constant_elems(num_inputs, nullptr);
+    for (unsigned int index = 0; index < num_inputs; index++) {
+      NodeOperation *constant = find_constant_input(op, index);
+      if (constant) {
+        constants[index] = calculate_constant_output(constant);
+        constant_elems[index] = constants[index]->getBuffer();
+      }
+    }
+    const int identity_index = op->get_identity_input(constant_elems.data());
+    for (unsigned int index = 0; index < num_inputs; index++) {
+      delete constants[index];
+    }
+    if (identity_index < 0) {
+      continue;
+    }
+
+    /* Readers of the operation must keep their resolution: the identity input has to decide the
+     * resolution of the operation, or be its only input that isn't constant. */
+    bool other_inputs_constant = true;
+    for (unsigned int index = 0; index < num_inputs; index++) {
+      if (index != (unsigned int)identity_index && constant_elems[index] == nullptr) {
+        other_inputs_constant = false;
+      }
+    }
+    if (!other_inputs_constant &&
+        op->getResolutionInputSocketIndex() != (unsigned int)identity_index) {
+      continue;
+    }
+
+    NodeOperationOutput *identity = op->getInputSocket(identity_index)->getLink();
+    if (identity && identity->getDataType() == op->getOutputSocket()->getDataType() &&
+        identity->getOperation().getWidth() == op->getWidth() &&
+        identity->getOperation().getHeight() == op->getHeight()) {
+      replace_output_links(op->getOutputSocket(), identity);
+      num_removed++;
+    }
+  }
+  return num_removed;
+}
+
 void NodeOperationBuilder::determineResolutions()
 {
   /* determine all resolutions of the operations (Width/Height) */
@@ -649,6 +844,31 @@ void NodeOperationBuilder::prune_operations()
   m_operations = reachable_ops;
 }
 
+bool NodeOperationBuilder::is_full_frame_supported() const
+{
+  Tags reachable;
+  for (Operations::const_iterator it = m_operations.begin(); it != m_operations.end(); ++it) {
+    NodeOperation *op = *it;
+    if (op->isOutputOperation(m_context->isRendering())) {
+      find_reachable_operations_recursive(reachable, op);
+    }
+  }
+
+  for (Tags::const_iterator it = reachable.begin(); it != reachable.end(); ++it) {
+    NodeOperation *op = *it;
+    if (!op->isFullFrameOperation()) {
+      return false;
+    }
+    /* input buffers are read for every socket */
+    for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+      if (!op->getInputSocket(i)->isConnected()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 /* topological (depth-first) sorting of operations */
 static void sort_operations_recursive(NodeOperationBuilder::Operations &sorted,
                                       Tags &visited,
@@ -146,6 +146,20 @@ class NodeOperationBuilder {
   /** Replace proxy operations with direct links */
   void resolve_proxies();
 
+  /**
+   * Replace operations with constant inputs by constant operations
+   * \return the number of replaced operations
+   */
+  int fold_constant_operations();
+  /**
+   * Remove operations that output one of their inputs unchanged, at the same resolution.
+   * Needs the resolutions of the operations.
+   * \return the number of removed operations
+   */
+  int remove_identity_operations();
+  /** Move all links from an operation output to another output */
+  void replace_output_links(NodeOperationOutput *output, NodeOperationOutput *new_output);
+
   /** Calculate resolution for each operation */
   void determineResolutions();
 
@@ -161,6 +175,9 @@ class NodeOperationBuilder {
   /** Remove unreachable operations */
   void prune_operations();
 
+  /** Check if all reachable operations can be executed a full frame at a time */
+  bool is_full_frame_supported() const;
+
   /** Sort operations by link dependencies */
   void sort_operations();
 
@@ -23,6 +23,7 @@
 #include "BKE_node.h"
 #include "BKE_scene.h"
 
+#include "COM_BufferCache.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_MovieDistortionOperation.h"
 #include "COM_WorkScheduler.h"
@@ -90,6 +91,11 @@ void COM_execute(RenderData *render_data,
   compositor_init_node_previews(render_data, node_tree);
   compositor_reset_node_tree_status(node_tree);
 
+  /* Buffers cached while editing are not used for rendering, free them. */
+  if (rendering) {
+    BufferCache::clear();
+  }
+
   /* Initialize workscheduler. */
   const bool use_opencl = (node_tree->flag & NTREE_COM_OPENCL) != 0;
   WorkScheduler::initialize(use_opencl, BKE_render_num_threads(render_data));
@@ -119,6 +125,7 @@ void COM_deinitialize()
   if (g_compositor.is_initialized) {
     BLI_mutex_lock(&g_compositor.mutex);
     WorkScheduler::deinitialize();
+    BufferCache::clear();
     g_compositor.is_initialized = false;
     BLI_mutex_unlock(&g_compositor.mutex);
     BLI_mutex_end(&g_compositor.mutex);
@@ -16,6 +16,8 @@
  * Copyright 2011, Blender Foundation.
  */
 
+#include "BLI_math_base.h"
+
 #include "COM_BlurNode.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_FastGaussianBlurOperation.h"
@@ -48,9 +50,18 @@ void BlurNode::convertToOperations(NodeConverter &converter,
   CompositorQuality quality = context.getQuality();
   NodeOperation *input_operation = nullptr, *output_operation = nullptr;
 
-  if (data->filtertype == R_FILTER_FAST_GAUSS) {
+  /* The cost of the Gaussian operations grows with the size, large sizes are blurred with the
+   * recursive filter instead, which only has a constant cost per pixel. */
+  const bool use_recursive_gauss = data->filtertype == R_FILTER_GAUSS && !data->bokeh &&
+                                   !data->relative && !connectedSizeSocket &&
+                                   !(editorNode->custom1 & CMP_NODEFLAG_BLUR_VARIABLE_SIZE) &&
+                                   size * min_ii(data->sizex, data->sizey) >=
+                                       MIN_RECURSIVE_GAUSS_RADIUS;
+
+  if (data->filtertype == R_FILTER_FAST_GAUSS || use_recursive_gauss) {
     FastGaussianBlurOperation *operationfgb = new FastGaussianBlurOperation();
     operationfgb->setData(data);
+    operationfgb->setUseGaussianRadius(use_recursive_gauss);
     operationfgb->setExtendBounds(extend_bounds);
     converter.addOperation(operationfgb);
 
@@ -20,7 +20,9 @@
 
 AlphaOverKeyOperation::AlphaOverKeyOperation()
 {
-  /* pass */
+  /* Not ported to the full frame execution model of the mix operations. */
+  this->setFullFrameOperation(false);
+  this->setCanBeConstant(false);
 }
 
 void AlphaOverKeyOperation::executePixelSampled(float output[4],
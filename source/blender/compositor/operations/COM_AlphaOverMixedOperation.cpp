@@ -21,6 +21,9 @@
 AlphaOverMixedOperation::AlphaOverMixedOperation()
 {
   this->m_x = 0.0f;
+  /* Not ported to the full frame execution model of the mix operations. */
+  this->setFullFrameOperation(false);
+  this->setCanBeConstant(false);
 }
 
 void AlphaOverMixedOperation::executePixelSampled(float output[4],
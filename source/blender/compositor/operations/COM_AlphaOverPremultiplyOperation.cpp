@@ -20,7 +20,9 @@
 
 AlphaOverPremultiplyOperation::AlphaOverPremultiplyOperation()
 {
-  /* pass */
+  /* Not ported to the full frame execution model of the mix operations. */
+  this->setFullFrameOperation(false);
+  this->setCanBeConstant(false);
 }
 
 void AlphaOverPremultiplyOperation::executePixelSampled(float output[4],
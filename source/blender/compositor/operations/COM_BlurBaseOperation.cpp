@@ -158,6 +158,25 @@ void BlurBaseOperation::deinitExecution()
   this->m_inputSize = nullptr;
 }
 
+bool BlurBaseOperation::hash_output_params()
+{
+  hash_param(this->m_data.sizex);
+  hash_param(this->m_data.sizey);
+  hash_param(this->m_data.relative);
+  hash_param(this->m_data.aspect);
+  hash_param(this->m_data.percentx);
+  hash_param(this->m_data.percenty);
+  hash_param(this->m_data.filtertype);
+  hash_param(this->m_data.image_in_width);
+  hash_param(this->m_data.image_in_height);
+  hash_param(this->m_size);
+  hash_param(this->m_sizeavailable);
+  hash_param(this->m_extend_bounds);
+  hash_param(this->getStep());
+  hash_param(this->getOffsetAdd());
+  return true;
+}
+
 void BlurBaseOperation::setData(const NodeBlurData *data)
 {
   memcpy(&m_data, data, sizeof(NodeBlurData));
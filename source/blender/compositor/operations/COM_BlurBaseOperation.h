@@ -22,6 +22,8 @@
 #include "COM_QualityStepHelper.h"
 
 #define MAX_GAUSSTAB_RADIUS 30000
+/* Gaussian blurs from this radius on use the recursive filter of FastGaussianBlurOperation. */
+#define MIN_RECURSIVE_GAUSS_RADIUS 32
 
 #include "BLI_simd.h"
 
@@ -74,4 +76,7 @@ class BlurBaseOperation : public NodeOperation, public QualityStepHelper {
   }
 
   void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
+
+ protected:
+  bool hash_output_params();
 };
@@ -138,6 +138,16 @@ void BokehBlurOperation::deinitExecution()
   this->m_inputBoundingBoxReader = nullptr;
 }
 
+bool BokehBlurOperation::hash_output_params()
+{
+  hash_param(this->m_size);
+  hash_param(this->m_sizeavailable);
+  hash_param(this->m_extend_bounds);
+  hash_param(this->getStep());
+  hash_param(this->getOffsetAdd());
+  return true;
+}
+
 bool BokehBlurOperation::determineDependingAreaOfInterest(rcti *input,
                                                           ReadBufferOperation *readOperation,
                                                           rcti *output)
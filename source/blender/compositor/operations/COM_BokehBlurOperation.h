@@ -76,4 +76,7 @@ class BokehBlurOperation : public NodeOperation, public QualityStepHelper {
   }
 
   void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
+
+ protected:
+  bool hash_output_params();
 };
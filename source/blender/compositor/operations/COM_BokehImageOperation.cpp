@@ -118,6 +118,16 @@ void BokehImageOperation::deinitExecution()
   }
 }
 
+bool BokehImageOperation::hash_output_params()
+{
+  hash_param(this->m_data->angle);
+  hash_param(this->m_data->flaps);
+  hash_param(this->m_data->rounding);
+  hash_param(this->m_data->catadioptric);
+  hash_param(this->m_data->lensshift);
+  return true;
+}
+
 void BokehImageOperation::determineResolution(unsigned int resolution[2],
                                               unsigned int /*preferredResolution*/[2])
 {
@@ -148,4 +148,7 @@ class BokehImageOperation : public NodeOperation {
   {
     this->m_deleteData = true;
   }
+
+ protected:
+  bool hash_output_params();
 };
@@ -17,6 +17,7 @@
  */
 
 #include "COM_BrightnessOperation.h"
+#include "COM_BuffersIterator.h"
 
 BrightnessOperation::BrightnessOperation()
 {
@@ -26,6 +27,8 @@ BrightnessOperation::BrightnessOperation()
   this->addOutputSocket(COM_DT_COLOR);
   this->m_inputProgram = nullptr;
   this->m_use_premultiply = false;
+  this->setFullFrameOperation(true);
+  this->setCanBeConstant(true);
 }
 
 void BrightnessOperation::setUsePremultiply(bool use_premultiply)
@@ -83,9 +86,49 @@ void BrightnessOperation::executePixelSampled(float output[4],
   }
 }
 
+void BrightnessOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    float inputValue[4];
+    float a, b;
+    copy_v4_v4(inputValue, it.in(0));
+    float brightness = it.in(1)[0];
+    float contrast = it.in(2)[0];
+    brightness /= 100.0f;
+    float delta = contrast / 200.0f;
+    /* See #executePixelSampled for the origin of the algorithm. */
+    if (contrast > 0) {
+      a = 1.0f - delta * 2.0f;
+      a = 1.0f / max_ff(a, FLT_EPSILON);
+      b = a * (brightness - delta);
+    }
+    else {
+      delta *= -1;
+      a = max_ff(1.0f - delta * 2.0f, 0.0f);
+      b = a * brightness + delta;
+    }
+    if (this->m_use_premultiply) {
+      premul_to_straight_v4(inputValue);
+    }
+    it.out[0] = a * inputValue[0] + b;
+    it.out[1] = a * inputValue[1] + b;
+    it.out[2] = a * inputValue[2] + b;
+    it.out[3] = inputValue[3];
+    if (this->m_use_premultiply) {
+      straight_to_premul_v4(it.out);
+    }
+  }
+}
+
 void BrightnessOperation::deinitExecution()
 {
   this->m_inputProgram = nullptr;
   this->m_inputBrightnessProgram = nullptr;
   this->m_inputContrastProgram = nullptr;
 }
+
+bool BrightnessOperation::hash_output_params()
+{
+  hash_param(this->m_use_premultiply);
+  return true;
+}
@@ -38,6 +38,7 @@ class BrightnessOperation : public NodeOperation {
    * The inner loop of this operation.
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 
   /**
    * Initialize the execution
@@ -50,4 +51,7 @@ class BrightnessOperation : public NodeOperation {
   void deinitExecution();
 
   void setUsePremultiply(bool use_premultiply);
+
+ protected:
+  bool hash_output_params();
 };
@@ -17,6 +17,7 @@
  */
 
 #include "COM_CompositorOperation.h"
+#include "COM_BuffersIterator.h"
 #include "BKE_global.h"
 #include "BKE_image.h"
 #include "BLI_listbase.h"
@@ -50,6 +51,7 @@ CompositorOperation::CompositorOperation()
   this->m_scene = nullptr;
   this->m_sceneName[0] = '\0';
   this->m_viewName = nullptr;
+  this->setFullFrameOperation(true);
 }
 
 void CompositorOperation::initExecution()
@@ -216,6 +218,28 @@ void CompositorOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
   }
 }
 
+void CompositorOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  float *buffer = this->m_outputBuffer;
+  float *zbuffer = this->m_depthBuffer;
+  if (!buffer) {
+    return;
+  }
+
+  const int width = this->getWidth();
+  for (; !it.is_end(); ++it) {
+    const int offset = it.y() * width + it.x();
+    float *color = &buffer[offset * COM_NUM_CHANNELS_COLOR];
+    copy_v4_v4(color, it.in(0));
+    if (this->m_useAlphaInput) {
+      color[3] = *it.in(1);
+    }
+    if (zbuffer) {
+      zbuffer[offset] = *it.in(2);
+    }
+  }
+}
+
 void CompositorOperation::determineResolution(unsigned int resolution[2],
                                               unsigned int preferredResolution[2])
 {
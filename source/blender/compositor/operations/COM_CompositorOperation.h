@@ -87,6 +87,7 @@ class CompositorOperation : public NodeOperation {
     return this->m_active;
   }
   void executeRegion(rcti *rect, unsigned int tileNumber);
+  void update_memory_buffer_partial(BuffersIterator &it);
   void setScene(const struct Scene *scene)
   {
     m_scene = scene;
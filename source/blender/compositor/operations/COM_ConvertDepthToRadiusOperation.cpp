@@ -113,3 +113,15 @@ void ConvertDepthToRadiusOperation::deinitExecution()
 {
   this->m_inputOperation = nullptr;
 }
+
+bool ConvertDepthToRadiusOperation::hash_output_params()
+{
+  hash_param(this->m_fStop);
+  hash_param(this->m_aspect);
+  hash_param(this->m_maxRadius);
+  hash_param(this->m_inverseFocalDistance);
+  hash_param(this->m_aperture);
+  hash_param(this->m_cam_lens);
+  hash_param(this->m_dof_sp);
+  return true;
+}
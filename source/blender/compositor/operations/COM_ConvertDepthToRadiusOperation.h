@@ -80,4 +80,7 @@ class ConvertDepthToRadiusOperation : public NodeOperation {
   {
     this->m_blurPostOperation = operation;
   }
+
+ protected:
+  bool hash_output_params();
 };
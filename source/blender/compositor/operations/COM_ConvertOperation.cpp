@@ -17,12 +17,15 @@
  */
 
 #include "COM_ConvertOperation.h"
+#include "COM_BuffersIterator.h"
 
 #include "IMB_colormanagement.h"
 
 ConvertBaseOperation::ConvertBaseOperation()
 {
   this->m_inputOperation = nullptr;
+  this->setFullFrameOperation(true);
+  this->setCanBeConstant(true);
 }
 
 void ConvertBaseOperation::initExecution()
@@ -35,6 +38,11 @@ void ConvertBaseOperation::deinitExecution()
   this->m_inputOperation = nullptr;
 }
 
+bool ConvertBaseOperation::hash_output_params()
+{
+  return true;
+}
+
 /* ******** Value to Color ******** */
 
 ConvertValueToColorOperation::ConvertValueToColorOperation() : ConvertBaseOperation()
@@ -54,6 +62,15 @@ void ConvertValueToColorOperation::executePixelSampled(float output[4],
   output[3] = 1.0f;
 }
 
+void ConvertValueToColorOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float value = *it.in(0);
+    it.out[0] = it.out[1] = it.out[2] = value;
+    it.out[3] = 1.0f;
+  }
+}
+
 /* ******** Color to Value ******** */
 
 ConvertColorToValueOperation::ConvertColorToValueOperation() : ConvertBaseOperation()
@@ -72,6 +89,14 @@ void ConvertColorToValueOperation::executePixelSampled(float output[4],
   output[0] = (inputColor[0] + inputColor[1] + inputColor[2]) / 3.0f;
 }
 
+void ConvertColorToValueOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float *in = it.in(0);
+    it.out[0] = (in[0] + in[1] + in[2]) / 3.0f;
+  }
+}
+
 /* ******** Color to BW ******** */
 
 ConvertColorToBWOperation::ConvertColorToBWOperation() : ConvertBaseOperation()
@@ -90,6 +115,13 @@ void ConvertColorToBWOperation::executePixelSampled(float output[4],
   output[0] = IMB_colormanagement_get_luminance(inputColor);
 }
 
+void ConvertColorToBWOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    it.out[0] = IMB_colormanagement_get_luminance(it.in(0));
+  }
+}
+
 /* ******** Color to Vector ******** */
 
 ConvertColorToVectorOperation::ConvertColorToVectorOperation() : ConvertBaseOperation()
@@ -108,6 +140,13 @@ void ConvertColorToVectorOperation::executePixelSampled(float output[4],
   copy_v3_v3(output, color);
 }
 
+void ConvertColorToVectorOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    copy_v3_v3(it.out, it.in(0));
+  }
+}
+
 /* ******** Value to Vector ******** */
 
 ConvertValueToVectorOperation::ConvertValueToVectorOperation() : ConvertBaseOperation()
@@ -126,6 +165,14 @@ void ConvertValueToVectorOperation::executePixelSampled(float output[4],
   output[0] = output[1] = output[2] = value;
 }
 
+void ConvertValueToVectorOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float value = *it.in(0);
+    it.out[0] = it.out[1] = it.out[2] = value;
+  }
+}
+
 /* ******** Vector to Color ******** */
 
 ConvertVectorToColorOperation::ConvertVectorToColorOperation() : ConvertBaseOperation()
@@ -143,6 +190,14 @@ void ConvertVectorToColorOperation::executePixelSampled(float output[4],
   output[3] = 1.0f;
 }
 
+void ConvertVectorToColorOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    copy_v3_v3(it.out, it.in(0));
+    it.out[3] = 1.0f;
+  }
+}
+
 /* ******** Vector to Value ******** */
 
 ConvertVectorToValueOperation::ConvertVectorToValueOperation() : ConvertBaseOperation()
@@ -161,6 +216,14 @@ void ConvertVectorToValueOperation::executePixelSampled(float output[4],
   output[0] = (input[0] + input[1] + input[2]) / 3.0f;
 }
 
+void ConvertVectorToValueOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float *in = it.in(0);
+    it.out[0] = (in[0] + in[1] + in[2]) / 3.0f;
+  }
+}
+
 /* ******** RGB to YCC ******** */
 
 ConvertRGBToYCCOperation::ConvertRGBToYCCOperation() : ConvertBaseOperation()
@@ -203,6 +266,26 @@ void ConvertRGBToYCCOperation::executePixelSampled(float output[4],
   output[3] = inputColor[3];
 }
 
+bool ConvertRGBToYCCOperation::hash_output_params()
+{
+  hash_param(this->m_mode);
+  return true;
+}
+
+void ConvertRGBToYCCOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float *in = it.in(0);
+    float color[3];
+    rgb_to_ycc(in[0], in[1], in[2], &color[0], &color[1], &color[2], this->m_mode);
+
+    /* divided by 255 to normalize for viewing in */
+    /* R,G,B --> Y,Cb,Cr */
+    mul_v3_v3fl(it.out, color, 1.0f / 255.0f);
+    it.out[3] = in[3];
+  }
+}
+
 /* ******** YCC to RGB ******** */
 
 ConvertYCCToRGBOperation::ConvertYCCToRGBOperation() : ConvertBaseOperation()
@@ -249,6 +332,26 @@ void ConvertYCCToRGBOperation::executePixelSampled(float output[4],
   output[3] = inputColor[3];
 }
 
+bool ConvertYCCToRGBOperation::hash_output_params()
+{
+  hash_param(this->m_mode);
+  return true;
+}
+
+void ConvertYCCToRGBOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float *in = it.in(0);
+    /* need to un-normalize the data */
+    /* R,G,B --> Y,Cb,Cr */
+    float color[3];
+    mul_v3_v3fl(color, in, 255.0f);
+
+    ycc_to_rgb(color[0], color[1], color[2], &it.out[0], &it.out[1], &it.out[2], this->m_mode);
+    it.out[3] = in[3];
+  }
+}
+
 /* ******** RGB to YUV ******** */
 
 ConvertRGBToYUVOperation::ConvertRGBToYUVOperation() : ConvertBaseOperation()
@@ -274,6 +377,15 @@ void ConvertRGBToYUVOperation::executePixelSampled(float output[4],
   output[3] = inputColor[3];
 }
 
+void ConvertRGBToYUVOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float *in = it.in(0);
+    rgb_to_yuv(in[0], in[1], in[2], &it.out[0], &it.out[1], &it.out[2], BLI_YUV_ITU_BT709);
+    it.out[3] = in[3];
+  }
+}
+
 /* ******** YUV to RGB ******** */
 
 ConvertYUVToRGBOperation::ConvertYUVToRGBOperation() : ConvertBaseOperation()
@@ -299,6 +411,15 @@ void ConvertYUVToRGBOperation::executePixelSampled(float output[4],
   output[3] = inputColor[3];
 }
 
+void ConvertYUVToRGBOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float *in = it.in(0);
+    yuv_to_rgb(in[0], in[1], in[2], &it.out[0], &it.out[1], &it.out[2], BLI_YUV_ITU_BT709);
+    it.out[3] = in[3];
+  }
+}
+
 /* ******** RGB to HSV ******** */
 
 ConvertRGBToHSVOperation::ConvertRGBToHSVOperation() : ConvertBaseOperation()
@@ -318,6 +439,15 @@ void ConvertRGBToHSVOperation::executePixelSampled(float output[4],
   output[3] = inputColor[3];
 }
 
+void ConvertRGBToHSVOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float *in = it.in(0);
+    rgb_to_hsv_v(in, it.out);
+    it.out[3] = in[3];
+  }
+}
+
 /* ******** HSV to RGB ******** */
 
 ConvertHSVToRGBOperation::ConvertHSVToRGBOperation() : ConvertBaseOperation()
@@ -340,6 +470,18 @@ void ConvertHSVToRGBOperation::executePixelSampled(float output[4],
   output[3] = inputColor[3];
 }
 
+void ConvertHSVToRGBOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float *in = it.in(0);
+    hsv_to_rgb_v(in, it.out);
+    it.out[0] = max_ff(it.out[0], 0.0f);
+    it.out[1] = max_ff(it.out[1], 0.0f);
+    it.out[2] = max_ff(it.out[2], 0.0f);
+    it.out[3] = in[3];
+  }
+}
+
 /* ******** Premul to Straight ******** */
 
 ConvertPremulToStraightOperation::ConvertPremulToStraightOperation() : ConvertBaseOperation()
@@ -370,6 +512,23 @@ void ConvertPremulToStraightOperation::executePixelSampled(float output[4],
   output[3] = alpha;
 }
 
+void ConvertPremulToStraightOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float *in = it.in(0);
+    const float alpha = in[3];
+    if (fabsf(alpha) < 1e-5f) {
+      zero_v3(it.out);
+    }
+    else {
+      mul_v3_v3fl(it.out, in, 1.0f / alpha);
+    }
+
+    /* never touches the alpha */
+    it.out[3] = alpha;
+  }
+}
+
 /* ******** Straight to Premul ******** */
 
 ConvertStraightToPremulOperation::ConvertStraightToPremulOperation() : ConvertBaseOperation()
@@ -395,6 +554,18 @@ void ConvertStraightToPremulOperation::executePixelSampled(float output[4],
   output[3] = alpha;
 }
 
+void ConvertStraightToPremulOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float *in = it.in(0);
+    const float alpha = in[3];
+    mul_v3_v3fl(it.out, in, alpha);
+
+    /* never touches the alpha */
+    it.out[3] = alpha;
+  }
+}
+
 /* ******** Separate Channels ******** */
 
 SeparateChannelOperation::SeparateChannelOperation()
@@ -402,6 +573,8 @@ SeparateChannelOperation::SeparateChannelOperation()
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_VALUE);
   this->m_inputOperation = nullptr;
+  this->setFullFrameOperation(true);
+  this->setCanBeConstant(true);
 }
 void SeparateChannelOperation::initExecution()
 {
@@ -413,6 +586,12 @@ void SeparateChannelOperation::deinitExecution()
   this->m_inputOperation = nullptr;
 }
 
+bool SeparateChannelOperation::hash_output_params()
+{
+  hash_param(this->m_channel);
+  return true;
+}
+
 void SeparateChannelOperation::executePixelSampled(float output[4],
                                                    float x,
                                                    float y,
@@ -423,6 +602,13 @@ void SeparateChannelOperation::executePixelSampled(float output[4],
   output[0] = input[this->m_channel];
 }
 
+void SeparateChannelOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    it.out[0] = it.in(0)[this->m_channel];
+  }
+}
+
 /* ******** Combine Channels ******** */
 
 CombineChannelsOperation::CombineChannelsOperation()
@@ -437,6 +623,8 @@ CombineChannelsOperation::CombineChannelsOperation()
   this->m_inputChannel2Operation = nullptr;
   this->m_inputChannel3Operation = nullptr;
   this->m_inputChannel4Operation = nullptr;
+  this->setFullFrameOperation(true);
+  this->setCanBeConstant(true);
 }
 
 void CombineChannelsOperation::initExecution()
@@ -455,6 +643,11 @@ void CombineChannelsOperation::deinitExecution()
   this->m_inputChannel4Operation = nullptr;
 }
 
+bool CombineChannelsOperation::hash_output_params()
+{
+  return true;
+}
+
 void CombineChannelsOperation::executePixelSampled(float output[4],
                                                    float x,
                                                    float y,
@@ -478,3 +671,13 @@ void CombineChannelsOperation::executePixelSampled(float output[4],
     output[3] = input[0];
   }
 }
+
+void CombineChannelsOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    it.out[0] = *it.in(0);
+    it.out[1] = *it.in(1);
+    it.out[2] = *it.in(2);
+    it.out[3] = *it.in(3);
+  }
+}
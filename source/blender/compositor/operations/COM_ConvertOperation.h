@@ -29,6 +29,9 @@ class ConvertBaseOperation : public NodeOperation {
 
   void initExecution();
   void deinitExecution();
+
+ protected:
+  bool hash_output_params();
 };
 
 class ConvertValueToColorOperation : public ConvertBaseOperation {
@@ -36,6 +39,7 @@ class ConvertValueToColorOperation : public ConvertBaseOperation {
   ConvertValueToColorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class ConvertColorToValueOperation : public ConvertBaseOperation {
@@ -43,6 +47,7 @@ class ConvertColorToValueOperation : public ConvertBaseOperation {
   ConvertColorToValueOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class ConvertColorToBWOperation : public ConvertBaseOperation {
@@ -50,6 +55,7 @@ class ConvertColorToBWOperation : public ConvertBaseOperation {
   ConvertColorToBWOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class ConvertColorToVectorOperation : public ConvertBaseOperation {
@@ -57,6 +63,7 @@ class ConvertColorToVectorOperation : public ConvertBaseOperation {
   ConvertColorToVectorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class ConvertValueToVectorOperation : public ConvertBaseOperation {
@@ -64,6 +71,7 @@ class ConvertValueToVectorOperation : public ConvertBaseOperation {
   ConvertValueToVectorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class ConvertVectorToColorOperation : public ConvertBaseOperation {
@@ -71,6 +79,7 @@ class ConvertVectorToColorOperation : public ConvertBaseOperation {
   ConvertVectorToColorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class ConvertVectorToValueOperation : public ConvertBaseOperation {
@@ -78,6 +87,7 @@ class ConvertVectorToValueOperation : public ConvertBaseOperation {
   ConvertVectorToValueOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class ConvertRGBToYCCOperation : public ConvertBaseOperation {
@@ -89,9 +99,13 @@ class ConvertRGBToYCCOperation : public ConvertBaseOperation {
   ConvertRGBToYCCOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 
   /** Set the YCC mode */
   void setMode(int mode);
+
+ protected:
+  bool hash_output_params();
 };
 
 class ConvertYCCToRGBOperation : public ConvertBaseOperation {
@@ -103,9 +117,13 @@ class ConvertYCCToRGBOperation : public ConvertBaseOperation {
   ConvertYCCToRGBOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 
   /** Set the YCC mode */
   void setMode(int mode);
+
+ protected:
+  bool hash_output_params();
 };
 
 class ConvertRGBToYUVOperation : public ConvertBaseOperation {
@@ -113,6 +131,7 @@ class ConvertRGBToYUVOperation : public ConvertBaseOperation {
   ConvertRGBToYUVOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class ConvertYUVToRGBOperation : public ConvertBaseOperation {
@@ -120,6 +139,7 @@ class ConvertYUVToRGBOperation : public ConvertBaseOperation {
   ConvertYUVToRGBOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class ConvertRGBToHSVOperation : public ConvertBaseOperation {
@@ -127,6 +147,7 @@ class ConvertRGBToHSVOperation : public ConvertBaseOperation {
   ConvertRGBToHSVOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class ConvertHSVToRGBOperation : public ConvertBaseOperation {
@@ -134,6 +155,7 @@ class ConvertHSVToRGBOperation : public ConvertBaseOperation {
   ConvertHSVToRGBOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class ConvertPremulToStraightOperation : public ConvertBaseOperation {
@@ -141,6 +163,7 @@ class ConvertPremulToStraightOperation : public ConvertBaseOperation {
   ConvertPremulToStraightOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class ConvertStraightToPremulOperation : public ConvertBaseOperation {
@@ -148,6 +171,7 @@ class ConvertStraightToPremulOperation : public ConvertBaseOperation {
   ConvertStraightToPremulOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class SeparateChannelOperation : public NodeOperation {
@@ -158,6 +182,7 @@ class SeparateChannelOperation : public NodeOperation {
  public:
   SeparateChannelOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 
   void initExecution();
   void deinitExecution();
@@ -166,6 +191,9 @@ class SeparateChannelOperation : public NodeOperation {
   {
     this->m_channel = channel;
   }
+
+ protected:
+  bool hash_output_params();
 };
 
 class CombineChannelsOperation : public NodeOperation {
@@ -178,7 +206,11 @@ class CombineChannelsOperation : public NodeOperation {
  public:
   CombineChannelsOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 
   void initExecution();
   void deinitExecution();
+
+ protected:
+  bool hash_output_params();
 };
@@ -16,8 +16,7 @@
  * Copyright 2011, Blender Foundation.
  */
 
-#include <climits>
-
+#include "BLI_recursive_gaussian.h"
 #include "BLI_utildefines.h"
 #include "COM_FastGaussianBlurOperation.h"
 #include "MEM_guardedalloc.h"
@@ -25,6 +24,7 @@
 FastGaussianBlurOperation::FastGaussianBlurOperation() : BlurBaseOperation(COM_DT_COLOR)
 {
   this->m_iirgaus = nullptr;
+  this->m_use_gaussian_radius = false;
 }
 
 void FastGaussianBlurOperation::executePixel(float output[4], int x, int y, void *data)
@@ -75,6 +75,13 @@ void FastGaussianBlurOperation::deinitExecution()
   BlurBaseOperation::deinitMutex();
 }
 
+bool FastGaussianBlurOperation::hash_output_params()
+{
+  BlurBaseOperation::hash_output_params();
+  hash_param(this->m_use_gaussian_radius);
+  return true;
+}
+
 void *FastGaussianBlurOperation::initializeTileData(rcti *rect)
 {
   lockMutex();
@@ -83,25 +90,20 @@ void *FastGaussianBlurOperation::initializeTileData(rcti *rect)
     MemoryBuffer *copy = newBuf->duplicate();
     updateSize();
 
-    int c;
-    this->m_sx = this->m_data.sizex * this->m_size / 2.0f;
-    this->m_sy = this->m_data.sizey * this->m_size / 2.0f;
+    /* The gaussian filter of the Gaussian blur operations falls off within 3 sigma. */
+    const float radius_to_sigma = this->m_use_gaussian_radius ? 1.0f / 3.0f : 0.5f;
+    this->m_sx = this->m_data.sizex * this->m_size * radius_to_sigma;
+    this->m_sy = this->m_data.sizey * this->m_size * radius_to_sigma;
 
     if ((this->m_sx == this->m_sy) && (this->m_sx > 0.0f)) {
-      for (c = 0; c < COM_NUM_CHANNELS_COLOR; c++) {
-        IIR_gauss(copy, this->m_sx, c, 3);
-      }
+      IIR_gauss(copy, this->m_sx, 3);
     }
     else {
       if (this->m_sx > 0.0f) {
-        for (c = 0; c < COM_NUM_CHANNELS_COLOR; c++) {
-          IIR_gauss(copy, this->m_sx, c, 1);
-        }
+        IIR_gauss(copy, this->m_sx, 1);
       }
       if (this->m_sy > 0.0f) {
-        for (c = 0; c < COM_NUM_CHANNELS_COLOR; c++) {
-          IIR_gauss(copy, this->m_sy, c, 2);
-        }
+        IIR_gauss(copy, this->m_sy, 2);
       }
     }
     this->m_iirgaus = copy;
@@ -110,149 +112,35 @@ void *FastGaussianBlurOperation::initializeTileData(rcti *rect)
   return this->m_iirgaus;
 }
 
-void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
-                                          float sigma,
-                                          unsigned int chan,
-                                          unsigned int xy)
+/**
+ * Blur \a channels consecutive channels of \a src, starting at the channel \a buffer points to.
+ */
+static void IIR_gauss_channels(
+    MemoryBuffer *src, float *buffer, unsigned int channels, float sigma, unsigned int xy)
 {
-  double q, q2, sc, cf[4], tsM[9], tsu[3], tsv[3];
-  double *X, *Y, *W;
-  const unsigned int src_width = src->getWidth();
-  const unsigned int src_height = src->getHeight();
-  unsigned int x, y, sz;
-  unsigned int i;
-  float *buffer = src->getBuffer();
-  const unsigned int num_channels = src->get_num_channels();
-
-  // <0.5 not valid, though can have a possibly useful sort of sharpening effect
-  if (sigma < 0.5f) {
-    return;
-  }
-
   if ((xy < 1) || (xy > 3)) {
     xy = 3;
   }
+  BLI_recursive_gaussian_blur_fl(buffer,
+                                 src->getWidth(),
+                                 src->getHeight(),
+                                 src->get_num_channels(),
+                                 channels,
+                                 (xy & 1) ? sigma : 0.0f,
+                                 (xy & 2) ? sigma : 0.0f);
+}
 
-  // XXX The YVV macro defined below explicitly expects sources of at least 3x3 pixels,
-  //     so just skipping blur along faulty direction if src's def is below that limit!
-  if (src_width < 3) {
-    xy &= ~1;
-  }
-  if (src_height < 3) {
-    xy &= ~2;
-  }
-  if (xy < 1) {
-    return;
-  }
-
-  // see "Recursive Gabor Filtering" by Young/VanVliet
-  // all factors here in double.prec.
-  // Required, because for single.prec it seems to blow up if sigma > ~200
-  if (sigma >= 3.556f) {
-    q = 0.9804f * (sigma - 3.556f) + 2.5091f;
-  }
-  else {  // sigma >= 0.5
-    q = (0.0561f * sigma + 0.5784f) * sigma - 0.2568f;
-  }
-  q2 = q * q;
-  sc = (1.1668 + q) * (3.203729649 + (2.21566 + q) * q);
-  // no gabor filtering here, so no complex multiplies, just the regular coefs.
-  // all negated here, so as not to have to recalc Triggs/Sdika matrix
-  cf[1] = q * (5.788961737 + (6.76492 + 3.0 * q) * q) / sc;
-  cf[2] = -q2 * (3.38246 + 3.0 * q) / sc;
-  // 0 & 3 unchanged
-  cf[3] = q2 * q / sc;
-  cf[0] = 1.0 - cf[1] - cf[2] - cf[3];
-
-  // Triggs/Sdika border corrections,
-  // it seems to work, not entirely sure if it is actually totally correct,
-  // Besides J.M.Geusebroek's anigauss.c (see http://www.science.uva.nl/~mark),
-  // found one other implementation by Cristoph Lampert,
-  // but neither seem to be quite the same, result seems to be ok so far anyway.
-  // Extra scale factor here to not have to do it in filter,
-  // though maybe this had something to with the precision errors
-  sc = cf[0] / ((1.0 + cf[1] - cf[2] + cf[3]) * (1.0 - cf[1] - cf[2] - cf[3]) *
-                (1.0 + cf[2] + (cf[1] - cf[3]) * cf[3]));
-  tsM[0] = sc * (-cf[3] * cf[1] + 1.0 - cf[3] * cf[3] - cf[2]);
-  tsM[1] = sc * ((cf[3] + cf[1]) * (cf[2] + cf[3] * cf[1]));
-  tsM[2] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
-  tsM[3] = sc * (cf[1] + cf[3] * cf[2]);
-  tsM[4] = sc * (-(cf[2] - 1.0) * (cf[2] + cf[3] * cf[1]));
-  tsM[5] = sc * (-(cf[3] * cf[1] + cf[3] * cf[3] + cf[2] - 1.0) * cf[3]);
-  tsM[6] = sc * (cf[3] * cf[1] + cf[2] + cf[1] * cf[1] - cf[2] * cf[2]);
-  tsM[7] = sc * (cf[1] * cf[2] + cf[3] * cf[2] * cf[2] - cf[1] * cf[3] * cf[3] -
-                 cf[3] * cf[3] * cf[3] - cf[3] * cf[2] + cf[3]);
-  tsM[8] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
-
-#define YVV(L) \
-  { \
-    W[0] = cf[0] * X[0] + cf[1] * X[0] + cf[2] * X[0] + cf[3] * X[0]; \
-    W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * X[0] + cf[3] * X[0]; \
-    W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * X[0]; \
-    for (i = 3; i < L; i++) { \
-      W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3]; \
-    } \
-    tsu[0] = W[L - 1] - X[L - 1]; \
-    tsu[1] = W[L - 2] - X[L - 1]; \
-    tsu[2] = W[L - 3] - X[L - 1]; \
-    tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + X[L - 1]; \
-    tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + X[L - 1]; \
-    tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + X[L - 1]; \
-    Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2]; \
-    Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1]; \
-    Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0]; \
-    /* 'i != UINT_MAX' is really 'i >= 0', but necessary for unsigned int wrapping */ \
-    for (i = L - 4; i != UINT_MAX; i--) { \
-      Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3]; \
-    } \
-  } \
-  (void)0
-
-  // intermediate buffers
-  sz = max(src_width, src_height);
-  X = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss X buf");
-  Y = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss Y buf");
-  W = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss W buf");
-  if (xy & 1) {  // H
-    int offset;
-    for (y = 0; y < src_height; y++) {
-      const int yx = y * src_width;
-      offset = yx * num_channels + chan;
-      for (x = 0; x < src_width; x++) {
-        X[x] = buffer[offset];
-        offset += num_channels;
-      }
-      YVV(src_width);
-      offset = yx * num_channels + chan;
-      for (x = 0; x < src_width; x++) {
-        buffer[offset] = Y[x];
-        offset += num_channels;
-      }
-    }
-  }
-  if (xy & 2) {  // V
-    int offset;
-    const int add = src_width * num_channels;
-
-    for (x = 0; x < src_width; x++) {
-      offset = x * num_channels + chan;
-      for (y = 0; y < src_height; y++) {
-        X[y] = buffer[offset];
-        offset += add;
-      }
-      YVV(src_height);
-      offset = x * num_channels + chan;
-      for (y = 0; y < src_height; y++) {
-        buffer[offset] = Y[y];
-        offset += add;
-      }
-    }
-  }
+void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
+                                          float sigma,
+                                          unsigned int chan,
+                                          unsigned int xy)
+{
+  IIR_gauss_channels(src, src->getBuffer() + chan, 1, sigma, xy);
+}
 
-  MEM_freeN(X);
-  MEM_freeN(W);
-  MEM_freeN(Y);
-#undef YVV
+void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src, float sigma, unsigned int xy)
+{
+  IIR_gauss_channels(src, src->getBuffer(), src->get_num_channels(), sigma, xy);
 }
 
 ///
@@ -305,6 +193,13 @@ void FastGaussianBlurValueOperation::deinitExecution()
   deinitMutex();
 }
 
+bool FastGaussianBlurValueOperation::hash_output_params()
+{
+  hash_param(this->m_sigma);
+  hash_param(this->m_overlay);
+  return true;
+}
+
 void *FastGaussianBlurValueOperation::initializeTileData(rcti *rect)
 {
   lockMutex();
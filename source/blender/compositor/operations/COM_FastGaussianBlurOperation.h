@@ -26,6 +26,7 @@ class FastGaussianBlurOperation : public BlurBaseOperation {
   float m_sx;
   float m_sy;
   MemoryBuffer *m_iirgaus;
+  bool m_use_gaussian_radius;
 
  public:
   FastGaussianBlurOperation();
@@ -35,9 +36,26 @@ class FastGaussianBlurOperation : public BlurBaseOperation {
   void executePixel(float output[4], int x, int y, void *data);
 
   static void IIR_gauss(MemoryBuffer *src, float sigma, unsigned int channel, unsigned int xy);
+  /**
+   * \brief blur all channels of the buffer at once
+   * Rows and columns are filtered in parallel.
+   */
+  static void IIR_gauss(MemoryBuffer *src, float sigma, unsigned int xy);
   void *initializeTileData(rcti *rect);
   void deinitExecution();
   void initExecution();
+
+  /**
+   * \brief interpret the blur size like GaussianXBlurOperation and GaussianYBlurOperation do
+   * Used in place of them for large sizes, where the recursive filter is much faster.
+   */
+  void setUseGaussianRadius(bool use_gaussian_radius)
+  {
+    this->m_use_gaussian_radius = use_gaussian_radius;
+  }
+
+ protected:
+  bool hash_output_params();
 };
 
 enum {
@@ -78,4 +96,7 @@ class FastGaussianBlurValueOperation : public NodeOperation {
   {
     this->m_overlay = overlay;
   }
+
+ protected:
+  bool hash_output_params();
 };
@@ -61,6 +61,11 @@ void GammaCorrectOperation::deinitExecution()
   this->m_inputProgram = nullptr;
 }
 
+bool GammaCorrectOperation::hash_output_params()
+{
+  return true;
+}
+
 GammaUncorrectOperation::GammaUncorrectOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
@@ -102,3 +107,8 @@ void GammaUncorrectOperation::deinitExecution()
 {
   this->m_inputProgram = nullptr;
 }
+
+bool GammaUncorrectOperation::hash_output_params()
+{
+  return true;
+}
@@ -44,6 +44,9 @@ class GammaCorrectOperation : public NodeOperation {
    * Deinitialize the execution
    */
   void deinitExecution();
+
+ protected:
+  bool hash_output_params();
 };
 
 class GammaUncorrectOperation : public NodeOperation {
@@ -70,4 +73,7 @@ class GammaUncorrectOperation : public NodeOperation {
    * Deinitialize the execution
    */
   void deinitExecution();
+
+ protected:
+  bool hash_output_params();
 };
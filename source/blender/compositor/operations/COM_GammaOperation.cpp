@@ -17,6 +17,7 @@
  */
 
 #include "COM_GammaOperation.h"
+#include "COM_BuffersIterator.h"
 #include "BLI_math.h"
 
 GammaOperation::GammaOperation()
@@ -26,6 +27,8 @@ GammaOperation::GammaOperation()
   this->addOutputSocket(COM_DT_COLOR);
   this->m_inputProgram = nullptr;
   this->m_inputGammaProgram = nullptr;
+  this->setFullFrameOperation(true);
+  this->setCanBeConstant(true);
 }
 void GammaOperation::initExecution()
 {
@@ -49,8 +52,36 @@ void GammaOperation::executePixelSampled(float output[4], float x, float y, Pixe
   output[3] = inputValue[3];
 }
 
+void GammaOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float *inputValue = it.in(0);
+    const float gamma = it.in(1)[0];
+    /* check for negative to avoid nan's */
+    it.out[0] = inputValue[0] > 0.0f ? powf(inputValue[0], gamma) : inputValue[0];
+    it.out[1] = inputValue[1] > 0.0f ? powf(inputValue[1], gamma) : inputValue[1];
+    it.out[2] = inputValue[2] > 0.0f ? powf(inputValue[2], gamma) : inputValue[2];
+
+    it.out[3] = inputValue[3];
+  }
+}
+
+int GammaOperation::get_identity_input(const float *const *constant_inputs) const
+{
+  /* a gamma of one */
+  if (constant_inputs[1] && constant_inputs[1][0] == 1.0f) {
+    return 0;
+  }
+  return -1;
+}
+
 void GammaOperation::deinitExecution()
 {
   this->m_inputProgram = nullptr;
   this->m_inputGammaProgram = nullptr;
 }
+
+bool GammaOperation::hash_output_params()
+{
+  return true;
+}
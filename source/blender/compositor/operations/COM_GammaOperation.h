@@ -35,6 +35,8 @@ class GammaOperation : public NodeOperation {
    * The inner loop of this operation.
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
+  int get_identity_input(const float *const *constant_inputs) const;
 
   /**
    * Initialize the execution
@@ -45,4 +47,7 @@ class GammaOperation : public NodeOperation {
    * Deinitialize the execution
    */
   void deinitExecution();
+
+ protected:
+  bool hash_output_params();
 };
@@ -156,6 +156,13 @@ void GaussianAlphaXBlurOperation::deinitExecution()
   deinitMutex();
 }
 
+bool GaussianAlphaXBlurOperation::hash_output_params()
+{
+  hash_param(this->m_falloff);
+  hash_param(this->m_do_subtract);
+  return BlurBaseOperation::hash_output_params();
+}
+
 bool GaussianAlphaXBlurOperation::determineDependingAreaOfInterest(
     rcti *input, ReadBufferOperation *readOperation, rcti *output)
 {
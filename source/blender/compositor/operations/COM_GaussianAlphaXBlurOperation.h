@@ -64,4 +64,7 @@ class GaussianAlphaXBlurOperation : public BlurBaseOperation {
   {
     this->m_falloff = falloff;
   }
+
+ protected:
+  bool hash_output_params();
 };
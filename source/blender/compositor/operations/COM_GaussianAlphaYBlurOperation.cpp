@@ -156,6 +156,13 @@ void GaussianAlphaYBlurOperation::deinitExecution()
   deinitMutex();
 }
 
+bool GaussianAlphaYBlurOperation::hash_output_params()
+{
+  hash_param(this->m_falloff);
+  hash_param(this->m_do_subtract);
+  return BlurBaseOperation::hash_output_params();
+}
+
 bool GaussianAlphaYBlurOperation::determineDependingAreaOfInterest(
     rcti *input, ReadBufferOperation *readOperation, rcti *output)
 {
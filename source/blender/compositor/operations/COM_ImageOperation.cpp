@@ -17,6 +17,7 @@
  */
 
 #include "COM_ImageOperation.h"
+#include "COM_BuffersIterator.h"
 
 #include "BKE_image.h"
 #include "BKE_scene.h"
@@ -45,6 +46,7 @@ BaseImageOperation::BaseImageOperation()
   this->m_numberOfChannels = 0;
   this->m_rd = nullptr;
   this->m_viewName = nullptr;
+  this->setFullFrameOperation(true);
 }
 ImageOperation::ImageOperation() : BaseImageOperation()
 {
@@ -168,6 +170,18 @@ void ImageOperation::executePixelSampled(float output[4], float x, float y, Pixe
   }
 }
 
+void ImageOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    if (this->m_imageFloatBuffer == nullptr && this->m_imageByteBuffer == nullptr) {
+      zero_v4(it.out);
+    }
+    else {
+      sampleImageAtLocation(this->m_buffer, it.x(), it.y(), COM_PS_NEAREST, true, it.out);
+    }
+  }
+}
+
 void ImageAlphaOperation::executePixelSampled(float output[4],
                                               float x,
                                               float y,
@@ -185,6 +199,22 @@ void ImageAlphaOperation::executePixelSampled(float output[4],
   }
 }
 
+void ImageAlphaOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  float tempcolor[4];
+
+  for (; !it.is_end(); ++it) {
+    if (this->m_imageFloatBuffer == nullptr && this->m_imageByteBuffer == nullptr) {
+      it.out[0] = 0.0f;
+    }
+    else {
+      tempcolor[3] = 1.0f;
+      sampleImageAtLocation(this->m_buffer, it.x(), it.y(), COM_PS_NEAREST, false, tempcolor);
+      it.out[0] = tempcolor[3];
+    }
+  }
+}
+
 void ImageDepthOperation::executePixelSampled(float output[4],
                                               float x,
                                               float y,
@@ -203,3 +233,15 @@ void ImageDepthOperation::executePixelSampled(float output[4],
     }
   }
 }
+
+void ImageDepthOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    if (this->m_depthBuffer == nullptr) {
+      it.out[0] = 0.0f;
+    }
+    else {
+      it.out[0] = this->m_depthBuffer[it.y() * this->m_width + it.x()];
+    }
+  }
+}
@@ -84,6 +84,7 @@ class ImageOperation : public BaseImageOperation {
    */
   ImageOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class ImageAlphaOperation : public BaseImageOperation {
  public:
@@ -92,6 +93,7 @@ class ImageAlphaOperation : public BaseImageOperation {
    */
   ImageAlphaOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class ImageDepthOperation : public BaseImageOperation {
  public:
@@ -100,4 +102,5 @@ class ImageDepthOperation : public BaseImageOperation {
    */
   ImageDepthOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
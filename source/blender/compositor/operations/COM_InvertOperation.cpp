@@ -17,6 +17,7 @@
  */
 
 #include "COM_InvertOperation.h"
+#include "COM_BuffersIterator.h"
 
 InvertOperation::InvertOperation()
 {
@@ -28,6 +29,8 @@ InvertOperation::InvertOperation()
   this->m_color = true;
   this->m_alpha = false;
   setResolutionInputSocketIndex(1);
+  this->setFullFrameOperation(true);
+  this->setCanBeConstant(true);
 }
 void InvertOperation::initExecution()
 {
@@ -62,8 +65,40 @@ void InvertOperation::executePixelSampled(float output[4], float x, float y, Pix
   }
 }
 
+void InvertOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    const float value = it.in(0)[0];
+    const float *inputColor = it.in(1);
+    const float invertedValue = 1.0f - value;
+
+    if (this->m_color) {
+      it.out[0] = (1.0f - inputColor[0]) * value + inputColor[0] * invertedValue;
+      it.out[1] = (1.0f - inputColor[1]) * value + inputColor[1] * invertedValue;
+      it.out[2] = (1.0f - inputColor[2]) * value + inputColor[2] * invertedValue;
+    }
+    else {
+      copy_v3_v3(it.out, inputColor);
+    }
+
+    if (this->m_alpha) {
+      it.out[3] = (1.0f - inputColor[3]) * value + inputColor[3] * invertedValue;
+    }
+    else {
+      it.out[3] = inputColor[3];
+    }
+  }
+}
+
 void InvertOperation::deinitExecution()
 {
   this->m_inputValueProgram = nullptr;
   this->m_inputColorProgram = nullptr;
 }
+
+bool InvertOperation::hash_output_params()
+{
+  hash_param(this->m_color);
+  hash_param(this->m_alpha);
+  return true;
+}
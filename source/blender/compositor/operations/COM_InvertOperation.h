@@ -38,6 +38,7 @@ class InvertOperation : public NodeOperation {
    * The inner loop of this operation.
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 
   /**
    * Initialize the execution
@@ -57,4 +58,7 @@ class InvertOperation : public NodeOperation {
   {
     this->m_alpha = alpha;
   }
+
+ protected:
+  bool hash_output_params();
 };
@@ -30,6 +30,8 @@ MathBaseOperation::MathBaseOperation()
   this->m_inputValue2Operation = nullptr;
   this->m_inputValue3Operation = nullptr;
   this->m_useClamp = false;
+  this->setFullFrameOperation(true);
+  this->setCanBeConstant(true);
 }
 
 void MathBaseOperation::initExecution()
@@ -46,6 +48,12 @@ void MathBaseOperation::deinitExecution()
   this->m_inputValue3Operation = nullptr;
 }
 
+bool MathBaseOperation::hash_output_params()
+{
+  hash_param(this->m_useClamp);
+  return true;
+}
+
 void MathBaseOperation::determineResolution(unsigned int resolution[2],
                                             unsigned int preferredResolution[2])
 {
@@ -71,17 +79,39 @@ void MathBaseOperation::clampIfNeeded(float *color)
   }
 }
 
+static inline float math_add(float value1, float value2, float /*value3*/)
+{
+  return value1 + value2;
+}
+
 void MathAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
+  execute_pixel_sampled_math<math_add, 2>(output, x, y, sampler);
+}
 
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+void MathAddOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_add, 2>(it);
+}
 
-  output[0] = inputValue1[0] + inputValue2[0];
+int MathAddOperation::get_identity_input(const float *const *constant_inputs) const
+{
+  if (this->m_useClamp) {
+    return -1;
+  }
+  /* adding zero */
+  if (constant_inputs[1] && constant_inputs[1][0] == 0.0f) {
+    return 0;
+  }
+  if (constant_inputs[0] && constant_inputs[0][0] == 0.0f) {
+    return 1;
+  }
+  return -1;
+}
 
-  clampIfNeeded(output);
+static inline float math_subtract(float value1, float value2, float /*value3*/)
+{
+  return value1 - value2;
 }
 
 void MathSubtractOperation::executePixelSampled(float output[4],
@@ -89,15 +119,26 @@ void MathSubtractOperation::executePixelSampled(float output[4],
                                                 float y,
                                                 PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
+  execute_pixel_sampled_math<math_subtract, 2>(output, x, y, sampler);
+}
 
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+void MathSubtractOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_subtract, 2>(it);
+}
 
-  output[0] = inputValue1[0] - inputValue2[0];
+int MathSubtractOperation::get_identity_input(const float *const *constant_inputs) const
+{
+  /* subtracting zero */
+  if (!this->m_useClamp && constant_inputs[1] && constant_inputs[1][0] == 0.0f) {
+    return 0;
+  }
+  return -1;
+}
 
-  clampIfNeeded(output);
+static inline float math_multiply(float value1, float value2, float /*value3*/)
+{
+  return value1 * value2;
 }
 
 void MathMultiplyOperation::executePixelSampled(float output[4],
@@ -105,15 +146,37 @@ void MathMultiplyOperation::executePixelSampled(float output[4],
                                                 float y,
                                                 PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
+  execute_pixel_sampled_math<math_multiply, 2>(output, x, y, sampler);
+}
 
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+void MathMultiplyOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_multiply, 2>(it);
+}
 
-  output[0] = inputValue1[0] * inputValue2[0];
+int MathMultiplyOperation::get_identity_input(const float *const *constant_inputs) const
+{
+  if (this->m_useClamp) {
+    return -1;
+  }
+  /* multiplying by one */
+  if (constant_inputs[1] && constant_inputs[1][0] == 1.0f) {
+    return 0;
+  }
+  if (constant_inputs[0] && constant_inputs[0][0] == 1.0f) {
+    return 1;
+  }
+  return -1;
+}
 
-  clampIfNeeded(output);
+static inline float math_divide(float value1, float value2, float /*value3*/)
+{
+  if (value2 == 0) { /* We don't want to divide by zero. */
+    return 0.0;
+  }
+  else {
+    return value1 / value2;
+  }
 }
 
 void MathDivideOperation::executePixelSampled(float output[4],
@@ -121,20 +184,26 @@ void MathDivideOperation::executePixelSampled(float output[4],
                                               float y,
                                               PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
+  execute_pixel_sampled_math<math_divide, 2>(output, x, y, sampler);
+}
 
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+void MathDivideOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_divide, 2>(it);
+}
 
-  if (inputValue2[0] == 0) { /* We don't want to divide by zero. */
-    output[0] = 0.0;
-  }
-  else {
-    output[0] = inputValue1[0] / inputValue2[0];
+int MathDivideOperation::get_identity_input(const float *const *constant_inputs) const
+{
+  /* dividing by one */
+  if (!this->m_useClamp && constant_inputs[1] && constant_inputs[1][0] == 1.0f) {
+    return 0;
   }
+  return -1;
+}
 
-  clampIfNeeded(output);
+static inline float math_sine(float value1, float /*value2*/, float /*value3*/)
+{
+  return sin(value1);
 }
 
 void MathSineOperation::executePixelSampled(float output[4],
@@ -142,15 +211,17 @@ void MathSineOperation::executePixelSampled(float output[4],
                                             float y,
                                             PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_sine, 1>(output, x, y, sampler);
+}
 
-  output[0] = sin(inputValue1[0]);
+void MathSineOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_sine, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_cosine(float value1, float /*value2*/, float /*value3*/)
+{
+  return cos(value1);
 }
 
 void MathCosineOperation::executePixelSampled(float output[4],
@@ -158,15 +229,17 @@ void MathCosineOperation::executePixelSampled(float output[4],
                                               float y,
                                               PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_cosine, 1>(output, x, y, sampler);
+}
 
-  output[0] = cos(inputValue1[0]);
+void MathCosineOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_cosine, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_tangent(float value1, float /*value2*/, float /*value3*/)
+{
+  return tan(value1);
 }
 
 void MathTangentOperation::executePixelSampled(float output[4],
@@ -174,15 +247,17 @@ void MathTangentOperation::executePixelSampled(float output[4],
                                                float y,
                                                PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_tangent, 1>(output, x, y, sampler);
+}
 
-  output[0] = tan(inputValue1[0]);
+void MathTangentOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_tangent, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_hyperbolic_sine(float value1, float /*value2*/, float /*value3*/)
+{
+  return sinh(value1);
 }
 
 void MathHyperbolicSineOperation::executePixelSampled(float output[4],
@@ -190,15 +265,17 @@ void MathHyperbolicSineOperation::executePixelSampled(float output[4],
                                                       float y,
                                                       PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_hyperbolic_sine, 1>(output, x, y, sampler);
+}
 
-  output[0] = sinh(inputValue1[0]);
+void MathHyperbolicSineOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_hyperbolic_sine, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_hyperbolic_cosine(float value1, float /*value2*/, float /*value3*/)
+{
+  return cosh(value1);
 }
 
 void MathHyperbolicCosineOperation::executePixelSampled(float output[4],
@@ -206,15 +283,17 @@ void MathHyperbolicCosineOperation::executePixelSampled(float output[4],
                                                         float y,
                                                         PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_hyperbolic_cosine, 1>(output, x, y, sampler);
+}
 
-  output[0] = cosh(inputValue1[0]);
+void MathHyperbolicCosineOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_hyperbolic_cosine, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_hyperbolic_tangent(float value1, float /*value2*/, float /*value3*/)
+{
+  return tanh(value1);
 }
 
 void MathHyperbolicTangentOperation::executePixelSampled(float output[4],
@@ -222,15 +301,22 @@ void MathHyperbolicTangentOperation::executePixelSampled(float output[4],
                                                          float y,
                                                          PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_hyperbolic_tangent, 1>(output, x, y, sampler);
+}
 
-  output[0] = tanh(inputValue1[0]);
+void MathHyperbolicTangentOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_hyperbolic_tangent, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_arc_sine(float value1, float /*value2*/, float /*value3*/)
+{
+  if (value1 <= 1 && value1 >= -1) {
+    return asin(value1);
+  }
+  else {
+    return 0.0;
+  }
 }
 
 void MathArcSineOperation::executePixelSampled(float output[4],
@@ -238,20 +324,22 @@ void MathArcSineOperation::executePixelSampled(float output[4],
                                                float y,
                                                PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
+  execute_pixel_sampled_math<math_arc_sine, 1>(output, x, y, sampler);
+}
 
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+void MathArcSineOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_arc_sine, 1>(it);
+}
 
-  if (inputValue1[0] <= 1 && inputValue1[0] >= -1) {
-    output[0] = asin(inputValue1[0]);
+static inline float math_arc_cosine(float value1, float /*value2*/, float /*value3*/)
+{
+  if (value1 <= 1 && value1 >= -1) {
+    return acos(value1);
   }
   else {
-    output[0] = 0.0;
+    return 0.0;
   }
-
-  clampIfNeeded(output);
 }
 
 void MathArcCosineOperation::executePixelSampled(float output[4],
@@ -259,20 +347,17 @@ void MathArcCosineOperation::executePixelSampled(float output[4],
                                                  float y,
                                                  PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_arc_cosine, 1>(output, x, y, sampler);
+}
 
-  if (inputValue1[0] <= 1 && inputValue1[0] >= -1) {
-    output[0] = acos(inputValue1[0]);
-  }
-  else {
-    output[0] = 0.0;
-  }
+void MathArcCosineOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_arc_cosine, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_arc_tangent(float value1, float /*value2*/, float /*value3*/)
+{
+  return atan(value1);
 }
 
 void MathArcTangentOperation::executePixelSampled(float output[4],
@@ -280,15 +365,30 @@ void MathArcTangentOperation::executePixelSampled(float output[4],
                                                   float y,
                                                   PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_arc_tangent, 1>(output, x, y, sampler);
+}
 
-  output[0] = atan(inputValue1[0]);
+void MathArcTangentOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_arc_tangent, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_power(float value1, float value2, float /*value3*/)
+{
+  if (value1 >= 0) {
+    return pow(value1, value2);
+  }
+  else {
+    float y_mod_1 = fmod(value2, 1);
+    /* if input value is not nearly an integer, fall back to zero,
+     * nicer than straight rounding */
+    if (y_mod_1 > 0.999f || y_mod_1 < 0.001f) {
+      return pow(value1, floorf(value2 + 0.5f));
+    }
+    else {
+      return 0.0;
+    }
+  }
 }
 
 void MathPowerOperation::executePixelSampled(float output[4],
@@ -296,27 +396,22 @@ void MathPowerOperation::executePixelSampled(float output[4],
                                              float y,
                                              PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
+  execute_pixel_sampled_math<math_power, 2>(output, x, y, sampler);
+}
 
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+void MathPowerOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_power, 2>(it);
+}
 
-  if (inputValue1[0] >= 0) {
-    output[0] = pow(inputValue1[0], inputValue2[0]);
+static inline float math_logarithm(float value1, float value2, float /*value3*/)
+{
+  if (value1 > 0 && value2 > 0) {
+    return log(value1) / log(value2);
   }
   else {
-    float y_mod_1 = fmod(inputValue2[0], 1);
-    /* if input value is not nearly an integer, fall back to zero, nicer than straight rounding */
-    if (y_mod_1 > 0.999f || y_mod_1 < 0.001f) {
-      output[0] = pow(inputValue1[0], floorf(inputValue2[0] + 0.5f));
-    }
-    else {
-      output[0] = 0.0;
-    }
+    return 0.0;
   }
-
-  clampIfNeeded(output);
 }
 
 void MathLogarithmOperation::executePixelSampled(float output[4],
@@ -324,20 +419,17 @@ void MathLogarithmOperation::executePixelSampled(float output[4],
                                                  float y,
                                                  PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_logarithm, 2>(output, x, y, sampler);
+}
 
-  if (inputValue1[0] > 0 && inputValue2[0] > 0) {
-    output[0] = log(inputValue1[0]) / log(inputValue2[0]);
-  }
-  else {
-    output[0] = 0.0;
-  }
+void MathLogarithmOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_logarithm, 2>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_minimum(float value1, float value2, float /*value3*/)
+{
+  return min(value1, value2);
 }
 
 void MathMinimumOperation::executePixelSampled(float output[4],
@@ -345,15 +437,17 @@ void MathMinimumOperation::executePixelSampled(float output[4],
                                                float y,
                                                PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_minimum, 2>(output, x, y, sampler);
+}
 
-  output[0] = min(inputValue1[0], inputValue2[0]);
+void MathMinimumOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_minimum, 2>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_maximum(float value1, float value2, float /*value3*/)
+{
+  return max(value1, value2);
 }
 
 void MathMaximumOperation::executePixelSampled(float output[4],
@@ -361,15 +455,17 @@ void MathMaximumOperation::executePixelSampled(float output[4],
                                                float y,
                                                PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_maximum, 2>(output, x, y, sampler);
+}
 
-  output[0] = max(inputValue1[0], inputValue2[0]);
+void MathMaximumOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_maximum, 2>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_round(float value1, float /*value2*/, float /*value3*/)
+{
+  return round(value1);
 }
 
 void MathRoundOperation::executePixelSampled(float output[4],
@@ -377,15 +473,17 @@ void MathRoundOperation::executePixelSampled(float output[4],
                                              float y,
                                              PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_round, 1>(output, x, y, sampler);
+}
 
-  output[0] = round(inputValue1[0]);
+void MathRoundOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_round, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_less_than(float value1, float value2, float /*value3*/)
+{
+  return value1 < value2 ? 1.0f : 0.0f;
 }
 
 void MathLessThanOperation::executePixelSampled(float output[4],
@@ -393,15 +491,17 @@ void MathLessThanOperation::executePixelSampled(float output[4],
                                                 float y,
                                                 PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_less_than, 2>(output, x, y, sampler);
+}
 
-  output[0] = inputValue1[0] < inputValue2[0] ? 1.0f : 0.0f;
+void MathLessThanOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_less_than, 2>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_greater_than(float value1, float value2, float /*value3*/)
+{
+  return value1 > value2 ? 1.0f : 0.0f;
 }
 
 void MathGreaterThanOperation::executePixelSampled(float output[4],
@@ -409,15 +509,22 @@ void MathGreaterThanOperation::executePixelSampled(float output[4],
                                                    float y,
                                                    PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_greater_than, 2>(output, x, y, sampler);
+}
 
-  output[0] = inputValue1[0] > inputValue2[0] ? 1.0f : 0.0f;
+void MathGreaterThanOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_greater_than, 2>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_modulo(float value1, float value2, float /*value3*/)
+{
+  if (value2 == 0) {
+    return 0.0;
+  }
+  else {
+    return fmod(value1, value2);
+  }
 }
 
 void MathModuloOperation::executePixelSampled(float output[4],
@@ -425,20 +532,17 @@ void MathModuloOperation::executePixelSampled(float output[4],
                                               float y,
                                               PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_modulo, 2>(output, x, y, sampler);
+}
 
-  if (inputValue2[0] == 0) {
-    output[0] = 0.0;
-  }
-  else {
-    output[0] = fmod(inputValue1[0], inputValue2[0]);
-  }
+void MathModuloOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_modulo, 2>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_absolute(float value1, float /*value2*/, float /*value3*/)
+{
+  return fabs(value1);
 }
 
 void MathAbsoluteOperation::executePixelSampled(float output[4],
@@ -446,13 +550,17 @@ void MathAbsoluteOperation::executePixelSampled(float output[4],
                                                 float y,
                                                 PixelSampler sampler)
 {
-  float inputValue1[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
+  execute_pixel_sampled_math<math_absolute, 1>(output, x, y, sampler);
+}
 
-  output[0] = fabs(inputValue1[0]);
+void MathAbsoluteOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_absolute, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_radians(float value1, float /*value2*/, float /*value3*/)
+{
+  return DEG2RADF(value1);
 }
 
 void MathRadiansOperation::executePixelSampled(float output[4],
@@ -460,13 +568,17 @@ void MathRadiansOperation::executePixelSampled(float output[4],
                                                float y,
                                                PixelSampler sampler)
 {
-  float inputValue1[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
+  execute_pixel_sampled_math<math_radians, 1>(output, x, y, sampler);
+}
 
-  output[0] = DEG2RADF(inputValue1[0]);
+void MathRadiansOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_radians, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_degrees(float value1, float /*value2*/, float /*value3*/)
+{
+  return RAD2DEGF(value1);
 }
 
 void MathDegreesOperation::executePixelSampled(float output[4],
@@ -474,13 +586,17 @@ void MathDegreesOperation::executePixelSampled(float output[4],
                                                float y,
                                                PixelSampler sampler)
 {
-  float inputValue1[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
+  execute_pixel_sampled_math<math_degrees, 1>(output, x, y, sampler);
+}
 
-  output[0] = RAD2DEGF(inputValue1[0]);
+void MathDegreesOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_degrees, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_arc_tan2(float value1, float value2, float /*value3*/)
+{
+  return atan2(value1, value2);
 }
 
 void MathArcTan2Operation::executePixelSampled(float output[4],
@@ -488,15 +604,17 @@ void MathArcTan2Operation::executePixelSampled(float output[4],
                                                float y,
                                                PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_arc_tan2, 2>(output, x, y, sampler);
+}
 
-  output[0] = atan2(inputValue1[0], inputValue2[0]);
+void MathArcTan2Operation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_arc_tan2, 2>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_floor(float value1, float /*value2*/, float /*value3*/)
+{
+  return floor(value1);
 }
 
 void MathFloorOperation::executePixelSampled(float output[4],
@@ -504,13 +622,17 @@ void MathFloorOperation::executePixelSampled(float output[4],
                                              float y,
                                              PixelSampler sampler)
 {
-  float inputValue1[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
+  execute_pixel_sampled_math<math_floor, 1>(output, x, y, sampler);
+}
 
-  output[0] = floor(inputValue1[0]);
+void MathFloorOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_floor, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_ceil(float value1, float /*value2*/, float /*value3*/)
+{
+  return ceil(value1);
 }
 
 void MathCeilOperation::executePixelSampled(float output[4],
@@ -518,13 +640,17 @@ void MathCeilOperation::executePixelSampled(float output[4],
                                             float y,
                                             PixelSampler sampler)
 {
-  float inputValue1[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
+  execute_pixel_sampled_math<math_ceil, 1>(output, x, y, sampler);
+}
 
-  output[0] = ceil(inputValue1[0]);
+void MathCeilOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_ceil, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_fract(float value1, float /*value2*/, float /*value3*/)
+{
+  return value1 - floor(value1);
 }
 
 void MathFractOperation::executePixelSampled(float output[4],
@@ -532,13 +658,22 @@ void MathFractOperation::executePixelSampled(float output[4],
                                              float y,
                                              PixelSampler sampler)
 {
-  float inputValue1[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
+  execute_pixel_sampled_math<math_fract, 1>(output, x, y, sampler);
+}
 
-  output[0] = inputValue1[0] - floor(inputValue1[0]);
+void MathFractOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_fract, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_sqrt(float value1, float /*value2*/, float /*value3*/)
+{
+  if (value1 > 0) {
+    return sqrt(value1);
+  }
+  else {
+    return 0.0f;
+  }
 }
 
 void MathSqrtOperation::executePixelSampled(float output[4],
@@ -546,18 +681,22 @@ void MathSqrtOperation::executePixelSampled(float output[4],
                                             float y,
                                             PixelSampler sampler)
 {
-  float inputValue1[4];
+  execute_pixel_sampled_math<math_sqrt, 1>(output, x, y, sampler);
+}
 
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
+void MathSqrtOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_sqrt, 1>(it);
+}
 
-  if (inputValue1[0] > 0) {
-    output[0] = sqrt(inputValue1[0]);
+static inline float math_inverse_sqrt(float value1, float /*value2*/, float /*value3*/)
+{
+  if (value1 > 0) {
+    return 1.0f / sqrt(value1);
   }
   else {
-    output[0] = 0.0f;
+    return 0.0f;
   }
-
-  clampIfNeeded(output);
 }
 
 void MathInverseSqrtOperation::executePixelSampled(float output[4],
@@ -565,18 +704,17 @@ void MathInverseSqrtOperation::executePixelSampled(float output[4],
                                                    float y,
                                                    PixelSampler sampler)
 {
-  float inputValue1[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
+  execute_pixel_sampled_math<math_inverse_sqrt, 1>(output, x, y, sampler);
+}
 
-  if (inputValue1[0] > 0) {
-    output[0] = 1.0f / sqrt(inputValue1[0]);
-  }
-  else {
-    output[0] = 0.0f;
-  }
+void MathInverseSqrtOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_inverse_sqrt, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_sign(float value1, float /*value2*/, float /*value3*/)
+{
+  return compatible_signf(value1);
 }
 
 void MathSignOperation::executePixelSampled(float output[4],
@@ -584,13 +722,17 @@ void MathSignOperation::executePixelSampled(float output[4],
                                             float y,
                                             PixelSampler sampler)
 {
-  float inputValue1[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
+  execute_pixel_sampled_math<math_sign, 1>(output, x, y, sampler);
+}
 
-  output[0] = compatible_signf(inputValue1[0]);
+void MathSignOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_sign, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_exponent(float value1, float /*value2*/, float /*value3*/)
+{
+  return expf(value1);
 }
 
 void MathExponentOperation::executePixelSampled(float output[4],
@@ -598,13 +740,17 @@ void MathExponentOperation::executePixelSampled(float output[4],
                                                 float y,
                                                 PixelSampler sampler)
 {
-  float inputValue1[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
+  execute_pixel_sampled_math<math_exponent, 1>(output, x, y, sampler);
+}
 
-  output[0] = expf(inputValue1[0]);
+void MathExponentOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_exponent, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_trunc(float value1, float /*value2*/, float /*value3*/)
+{
+  return (value1 >= 0.0f) ? floor(value1) : ceil(value1);
 }
 
 void MathTruncOperation::executePixelSampled(float output[4],
@@ -612,13 +758,22 @@ void MathTruncOperation::executePixelSampled(float output[4],
                                              float y,
                                              PixelSampler sampler)
 {
-  float inputValue1[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
+  execute_pixel_sampled_math<math_trunc, 1>(output, x, y, sampler);
+}
 
-  output[0] = (inputValue1[0] >= 0.0f) ? floor(inputValue1[0]) : ceil(inputValue1[0]);
+void MathTruncOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_trunc, 1>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_snap(float value1, float value2, float /*value3*/)
+{
+  if (value1 == 0 || value2 == 0) { /* We don't want to divide by zero. */
+    return 0.0f;
+  }
+  else {
+    return floorf(value1 / value2) * value2;
+  }
 }
 
 void MathSnapOperation::executePixelSampled(float output[4],
@@ -626,20 +781,17 @@ void MathSnapOperation::executePixelSampled(float output[4],
                                             float y,
                                             PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_snap, 2>(output, x, y, sampler);
+}
 
-  if (inputValue1[0] == 0 || inputValue2[0] == 0) { /* We don't want to divide by zero. */
-    output[0] = 0.0f;
-  }
-  else {
-    output[0] = floorf(inputValue1[0] / inputValue2[0]) * inputValue2[0];
-  }
+void MathSnapOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_snap, 2>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_wrap(float value1, float value2, float value3)
+{
+  return wrapf(value1, value2, value3);
 }
 
 void MathWrapOperation::executePixelSampled(float output[4],
@@ -647,17 +799,17 @@ void MathWrapOperation::executePixelSampled(float output[4],
                                             float y,
                                             PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-  float inputValue3[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-  this->m_inputValue3Operation->readSampled(inputValue3, x, y, sampler);
+  execute_pixel_sampled_math<math_wrap, 3>(output, x, y, sampler);
+}
 
-  output[0] = wrapf(inputValue1[0], inputValue2[0], inputValue3[0]);
+void MathWrapOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_wrap, 3>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_pingpong(float value1, float value2, float /*value3*/)
+{
+  return pingpongf(value1, value2);
 }
 
 void MathPingpongOperation::executePixelSampled(float output[4],
@@ -665,15 +817,17 @@ void MathPingpongOperation::executePixelSampled(float output[4],
                                                 float y,
                                                 PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+  execute_pixel_sampled_math<math_pingpong, 2>(output, x, y, sampler);
+}
 
-  output[0] = pingpongf(inputValue1[0], inputValue2[0]);
+void MathPingpongOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_pingpong, 2>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_compare(float value1, float value2, float value3)
+{
+  return (fabsf(value1 - value2) <= MAX2(value3, 1e-5f)) ? 1.0f : 0.0f;
 }
 
 void MathCompareOperation::executePixelSampled(float output[4],
@@ -681,18 +835,17 @@ void MathCompareOperation::executePixelSampled(float output[4],
                                                float y,
                                                PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-  float inputValue3[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-  this->m_inputValue3Operation->readSampled(inputValue3, x, y, sampler);
+  execute_pixel_sampled_math<math_compare, 3>(output, x, y, sampler);
+}
 
-  output[0] = (fabsf(inputValue1[0] - inputValue2[0]) <= MAX2(inputValue3[0], 1e-5f)) ? 1.0f :
-                                                                                        0.0f;
+void MathCompareOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_compare, 3>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_multiply_add(float value1, float value2, float value3)
+{
+  return value1 * value2 + value3;
 }
 
 void MathMultiplyAddOperation::executePixelSampled(float output[4],
@@ -700,17 +853,17 @@ void MathMultiplyAddOperation::executePixelSampled(float output[4],
                                                    float y,
                                                    PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-  float inputValue3[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-  this->m_inputValue3Operation->readSampled(inputValue3, x, y, sampler);
+  execute_pixel_sampled_math<math_multiply_add, 3>(output, x, y, sampler);
+}
 
-  output[0] = inputValue1[0] * inputValue2[0] + inputValue3[0];
+void MathMultiplyAddOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_multiply_add, 3>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_smooth_min(float value1, float value2, float value3)
+{
+  return smoothminf(value1, value2, value3);
 }
 
 void MathSmoothMinOperation::executePixelSampled(float output[4],
@@ -718,17 +871,17 @@ void MathSmoothMinOperation::executePixelSampled(float output[4],
                                                  float y,
                                                  PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-  float inputValue3[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-  this->m_inputValue3Operation->readSampled(inputValue3, x, y, sampler);
+  execute_pixel_sampled_math<math_smooth_min, 3>(output, x, y, sampler);
+}
 
-  output[0] = smoothminf(inputValue1[0], inputValue2[0], inputValue3[0]);
+void MathSmoothMinOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_smooth_min, 3>(it);
+}
 
-  clampIfNeeded(output);
+static inline float math_smooth_max(float value1, float value2, float value3)
+{
+  return -smoothminf(-value1, -value2, value3);
 }
 
 void MathSmoothMaxOperation::executePixelSampled(float output[4],
@@ -736,15 +889,10 @@ void MathSmoothMaxOperation::executePixelSampled(float output[4],
                                                  float y,
                                                  PixelSampler sampler)
 {
-  float inputValue1[4];
-  float inputValue2[4];
-  float inputValue3[4];
-
-  this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-  this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-  this->m_inputValue3Operation->readSampled(inputValue3, x, y, sampler);
-
-  output[0] = -smoothminf(-inputValue1[0], -inputValue2[0], inputValue3[0]);
+  execute_pixel_sampled_math<math_smooth_max, 3>(output, x, y, sampler);
+}
 
-  clampIfNeeded(output);
+void MathSmoothMaxOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_math<math_smooth_max, 3>(it);
 }
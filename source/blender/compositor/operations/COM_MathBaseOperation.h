@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include "COM_BuffersIterator.h"
 #include "COM_NodeOperation.h"
 
 /**
@@ -43,6 +44,42 @@ class MathBaseOperation : public NodeOperation {
 
   void clampIfNeeded(float color[4]);
 
+  /**
+   * Compute a single element from the first \a num_inputs input values. Shared by the tiled and
+   * the full frame execution.
+   */
+  using MathFunction = float (*)(float value1, float value2, float value3);
+
+  template<MathFunction math, int num_inputs>
+  void execute_pixel_sampled_math(float output[4], float x, float y, PixelSampler sampler)
+  {
+    float inputValue1[4];
+    float inputValue2[4] = {0.0f};
+    float inputValue3[4] = {0.0f};
+
+    this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
+    if (num_inputs > 1) {
+      this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+    }
+    if (num_inputs > 2) {
+      this->m_inputValue3Operation->readSampled(inputValue3, x, y, sampler);
+    }
+
+    output[0] = math(inputValue1[0], inputValue2[0], inputValue3[0]);
+    clampIfNeeded(output);
+  }
+
+  template<MathFunction math, int num_inputs>
+  void update_memory_buffer_partial_math(BuffersIterator &it)
+  {
+    for (; !it.is_end(); ++it) {
+      const float value2 = (num_inputs > 1) ? it.in(1)[0] : 0.0f;
+      const float value3 = (num_inputs > 2) ? it.in(2)[0] : 0.0f;
+      it.out[0] = math(it.in(0)[0], value2, value3);
+      clampIfNeeded(it.out);
+    }
+  }
+
  public:
   /**
    * The inner loop of this operation.
@@ -68,6 +105,9 @@ class MathBaseOperation : public NodeOperation {
   {
     this->m_useClamp = value;
   }
+
+ protected:
+  bool hash_output_params();
 };
 
 class MathAddOperation : public MathBaseOperation {
@@ -76,6 +116,8 @@ class MathAddOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
+  int get_identity_input(const float *const *constant_inputs) const;
 };
 class MathSubtractOperation : public MathBaseOperation {
  public:
@@ -83,6 +125,8 @@ class MathSubtractOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
+  int get_identity_input(const float *const *constant_inputs) const;
 };
 class MathMultiplyOperation : public MathBaseOperation {
  public:
@@ -90,6 +134,8 @@ class MathMultiplyOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
+  int get_identity_input(const float *const *constant_inputs) const;
 };
 class MathDivideOperation : public MathBaseOperation {
  public:
@@ -97,6 +143,8 @@ class MathDivideOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
+  int get_identity_input(const float *const *constant_inputs) const;
 };
 class MathSineOperation : public MathBaseOperation {
  public:
@@ -104,6 +152,7 @@ class MathSineOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class MathCosineOperation : public MathBaseOperation {
  public:
@@ -111,6 +160,7 @@ class MathCosineOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class MathTangentOperation : public MathBaseOperation {
  public:
@@ -118,6 +168,7 @@ class MathTangentOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathHyperbolicSineOperation : public MathBaseOperation {
@@ -126,6 +177,7 @@ class MathHyperbolicSineOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class MathHyperbolicCosineOperation : public MathBaseOperation {
  public:
@@ -133,6 +185,7 @@ class MathHyperbolicCosineOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class MathHyperbolicTangentOperation : public MathBaseOperation {
  public:
@@ -140,6 +193,7 @@ class MathHyperbolicTangentOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathArcSineOperation : public MathBaseOperation {
@@ -148,6 +202,7 @@ class MathArcSineOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class MathArcCosineOperation : public MathBaseOperation {
  public:
@@ -155,6 +210,7 @@ class MathArcCosineOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class MathArcTangentOperation : public MathBaseOperation {
  public:
@@ -162,6 +218,7 @@ class MathArcTangentOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class MathPowerOperation : public MathBaseOperation {
  public:
@@ -169,6 +226,7 @@ class MathPowerOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class MathLogarithmOperation : public MathBaseOperation {
  public:
@@ -176,6 +234,7 @@ class MathLogarithmOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class MathMinimumOperation : public MathBaseOperation {
  public:
@@ -183,6 +242,7 @@ class MathMinimumOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class MathMaximumOperation : public MathBaseOperation {
  public:
@@ -190,6 +250,7 @@ class MathMaximumOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class MathRoundOperation : public MathBaseOperation {
  public:
@@ -197,6 +258,7 @@ class MathRoundOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class MathLessThanOperation : public MathBaseOperation {
  public:
@@ -204,6 +266,7 @@ class MathLessThanOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 class MathGreaterThanOperation : public MathBaseOperation {
  public:
@@ -211,6 +274,7 @@ class MathGreaterThanOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathModuloOperation : public MathBaseOperation {
@@ -219,6 +283,7 @@ class MathModuloOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathAbsoluteOperation : public MathBaseOperation {
@@ -227,6 +292,7 @@ class MathAbsoluteOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathRadiansOperation : public MathBaseOperation {
@@ -235,6 +301,7 @@ class MathRadiansOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathDegreesOperation : public MathBaseOperation {
@@ -243,6 +310,7 @@ class MathDegreesOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathArcTan2Operation : public MathBaseOperation {
@@ -251,6 +319,7 @@ class MathArcTan2Operation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathFloorOperation : public MathBaseOperation {
@@ -259,6 +328,7 @@ class MathFloorOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathCeilOperation : public MathBaseOperation {
@@ -267,6 +337,7 @@ class MathCeilOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathFractOperation : public MathBaseOperation {
@@ -275,6 +346,7 @@ class MathFractOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathSqrtOperation : public MathBaseOperation {
@@ -283,6 +355,7 @@ class MathSqrtOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathInverseSqrtOperation : public MathBaseOperation {
@@ -291,6 +364,7 @@ class MathInverseSqrtOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathSignOperation : public MathBaseOperation {
@@ -299,6 +373,7 @@ class MathSignOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathExponentOperation : public MathBaseOperation {
@@ -307,6 +382,7 @@ class MathExponentOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathTruncOperation : public MathBaseOperation {
@@ -315,6 +391,7 @@ class MathTruncOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathSnapOperation : public MathBaseOperation {
@@ -323,6 +400,7 @@ class MathSnapOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathWrapOperation : public MathBaseOperation {
@@ -331,6 +409,7 @@ class MathWrapOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathPingpongOperation : public MathBaseOperation {
@@ -339,6 +418,7 @@ class MathPingpongOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathCompareOperation : public MathBaseOperation {
@@ -347,6 +427,7 @@ class MathCompareOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathMultiplyAddOperation : public MathBaseOperation {
@@ -355,6 +436,7 @@ class MathMultiplyAddOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathSmoothMinOperation : public MathBaseOperation {
@@ -363,6 +445,7 @@ class MathSmoothMinOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MathSmoothMaxOperation : public MathBaseOperation {
@@ -371,4 +454,5 @@ class MathSmoothMaxOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
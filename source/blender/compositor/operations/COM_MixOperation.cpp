@@ -33,6 +33,8 @@ MixBaseOperation::MixBaseOperation()
   this->m_inputColor2Operation = nullptr;
   this->setUseValueAlphaMultiply(false);
   this->setUseClamp(false);
+  this->setFullFrameOperation(true);
+  this->setCanBeConstant(true);
 }
 
 void MixBaseOperation::initExecution()
@@ -42,20 +44,11 @@ void MixBaseOperation::initExecution()
   this->m_inputColor2Operation = this->getInputSocketReader(2);
 }
 
-void MixBaseOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+static inline void mix_blend(float output[4],
+                             float value,
+                             const float inputColor1[4],
+                             const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   float valuem = 1.0f - value;
   output[0] = valuem * (inputColor1[0]) + value * (inputColor2[0]);
   output[1] = valuem * (inputColor1[1]) + value * (inputColor2[1]);
@@ -63,6 +56,24 @@ void MixBaseOperation::executePixelSampled(float output[4], float x, float y, Pi
   output[3] = inputColor1[3];
 }
 
+void MixBaseOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_blend>(output, x, y, sampler);
+}
+
+void MixBaseOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_blend>(it);
+}
+
+int MixBaseOperation::get_zero_factor_identity_input(const float *const *constant_inputs) const
+{
+  if (!this->m_useClamp && constant_inputs[0] && constant_inputs[0][0] == 0.0f) {
+    return 1;
+  }
+  return -1;
+}
+
 void MixBaseOperation::determineResolution(unsigned int resolution[2],
                                            unsigned int preferredResolution[2])
 {
@@ -95,6 +106,13 @@ void MixBaseOperation::deinitExecution()
   this->m_inputColor2Operation = nullptr;
 }
 
+bool MixBaseOperation::hash_output_params()
+{
+  hash_param(this->m_valueAlphaMultiply);
+  hash_param(this->m_useClamp);
+  return true;
+}
+
 /* ******** Mix Add Operation ******** */
 
 MixAddOperation::MixAddOperation()
@@ -102,26 +120,30 @@ MixAddOperation::MixAddOperation()
   /* pass */
 }
 
-void MixAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+static inline void mix_add(float output[4],
+                           float value,
+                           const float inputColor1[4],
+                           const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   output[0] = inputColor1[0] + value * inputColor2[0];
   output[1] = inputColor1[1] + value * inputColor2[1];
   output[2] = inputColor1[2] + value * inputColor2[2];
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_add>(output, x, y, sampler);
+}
+
+void MixAddOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_add>(it);
+}
+
+int MixAddOperation::get_identity_input(const float *const *constant_inputs) const
+{
+  return get_zero_factor_identity_input(constant_inputs);
 }
 
 /* ******** Mix Blend Operation ******** */
@@ -136,26 +158,17 @@ void MixBlendOperation::executePixelSampled(float output[4],
                                             float y,
                                             PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-  float value;
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-  value = inputValue[0];
+  execute_pixel_sampled_mix<mix_blend>(output, x, y, sampler);
+}
 
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
-  float valuem = 1.0f - value;
-  output[0] = valuem * (inputColor1[0]) + value * (inputColor2[0]);
-  output[1] = valuem * (inputColor1[1]) + value * (inputColor2[1]);
-  output[2] = valuem * (inputColor1[2]) + value * (inputColor2[2]);
-  output[3] = inputColor1[3];
+void MixBlendOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_blend>(it);
+}
 
-  clampIfNeeded(output);
+int MixBlendOperation::get_identity_input(const float *const *constant_inputs) const
+{
+  return get_zero_factor_identity_input(constant_inputs);
 }
 
 /* ******** Mix Burn Operation ******** */
@@ -165,25 +178,13 @@ MixColorBurnOperation::MixColorBurnOperation()
   /* pass */
 }
 
-void MixColorBurnOperation::executePixelSampled(float output[4],
-                                                float x,
-                                                float y,
-                                                PixelSampler sampler)
+static inline void mix_color_burn(float output[4],
+                                  float value,
+                                  const float inputColor1[4],
+                                  const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-  float tmp;
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   float valuem = 1.0f - value;
+  float tmp;
 
   tmp = valuem + value * inputColor2[0];
   if (tmp <= 0.0f) {
@@ -237,8 +238,19 @@ void MixColorBurnOperation::executePixelSampled(float output[4],
   }
 
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixColorBurnOperation::executePixelSampled(float output[4],
+                                                float x,
+                                                float y,
+                                                PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_color_burn>(output, x, y, sampler);
+}
+
+void MixColorBurnOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_color_burn>(it);
 }
 
 /* ******** Mix Color Operation ******** */
@@ -248,23 +260,11 @@ MixColorOperation::MixColorOperation()
   /* pass */
 }
 
-void MixColorOperation::executePixelSampled(float output[4],
-                                            float x,
-                                            float y,
-                                            PixelSampler sampler)
+static inline void mix_color(float output[4],
+                             float value,
+                             const float inputColor1[4],
+                             const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   float valuem = 1.0f - value;
 
   float colH, colS, colV;
@@ -282,8 +282,19 @@ void MixColorOperation::executePixelSampled(float output[4],
     copy_v3_v3(output, inputColor1);
   }
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixColorOperation::executePixelSampled(float output[4],
+                                            float x,
+                                            float y,
+                                            PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_color>(output, x, y, sampler);
+}
+
+void MixColorOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_color>(it);
 }
 
 /* ******** Mix Darken Operation ******** */
@@ -293,30 +304,29 @@ MixDarkenOperation::MixDarkenOperation()
   /* pass */
 }
 
-void MixDarkenOperation::executePixelSampled(float output[4],
-                                             float x,
-                                             float y,
-                                             PixelSampler sampler)
+static inline void mix_darken(float output[4],
+                              float value,
+                              const float inputColor1[4],
+                              const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   float valuem = 1.0f - value;
   output[0] = min_ff(inputColor1[0], inputColor2[0]) * value + inputColor1[0] * valuem;
   output[1] = min_ff(inputColor1[1], inputColor2[1]) * value + inputColor1[1] * valuem;
   output[2] = min_ff(inputColor1[2], inputColor2[2]) * value + inputColor1[2] * valuem;
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixDarkenOperation::executePixelSampled(float output[4],
+                                             float x,
+                                             float y,
+                                             PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_darken>(output, x, y, sampler);
+}
+
+void MixDarkenOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_darken>(it);
 }
 
 /* ******** Mix Difference Operation ******** */
@@ -326,30 +336,29 @@ MixDifferenceOperation::MixDifferenceOperation()
   /* pass */
 }
 
-void MixDifferenceOperation::executePixelSampled(float output[4],
-                                                 float x,
-                                                 float y,
-                                                 PixelSampler sampler)
+static inline void mix_difference(float output[4],
+                                  float value,
+                                  const float inputColor1[4],
+                                  const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   float valuem = 1.0f - value;
   output[0] = valuem * inputColor1[0] + value * fabsf(inputColor1[0] - inputColor2[0]);
   output[1] = valuem * inputColor1[1] + value * fabsf(inputColor1[1] - inputColor2[1]);
   output[2] = valuem * inputColor1[2] + value * fabsf(inputColor1[2] - inputColor2[2]);
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixDifferenceOperation::executePixelSampled(float output[4],
+                                                 float x,
+                                                 float y,
+                                                 PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_difference>(output, x, y, sampler);
+}
+
+void MixDifferenceOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_difference>(it);
 }
 
 /* ******** Mix Difference Operation ******** */
@@ -359,23 +368,11 @@ MixDivideOperation::MixDivideOperation()
   /* pass */
 }
 
-void MixDivideOperation::executePixelSampled(float output[4],
-                                             float x,
-                                             float y,
-                                             PixelSampler sampler)
+static inline void mix_divide(float output[4],
+                              float value,
+                              const float inputColor1[4],
+                              const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   float valuem = 1.0f - value;
 
   if (inputColor2[0] != 0.0f) {
@@ -398,8 +395,19 @@ void MixDivideOperation::executePixelSampled(float output[4],
   }
 
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixDivideOperation::executePixelSampled(float output[4],
+                                             float x,
+                                             float y,
+                                             PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_divide>(output, x, y, sampler);
+}
+
+void MixDivideOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_divide>(it);
 }
 
 /* ******** Mix Dodge Operation ******** */
@@ -409,25 +417,13 @@ MixDodgeOperation::MixDodgeOperation()
   /* pass */
 }
 
-void MixDodgeOperation::executePixelSampled(float output[4],
-                                            float x,
-                                            float y,
-                                            PixelSampler sampler)
+static inline void mix_dodge(float output[4],
+                             float value,
+                             const float inputColor1[4],
+                             const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
   float tmp;
 
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
-
   if (inputColor1[0] != 0.0f) {
     tmp = 1.0f - value * inputColor2[0];
     if (tmp <= 0.0f) {
@@ -486,8 +482,19 @@ void MixDodgeOperation::executePixelSampled(float output[4],
   }
 
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixDodgeOperation::executePixelSampled(float output[4],
+                                            float x,
+                                            float y,
+                                            PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_dodge>(output, x, y, sampler);
+}
+
+void MixDodgeOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_dodge>(it);
 }
 
 /* ******** Mix Glare Operation ******** */
@@ -497,6 +504,32 @@ MixGlareOperation::MixGlareOperation()
   /* pass */
 }
 
+static inline void mix_glare(float output[4],
+                             float value,
+                             const float inputColor1[4],
+                             const float inputColor2[4])
+{
+  float mf = 2.0f - 2.0f * fabsf(value - 0.5f);
+  float color1[3];
+
+  copy_v3_v3(color1, inputColor1);
+  if (color1[0] < 0.0f) {
+    color1[0] = 0.0f;
+  }
+  if (color1[1] < 0.0f) {
+    color1[1] = 0.0f;
+  }
+  if (color1[2] < 0.0f) {
+    color1[2] = 0.0f;
+  }
+
+  output[0] = mf * max(color1[0] + value * (inputColor2[0] - color1[0]), 0.0f);
+  output[1] = mf * max(color1[1] + value * (inputColor2[1] - color1[1]), 0.0f);
+  output[2] = mf * max(color1[2] + value * (inputColor2[2] - color1[2]), 0.0f);
+  output[3] = inputColor1[3];
+}
+
+/* The glare factor is never multiplied by the alpha of the glare color. */
 void MixGlareOperation::executePixelSampled(float output[4],
                                             float x,
                                             float y,
@@ -505,32 +538,23 @@ void MixGlareOperation::executePixelSampled(float output[4],
   float inputColor1[4];
   float inputColor2[4];
   float inputValue[4];
-  float value;
 
   this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
   this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
   this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-  value = inputValue[0];
-  float mf = 2.0f - 2.0f * fabsf(value - 0.5f);
-
-  if (inputColor1[0] < 0.0f) {
-    inputColor1[0] = 0.0f;
-  }
-  if (inputColor1[1] < 0.0f) {
-    inputColor1[1] = 0.0f;
-  }
-  if (inputColor1[2] < 0.0f) {
-    inputColor1[2] = 0.0f;
-  }
-
-  output[0] = mf * max(inputColor1[0] + value * (inputColor2[0] - inputColor1[0]), 0.0f);
-  output[1] = mf * max(inputColor1[1] + value * (inputColor2[1] - inputColor1[1]), 0.0f);
-  output[2] = mf * max(inputColor1[2] + value * (inputColor2[2] - inputColor1[2]), 0.0f);
-  output[3] = inputColor1[3];
 
+  mix_glare(output, inputValue[0], inputColor1, inputColor2);
   clampIfNeeded(output);
 }
 
+void MixGlareOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    mix_glare(it.out, it.in(0)[0], it.in(1), it.in(2));
+    clampIfNeeded(it.out);
+  }
+}
+
 /* ******** Mix Hue Operation ******** */
 
 MixHueOperation::MixHueOperation()
@@ -538,20 +562,11 @@ MixHueOperation::MixHueOperation()
   /* pass */
 }
 
-void MixHueOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+static inline void mix_hue(float output[4],
+                           float value,
+                           const float inputColor1[4],
+                           const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   float valuem = 1.0f - value;
 
   float colH, colS, colV;
@@ -569,8 +584,16 @@ void MixHueOperation::executePixelSampled(float output[4], float x, float y, Pix
     copy_v3_v3(output, inputColor1);
   }
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixHueOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_hue>(output, x, y, sampler);
+}
+
+void MixHueOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_hue>(it);
 }
 
 /* ******** Mix Lighten Operation ******** */
@@ -580,23 +603,11 @@ MixLightenOperation::MixLightenOperation()
   /* pass */
 }
 
-void MixLightenOperation::executePixelSampled(float output[4],
-                                              float x,
-                                              float y,
-                                              PixelSampler sampler)
+static inline void mix_lighten(float output[4],
+                               float value,
+                               const float inputColor1[4],
+                               const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   float tmp;
   tmp = value * inputColor2[0];
   if (tmp > inputColor1[0]) {
@@ -620,8 +631,19 @@ void MixLightenOperation::executePixelSampled(float output[4],
     output[2] = inputColor1[2];
   }
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixLightenOperation::executePixelSampled(float output[4],
+                                              float x,
+                                              float y,
+                                              PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_lighten>(output, x, y, sampler);
+}
+
+void MixLightenOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_lighten>(it);
 }
 
 /* ******** Mix Linear Light Operation ******** */
@@ -631,23 +653,11 @@ MixLinearLightOperation::MixLinearLightOperation()
   /* pass */
 }
 
-void MixLinearLightOperation::executePixelSampled(float output[4],
-                                                  float x,
-                                                  float y,
-                                                  PixelSampler sampler)
+static inline void mix_linear_light(float output[4],
+                                    float value,
+                                    const float inputColor1[4],
+                                    const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   if (inputColor2[0] > 0.5f) {
     output[0] = inputColor1[0] + value * (2.0f * (inputColor2[0] - 0.5f));
   }
@@ -668,8 +678,19 @@ void MixLinearLightOperation::executePixelSampled(float output[4],
   }
 
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixLinearLightOperation::executePixelSampled(float output[4],
+                                                  float x,
+                                                  float y,
+                                                  PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_linear_light>(output, x, y, sampler);
+}
+
+void MixLinearLightOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_linear_light>(it);
 }
 
 /* ******** Mix Multiply Operation ******** */
@@ -679,30 +700,34 @@ MixMultiplyOperation::MixMultiplyOperation()
   /* pass */
 }
 
-void MixMultiplyOperation::executePixelSampled(float output[4],
-                                               float x,
-                                               float y,
-                                               PixelSampler sampler)
+static inline void mix_multiply(float output[4],
+                                float value,
+                                const float inputColor1[4],
+                                const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   float valuem = 1.0f - value;
   output[0] = inputColor1[0] * (valuem + value * inputColor2[0]);
   output[1] = inputColor1[1] * (valuem + value * inputColor2[1]);
   output[2] = inputColor1[2] * (valuem + value * inputColor2[2]);
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixMultiplyOperation::executePixelSampled(float output[4],
+                                               float x,
+                                               float y,
+                                               PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_multiply>(output, x, y, sampler);
+}
+
+void MixMultiplyOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_multiply>(it);
+}
+
+int MixMultiplyOperation::get_identity_input(const float *const *constant_inputs) const
+{
+  return get_zero_factor_identity_input(constant_inputs);
 }
 
 /* ******** Mix Overlay Operation ******** */
@@ -712,47 +737,48 @@ MixOverlayOperation::MixOverlayOperation()
   /* pass */
 }
 
-void MixOverlayOperation::executePixelSampled(float output[4],
-                                              float x,
-                                              float y,
-                                              PixelSampler sampler)
+static inline void mix_overlay(float output[4],
+                               float value,
+                               const float inputColor1[4],
+                               const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
-
   float valuem = 1.0f - value;
 
   if (inputColor1[0] < 0.5f) {
     output[0] = inputColor1[0] * (valuem + 2.0f * value * inputColor2[0]);
   }
   else {
-    output[0] = 1.0f - (valuem + 2.0f * value * (1.0f - inputColor2[0])) * (1.0f - inputColor1[0]);
+    output[0] = 1.0f -
+                (valuem + 2.0f * value * (1.0f - inputColor2[0])) * (1.0f - inputColor1[0]);
   }
   if (inputColor1[1] < 0.5f) {
     output[1] = inputColor1[1] * (valuem + 2.0f * value * inputColor2[1]);
   }
   else {
-    output[1] = 1.0f - (valuem + 2.0f * value * (1.0f - inputColor2[1])) * (1.0f - inputColor1[1]);
+    output[1] = 1.0f -
+                (valuem + 2.0f * value * (1.0f - inputColor2[1])) * (1.0f - inputColor1[1]);
   }
   if (inputColor1[2] < 0.5f) {
     output[2] = inputColor1[2] * (valuem + 2.0f * value * inputColor2[2]);
   }
   else {
-    output[2] = 1.0f - (valuem + 2.0f * value * (1.0f - inputColor2[2])) * (1.0f - inputColor1[2]);
+    output[2] = 1.0f -
+                (valuem + 2.0f * value * (1.0f - inputColor2[2])) * (1.0f - inputColor1[2]);
   }
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixOverlayOperation::executePixelSampled(float output[4],
+                                              float x,
+                                              float y,
+                                              PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_overlay>(output, x, y, sampler);
+}
+
+void MixOverlayOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_overlay>(it);
 }
 
 /* ******** Mix Saturation Operation ******** */
@@ -762,23 +788,11 @@ MixSaturationOperation::MixSaturationOperation()
   /* pass */
 }
 
-void MixSaturationOperation::executePixelSampled(float output[4],
-                                                 float x,
-                                                 float y,
-                                                 PixelSampler sampler)
+static inline void mix_saturation(float output[4],
+                                  float value,
+                                  const float inputColor1[4],
+                                  const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   float valuem = 1.0f - value;
 
   float rH, rS, rV;
@@ -793,8 +807,19 @@ void MixSaturationOperation::executePixelSampled(float output[4],
   }
 
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixSaturationOperation::executePixelSampled(float output[4],
+                                                 float x,
+                                                 float y,
+                                                 PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_saturation>(output, x, y, sampler);
+}
+
+void MixSaturationOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_saturation>(it);
 }
 
 /* ******** Mix Screen Operation ******** */
@@ -804,31 +829,30 @@ MixScreenOperation::MixScreenOperation()
   /* pass */
 }
 
-void MixScreenOperation::executePixelSampled(float output[4],
-                                             float x,
-                                             float y,
-                                             PixelSampler sampler)
+static inline void mix_screen(float output[4],
+                              float value,
+                              const float inputColor1[4],
+                              const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   float valuem = 1.0f - value;
 
   output[0] = 1.0f - (valuem + value * (1.0f - inputColor2[0])) * (1.0f - inputColor1[0]);
   output[1] = 1.0f - (valuem + value * (1.0f - inputColor2[1])) * (1.0f - inputColor1[1]);
   output[2] = 1.0f - (valuem + value * (1.0f - inputColor2[2])) * (1.0f - inputColor1[2]);
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixScreenOperation::executePixelSampled(float output[4],
+                                             float x,
+                                             float y,
+                                             PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_screen>(output, x, y, sampler);
+}
+
+void MixScreenOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_screen>(it);
 }
 
 /* ******** Mix Soft Light Operation ******** */
@@ -838,23 +862,11 @@ MixSoftLightOperation::MixSoftLightOperation()
   /* pass */
 }
 
-void MixSoftLightOperation::executePixelSampled(float output[4],
-                                                float x,
-                                                float y,
-                                                PixelSampler sampler)
+static inline void mix_soft_light(float output[4],
+                                  float value,
+                                  const float inputColor1[4],
+                                  const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   float valuem = 1.0f - value;
   float scr, scg, scb;
 
@@ -873,8 +885,19 @@ void MixSoftLightOperation::executePixelSampled(float output[4],
               value * (((1.0f - inputColor1[2]) * inputColor2[2] * (inputColor1[2])) +
                        (inputColor1[2] * scb));
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixSoftLightOperation::executePixelSampled(float output[4],
+                                                float x,
+                                                float y,
+                                                PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_soft_light>(output, x, y, sampler);
+}
+
+void MixSoftLightOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_soft_light>(it);
 }
 
 /* ******** Mix Subtract Operation ******** */
@@ -884,29 +907,33 @@ MixSubtractOperation::MixSubtractOperation()
   /* pass */
 }
 
+static inline void mix_subtract(float output[4],
+                                float value,
+                                const float inputColor1[4],
+                                const float inputColor2[4])
+{
+  output[0] = inputColor1[0] - value * (inputColor2[0]);
+  output[1] = inputColor1[1] - value * (inputColor2[1]);
+  output[2] = inputColor1[2] - value * (inputColor2[2]);
+  output[3] = inputColor1[3];
+}
+
 void MixSubtractOperation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
                                                PixelSampler sampler)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+  execute_pixel_sampled_mix<mix_subtract>(output, x, y, sampler);
+}
 
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
-  output[0] = inputColor1[0] - value * (inputColor2[0]);
-  output[1] = inputColor1[1] - value * (inputColor2[1]);
-  output[2] = inputColor1[2] - value * (inputColor2[2]);
-  output[3] = inputColor1[3];
+void MixSubtractOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_subtract>(it);
+}
 
-  clampIfNeeded(output);
+int MixSubtractOperation::get_identity_input(const float *const *constant_inputs) const
+{
+  return get_zero_factor_identity_input(constant_inputs);
 }
 
 /* ******** Mix Value Operation ******** */
@@ -916,23 +943,11 @@ MixValueOperation::MixValueOperation()
   /* pass */
 }
 
-void MixValueOperation::executePixelSampled(float output[4],
-                                            float x,
-                                            float y,
-                                            PixelSampler sampler)
+static inline void mix_value(float output[4],
+                             float value,
+                             const float inputColor1[4],
+                             const float inputColor2[4])
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
   float valuem = 1.0f - value;
 
   float rH, rS, rV;
@@ -941,6 +956,17 @@ void MixValueOperation::executePixelSampled(float output[4],
   rgb_to_hsv(inputColor2[0], inputColor2[1], inputColor2[2], &colH, &colS, &colV);
   hsv_to_rgb(rH, rS, (valuem * rV + value * colV), &output[0], &output[1], &output[2]);
   output[3] = inputColor1[3];
+}
 
-  clampIfNeeded(output);
+void MixValueOperation::executePixelSampled(float output[4],
+                                            float x,
+                                            float y,
+                                            PixelSampler sampler)
+{
+  execute_pixel_sampled_mix<mix_value>(output, x, y, sampler);
+}
+
+void MixValueOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  update_memory_buffer_partial_mix<mix_value>(it);
 }
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include "COM_BuffersIterator.h"
 #include "COM_NodeOperation.h"
 
 /**
@@ -43,6 +44,50 @@ class MixBaseOperation : public NodeOperation {
     }
   }
 
+  /**
+   * \brief the output of blend modes mixing from the first color is equal to the first color
+   * when the factor is zero
+   */
+  int get_zero_factor_identity_input(const float *const *constant_inputs) const;
+
+  /**
+   * Mix a single element. \a value is the mix factor, already multiplied by the alpha of the
+   * second color when enabled. Shared by the tiled and the full frame execution.
+   */
+  using MixFunction = void (*)(float output[4],
+                               float value,
+                               const float inputColor1[4],
+                               const float inputColor2[4]);
+
+  inline float get_mix_factor(const float inputValue[4], const float inputColor2[4])
+  {
+    return this->m_valueAlphaMultiply ? inputValue[0] * inputColor2[3] : inputValue[0];
+  }
+
+  template<MixFunction mix>
+  void execute_pixel_sampled_mix(float output[4], float x, float y, PixelSampler sampler)
+  {
+    float inputColor1[4];
+    float inputColor2[4];
+    float inputValue[4];
+
+    this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
+    this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
+    this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+
+    mix(output, get_mix_factor(inputValue, inputColor2), inputColor1, inputColor2);
+    clampIfNeeded(output);
+  }
+
+  template<MixFunction mix> void update_memory_buffer_partial_mix(BuffersIterator &it)
+  {
+    for (; !it.is_end(); ++it) {
+      const float *inputColor2 = it.in(2);
+      mix(it.out, get_mix_factor(it.in(0), inputColor2), it.in(1), inputColor2);
+      clampIfNeeded(it.out);
+    }
+  }
+
  public:
   /**
    * Default constructor
@@ -53,6 +98,7 @@ class MixBaseOperation : public NodeOperation {
    * The inner loop of this operation.
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 
   /**
    * Initialize the execution
@@ -78,118 +124,144 @@ class MixBaseOperation : public NodeOperation {
   {
     this->m_useClamp = value;
   }
+
+ protected:
+  bool hash_output_params();
 };
 
 class MixAddOperation : public MixBaseOperation {
  public:
   MixAddOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
+  int get_identity_input(const float *const *constant_inputs) const;
 };
 
 class MixBlendOperation : public MixBaseOperation {
  public:
   MixBlendOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
+  int get_identity_input(const float *const *constant_inputs) const;
 };
 
 class MixColorBurnOperation : public MixBaseOperation {
  public:
   MixColorBurnOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixColorOperation : public MixBaseOperation {
  public:
   MixColorOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixDarkenOperation : public MixBaseOperation {
  public:
   MixDarkenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixDifferenceOperation : public MixBaseOperation {
  public:
   MixDifferenceOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixDivideOperation : public MixBaseOperation {
  public:
   MixDivideOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixDodgeOperation : public MixBaseOperation {
  public:
   MixDodgeOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixGlareOperation : public MixBaseOperation {
  public:
   MixGlareOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixHueOperation : public MixBaseOperation {
  public:
   MixHueOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixLightenOperation : public MixBaseOperation {
  public:
   MixLightenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixLinearLightOperation : public MixBaseOperation {
  public:
   MixLinearLightOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixMultiplyOperation : public MixBaseOperation {
  public:
   MixMultiplyOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
+  int get_identity_input(const float *const *constant_inputs) const;
 };
 
 class MixOverlayOperation : public MixBaseOperation {
  public:
   MixOverlayOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixSaturationOperation : public MixBaseOperation {
  public:
   MixSaturationOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixScreenOperation : public MixBaseOperation {
  public:
   MixScreenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixSoftLightOperation : public MixBaseOperation {
  public:
   MixSoftLightOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class MixSubtractOperation : public MixBaseOperation {
  public:
   MixSubtractOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
+  int get_identity_input(const float *const *constant_inputs) const;
 };
 
 class MixValueOperation : public MixBaseOperation {
  public:
   MixValueOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
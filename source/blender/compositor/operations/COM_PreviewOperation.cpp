@@ -44,6 +44,7 @@ PreviewOperation::PreviewOperation(const ColorManagedViewSettings *viewSettings,
   this->m_divider = 1.0f;
   this->m_viewSettings = viewSettings;
   this->m_displaySettings = displaySettings;
+  this->setFullFrameOperation(true);
 }
 
 void PreviewOperation::verifyPreview(bNodeInstanceHash *previews, bNodeInstanceKey key)
@@ -109,6 +110,37 @@ void PreviewOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 
   IMB_colormanagement_processor_free(cm_processor);
 }
+
+void PreviewOperation::update_memory_buffer(MemoryBuffer * /*output*/,
+                                            const rcti &area,
+                                            MemoryBuffer **inputs)
+{
+  MemoryBuffer *input = inputs[0];
+  float color[4];
+  struct ColormanageProcessor *cm_processor;
+
+  cm_processor = IMB_colormanagement_display_processor_new(this->m_viewSettings,
+                                                           this->m_displaySettings);
+
+  for (int y = area.ymin; y < area.ymax; y++) {
+    int offset = (y * getWidth() + area.xmin) * 4;
+    for (int x = area.xmin; x < area.xmax; x++) {
+      const int rx = floor(x / this->m_divider);
+      const int ry = floor(y / this->m_divider);
+
+      color[0] = 0.0f;
+      color[1] = 0.0f;
+      color[2] = 0.0f;
+      color[3] = 1.0f;
+      input->read_elem_checked(rx, ry, color);
+      IMB_colormanagement_processor_apply_v4(cm_processor, color);
+      rgba_float_to_uchar(this->m_outputBuffer + offset, color);
+      offset += 4;
+    }
+  }
+
+  IMB_colormanagement_processor_free(cm_processor);
+}
 bool PreviewOperation::determineDependingAreaOfInterest(rcti *input,
                                                         ReadBufferOperation *readOperation,
                                                         rcti *output)
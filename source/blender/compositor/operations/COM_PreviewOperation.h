@@ -52,6 +52,7 @@ class PreviewOperation : public NodeOperation {
   CompositorPriority getRenderPriority() const;
 
   void executeRegion(rcti *rect, unsigned int tileNumber);
+  void update_memory_buffer(MemoryBuffer *output, const rcti &area, MemoryBuffer **inputs);
   void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
   bool determineDependingAreaOfInterest(rcti *input,
                                         ReadBufferOperation *readOperation,
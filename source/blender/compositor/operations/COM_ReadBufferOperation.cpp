@@ -74,6 +74,12 @@ void ReadBufferOperation::executePixelSampled(float output[4],
   }
 }
 
+bool ReadBufferOperation::hash_output_params()
+{
+  /* identified by the operation writing the buffer */
+  return true;
+}
+
 void ReadBufferOperation::executePixelExtend(float output[4],
                                              float x,
                                              float y,
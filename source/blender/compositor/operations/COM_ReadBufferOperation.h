@@ -71,4 +71,7 @@ class ReadBufferOperation : public NodeOperation {
   }
   void readResolutionFromWriteBuffer();
   void updateMemoryBuffer();
+
+ protected:
+  bool hash_output_params();
 };
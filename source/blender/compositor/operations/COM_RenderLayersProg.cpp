@@ -17,6 +17,7 @@
  */
 
 #include "COM_RenderLayersProg.h"
+#include "COM_BuffersIterator.h"
 
 #include "COM_MetaData.h"
 
@@ -44,6 +45,7 @@ RenderLayersProg::RenderLayersProg(const char *passName, DataType type, int elem
   this->m_rd = nullptr;
 
   this->addOutputSocket(type);
+  this->setFullFrameOperation(true);
 }
 
 void RenderLayersProg::initExecution()
@@ -182,11 +184,44 @@ void RenderLayersProg::executePixelSampled(float output[4], float x, float y, Pi
   }
 }
 
+void RenderLayersProg::update_memory_buffer_partial(BuffersIterator &it)
+{
+  const float *inputBuffer = this->m_inputBuffer;
+  const int width = this->getWidth();
+  const size_t elem_size = sizeof(float) * this->m_elementsize;
+
+  for (; !it.is_end(); ++it) {
+    if (inputBuffer == nullptr) {
+      memset(it.out, 0, elem_size);
+    }
+    else {
+      memcpy(it.out, &inputBuffer[(it.y() * width + it.x()) * this->m_elementsize], elem_size);
+    }
+  }
+}
+
 void RenderLayersProg::deinitExecution()
 {
   this->m_inputBuffer = nullptr;
 }
 
+bool RenderLayersProg::hash_output_params()
+{
+  Render *re = (this->m_scene) ? RE_GetSceneRender(this->m_scene) : nullptr;
+  if (re == nullptr || this->m_inputBuffer == nullptr) {
+    return false;
+  }
+  /* The render result is replaced by every render, which is identified by its start time. */
+  hash_param(RE_GetStats(re)->starttime);
+  hash_param(this->m_inputBuffer);
+  hash_param(this->m_elementsize);
+  if (this->m_rd) {
+    hash_param(this->m_rd->mode);
+    hash_param(this->m_rd->border);
+  }
+  return true;
+}
+
 void RenderLayersProg::determineResolution(unsigned int resolution[2],
                                            unsigned int /*preferredResolution*/[2])
 {
@@ -312,6 +347,22 @@ void RenderLayersAOOperation::executePixelSampled(float output[4],
   output[3] = 1.0f;
 }
 
+void RenderLayersAOOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  const float *inputBuffer = this->getInputBuffer();
+  const int width = this->getWidth();
+
+  for (; !it.is_end(); ++it) {
+    if (inputBuffer == nullptr) {
+      zero_v3(it.out);
+    }
+    else {
+      copy_v3_v3(it.out, &inputBuffer[(it.y() * width + it.x()) * this->m_elementsize]);
+    }
+    it.out[3] = 1.0f;
+  }
+}
+
 /* ******** Render Layers Alpha Operation ******** */
 void RenderLayersAlphaProg::executePixelSampled(float output[4],
                                                 float x,
@@ -330,6 +381,18 @@ void RenderLayersAlphaProg::executePixelSampled(float output[4],
   }
 }
 
+void RenderLayersAlphaProg::update_memory_buffer_partial(BuffersIterator &it)
+{
+  const float *inputBuffer = this->getInputBuffer();
+  const int width = this->getWidth();
+
+  for (; !it.is_end(); ++it) {
+    it.out[0] = (inputBuffer == nullptr) ?
+                    0.0f :
+                    inputBuffer[(it.y() * width + it.x()) * this->m_elementsize + 3];
+  }
+}
+
 /* ******** Render Layers Depth Operation ******** */
 void RenderLayersDepthProg::executePixelSampled(float output[4],
                                                 float x,
@@ -349,3 +412,13 @@ void RenderLayersDepthProg::executePixelSampled(float output[4],
     output[0] = inputBuffer[offset];
   }
 }
+
+void RenderLayersDepthProg::update_memory_buffer_partial(BuffersIterator &it)
+{
+  const float *inputBuffer = this->getInputBuffer();
+  const int width = this->getWidth();
+
+  for (; !it.is_end(); ++it) {
+    it.out[0] = (inputBuffer == nullptr) ? 10e10f : inputBuffer[it.y() * width + it.x()];
+  }
+}
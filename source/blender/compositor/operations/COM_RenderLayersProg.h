@@ -122,8 +122,12 @@ class RenderLayersProg : public NodeOperation {
   void initExecution() override;
   void deinitExecution() override;
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler) override;
+  void update_memory_buffer_partial(BuffersIterator &it) override;
 
   std::unique_ptr<MetaData> getMetaData() const override;
+
+ protected:
+  bool hash_output_params() override;
 };
 
 class RenderLayersAOOperation : public RenderLayersProg {
@@ -133,6 +137,7 @@ class RenderLayersAOOperation : public RenderLayersProg {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class RenderLayersAlphaProg : public RenderLayersProg {
@@ -142,6 +147,7 @@ class RenderLayersAlphaProg : public RenderLayersProg {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
 
 class RenderLayersDepthProg : public RenderLayersProg {
@@ -151,4 +157,5 @@ class RenderLayersDepthProg : public RenderLayersProg {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 };
@@ -17,6 +17,7 @@
  */
 
 #include "COM_SetAlphaMultiplyOperation.h"
+#include "COM_BuffersIterator.h"
 
 SetAlphaMultiplyOperation::SetAlphaMultiplyOperation()
 {
@@ -26,6 +27,8 @@ SetAlphaMultiplyOperation::SetAlphaMultiplyOperation()
 
   this->m_inputColor = nullptr;
   this->m_inputAlpha = nullptr;
+  this->setFullFrameOperation(true);
+  this->setCanBeConstant(true);
 }
 
 void SetAlphaMultiplyOperation::initExecution()
@@ -48,8 +51,20 @@ void SetAlphaMultiplyOperation::executePixelSampled(float output[4],
   mul_v4_v4fl(output, color_input, alpha_input[0]);
 }
 
+void SetAlphaMultiplyOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    mul_v4_v4fl(it.out, it.in(0), it.in(1)[0]);
+  }
+}
+
 void SetAlphaMultiplyOperation::deinitExecution()
 {
   this->m_inputColor = nullptr;
   this->m_inputAlpha = nullptr;
 }
+
+bool SetAlphaMultiplyOperation::hash_output_params()
+{
+  return true;
+}
@@ -34,7 +34,11 @@ class SetAlphaMultiplyOperation : public NodeOperation {
   SetAlphaMultiplyOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 
   void initExecution();
   void deinitExecution();
+
+ protected:
+  bool hash_output_params();
 };
@@ -17,6 +17,7 @@
  */
 
 #include "COM_SetAlphaReplaceOperation.h"
+#include "COM_BuffersIterator.h"
 
 SetAlphaReplaceOperation::SetAlphaReplaceOperation()
 {
@@ -26,6 +27,8 @@ SetAlphaReplaceOperation::SetAlphaReplaceOperation()
 
   this->m_inputColor = nullptr;
   this->m_inputAlpha = nullptr;
+  this->setFullFrameOperation(true);
+  this->setCanBeConstant(true);
 }
 
 void SetAlphaReplaceOperation::initExecution()
@@ -46,8 +49,21 @@ void SetAlphaReplaceOperation::executePixelSampled(float output[4],
   output[3] = alpha_input[0];
 }
 
+void SetAlphaReplaceOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    copy_v3_v3(it.out, it.in(0));
+    it.out[3] = it.in(1)[0];
+  }
+}
+
 void SetAlphaReplaceOperation::deinitExecution()
 {
   this->m_inputColor = nullptr;
   this->m_inputAlpha = nullptr;
 }
+
+bool SetAlphaReplaceOperation::hash_output_params()
+{
+  return true;
+}
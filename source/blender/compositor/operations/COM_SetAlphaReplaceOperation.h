@@ -39,7 +39,11 @@ class SetAlphaReplaceOperation : public NodeOperation {
    * the inner loop of this program
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 
   void initExecution();
   void deinitExecution();
+
+ protected:
+  bool hash_output_params();
 };
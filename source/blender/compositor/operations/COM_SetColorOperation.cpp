@@ -17,10 +17,12 @@
  */
 
 #include "COM_SetColorOperation.h"
+#include "COM_BuffersIterator.h"
 
 SetColorOperation::SetColorOperation()
 {
   this->addOutputSocket(COM_DT_COLOR);
+  this->setFullFrameOperation(true);
 }
 
 void SetColorOperation::executePixelSampled(float output[4],
@@ -31,6 +33,19 @@ void SetColorOperation::executePixelSampled(float output[4],
   copy_v4_v4(output, this->m_color);
 }
 
+bool SetColorOperation::hash_output_params()
+{
+  hash_param(this->m_color);
+  return true;
+}
+
+void SetColorOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    copy_v4_v4(it.out, this->m_color);
+  }
+}
+
 void SetColorOperation::determineResolution(unsigned int resolution[2],
                                             unsigned int preferredResolution[2])
 {
@@ -75,10 +75,14 @@ class SetColorOperation : public NodeOperation {
    * The inner loop of this operation.
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 
   void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
   bool isSetOperation() const
   {
     return true;
   }
+
+ protected:
+  bool hash_output_params();
 };
@@ -17,10 +17,12 @@
  */
 
 #include "COM_SetValueOperation.h"
+#include "COM_BuffersIterator.h"
 
 SetValueOperation::SetValueOperation()
 {
   this->addOutputSocket(COM_DT_VALUE);
+  this->setFullFrameOperation(true);
 }
 
 void SetValueOperation::executePixelSampled(float output[4],
@@ -31,6 +33,19 @@ void SetValueOperation::executePixelSampled(float output[4],
   output[0] = this->m_value;
 }
 
+bool SetValueOperation::hash_output_params()
+{
+  hash_param(this->m_value);
+  return true;
+}
+
+void SetValueOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    it.out[0] = this->m_value;
+  }
+}
+
 void SetValueOperation::determineResolution(unsigned int resolution[2],
                                             unsigned int preferredResolution[2])
 {
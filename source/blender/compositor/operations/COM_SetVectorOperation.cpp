@@ -17,11 +17,13 @@
  */
 
 #include "COM_SetVectorOperation.h"
+#include "COM_BuffersIterator.h"
 #include "COM_defines.h"
 
 SetVectorOperation::SetVectorOperation()
 {
   this->addOutputSocket(COM_DT_VECTOR);
+  this->setFullFrameOperation(true);
 }
 
 void SetVectorOperation::executePixelSampled(float output[4],
@@ -34,6 +36,24 @@ void SetVectorOperation::executePixelSampled(float output[4],
   output[2] = this->m_z;
 }
 
+bool SetVectorOperation::hash_output_params()
+{
+  hash_param(this->m_x);
+  hash_param(this->m_y);
+  hash_param(this->m_z);
+  hash_param(this->m_w);
+  return true;
+}
+
+void SetVectorOperation::update_memory_buffer_partial(BuffersIterator &it)
+{
+  for (; !it.is_end(); ++it) {
+    it.out[0] = this->m_x;
+    it.out[1] = this->m_y;
+    it.out[2] = this->m_z;
+  }
+}
+
 void SetVectorOperation::determineResolution(unsigned int resolution[2],
                                              unsigned int preferredResolution[2])
 {
@@ -74,6 +74,7 @@ class SetVectorOperation : public NodeOperation {
    * The inner loop of this operation.
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer_partial(BuffersIterator &it);
 
   void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
   bool isSetOperation() const
@@ -87,4 +88,7 @@ class SetVectorOperation : public NodeOperation {
     setY(vector[1]);
     setZ(vector[2]);
   }
+
+ protected:
+  bool hash_output_params();
 };
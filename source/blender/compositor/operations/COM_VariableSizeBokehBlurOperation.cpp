@@ -229,6 +229,16 @@ void VariableSizeBokehBlurOperation::deinitExecution()
 #endif
 }
 
+bool VariableSizeBokehBlurOperation::hash_output_params()
+{
+  hash_param(this->m_maxBlur);
+  hash_param(this->m_threshold);
+  hash_param(this->m_do_size_scale);
+  hash_param(this->getStep());
+  hash_param(this->getOffsetAdd());
+  return true;
+}
+
 bool VariableSizeBokehBlurOperation::determineDependingAreaOfInterest(
     rcti *input, ReadBufferOperation *readOperation, rcti *output)
 {
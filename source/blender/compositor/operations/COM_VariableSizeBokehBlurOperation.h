@@ -82,6 +82,9 @@ class VariableSizeBokehBlurOperation : public NodeOperation, public QualityStepH
                      MemoryBuffer **inputMemoryBuffers,
                      list<cl_mem> *clMemToCleanUp,
                      list<cl_kernel> *clKernelsToCleanUp);
+
+ protected:
+  bool hash_output_params();
 };
 
 #ifdef COM_DEFOCUS_SEARCH
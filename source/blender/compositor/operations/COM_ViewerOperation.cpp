@@ -17,6 +17,7 @@
  */
 
 #include "COM_ViewerOperation.h"
+#include "COM_BuffersIterator.h"
 #include "BKE_image.h"
 #include "BKE_scene.h"
 #include "BLI_listbase.h"
@@ -53,6 +54,7 @@ ViewerOperation::ViewerOperation()
   this->m_depthInput = nullptr;
   this->m_rd = nullptr;
   this->m_viewName = nullptr;
+  this->setFullFrameOperation(true);
 }
 
 void ViewerOperation::initExecution()
@@ -118,6 +120,33 @@ void ViewerOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
   updateImage(rect);
 }
 
+void ViewerOperation::update_memory_buffer(MemoryBuffer * /*output*/,
+                                           const rcti &area,
+                                           MemoryBuffer **inputs)
+{
+  float *buffer = this->m_outputBuffer;
+  float *depthbuffer = this->m_depthBuffer;
+  if (!buffer) {
+    return;
+  }
+
+  const int width = this->getWidth();
+  for (BuffersIterator it(nullptr, area, inputs, getNumberOfInputSockets()); !it.is_end(); ++it) {
+    const int offset = it.y() * width + it.x();
+    float *color = &buffer[offset * 4];
+    copy_v4_v4(color, it.in(0));
+    if (this->m_useAlphaInput) {
+      color[3] = *it.in(1);
+    }
+    if (depthbuffer) {
+      depthbuffer[offset] = *it.in(2);
+    }
+  }
+
+  rcti rect = area;
+  updateImage(&rect);
+}
+
 void ViewerOperation::initImage()
 {
   Image *ima = this->m_image;
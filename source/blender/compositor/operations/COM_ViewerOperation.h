@@ -51,6 +51,7 @@ class ViewerOperation : public NodeOperation {
   void initExecution();
   void deinitExecution();
   void executeRegion(rcti *rect, unsigned int tileNumber);
+  void update_memory_buffer(MemoryBuffer *output, const rcti &area, MemoryBuffer **inputs);
   bool isOutputOperation(bool /*rendering*/) const
   {
     if (G.background) {
@@ -56,6 +56,11 @@ void WriteBufferOperation::deinitExecution()
   this->m_memoryProxy->free();
 }
 
+bool WriteBufferOperation::hash_output_params()
+{
+  return true;
+}
+
 void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 {
   MemoryBuffer *memoryBuffer = this->m_memoryProxy->getBuffer();
@@ -61,4 +61,7 @@ class WriteBufferOperation : public NodeOperation {
   {
     return m_input;
   }
+
+ protected:
+  bool hash_output_params();
 };
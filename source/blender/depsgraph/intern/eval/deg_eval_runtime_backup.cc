@@ -39,7 +39,8 @@ RuntimeBackup::RuntimeBackup(const Depsgraph *depsgraph)
       object_backup(depsgraph),
       drawdata_ptr(nullptr),
       movieclip_backup(depsgraph),
-      volume_backup(depsgraph)
+      volume_backup(depsgraph),
+      mesh_backup(depsgraph)
 {
   drawdata_backup.first = drawdata_backup.last = nullptr;
 }
@@ -70,6 +71,9 @@ void RuntimeBackup::init_from_id(ID *id)
     case ID_VO:
       volume_backup.init_from_volume(reinterpret_cast<Volume *>(id));
       break;
+    case ID_ME:
+      mesh_backup.init_from_mesh(reinterpret_cast<Mesh *>(id));
+      break;
     default:
       break;
   }
@@ -108,6 +112,9 @@ void RuntimeBackup::restore_to_id(ID *id)
     case ID_VO:
       volume_backup.restore_to_volume(reinterpret_cast<Volume *>(id));
       break;
+    case ID_ME:
+      mesh_backup.restore_to_mesh(reinterpret_cast<Mesh *>(id));
+      break;
     default:
       break;
   }
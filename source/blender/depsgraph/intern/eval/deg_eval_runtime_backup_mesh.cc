@@ -0,0 +1,49 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/eval/deg_eval_runtime_backup_mesh.h"
+
+#include "DNA_mesh_types.h"
+
+#include "BKE_mesh_runtime.h"
+
+namespace blender::deg {
+
+MeshBackup::MeshBackup(const Depsgraph * /*depsgraph*/) : topology_cache(nullptr)
+{
+}
+
+void MeshBackup::init_from_mesh(Mesh *mesh)
+{
+  topology_cache = BKE_mesh_runtime_topology_cache_backup(mesh);
+}
+
+void MeshBackup::restore_to_mesh(Mesh *mesh)
+{
+  if (topology_cache) {
+    BKE_mesh_runtime_topology_cache_restore(mesh, topology_cache);
+    topology_cache = nullptr;
+  }
+}
+
+}  // namespace blender::deg
@@ -34,6 +34,7 @@
 #include "BLI_math_vector.h"
 #include "BLI_string.h"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_mesh_types.h"
@@ -763,6 +764,8 @@ typedef void(ExtractFinishFn)(const MeshRenderData *mr,
                               struct MeshBatchCache *cache,
                               void *buffer,
                               void *data);
+typedef void *(ExtractTaskInitFn)(const MeshRenderData *mr, void *data);
+typedef void(ExtractTaskFinishFn)(const MeshRenderData *mr, void *data, void *task_data);
 
 typedef struct MeshExtract {
   /** Executed on main thread and return user data for iteration functions. */
@@ -778,10 +781,22 @@ typedef struct MeshExtract {
   ExtractLVertMeshFn *iter_lvert_mesh;
   /** Executed on one worker thread after all elements iterations. */
   ExtractFinishFn *finish;
+  /**
+   * Optional, executed before the iterations of each range task and returns the data passed to
+   * the iteration functions instead of the user data. Used for per task buffers.
+   */
+  ExtractTaskInitFn *task_init;
+  /** Executed after the iterations of each range task, merges the data into the user data. */
+  ExtractTaskFinishFn *task_finish;
   /** Used to request common data. */
   const eMRDataType data_flag;
   /** Used to know if the element callbacks are thread-safe and can be parallelized. */
   const bool use_threading;
+  /**
+   * Cost of the iteration functions for one loop, relative to extracting positions and normals.
+   * Zero is the same as one. Used to decide how extraction is split into tasks.
+   */
+  const float cost;
 } MeshExtract;
 
 BLI_INLINE eMRIterType mesh_extract_iter_type(const MeshExtract *ext)
@@ -794,6 +809,35 @@ BLI_INLINE eMRIterType mesh_extract_iter_type(const MeshExtract *ext)
   return type;
 }
 
+BLI_INLINE float mesh_extract_cost(const MeshExtract *ext)
+{
+  return (ext->cost > 0.0f) ? ext->cost : 1.0f;
+}
+
+/** \} */
+
+/* ---------------------------------------------------------------------- */
+/** \name Index Buffer Range Tasks
+ *
+ * Index buffers filled with #GPU_indexbuf_set_point_vert and similar functions can be extracted
+ * from several range tasks at once, each task uses its own sub-builder.
+ * \{ */
+
+static void *extract_ibo_task_init(const MeshRenderData *UNUSED(mr), void *elb)
+{
+  GPUIndexBufBuilder *sub_builder = MEM_mallocN(sizeof(*sub_builder), __func__);
+  GPU_indexbuf_subbuilder_init(elb, sub_builder);
+  return sub_builder;
+}
+
+static void extract_ibo_task_finish(const MeshRenderData *UNUSED(mr),
+                                    void *elb,
+                                    void *sub_builder)
+{
+  GPU_indexbuf_subbuilder_finish(elb, sub_builder);
+  MEM_freeN(sub_builder);
+}
+
 /** \} */
 
 /* ---------------------------------------------------------------------- */
@@ -802,6 +846,8 @@ BLI_INLINE eMRIterType mesh_extract_iter_type(const MeshExtract *ext)
 
 typedef struct MeshExtract_Tri_Data {
   GPUIndexBufBuilder elb;
+  /** Index of the first triangle of each face in the index buffer, -1 for hidden faces. */
+  int *tri_first_index;
   int *tri_mat_start;
   int *tri_mat_end;
 } MeshExtract_Tri_Data;
@@ -848,6 +894,40 @@ static void *extract_tris_init(const MeshRenderData *mr,
 
   memcpy(data->tri_mat_end, mat_tri_len, mat_tri_idx_size);
 
+  /* Triangles of each material are stored in face order, the first triangle of each face is
+   * known in advance so ranges of triangles can be extracted in parallel. */
+  int *tri_first_index = data->tri_first_index = MEM_mallocN(sizeof(int) * mr->poly_len,
+                                                             __func__);
+  int *mat_tri_ofs = data->tri_mat_end;
+  if (mr->extract_type == MR_EXTRACT_BMESH) {
+    BMIter iter;
+    BMFace *efa;
+    int f_index;
+    BM_ITER_MESH_INDEX (efa, &iter, mr->bm, BM_FACES_OF_MESH, f_index) {
+      if (!BM_elem_flag_test(efa, BM_ELEM_HIDDEN)) {
+        int mat = min_ii(efa->mat_nr, mr->mat_len - 1);
+        tri_first_index[f_index] = mat_tri_ofs[mat];
+        mat_tri_ofs[mat] += efa->len - 2;
+      }
+      else {
+        tri_first_index[f_index] = -1;
+      }
+    }
+  }
+  else {
+    const MPoly *mp = mr->mpoly;
+    for (int mp_index = 0; mp_index < mr->poly_len; mp_index++, mp++) {
+      if (!(mr->use_hide && (mp->flag & ME_HIDE))) {
+        int mat = min_ii(mp->mat_nr, mr->mat_len - 1);
+        tri_first_index[mp_index] = mat_tri_ofs[mat];
+        mat_tri_ofs[mat] += mp->totloop - 2;
+      }
+      else {
+        tri_first_index[mp_index] = -1;
+      }
+    }
+  }
+
   int visible_tri_tot = ofs;
   GPU_indexbuf_init(&data->elb, GPU_PRIM_TRIS, visible_tri_tot, mr->loop_len);
 
@@ -859,14 +939,17 @@ static void extract_tris_iter_looptri_bm(const MeshRenderData *mr,
                                          void *_data)
 {
   MeshExtract_Tri_Data *data = _data;
-  const int mat_last = mr->mat_len - 1;
-  EXTRACT_TRIS_LOOPTRI_FOREACH_BM_BEGIN(elt, _elt_index, params)
+  EXTRACT_TRIS_LOOPTRI_FOREACH_BM_BEGIN(elt, elt_index, params)
   {
-    if (!BM_elem_flag_test(elt[0]->f, BM_ELEM_HIDDEN)) {
-      int *mat_tri_ofs = data->tri_mat_end;
-      const int mat = min_ii(elt[0]->f->mat_nr, mat_last);
+    BMFace *f = elt[0]->f;
+    const int f_index = BM_elem_index_get(f);
+    const int tri_first_index = data->tri_first_index[f_index];
+    if (tri_first_index != -1) {
+      /* The looptris of a face are contiguous, like its loops. */
+      const int f_tri_first = poly_to_tri_count(f_index,
+                                                BM_elem_index_get(BM_FACE_FIRST_LOOP(f)));
       GPU_indexbuf_set_tri_verts(&data->elb,
-                                 mat_tri_ofs[mat]++,
+                                 tri_first_index + elt_index - f_tri_first,
                                  BM_elem_index_get(elt[0]),
                                  BM_elem_index_get(elt[1]),
                                  BM_elem_index_get(elt[2]));
@@ -880,15 +963,17 @@ static void extract_tris_iter_looptri_mesh(const MeshRenderData *mr,
                                            void *_data)
 {
   MeshExtract_Tri_Data *data = _data;
-  const int mat_last = mr->mat_len - 1;
-  EXTRACT_TRIS_LOOPTRI_FOREACH_MESH_BEGIN(mlt, _mlt_index, params)
+  EXTRACT_TRIS_LOOPTRI_FOREACH_MESH_BEGIN(mlt, mlt_index, params)
   {
-    const MPoly *mp = &mr->mpoly[mlt->poly];
-    if (!(mr->use_hide && (mp->flag & ME_HIDE))) {
-      int *mat_tri_ofs = data->tri_mat_end;
-      const int mat = min_ii(mp->mat_nr, mat_last);
-      GPU_indexbuf_set_tri_verts(
-          &data->elb, mat_tri_ofs[mat]++, mlt->tri[0], mlt->tri[1], mlt->tri[2]);
+    const int tri_first_index = data->tri_first_index[mlt->poly];
+    if (tri_first_index != -1) {
+      /* The looptris of a face are contiguous, like its loops. */
+      const int mp_tri_first = poly_to_tri_count(mlt->poly, mr->mpoly[mlt->poly].loopstart);
+      GPU_indexbuf_set_tri_verts(&data->elb,
+                                 tri_first_index + mlt_index - mp_tri_first,
+                                 mlt->tri[0],
+                                 mlt->tri[1],
+                                 mlt->tri[2]);
     }
   }
   EXTRACT_TRIS_LOOPTRI_FOREACH_MESH_END;
@@ -920,18 +1005,40 @@ static void extract_tris_finish(const MeshRenderData *mr,
       GPU_indexbuf_create_subrange_in_place(mbc->tris_per_mat[i], ibo, start, len);
     }
   }
+  MEM_freeN(data->tri_first_index);
   MEM_freeN(data->tri_mat_start);
   MEM_freeN(data->tri_mat_end);
   MEM_freeN(data);
 }
 
+static void *extract_tris_task_init(const MeshRenderData *UNUSED(mr), void *_data)
+{
+  MeshExtract_Tri_Data *data = _data;
+  MeshExtract_Tri_Data *task_data = MEM_mallocN(sizeof(*task_data), __func__);
+  *task_data = *data;
+  GPU_indexbuf_subbuilder_init(&data->elb, &task_data->elb);
+  return task_data;
+}
+
+static void extract_tris_task_finish(const MeshRenderData *UNUSED(mr),
+                                     void *_data,
+                                     void *_task_data)
+{
+  MeshExtract_Tri_Data *data = _data;
+  MeshExtract_Tri_Data *task_data = _task_data;
+  GPU_indexbuf_subbuilder_finish(&data->elb, &task_data->elb);
+  MEM_freeN(task_data);
+}
+
 static const MeshExtract extract_tris = {
     .init = extract_tris_init,
     .iter_looptri_bm = extract_tris_iter_looptri_bm,
     .iter_looptri_mesh = extract_tris_iter_looptri_mesh,
     .finish = extract_tris_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .task_init = extract_tris_task_init,
+    .task_finish = extract_tris_task_finish,
+    .use_threading = true,
 };
 
 /** \} */
@@ -951,6 +1058,9 @@ static void *extract_lines_init(const MeshRenderData *mr,
   return elb;
 }
 
+/* Edges are shared by faces which can be extracted by different range tasks, both vertices of a
+ * line are set at once to never mix the loops of different faces. */
+
 static void extract_lines_iter_poly_bm(const MeshRenderData *mr,
                                        const ExtractPolyBMesh_Params *params,
                                        void *elb)
@@ -963,10 +1073,10 @@ static void extract_lines_iter_poly_bm(const MeshRenderData *mr,
     l_iter = l_first = BM_FACE_FIRST_LOOP(f)->prev;
     do {
       if (!BM_elem_flag_test(l_iter->e, BM_ELEM_HIDDEN)) {
-        GPU_indexbuf_set_line_verts(elb,
-                                    BM_elem_index_get(l_iter->e),
-                                    BM_elem_index_get(l_iter),
-                                    BM_elem_index_get(l_iter->next));
+        GPU_indexbuf_set_line_verts_shared(elb,
+                                           BM_elem_index_get(l_iter->e),
+                                           BM_elem_index_get(l_iter),
+                                           BM_elem_index_get(l_iter->next));
       }
       else {
         GPU_indexbuf_set_line_restart(elb, BM_elem_index_get(l_iter->e));
@@ -994,7 +1104,7 @@ static void extract_lines_iter_poly_mesh(const MeshRenderData *mr,
         if (!((mr->use_hide && (med->flag & ME_HIDE)) ||
               ((mr->extract_type == MR_EXTRACT_MAPPED) && (mr->e_origindex) &&
                (mr->e_origindex[ml->e] == ORIGINDEX_NONE)))) {
-          GPU_indexbuf_set_line_verts(elb, ml->e, ml_index, ml_index_next);
+          GPU_indexbuf_set_line_verts_shared(elb, ml->e, ml_index, ml_index_next);
         }
         else {
           GPU_indexbuf_set_line_restart(elb, ml->e);
@@ -1010,7 +1120,7 @@ static void extract_lines_iter_poly_mesh(const MeshRenderData *mr,
       int ml_index = ml_index_last, ml_index_next = mp->loopstart;
       do {
         const MLoop *ml = &mloop[ml_index];
-        GPU_indexbuf_set_line_verts(elb, ml->e, ml_index, ml_index_next);
+        GPU_indexbuf_set_line_verts_shared(elb, ml->e, ml_index, ml_index_next);
       } while ((ml_index = ml_index_next++) != ml_index_last);
     }
     EXTRACT_POLY_FOREACH_MESH_END;
@@ -1077,7 +1187,10 @@ static const MeshExtract extract_lines = {
     .iter_ledge_mesh = extract_lines_iter_ledge_mesh,
     .finish = extract_lines_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .task_init = extract_ibo_task_init,
+    .task_finish = extract_ibo_task_finish,
+    .use_threading = true,
+    .cost = 0.5f,
 };
 /** \} */
 
@@ -1114,7 +1227,10 @@ static const MeshExtract extract_lines_with_lines_loose = {
     .iter_ledge_mesh = extract_lines_iter_ledge_mesh,
     .finish = extract_lines_with_lines_loose_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .task_init = extract_ibo_task_init,
+    .task_finish = extract_ibo_task_finish,
+    .use_threading = true,
+    .cost = 0.5f,
 };
 
 /** \} */
@@ -1248,7 +1364,10 @@ static const MeshExtract extract_points = {
     .iter_lvert_mesh = extract_points_iter_lvert_mesh,
     .finish = extract_points_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .task_init = extract_ibo_task_init,
+    .task_finish = extract_ibo_task_finish,
+    .use_threading = true,
+    .cost = 0.5f,
 };
 
 /** \} */
@@ -1329,7 +1448,10 @@ static const MeshExtract extract_fdots = {
     .iter_poly_mesh = extract_fdots_iter_poly_mesh,
     .finish = extract_fdots_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .task_init = extract_ibo_task_init,
+    .task_finish = extract_ibo_task_finish,
+    .use_threading = true,
+    .cost = 0.5f,
 };
 
 /** \} */
@@ -1423,10 +1545,25 @@ typedef struct MeshExtract_LineAdjacency_Data {
   GPUIndexBufBuilder elb;
   EdgeHash *eh;
   bool is_manifold;
+  /** Protects `elb`, `eh` and `is_manifold` when the edges of a task are merged. */
+  ThreadMutex mutex;
   /* Array to convert vert index to any loop index of this vert. */
   uint vert_to_loop[0];
 } MeshExtract_LineAdjacency_Data;
 
+/* Each range task pairs the edges of its own triangles, the edges left unpaired are paired with
+ * the ones of the other tasks when the task finishes. */
+typedef struct MeshExtract_LineAdjacency_TaskData {
+  EdgeHash *eh;
+  bool is_manifold;
+  /* Shared with the other tasks, any loop of the vertex is valid. */
+  uint *vert_to_loop;
+  /* Indices of the lines found in this task, added to the index buffer when it finishes. */
+  uint *lines;
+  uint lines_len;
+  uint lines_len_alloc;
+} MeshExtract_LineAdjacency_TaskData;
+
 static void *extract_lines_adjacency_init(const MeshRenderData *mr,
                                           struct MeshBatchCache *UNUSED(cache),
                                           void *UNUSED(buf))
@@ -1442,50 +1579,94 @@ static void *extract_lines_adjacency_init(const MeshRenderData *mr,
   GPU_indexbuf_init(&data->elb, GPU_PRIM_LINES_ADJ, tess_edge_len, mr->loop_len);
   data->eh = BLI_edgehash_new_ex(__func__, tess_edge_len);
   data->is_manifold = true;
+  BLI_mutex_init(&data->mutex);
   return data;
 }
 
-BLI_INLINE void lines_adjacency_triangle(
-    uint v1, uint v2, uint v3, uint l1, uint l2, uint l3, MeshExtract_LineAdjacency_Data *data)
+static void *extract_lines_adjacency_task_init(const MeshRenderData *UNUSED(mr), void *_data)
 {
-  GPUIndexBufBuilder *elb = &data->elb;
-  /* Iterate around the triangle's edges. */
-  for (int e = 0; e < 3; e++) {
-    SHIFT3(uint, v3, v2, v1);
-    SHIFT3(uint, l3, l2, l1);
+  MeshExtract_LineAdjacency_Data *data = _data;
+  MeshExtract_LineAdjacency_TaskData *task_data = MEM_callocN(sizeof(*task_data), __func__);
+  task_data->eh = BLI_edgehash_new(__func__);
+  task_data->is_manifold = true;
+  task_data->vert_to_loop = data->vert_to_loop;
+  return task_data;
+}
 
-    bool inv_indices = (v2 > v3);
-    void **pval;
-    bool value_is_init = BLI_edgehash_ensure_p(data->eh, v2, v3, &pval);
-    int v_data = POINTER_AS_INT(*pval);
-    if (!value_is_init || v_data == NO_EDGE) {
-      /* Save the winding order inside the sign bit. Because the
-       * Edge-hash sort the keys and we need to compare winding later. */
-      int value = (int)l1 + 1; /* 0 cannot be signed so add one. */
-      *pval = POINTER_FROM_INT((inv_indices) ? -value : value);
-      /* Store loop indices for remaining non-manifold edges. */
-      data->vert_to_loop[v2] = l2;
-      data->vert_to_loop[v3] = l3;
+BLI_INLINE void lines_adjacency_add(
+    MeshExtract_LineAdjacency_TaskData *task_data, uint l1, uint l2, uint l3, uint l4)
+{
+  if (task_data->lines_len + 4 > task_data->lines_len_alloc) {
+    task_data->lines_len_alloc = max_ii(256, task_data->lines_len_alloc * 2);
+    task_data->lines = MEM_reallocN(task_data->lines,
+                                    sizeof(*task_data->lines) * task_data->lines_len_alloc);
+  }
+  uint *line = &task_data->lines[task_data->lines_len];
+  line[0] = l1;
+  line[1] = l2;
+  line[2] = l3;
+  line[3] = l4;
+  task_data->lines_len += 4;
+}
+
+/**
+ * Pair the edge (v2, v3) of the triangle with the opposite corner `l1` with the edge already
+ * stored in `eh`, or store it. Edge loops `l2` and `l3` follow the winding of the triangle.
+ */
+BLI_INLINE void lines_adjacency_edge(MeshExtract_LineAdjacency_TaskData *task_data,
+                                     EdgeHash *eh,
+                                     uint v2,
+                                     uint v3,
+                                     uint l1,
+                                     uint l2,
+                                     uint l3)
+{
+  bool inv_indices = (v2 > v3);
+  void **pval;
+  bool value_is_init = BLI_edgehash_ensure_p(eh, v2, v3, &pval);
+  int v_data = POINTER_AS_INT(*pval);
+  if (!value_is_init || v_data == NO_EDGE) {
+    /* Save the winding order inside the sign bit. Because the
+     * Edge-hash sort the keys and we need to compare winding later. */
+    int value = (int)l1 + 1; /* 0 cannot be signed so add one. */
+    *pval = POINTER_FROM_INT((inv_indices) ? -value : value);
+    /* Store loop indices for remaining non-manifold edges. */
+    task_data->vert_to_loop[v2] = l2;
+    task_data->vert_to_loop[v3] = l3;
+  }
+  else {
+    /* HACK Tag as not used. Prevent overhead of BLI_edgehash_remove. */
+    *pval = POINTER_FROM_INT(NO_EDGE);
+    bool inv_opposite = (v_data < 0);
+    uint l_opposite = (uint)abs(v_data) - 1;
+    if (inv_opposite == inv_indices) {
+      /* Don't share edge if triangles have non matching winding. */
+      lines_adjacency_add(task_data, l1, l2, l3, l1);
+      lines_adjacency_add(task_data, l_opposite, l2, l3, l_opposite);
+      task_data->is_manifold = false;
     }
     else {
-      /* HACK Tag as not used. Prevent overhead of BLI_edgehash_remove. */
-      *pval = POINTER_FROM_INT(NO_EDGE);
-      bool inv_opposite = (v_data < 0);
-      uint l_opposite = (uint)abs(v_data) - 1;
-      /* TODO Make this part thread-safe. */
-      if (inv_opposite == inv_indices) {
-        /* Don't share edge if triangles have non matching winding. */
-        GPU_indexbuf_add_line_adj_verts(elb, l1, l2, l3, l1);
-        GPU_indexbuf_add_line_adj_verts(elb, l_opposite, l2, l3, l_opposite);
-        data->is_manifold = false;
-      }
-      else {
-        GPU_indexbuf_add_line_adj_verts(elb, l1, l2, l3, l_opposite);
-      }
+      lines_adjacency_add(task_data, l1, l2, l3, l_opposite);
     }
   }
 }
 
+BLI_INLINE void lines_adjacency_triangle(uint v1,
+                                         uint v2,
+                                         uint v3,
+                                         uint l1,
+                                         uint l2,
+                                         uint l3,
+                                         MeshExtract_LineAdjacency_TaskData *task_data)
+{
+  /* Iterate around the triangle's edges. */
+  for (int e = 0; e < 3; e++) {
+    SHIFT3(uint, v3, v2, v1);
+    SHIFT3(uint, l3, l2, l1);
+    lines_adjacency_edge(task_data, task_data->eh, v2, v3, l1, l2, l3);
+  }
+}
+
 static void extract_lines_adjacency_iter_looptri_bm(const MeshRenderData *UNUSED(mr),
                                                     const struct ExtractTriBMesh_Params *params,
                                                     void *data)
@@ -1525,6 +1706,44 @@ static void extract_lines_adjacency_iter_looptri_mesh(const MeshRenderData *mr,
   EXTRACT_TRIS_LOOPTRI_FOREACH_MESH_END;
 }
 
+static void extract_lines_adjacency_task_finish(const MeshRenderData *UNUSED(mr),
+                                                void *_data,
+                                                void *_task_data)
+{
+  MeshExtract_LineAdjacency_Data *data = _data;
+  MeshExtract_LineAdjacency_TaskData *task_data = _task_data;
+
+  BLI_mutex_lock(&data->mutex);
+  /* Pair the remaining edges of the task with the ones of the tasks already finished. */
+  EdgeHashIterator *ehi = BLI_edgehashIterator_new(task_data->eh);
+  for (; !BLI_edgehashIterator_isDone(ehi); BLI_edgehashIterator_step(ehi)) {
+    uint v2, v3, l1, l2, l3;
+    int v_data = POINTER_AS_INT(BLI_edgehashIterator_getValue(ehi));
+    if (v_data != NO_EDGE) {
+      BLI_edgehashIterator_getKey(ehi, &v2, &v3);
+      l1 = (uint)abs(v_data) - 1;
+      if (v_data < 0) { /* inv_opposite  */
+        SWAP(uint, v2, v3);
+      }
+      l2 = data->vert_to_loop[v2];
+      l3 = data->vert_to_loop[v3];
+      lines_adjacency_edge(task_data, data->eh, v2, v3, l1, l2, l3);
+    }
+  }
+  BLI_edgehashIterator_free(ehi);
+
+  for (uint i = 0; i < task_data->lines_len; i += 4) {
+    const uint *line = &task_data->lines[i];
+    GPU_indexbuf_add_line_adj_verts(&data->elb, line[0], line[1], line[2], line[3]);
+  }
+  data->is_manifold &= task_data->is_manifold;
+  BLI_mutex_unlock(&data->mutex);
+
+  BLI_edgehash_free(task_data->eh, NULL);
+  MEM_SAFE_FREE(task_data->lines);
+  MEM_freeN(task_data);
+}
+
 static void extract_lines_adjacency_finish(const MeshRenderData *UNUSED(mr),
                                            struct MeshBatchCache *cache,
                                            void *ibo,
@@ -1550,6 +1769,7 @@ static void extract_lines_adjacency_finish(const MeshRenderData *UNUSED(mr),
   }
   BLI_edgehashIterator_free(ehi);
   BLI_edgehash_free(data->eh, NULL);
+  BLI_mutex_end(&data->mutex);
 
   cache->is_manifold = data->is_manifold;
 
@@ -1565,7 +1785,9 @@ static const MeshExtract extract_lines_adjacency = {
     .iter_looptri_mesh = extract_lines_adjacency_iter_looptri_mesh,
     .finish = extract_lines_adjacency_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .task_init = extract_lines_adjacency_task_init,
+    .task_finish = extract_lines_adjacency_task_finish,
+    .use_threading = true,
 };
 
 /** \} */
@@ -1579,6 +1801,27 @@ typedef struct MeshExtract_EditUvElem_Data {
   bool sync_selection;
 } MeshExtract_EditUvElem_Data;
 
+/* Elements are set at the index of their triangle, loop or face, hidden ones are replaced by
+ * restart indices. This way ranges of elements can be extracted in parallel. */
+static void *extract_edituv_task_init(const MeshRenderData *UNUSED(mr), void *_data)
+{
+  MeshExtract_EditUvElem_Data *data = _data;
+  MeshExtract_EditUvElem_Data *task_data = MEM_mallocN(sizeof(*task_data), __func__);
+  GPU_indexbuf_subbuilder_init(&data->elb, &task_data->elb);
+  task_data->sync_selection = data->sync_selection;
+  return task_data;
+}
+
+static void extract_edituv_task_finish(const MeshRenderData *UNUSED(mr),
+                                       void *_data,
+                                       void *_task_data)
+{
+  MeshExtract_EditUvElem_Data *data = _data;
+  MeshExtract_EditUvElem_Data *task_data = _task_data;
+  GPU_indexbuf_subbuilder_finish(&data->elb, &task_data->elb);
+  MEM_freeN(task_data);
+}
+
 static void *extract_edituv_tris_init(const MeshRenderData *mr,
                                       struct MeshBatchCache *UNUSED(cache),
                                       void *UNUSED(ibo))
@@ -1589,11 +1832,19 @@ static void *extract_edituv_tris_init(const MeshRenderData *mr,
   return data;
 }
 
-BLI_INLINE void edituv_tri_add(
-    MeshExtract_EditUvElem_Data *data, bool hidden, bool selected, int v1, int v2, int v3)
+BLI_INLINE void edituv_tri_add(MeshExtract_EditUvElem_Data *data,
+                               bool hidden,
+                               bool selected,
+                               int tri_index,
+                               int v1,
+                               int v2,
+                               int v3)
 {
   if (!hidden && (data->sync_selection || selected)) {
-    GPU_indexbuf_add_tri_verts(&data->elb, v1, v2, v3);
+    GPU_indexbuf_set_tri_verts(&data->elb, tri_index, v1, v2, v3);
+  }
+  else {
+    GPU_indexbuf_set_tri_restart(&data->elb, tri_index);
   }
 }
 
@@ -1601,11 +1852,12 @@ static void extract_edituv_tris_iter_looptri_bm(const MeshRenderData *UNUSED(mr)
                                                 const struct ExtractTriBMesh_Params *params,
                                                 void *data)
 {
-  EXTRACT_TRIS_LOOPTRI_FOREACH_BM_BEGIN(elt, _elt_index, params)
+  EXTRACT_TRIS_LOOPTRI_FOREACH_BM_BEGIN(elt, elt_index, params)
   {
     edituv_tri_add(data,
                    BM_elem_flag_test(elt[0]->f, BM_ELEM_HIDDEN),
                    BM_elem_flag_test(elt[0]->f, BM_ELEM_SELECT),
+                   elt_index,
                    BM_elem_index_get(elt[0]),
                    BM_elem_index_get(elt[1]),
                    BM_elem_index_get(elt[2]));
@@ -1617,12 +1869,13 @@ static void extract_edituv_tris_iter_looptri_mesh(const MeshRenderData *mr,
                                                   const struct ExtractTriMesh_Params *params,
                                                   void *data)
 {
-  EXTRACT_TRIS_LOOPTRI_FOREACH_MESH_BEGIN(mlt, _mlt_index, params)
+  EXTRACT_TRIS_LOOPTRI_FOREACH_MESH_BEGIN(mlt, mlt_index, params)
   {
     const MPoly *mp = &mr->mpoly[mlt->poly];
     edituv_tri_add(data,
                    (mp->flag & ME_HIDE) != 0,
                    (mp->flag & ME_FACE_SEL) != 0,
+                   mlt_index,
                    mlt->tri[0],
                    mlt->tri[1],
                    mlt->tri[2]);
@@ -1646,7 +1899,9 @@ static const MeshExtract extract_edituv_tris = {
     .iter_looptri_mesh = extract_edituv_tris_iter_looptri_mesh,
     .finish = extract_edituv_tris_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .task_init = extract_edituv_task_init,
+    .task_finish = extract_edituv_task_finish,
+    .use_threading = true,
 };
 
 /** \} */
@@ -1669,8 +1924,12 @@ static void *extract_edituv_lines_init(const MeshRenderData *mr,
 BLI_INLINE void edituv_edge_add(
     MeshExtract_EditUvElem_Data *data, bool hidden, bool selected, int v1, int v2)
 {
+  /* The line of each loop is stored at the loop index. */
   if (!hidden && (data->sync_selection || selected)) {
-    GPU_indexbuf_add_line_verts(&data->elb, v1, v2);
+    GPU_indexbuf_set_line_verts(&data->elb, v1, v1, v2);
+  }
+  else {
+    GPU_indexbuf_set_line_restart(&data->elb, v1);
   }
 }
 
@@ -1723,7 +1982,9 @@ static const MeshExtract extract_edituv_lines = {
     .iter_poly_mesh = extract_edituv_lines_iter_poly_mesh,
     .finish = extract_edituv_lines_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .task_init = extract_edituv_task_init,
+    .task_finish = extract_edituv_task_finish,
+    .use_threading = true,
 };
 
 /** \} */
@@ -1748,8 +2009,12 @@ BLI_INLINE void edituv_point_add(MeshExtract_EditUvElem_Data *data,
                                  bool selected,
                                  int v1)
 {
+  /* The point of each loop is stored at the loop index. */
   if (!hidden && (data->sync_selection || selected)) {
-    GPU_indexbuf_add_point_vert(&data->elb, v1);
+    GPU_indexbuf_set_point_vert(&data->elb, v1, v1);
+  }
+  else {
+    GPU_indexbuf_set_point_restart(&data->elb, v1);
   }
 }
 
@@ -1797,7 +2062,9 @@ static const MeshExtract extract_edituv_points = {
     .iter_poly_mesh = extract_edituv_points_iter_poly_mesh,
     .finish = extract_edituv_points_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .task_init = extract_edituv_task_init,
+    .task_finish = extract_edituv_task_finish,
+    .use_threading = true,
 };
 
 /** \} */
@@ -1891,7 +2158,9 @@ static const MeshExtract extract_edituv_fdots = {
     .iter_poly_mesh = extract_edituv_fdots_iter_poly_mesh,
     .finish = extract_edituv_fdots_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .task_init = extract_edituv_task_init,
+    .task_finish = extract_edituv_task_finish,
+    .use_threading = true,
 };
 
 /** \} */
@@ -2739,6 +3008,7 @@ static const MeshExtract extract_tan = {
     .init = extract_tan_init,
     .data_flag = MR_DATA_POLY_NOR | MR_DATA_TAN_LOOP_NOR | MR_DATA_LOOPTRI,
     .use_threading = false,
+    .cost = 8.0f,
 };
 
 /** \} */
@@ -2757,6 +3027,7 @@ static const MeshExtract extract_tan_hq = {
     .init = extract_tan_hq_init,
     .data_flag = MR_DATA_POLY_NOR | MR_DATA_TAN_LOOP_NOR | MR_DATA_LOOPTRI,
     .use_threading = false,
+    .cost = 8.0f,
 };
 
 /** \} */
@@ -3449,6 +3720,7 @@ static const MeshExtract extract_weights = {
     .finish = extract_weights_finish,
     .data_flag = 0,
     .use_threading = true,
+    .cost = 2.0f,
 };
 
 /** \} */
@@ -3735,6 +4007,7 @@ static const MeshExtract extract_edit_data = {
     .iter_lvert_mesh = extract_edit_data_iter_lvert_mesh,
     .data_flag = 0,
     .use_threading = true,
+    .cost = 2.0f,
 };
 
 /** \} */
@@ -3841,6 +4114,7 @@ static const MeshExtract extract_edituv_data = {
     .finish = extract_edituv_data_finish,
     .data_flag = 0,
     .use_threading = true,
+    .cost = 2.0f,
 };
 
 /** \} */
@@ -4761,6 +5035,7 @@ static const MeshExtract extract_mesh_analysis = {
      * * Maybe split into different extract. */
     .data_flag = MR_DATA_POLY_NOR | MR_DATA_LOOPTRI,
     .use_threading = false,
+    .cost = 8.0f,
 };
 
 /** \} */
@@ -5410,6 +5685,7 @@ static const MeshExtract extract_poly_idx = {
     .iter_poly_mesh = extract_poly_idx_iter_poly_mesh,
     .data_flag = 0,
     .use_threading = true,
+    .cost = 0.5f,
 };
 
 static const MeshExtract extract_edge_idx = {
@@ -5420,6 +5696,7 @@ static const MeshExtract extract_edge_idx = {
     .iter_ledge_mesh = extract_edge_idx_iter_ledge_mesh,
     .data_flag = 0,
     .use_threading = true,
+    .cost = 0.5f,
 };
 
 static const MeshExtract extract_vert_idx = {
@@ -5432,6 +5709,7 @@ static const MeshExtract extract_vert_idx = {
     .iter_lvert_mesh = extract_vert_idx_iter_lvert_mesh,
     .data_flag = 0,
     .use_threading = true,
+    .cost = 0.5f,
 };
 
 static void *extract_select_fdot_idx_init(const MeshRenderData *mr,
@@ -5486,6 +5764,7 @@ static const MeshExtract extract_fdot_idx = {
     .iter_poly_mesh = extract_fdot_idx_iter_poly_mesh,
     .data_flag = 0,
     .use_threading = true,
+    .cost = 0.5f,
 };
 
 /** \} */
@@ -5651,12 +5930,15 @@ static void extract_run(void *__restrict taskdata)
 {
   ExtractTaskData *data = (ExtractTaskData *)taskdata;
   if (data->tasktype == EXTRACT_MESH_EXTRACT) {
-    mesh_extract_iter(data->mr,
-                      data->iter_type,
-                      data->start,
-                      data->end,
-                      data->extract,
-                      data->user_data->user_data);
+    const MeshExtract *extract = data->extract;
+    void *user_data = data->user_data->user_data;
+    void *task_data = extract->task_init ? extract->task_init(data->mr, user_data) : user_data;
+
+    mesh_extract_iter(data->mr, data->iter_type, data->start, data->end, extract, task_data);
+
+    if (extract->task_finish) {
+      extract->task_finish(data->mr, user_data, task_data);
+    }
 
     /* If this is the last task, we do the finish function. */
     int remainin_tasks = atomic_sub_and_fetch_int32(data->task_counter, 1);
@@ -5825,6 +6107,75 @@ static void extract_range_task_create(struct TaskGraph *task_graph,
   BLI_task_graph_edge_create(task_node_user_data_init, task_node);
 }
 
+/* Extractions costing less are grouped in a single task with the other small extractions. */
+#define MIN_THREADED_COST 8192.0f
+/* Ranges costing less cost more in task scheduling than they gain. */
+#define MIN_RANGE_COST 2048.0f
+/* Elements of a range don't all cost the same, creating more ranges than threads balances the
+ * work between the threads. */
+#define RANGE_TASKS_PER_THREAD 4
+
+/* Estimated cost of iterating over all elements of the given type: the number of loops these
+ * elements have, times the cost of the extractor. */
+static float extract_iter_cost(const MeshRenderData *mr,
+                               const MeshExtract *extract,
+                               const eMRIterType type)
+{
+  float loops = 0.0f;
+  switch (type) {
+    case MR_ITER_LOOPTRI:
+      loops = mr->tri_len * 3.0f;
+      break;
+    case MR_ITER_POLY:
+      loops = mr->loop_len;
+      break;
+    case MR_ITER_LEDGE:
+      loops = mr->edge_loose_len * 2.0f;
+      break;
+    case MR_ITER_LVERT:
+      loops = mr->vert_loose_len;
+      break;
+  }
+  return loops * mesh_extract_cost(extract);
+}
+
+static float extract_cost(const MeshRenderData *mr,
+                          const MeshExtract *extract,
+                          const eMRIterType iter_type)
+{
+  float cost = 0.0f;
+  const eMRIterType types[4] = {MR_ITER_LOOPTRI, MR_ITER_POLY, MR_ITER_LEDGE, MR_ITER_LVERT};
+  for (int i = 0; i < ARRAY_SIZE(types); i++) {
+    if (iter_type & types[i]) {
+      cost += extract_iter_cost(mr, extract, types[i]);
+    }
+  }
+  return cost;
+}
+
+/* Divide `len` elements into ranges of equal size. The number of ranges follows the estimated
+ * cost of the elements, up to a few ranges per thread: cheap elements are merged into a single
+ * range, expensive extractors of large meshes use all threads without creating thousands of
+ * tasks. */
+static void extract_range_tasks_create(struct TaskGraph *task_graph,
+                                       struct TaskNode *task_node_user_data_init,
+                                       ExtractTaskData *taskdata,
+                                       const eMRIterType type,
+                                       const int len,
+                                       const int num_threads)
+{
+  if (len == 0) {
+    return;
+  }
+  const float cost = extract_iter_cost(taskdata->mr, taskdata->extract, type);
+  const int range_num = clamp_i(
+      (int)(cost / MIN_RANGE_COST), 1, num_threads * RANGE_TASKS_PER_THREAD);
+  const int range_len = (len + range_num - 1) / range_num;
+  for (int i = 0; i < len; i += range_len) {
+    extract_range_task_create(task_graph, task_node_user_data_init, taskdata, type, i, range_len);
+  }
+}
+
 static void extract_task_create(struct TaskGraph *task_graph,
                                 struct TaskNode *task_node_mesh_render_data,
                                 struct TaskNode *task_node_user_data_init,
@@ -5859,35 +6210,43 @@ static void extract_task_create(struct TaskGraph *task_graph,
   ExtractTaskData *taskdata = extract_task_data_create_mesh_extract(
       mr, cache, extract, buf, task_counter);
 
-  /* Simple heuristic. */
-  const int chunk_size = 8192;
-  const bool use_thread = (mr->loop_len + mr->loop_loose_len) > chunk_size;
+  /* Cost of the extraction decides whether it gets its own tasks. */
+  const bool use_thread = extract_cost(mr, extract, taskdata->iter_type) > MIN_THREADED_COST;
   if (use_thread && extract->use_threading) {
+    const int num_threads = BLI_system_thread_count();
 
-    /* Divide task into sensible chunks. */
+    /* Divide task into balanced ranges. */
     if (taskdata->iter_type & MR_ITER_LOOPTRI) {
-      for (int i = 0; i < mr->tri_len; i += chunk_size) {
-        extract_range_task_create(
-            task_graph, task_node_user_data_init, taskdata, MR_ITER_LOOPTRI, i, chunk_size);
-      }
+      extract_range_tasks_create(task_graph,
+                                 task_node_user_data_init,
+                                 taskdata,
+                                 MR_ITER_LOOPTRI,
+                                 mr->tri_len,
+                                 num_threads);
     }
     if (taskdata->iter_type & MR_ITER_POLY) {
-      for (int i = 0; i < mr->poly_len; i += chunk_size) {
-        extract_range_task_create(
-            task_graph, task_node_user_data_init, taskdata, MR_ITER_POLY, i, chunk_size);
-      }
+      extract_range_tasks_create(task_graph,
+                                 task_node_user_data_init,
+                                 taskdata,
+                                 MR_ITER_POLY,
+                                 mr->poly_len,
+                                 num_threads);
     }
     if (taskdata->iter_type & MR_ITER_LEDGE) {
-      for (int i = 0; i < mr->edge_loose_len; i += chunk_size) {
-        extract_range_task_create(
-            task_graph, task_node_user_data_init, taskdata, MR_ITER_LEDGE, i, chunk_size);
-      }
+      extract_range_tasks_create(task_graph,
+                                 task_node_user_data_init,
+                                 taskdata,
+                                 MR_ITER_LEDGE,
+                                 mr->edge_loose_len,
+                                 num_threads);
     }
     if (taskdata->iter_type & MR_ITER_LVERT) {
-      for (int i = 0; i < mr->vert_loose_len; i += chunk_size) {
-        extract_range_task_create(
-            task_graph, task_node_user_data_init, taskdata, MR_ITER_LVERT, i, chunk_size);
-      }
+      extract_range_tasks_create(task_graph,
+                                 task_node_user_data_init,
+                                 taskdata,
+                                 MR_ITER_LVERT,
+                                 mr->vert_loose_len,
+                                 num_threads);
     }
     BLI_addtail(user_data_init_task_datas, taskdata);
   }
@@ -5929,9 +6288,10 @@ void mesh_buffer_cache_create_requested(struct TaskGraph *task_graph,
    * Small extractions and extractions that can't be multi-threaded are grouped in a single
    * `extract_single_threaded_task_node`.
    *
-   * Other extractions will create a node for each loop exceeding 8192 items. these nodes are
-   * linked to the `user_data_init_task_node`. the `user_data_init_task_node` prepares the
-   * user_data needed for the extraction based on the data extracted from the mesh.
+   * Other extractions will create a node for each range of elements, the number of ranges
+   * depends on the estimated cost of the extraction, see #extract_range_tasks_create. These
+   * nodes are linked to the `user_data_init_task_node`. the `user_data_init_task_node` prepares
+   * the user_data needed for the extraction based on the data extracted from the mesh.
    * counters are used to check if the finalize of a task has to be called.
    *
    *                           Mesh extraction sub graph
@@ -622,6 +622,38 @@ static void mesh_batch_cache_discard_uvedit_select(MeshBatchCache *cache)
   cache->batch_ready &= ~MBC_EDITUV;
 }
 
+/* Only the vertex positions changed: keep the index buffers and the vertex buffers which only
+ * depend on topology or attributes (UVs, colors, weights, selection indices). */
+static void mesh_batch_cache_discard_deform(MeshBatchCache *cache)
+{
+  FOREACH_MESH_BUFFER_CACHE (cache, mbufcache) {
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.pos_nor);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.lnor);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.edge_fac);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.tan);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.edituv_stretch_area);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.edituv_stretch_angle);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.mesh_analysis);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.fdots_pos);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.fdots_nor);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.skin_roots);
+  }
+
+  /* Nearly all batches use one of the buffers above, they are cheap to create again. */
+  for (int i = 0; i < sizeof(cache->batch) / sizeof(void *); i++) {
+    GPUBatch **batch = (GPUBatch **)&cache->batch;
+    GPU_BATCH_DISCARD_SAFE(batch[i]);
+  }
+  for (int i = 0; i < cache->mat_len; i++) {
+    GPU_BATCH_DISCARD_SAFE(cache->surface_per_mat[i]);
+  }
+
+  cache->tot_area = 0.0f;
+  cache->tot_uv_area = 0.0f;
+
+  cache->batch_ready = 0;
+}
+
 void DRW_mesh_batch_cache_dirty_tag(Mesh *me, eMeshBatchDirtyMode mode)
 {
   MeshBatchCache *cache = me->runtime.batch_cache;
@@ -687,6 +719,9 @@ void DRW_mesh_batch_cache_dirty_tag(Mesh *me, eMeshBatchDirtyMode mode)
       GPU_BATCH_DISCARD_SAFE(cache->batch.edituv_fdots);
       cache->batch_ready &= ~MBC_EDITUV;
       break;
+    case BKE_MESH_BATCH_DIRTY_DEFORM:
+      mesh_batch_cache_discard_deform(cache);
+      break;
     default:
       BLI_assert(0);
   }
@@ -31,6 +31,8 @@
 #include "BLI_math.h"
 #include "BLI_memarena.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "BLT_translation.h"
 
@@ -45,6 +47,10 @@
 
 #include "DEG_depsgraph.h"
 
+#include "PIL_time.h"
+
+#include "atomic_ops.h"
+
 #include "eigen_capi.h"
 
 #include "meshlaplacian.h"
@@ -907,10 +913,11 @@ typedef struct MeshDeformBind {
 
   /* grids */
   MemArena *memarena;
+  /* allocations from 'memarena' while tagging boundary cells in parallel */
+  ThreadMutex memarena_lock;
   MDefBoundIsect *(*boundisect)[6];
   int *semibound;
   int *tag;
-  float *phi, *totalphi;
 
   /* mesh stuff */
   int *inside;
@@ -997,44 +1004,55 @@ static void harmonic_ray_callback(void *userdata,
   }
 }
 
-static MDefBoundIsect *meshdeform_ray_tree_intersect(MeshDeformBind *mdb,
-                                                     const float co1[3],
-                                                     const float co2[3])
+/* Returns the index of the cage triangle hit by the segment, or -1. Only reads 'mdb'. */
+static int meshdeform_ray_tree_cast(MeshDeformBind *mdb,
+                                    const float co1[3],
+                                    const float co2[3],
+                                    MeshDeformIsect *r_isect_mdef)
 {
   BVHTreeRayHit hit;
-  MeshDeformIsect isect_mdef;
   struct MeshRayCallbackData data = {
       mdb,
-      &isect_mdef,
+      r_isect_mdef,
   };
   float end[3], vec_normal[3];
 
   /* happens binding when a cage has no faces */
   if (UNLIKELY(mdb->bvhtree == NULL)) {
-    return NULL;
+    return -1;
   }
 
   /* setup isec */
-  memset(&isect_mdef, 0, sizeof(isect_mdef));
-  isect_mdef.lambda = 1e10f;
+  memset(r_isect_mdef, 0, sizeof(*r_isect_mdef));
+  r_isect_mdef->lambda = 1e10f;
 
-  copy_v3_v3(isect_mdef.start, co1);
+  copy_v3_v3(r_isect_mdef->start, co1);
   copy_v3_v3(end, co2);
-  sub_v3_v3v3(isect_mdef.vec, end, isect_mdef.start);
-  isect_mdef.vec_length = normalize_v3_v3(vec_normal, isect_mdef.vec);
+  sub_v3_v3v3(r_isect_mdef->vec, end, r_isect_mdef->start);
+  r_isect_mdef->vec_length = normalize_v3_v3(vec_normal, r_isect_mdef->vec);
 
   hit.index = -1;
   hit.dist = BVH_RAYCAST_DIST_MAX;
-  if (BLI_bvhtree_ray_cast_ex(mdb->bvhtree,
-                              isect_mdef.start,
-                              vec_normal,
-                              0.0,
-                              &hit,
-                              harmonic_ray_callback,
-                              &data,
-                              BVH_RAYCAST_WATERTIGHT) != -1) {
+  return BLI_bvhtree_ray_cast_ex(mdb->bvhtree,
+                                 r_isect_mdef->start,
+                                 vec_normal,
+                                 0.0,
+                                 &hit,
+                                 harmonic_ray_callback,
+                                 &data,
+                                 BVH_RAYCAST_WATERTIGHT);
+}
+
+static MDefBoundIsect *meshdeform_ray_tree_intersect(MeshDeformBind *mdb,
+                                                     const float co1[3],
+                                                     const float co2[3])
+{
+  MeshDeformIsect isect_mdef;
+
+  const int hit_index = meshdeform_ray_tree_cast(mdb, co1, co2, &isect_mdef);
+  if (hit_index != -1) {
     const MLoop *mloop = mdb->cagemesh_cache.mloop;
-    const MLoopTri *lt = &mdb->cagemesh_cache.looptri[hit.index];
+    const MLoopTri *lt = &mdb->cagemesh_cache.looptri[hit_index];
     const MPoly *mp = &mdb->cagemesh_cache.mpoly[lt->poly];
     const float(*cagecos)[3] = mdb->cagecos;
     const float len = isect_mdef.lambda;
@@ -1043,7 +1061,9 @@ static MDefBoundIsect *meshdeform_ray_tree_intersect(MeshDeformBind *mdb,
     float(*mp_cagecos)[3] = BLI_array_alloca(mp_cagecos, mp->totloop);
 
     /* create MDefBoundIsect, and extra for 'poly_weights[]' */
+    BLI_mutex_lock(&mdb->memarena_lock);
     isect = BLI_memarena_alloc(mdb->memarena, sizeof(*isect) + (sizeof(float) * mp->totloop));
+    BLI_mutex_unlock(&mdb->memarena_lock);
 
     /* compute intersection coordinate */
     madd_v3_v3v3fl(isect->co, co1, isect_mdef.vec, len);
@@ -1069,7 +1089,7 @@ static MDefBoundIsect *meshdeform_ray_tree_intersect(MeshDeformBind *mdb,
 
 static int meshdeform_inside_cage(MeshDeformBind *mdb, float *co)
 {
-  MDefBoundIsect *isect;
+  MeshDeformIsect isect_mdef;
   float outside[3], start[3], dir[3];
   int i;
 
@@ -1082,8 +1102,8 @@ static int meshdeform_inside_cage(MeshDeformBind *mdb, float *co)
     sub_v3_v3v3(dir, outside, start);
     normalize_v3(dir);
 
-    isect = meshdeform_ray_tree_intersect(mdb, start, outside);
-    if (isect && !isect->facing) {
+    /* non-facing intersections are considered interior */
+    if (meshdeform_ray_tree_cast(mdb, start, outside, &isect_mdef) != -1 && !isect_mdef.isect) {
       return 1;
     }
   }
@@ -1091,6 +1111,14 @@ static int meshdeform_inside_cage(MeshDeformBind *mdb, float *co)
   return 0;
 }
 
+static void meshdeform_inside_cage_task(void *__restrict userdata,
+                                        const int index,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  MeshDeformBind *mdb = userdata;
+  mdb->inside[index] = meshdeform_inside_cage(mdb, mdb->vertexcos[index]);
+}
+
 /* solving */
 
 BLI_INLINE int meshdeform_index(MeshDeformBind *mdb, int x, int y, int z, int n)
@@ -1151,6 +1179,19 @@ static void meshdeform_add_intersections(MeshDeformBind *mdb, int x, int y, int
   }
 }
 
+static void meshdeform_add_intersections_task(void *__restrict userdata,
+                                              const int z,
+                                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  MeshDeformBind *mdb = userdata;
+
+  for (int y = 0; y < mdb->size; y++) {
+    for (int x = 0; x < mdb->size; x++) {
+      meshdeform_add_intersections(mdb, x, y, z);
+    }
+  }
+}
+
 static void meshdeform_bind_floodfill(MeshDeformBind *mdb)
 {
   int *stack, *tag = mdb->tag;
@@ -1235,6 +1276,7 @@ static float meshdeform_boundary_phi(const MeshDeformBind *mdb,
 }
 
 static float meshdeform_interp_w(MeshDeformBind *mdb,
+                                 const float *phi,
                                  const float *gridvec,
                                  float *UNUSED(vec),
                                  int UNUSED(cagevert))
@@ -1284,7 +1326,7 @@ static float meshdeform_interp_w(MeshDeformBind *mdb,
 
     int a = meshdeform_index(mdb, x, y, z, 0);
     float weight = wx * wy * wz;
-    result += weight * mdb->phi[a];
+    result += weight * phi[a];
     totweight += weight;
   }
 
@@ -1370,7 +1412,7 @@ static void meshdeform_matrix_add_cell(
 }
 
 static void meshdeform_matrix_add_rhs(
-    MeshDeformBind *mdb, LinearSolver *context, int x, int y, int z, int cagevert)
+    MeshDeformBind *mdb, double *rhs_vec, int x, int y, int z, int cagevert)
 {
   MDefBoundIsect *isect;
   float rhs, weight, totweight;
@@ -1393,13 +1435,13 @@ static void meshdeform_matrix_add_rhs(
     if (isect) {
       weight = (1.0f / isect->len) / totweight;
       rhs = weight * meshdeform_boundary_phi(mdb, isect, cagevert);
-      EIG_linear_solver_right_hand_side_add(context, 0, mdb->varidx[acenter], rhs);
+      rhs_vec[mdb->varidx[acenter]] += rhs;
     }
   }
 }
 
 static void meshdeform_matrix_add_semibound_phi(
-    MeshDeformBind *mdb, int x, int y, int z, int cagevert)
+    MeshDeformBind *mdb, float *phi, int x, int y, int z, int cagevert)
 {
   MDefBoundIsect *isect;
   float rhs, weight, totweight;
@@ -1410,7 +1452,7 @@ static void meshdeform_matrix_add_semibound_phi(
     return;
   }
 
-  mdb->phi[a] = 0.0f;
+  phi[a] = 0.0f;
 
   totweight = meshdeform_boundary_total_weight(mdb, x, y, z);
   for (i = 1; i <= 6; i++) {
@@ -1419,15 +1461,15 @@ static void meshdeform_matrix_add_semibound_phi(
     if (isect) {
       weight = (1.0f / isect->len) / totweight;
       rhs = weight * meshdeform_boundary_phi(mdb, isect, cagevert);
-      mdb->phi[a] += rhs;
+      phi[a] += rhs;
     }
   }
 }
 
 static void meshdeform_matrix_add_exterior_phi(
-    MeshDeformBind *mdb, int x, int y, int z, int UNUSED(cagevert))
+    MeshDeformBind *mdb, float *phi, int x, int y, int z, int UNUSED(cagevert))
 {
-  float phi, totweight;
+  float phi_sum, totweight;
   int i, a, acenter;
 
   acenter = meshdeform_index(mdb, x, y, z, 0);
@@ -1435,28 +1477,167 @@ static void meshdeform_matrix_add_exterior_phi(
     return;
   }
 
-  phi = 0.0f;
+  phi_sum = 0.0f;
   totweight = 0.0f;
   for (i = 1; i <= 6; i++) {
     a = meshdeform_index(mdb, x, y, z, i);
 
     if (a != -1 && mdb->semibound[a]) {
-      phi += mdb->phi[a];
+      phi_sum += phi[a];
       totweight += 1.0f;
     }
   }
 
   if (totweight != 0.0f) {
-    mdb->phi[acenter] = phi / totweight;
+    phi[acenter] = phi_sum / totweight;
+  }
+}
+
+typedef struct MeshDeformSolveData {
+  MeshDeformBind *mdb;
+  LinearSolver *context;
+  int totvar;
+
+  /* dynamic bind: grid cells influenced by each cage vertex */
+  int **cage_cells;
+  float **cage_cell_weights;
+  int *cage_cells_len;
+
+  /** Next cage vertex to solve, tasks take the vertices one by one. */
+  int32_t cagevert_next;
+  /** Number of solved cage vertices, read by the main thread to report progress. */
+  int32_t cagevert_solved;
+  /** Set when a cage vertex can't be solved, the remaining vertices are skipped. */
+  int32_t failed;
+} MeshDeformSolveData;
+
+typedef struct MeshDeformSolveTLS {
+  float *phi;
+  double *rhs;
+  double *solution;
+} MeshDeformSolveTLS;
+
+/* Solve the harmonic field of one cage vertex. All cage vertices share the factorized matrix
+ * and are solved in parallel, each task with its own grid. */
+static bool meshdeform_matrix_solve_cagevert(MeshDeformSolveData *data,
+                                             MeshDeformSolveTLS *solve_tls,
+                                             const int cagevert)
+{
+  MeshDeformBind *mdb = data->mdb;
+  float vec[3], gridvec[3];
+  int b, x, y, z;
+
+  if (solve_tls->phi == NULL) {
+    solve_tls->phi = MEM_callocN(sizeof(float) * mdb->size3, "MeshDeformSolvePhi");
+    solve_tls->rhs = MEM_mallocN(sizeof(double) * data->totvar, "MeshDeformSolveRHS");
+    solve_tls->solution = MEM_mallocN(sizeof(double) * data->totvar, "MeshDeformSolveX");
+  }
+  float *phi = solve_tls->phi;
+
+  /* fill in right hand side and solve */
+  memset(solve_tls->rhs, 0, sizeof(double) * data->totvar);
+  for (z = 0; z < mdb->size; z++) {
+    for (y = 0; y < mdb->size; y++) {
+      for (x = 0; x < mdb->size; x++) {
+        meshdeform_matrix_add_rhs(mdb, solve_tls->rhs, x, y, z, cagevert);
+      }
+    }
+  }
+
+  if (!EIG_linear_solver_solve_vector(data->context, solve_tls->rhs, solve_tls->solution)) {
+    return false;
+  }
+
+  for (b = 0; b < mdb->size3; b++) {
+    phi[b] = (mdb->tag[b] != MESHDEFORM_TAG_EXTERIOR) ?
+                 (float)solve_tls->solution[mdb->varidx[b]] :
+                 0.0f;
+  }
+
+  for (z = 0; z < mdb->size; z++) {
+    for (y = 0; y < mdb->size; y++) {
+      for (x = 0; x < mdb->size; x++) {
+        meshdeform_matrix_add_semibound_phi(mdb, phi, x, y, z, cagevert);
+      }
+    }
+  }
+
+  for (z = 0; z < mdb->size; z++) {
+    for (y = 0; y < mdb->size; y++) {
+      for (x = 0; x < mdb->size; x++) {
+        meshdeform_matrix_add_exterior_phi(mdb, phi, x, y, z, cagevert);
+      }
+    }
+  }
+
+  if (mdb->weights) {
+    /* static bind : compute weights for each vertex */
+    for (b = 0; b < mdb->totvert; b++) {
+      if (mdb->inside[b]) {
+        copy_v3_v3(vec, mdb->vertexcos[b]);
+        gridvec[0] = (vec[0] - mdb->min[0] - mdb->halfwidth[0]) / mdb->width[0];
+        gridvec[1] = (vec[1] - mdb->min[1] - mdb->halfwidth[1]) / mdb->width[1];
+        gridvec[2] = (vec[2] - mdb->min[2] - mdb->halfwidth[2]) / mdb->width[2];
+
+        mdb->weights[b * mdb->totcagevert + cagevert] = meshdeform_interp_w(
+            mdb, phi, gridvec, vec, cagevert);
+      }
+    }
+  }
+  else {
+    /* dynamic bind, store the influenced cells, they are added to the grid in order later */
+    int cells_len = 0;
+    for (b = 0; b < mdb->size3; b++) {
+      if (phi[b] >= MESHDEFORM_MIN_INFLUENCE) {
+        cells_len++;
+      }
+    }
+
+    int *cells = MEM_mallocN(sizeof(int) * max_ii(cells_len, 1), "MeshDeformSolveCells");
+    float *weights = MEM_mallocN(sizeof(float) * max_ii(cells_len, 1), "MeshDeformSolveWeights");
+    cells_len = 0;
+    for (b = 0; b < mdb->size3; b++) {
+      if (phi[b] >= MESHDEFORM_MIN_INFLUENCE) {
+        cells[cells_len] = b;
+        weights[cells_len] = phi[b];
+        cells_len++;
+      }
+    }
+
+    data->cage_cells[cagevert] = cells;
+    data->cage_cell_weights[cagevert] = weights;
+    data->cage_cells_len[cagevert] = cells_len;
+  }
+
+  return true;
+}
+
+static void meshdeform_matrix_solve_task(TaskPool *__restrict pool, void *UNUSED(taskdata))
+{
+  MeshDeformSolveData *data = BLI_task_pool_user_data(pool);
+  MeshDeformSolveTLS solve_tls = {NULL};
+
+  while (atomic_add_and_fetch_int32(&data->failed, 0) == 0) {
+    const int cagevert = atomic_fetch_and_add_int32(&data->cagevert_next, 1);
+    if (cagevert >= data->mdb->totcagevert) {
+      break;
+    }
+    if (!meshdeform_matrix_solve_cagevert(data, &solve_tls, cagevert)) {
+      atomic_fetch_and_or_int32(&data->failed, 1);
+      break;
+    }
+    atomic_add_and_fetch_int32(&data->cagevert_solved, 1);
   }
+
+  MEM_SAFE_FREE(solve_tls.phi);
+  MEM_SAFE_FREE(solve_tls.rhs);
+  MEM_SAFE_FREE(solve_tls.solution);
 }
 
 static void meshdeform_matrix_solve(MeshDeformModifierData *mmd, MeshDeformBind *mdb)
 {
   LinearSolver *context;
-  float vec[3], gridvec[3];
   int a, b, x, y, z, totvar;
-  char message[256];
 
   /* setup variable indices */
   mdb->varidx = MEM_callocN(sizeof(int) * mdb->size3, "MeshDeformDSvaridx");
@@ -1483,95 +1664,77 @@ static void meshdeform_matrix_solve(MeshDeformModifierData *mmd, MeshDeformBind
     }
   }
 
+  MeshDeformSolveData data = {
+      .mdb = mdb,
+      .context = context,
+      .totvar = totvar,
+  };
+
   /* solve for each cage vert */
-  for (a = 0; a < mdb->totcagevert; a++) {
-    /* fill in right hand side and solve */
-    for (z = 0; z < mdb->size; z++) {
-      for (y = 0; y < mdb->size; y++) {
-        for (x = 0; x < mdb->size; x++) {
-          meshdeform_matrix_add_rhs(mdb, context, x, y, z, a);
-        }
-      }
+  if (EIG_linear_solver_factorize(context)) {
+    if (mdb->dyngrid) {
+      data.cage_cells = MEM_callocN(sizeof(int *) * mdb->totcagevert, __func__);
+      data.cage_cell_weights = MEM_callocN(sizeof(float *) * mdb->totcagevert, __func__);
+      data.cage_cells_len = MEM_callocN(sizeof(int) * mdb->totcagevert, __func__);
     }
 
-    if (EIG_linear_solver_solve(context)) {
-      for (z = 0; z < mdb->size; z++) {
-        for (y = 0; y < mdb->size; y++) {
-          for (x = 0; x < mdb->size; x++) {
-            meshdeform_matrix_add_semibound_phi(mdb, x, y, z, a);
-          }
-        }
-      }
-
-      for (z = 0; z < mdb->size; z++) {
-        for (y = 0; y < mdb->size; y++) {
-          for (x = 0; x < mdb->size; x++) {
-            meshdeform_matrix_add_exterior_phi(mdb, x, y, z, a);
-          }
-        }
-      }
-
-      for (b = 0; b < mdb->size3; b++) {
-        if (mdb->tag[b] != MESHDEFORM_TAG_EXTERIOR) {
-          mdb->phi[b] = EIG_linear_solver_variable_get(context, 0, mdb->varidx[b]);
-        }
-        mdb->totalphi[b] += mdb->phi[b];
-      }
-
-      if (mdb->weights) {
-        /* static bind : compute weights for each vertex */
-        for (b = 0; b < mdb->totvert; b++) {
-          if (mdb->inside[b]) {
-            copy_v3_v3(vec, mdb->vertexcos[b]);
-            gridvec[0] = (vec[0] - mdb->min[0] - mdb->halfwidth[0]) / mdb->width[0];
-            gridvec[1] = (vec[1] - mdb->min[1] - mdb->halfwidth[1]) / mdb->width[1];
-            gridvec[2] = (vec[2] - mdb->min[2] - mdb->halfwidth[2]) / mdb->width[2];
+    /* Solve in background tasks, so the main thread can report the progress. */
+    TaskPool *task_pool = BLI_task_pool_create_background(&data, TASK_PRIORITY_HIGH);
+    const int tasks_num = min_ii(BLI_task_scheduler_num_threads(), mdb->totcagevert);
+    for (a = 0; a < tasks_num; a++) {
+      BLI_task_pool_push(task_pool, meshdeform_matrix_solve_task, NULL, false, NULL);
+    }
 
-            mdb->weights[b * mdb->totcagevert + a] = meshdeform_interp_w(mdb, gridvec, vec, a);
-          }
-        }
+    int solved_prev = -1;
+    while (true) {
+      const int solved = atomic_add_and_fetch_int32(&data.cagevert_solved, 0);
+      if (solved != solved_prev) {
+        char message[256];
+        BLI_snprintf(message,
+                     sizeof(message),
+                     "Mesh deform solve %d / %d       |||",
+                     solved,
+                     mdb->totcagevert);
+        progress_bar((float)solved / (float)mdb->totcagevert, message);
+        solved_prev = solved;
       }
-      else {
-        MDefBindInfluence *inf;
-
-        /* dynamic bind */
-        for (b = 0; b < mdb->size3; b++) {
-          if (mdb->phi[b] >= MESHDEFORM_MIN_INFLUENCE) {
-            inf = BLI_memarena_alloc(mdb->memarena, sizeof(*inf));
-            inf->vertex = a;
-            inf->weight = mdb->phi[b];
-            inf->next = mdb->dyngrid[b];
-            mdb->dyngrid[b] = inf;
-          }
-        }
+      if (solved == mdb->totcagevert || atomic_add_and_fetch_int32(&data.failed, 0) != 0) {
+        break;
       }
+      PIL_sleep_ms(50);
     }
-    else {
-      BKE_modifier_set_error(
-          mmd->object, &mmd->modifier, "Failed to find bind solution (increase precision?)");
-      error("Mesh Deform: failed to find bind solution.");
-      break;
-    }
 
-    BLI_snprintf(
-        message, sizeof(message), "Mesh deform solve %d / %d       |||", a + 1, mdb->totcagevert);
-    progress_bar((float)(a + 1) / (float)(mdb->totcagevert), message);
+    BLI_task_pool_work_and_wait(task_pool);
+    BLI_task_pool_free(task_pool);
+  }
+  else {
+    data.failed = 1;
+  }
+
+  if (data.failed) {
+    BKE_modifier_set_error(
+        mmd->object, &mmd->modifier, "Failed to find bind solution (increase precision?)");
+    error("Mesh Deform: failed to find bind solution.");
   }
 
-#if 0
-  /* sanity check */
-  for (b = 0; b < mdb->size3; b++) {
-    if (mdb->tag[b] != MESHDEFORM_TAG_EXTERIOR) {
-      if (fabsf(mdb->totalphi[b] - 1.0f) > 1e-4f) {
-        printf("totalphi deficiency [%s|%d] %d: %.10f\n",
-               (mdb->tag[b] == MESHDEFORM_TAG_INTERIOR) ? "interior" : "boundary",
-               mdb->semibound[b],
-               mdb->varidx[b],
-               mdb->totalphi[b]);
+  if (data.cage_cells) {
+    /* dynamic bind */
+    for (a = 0; a < mdb->totcagevert; a++) {
+      for (b = 0; b < data.cage_cells_len[a]; b++) {
+        const int cell = data.cage_cells[a][b];
+        MDefBindInfluence *inf = BLI_memarena_alloc(mdb->memarena, sizeof(*inf));
+        inf->vertex = a;
+        inf->weight = data.cage_cell_weights[a][b];
+        inf->next = mdb->dyngrid[cell];
+        mdb->dyngrid[cell] = inf;
       }
+      MEM_SAFE_FREE(data.cage_cells[a]);
+      MEM_SAFE_FREE(data.cage_cell_weights[a]);
     }
+    MEM_freeN(data.cage_cells);
+    MEM_freeN(data.cage_cell_weights);
+    MEM_freeN(data.cage_cells_len);
   }
-#endif
 
   /* free */
   MEM_freeN(mdb->varidx);
@@ -1584,8 +1747,8 @@ static void harmonic_coordinates_bind(MeshDeformModifierData *mmd, MeshDeformBin
   MDefBindInfluence *inf;
   MDefInfluence *mdinf;
   MDefCell *cell;
-  float center[3], vec[3], maxwidth, totweight;
-  int a, b, x, y, z, totinside, offset;
+  float center[3], maxwidth, totweight;
+  int a, b, x, y, z, offset;
 
   /* compute bounding box of the cage mesh */
   INIT_MINMAX(mdb->min, mdb->max);
@@ -1598,8 +1761,6 @@ static void harmonic_coordinates_bind(MeshDeformModifierData *mmd, MeshDeformBin
   mdb->size = (2 << (mmd->gridsize - 1)) + 2;
   mdb->size3 = mdb->size * mdb->size * mdb->size;
   mdb->tag = MEM_callocN(sizeof(int) * mdb->size3, "MeshDeformBindTag");
-  mdb->phi = MEM_callocN(sizeof(float) * mdb->size3, "MeshDeformBindPhi");
-  mdb->totalphi = MEM_callocN(sizeof(float) * mdb->size3, "MeshDeformBindTotalPhi");
   mdb->boundisect = MEM_callocN(sizeof(*mdb->boundisect) * mdb->size3, "MDefBoundIsect");
   mdb->semibound = MEM_callocN(sizeof(int) * mdb->size3, "MDefSemiBound");
   mdb->bvhtree = BKE_bvhtree_from_mesh_get(&mdb->bvhdata, mdb->cagemesh, BVHTREE_FROM_LOOPTRI, 4);
@@ -1614,6 +1775,7 @@ static void harmonic_coordinates_bind(MeshDeformModifierData *mmd, MeshDeformBin
 
   mdb->memarena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, "harmonic coords arena");
   BLI_memarena_use_calloc(mdb->memarena);
+  BLI_mutex_init(&mdb->memarena_lock);
 
   /* initialize data from 'cagedm' for reuse */
   {
@@ -1649,18 +1811,10 @@ static void harmonic_coordinates_bind(MeshDeformModifierData *mmd, MeshDeformBin
 
   progress_bar(0, "Setting up mesh deform system");
 
-  totinside = 0;
-  for (a = 0; a < mdb->totvert; a++) {
-    copy_v3_v3(vec, mdb->vertexcos[a]);
-    mdb->inside[a] = meshdeform_inside_cage(mdb, vec);
-    if (mdb->inside[a]) {
-      totinside++;
-    }
-  }
-
-  /* free temporary MDefBoundIsects */
-  BLI_memarena_free(mdb->memarena);
-  mdb->memarena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, "harmonic coords arena");
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 64;
+  BLI_task_parallel_range(0, mdb->totvert, mdb, meshdeform_inside_cage_task, &settings);
 
   /* start with all cells untyped */
   for (a = 0; a < mdb->size3; a++) {
@@ -1668,13 +1822,8 @@ static void harmonic_coordinates_bind(MeshDeformModifierData *mmd, MeshDeformBin
   }
 
   /* detect intersections and tag boundary cells */
-  for (z = 0; z < mdb->size; z++) {
-    for (y = 0; y < mdb->size; y++) {
-      for (x = 0; x < mdb->size; x++) {
-        meshdeform_add_intersections(mdb, x, y, z);
-      }
-    }
-  }
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(0, mdb->size, mdb, meshdeform_add_intersections_task, &settings);
 
   /* compute exterior and interior tags */
   meshdeform_bind_floodfill(mdb);
@@ -1738,11 +1887,10 @@ static void harmonic_coordinates_bind(MeshDeformModifierData *mmd, MeshDeformBin
   }
 
   MEM_freeN(mdb->tag);
-  MEM_freeN(mdb->phi);
-  MEM_freeN(mdb->totalphi);
   MEM_freeN(mdb->boundisect);
   MEM_freeN(mdb->semibound);
   BLI_memarena_free(mdb->memarena);
+  BLI_mutex_end(&mdb->memarena_lock);
   free_bvhtree_from_mesh(&mdb->bvhdata);
 }
 
@@ -32,6 +32,7 @@
 #include "BLI_math.h"
 #include "BLI_math_color_blend.h"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -2463,15 +2464,11 @@ static float brush_strength(const Sculpt *sd,
 }
 
 /* Return a multiplier for brush strength on a particular vertex. */
-float SCULPT_brush_strength_factor(SculptSession *ss,
-                                   const Brush *br,
-                                   const float brush_point[3],
-                                   const float len,
-                                   const short vno[3],
-                                   const float fno[3],
-                                   const float mask,
-                                   const int vertex_index,
-                                   const int thread_id)
+/* Strength of the brush texture at the given location. */
+static float sculpt_brush_texture_strength(SculptSession *ss,
+                                           const Brush *br,
+                                           const float brush_point[3],
+                                           const int thread_id)
 {
   StrokeCache *cache = ss->cache;
   const Scene *scene = cache->vc->scene;
@@ -2532,20 +2529,40 @@ float SCULPT_brush_strength_factor(SculptSession *ss,
     }
   }
 
-  /* Hardness. */
-  float final_len = len;
-  const float hardness = cache->paint_brush.hardness;
-  float p = len / cache->radius;
+  return avg;
+}
+
+/* Distance passed to the falloff curve, so the falloff starts at the brush hardness. */
+BLI_INLINE float sculpt_brush_hardness_len(const float len,
+                                           const float radius,
+                                           const float hardness)
+{
+  const float p = len / radius;
   if (p < hardness) {
-    final_len = 0.0f;
-  }
-  else if (hardness == 1.0f) {
-    final_len = cache->radius;
+    return 0.0f;
   }
-  else {
-    p = (p - hardness) / (1.0f - hardness);
-    final_len = p * cache->radius;
+  if (hardness == 1.0f) {
+    return radius;
   }
+  return (p - hardness) / (1.0f - hardness) * radius;
+}
+
+float SCULPT_brush_strength_factor(SculptSession *ss,
+                                   const Brush *br,
+                                   const float brush_point[3],
+                                   const float len,
+                                   const short vno[3],
+                                   const float fno[3],
+                                   const float mask,
+                                   const int vertex_index,
+                                   const int thread_id)
+{
+  StrokeCache *cache = ss->cache;
+  float avg = sculpt_brush_texture_strength(ss, br, brush_point, thread_id);
+
+  /* Hardness. */
+  const float final_len = sculpt_brush_hardness_len(
+      len, cache->radius, cache->paint_brush.hardness);
 
   /* Falloff curve. */
   avg *= BKE_brush_curve_strength(br, final_len, cache->radius);
@@ -2560,6 +2577,189 @@ float SCULPT_brush_strength_factor(SculptSession *ss,
   return avg;
 }
 
+/* Batch of the calling thread, with room for all unique vertices of the node. Batches live in
+ * the stroke cache and are reused by all nodes and steps of the stroke, arrays only grow. */
+static SculptBrushBatch *sculpt_brush_batch_ensure(SculptSession *ss,
+                                                   PBVHNode *node,
+                                                   const int thread_id)
+{
+  StrokeCache *cache = ss->cache;
+  BLI_assert(cache->brush_batches != NULL && thread_id < BLENDER_MAX_THREADS);
+  SculptBrushBatch *batch = cache->brush_batches[thread_id];
+  if (batch == NULL) {
+    batch = MEM_callocN(sizeof(SculptBrushBatch), "SculptBrushBatch");
+    cache->brush_batches[thread_id] = batch;
+  }
+
+  int uniq_verts;
+  BKE_pbvh_node_num_verts(ss->pbvh, node, &uniq_verts, NULL);
+  if (uniq_verts > batch->capacity) {
+    SCULPT_brush_batch_free(batch);
+    batch->node_vert = MEM_malloc_arrayN(uniq_verts, sizeof(int), __func__);
+    batch->vert_index = MEM_malloc_arrayN(uniq_verts, sizeof(int), __func__);
+    batch->co = MEM_malloc_arrayN(uniq_verts, sizeof(float[3]), __func__);
+    batch->no = MEM_malloc_arrayN(uniq_verts, sizeof(float[3]), __func__);
+    batch->dist = MEM_malloc_arrayN(uniq_verts, sizeof(float), __func__);
+    batch->mask = MEM_malloc_arrayN(uniq_verts, sizeof(float), __func__);
+    batch->vert_co = MEM_malloc_arrayN(uniq_verts, sizeof(float *), __func__);
+    batch->vert_mask = MEM_malloc_arrayN(uniq_verts, sizeof(float *), __func__);
+    batch->factor = MEM_malloc_arrayN(uniq_verts, sizeof(float), __func__);
+    batch->capacity = uniq_verts;
+  }
+  batch->totvert = 0;
+  batch->mverts = (BKE_pbvh_type(ss->pbvh) == PBVH_FACES) ? BKE_pbvh_get_verts(ss->pbvh) : NULL;
+  return batch;
+}
+
+BLI_INLINE void sculpt_brush_batch_add(SculptBrushBatch *batch,
+                                       const PBVHVertexIter *vd,
+                                       const float co[3],
+                                       const float no[3],
+                                       const float dist)
+{
+  const int i = batch->totvert++;
+  batch->node_vert[i] = vd->i;
+  batch->vert_index[i] = vd->index;
+  copy_v3_v3(batch->co[i], co);
+  copy_v3_v3(batch->no[i], no);
+  batch->dist[i] = dist;
+  batch->mask[i] = vd->mask ? *vd->mask : 0.0f;
+  batch->vert_co[i] = vd->co;
+  batch->vert_mask[i] = vd->mask;
+}
+
+SculptBrushBatch *SCULPT_brush_batch_gather(SculptSession *ss,
+                                            PBVHNode *node,
+                                            SculptBrushTest *test,
+                                            SculptBrushTestFn sculpt_brush_test_sq_fn,
+                                            const int thread_id)
+{
+  SculptBrushBatch *batch = sculpt_brush_batch_ensure(ss, node, thread_id);
+
+  PBVHVertexIter vd;
+  BKE_pbvh_vertex_iter_begin(ss->pbvh, node, vd, PBVH_ITER_UNIQUE)
+  {
+    if (!sculpt_brush_test_sq_fn(test, vd.co)) {
+      continue;
+    }
+    float no[3];
+    if (vd.fno) {
+      copy_v3_v3(no, vd.fno);
+    }
+    else {
+      normal_short_to_float_v3(no, vd.no);
+    }
+    sculpt_brush_batch_add(batch, &vd, vd.co, no, sqrtf(test->dist));
+  }
+  BKE_pbvh_vertex_iter_end;
+
+  return batch;
+}
+
+SculptBrushBatch *SCULPT_brush_batch_gather_orig(SculptSession *ss,
+                                                 Object *ob,
+                                                 PBVHNode *node,
+                                                 SculptBrushTest *test,
+                                                 SculptBrushTestFn sculpt_brush_test_sq_fn,
+                                                 const int thread_id)
+{
+  SculptBrushBatch *batch = sculpt_brush_batch_ensure(ss, node, thread_id);
+
+  SculptOrigVertData orig_data;
+  SCULPT_orig_vert_data_init(&orig_data, ob, node);
+
+  PBVHVertexIter vd;
+  BKE_pbvh_vertex_iter_begin(ss->pbvh, node, vd, PBVH_ITER_UNIQUE)
+  {
+    SCULPT_orig_vert_data_update(&orig_data, &vd);
+    if (!sculpt_brush_test_sq_fn(test, orig_data.co)) {
+      continue;
+    }
+    float no[3];
+    normal_short_to_float_v3(no, orig_data.no);
+    sculpt_brush_batch_add(batch, &vd, orig_data.co, no, sqrtf(test->dist));
+  }
+  BKE_pbvh_vertex_iter_end;
+
+  return batch;
+}
+
+/* Same result as #SCULPT_brush_strength_factor for each vertex of the batch. */
+void SCULPT_brush_batch_strength_factors(SculptSession *ss,
+                                         const Brush *br,
+                                         SculptBrushBatch *batch,
+                                         const int thread_id)
+{
+  StrokeCache *cache = ss->cache;
+  AutomaskingCache *automasking = cache->automasking;
+  const int totvert = batch->totvert;
+  float *factor = batch->factor;
+
+  /* Paint mask. */
+  for (int i = 0; i < totvert; i++) {
+    factor[i] = 1.0f - batch->mask[i];
+  }
+
+  /* Texture, sampling can't be batched. */
+  if (br->mtex.tex) {
+    for (int i = 0; i < totvert; i++) {
+      factor[i] *= sculpt_brush_texture_strength(ss, br, batch->co[i], thread_id);
+    }
+  }
+
+  /* Hardness and falloff curve. */
+  const float radius = cache->radius;
+  const float hardness = cache->paint_brush.hardness;
+  for (int i = 0; i < totvert; i++) {
+    const float final_len = sculpt_brush_hardness_len(batch->dist[i], radius, hardness);
+    factor[i] *= BKE_brush_curve_strength(br, final_len, radius);
+  }
+
+  if (br->flag & BRUSH_FRONTFACE) {
+    for (int i = 0; i < totvert; i++) {
+      const float dot = dot_v3v3(batch->no[i], cache->view_normal);
+      factor[i] *= dot > 0.0f ? dot : 0.0f;
+    }
+  }
+
+  /* Auto-masking. */
+  if (automasking) {
+    if (automasking->factor) {
+      for (int i = 0; i < totvert; i++) {
+        factor[i] *= automasking->factor[batch->vert_index[i]];
+      }
+    }
+    else {
+      for (int i = 0; i < totvert; i++) {
+        factor[i] *= SCULPT_automasking_factor_get(automasking, ss, batch->vert_index[i]);
+      }
+    }
+  }
+}
+
+void SCULPT_brush_batch_tag_update(SculptBrushBatch *batch)
+{
+  if (batch->mverts) {
+    for (int i = 0; i < batch->totvert; i++) {
+      batch->mverts[batch->vert_index[i]].flag |= ME_VERT_PBVH_UPDATE;
+    }
+  }
+}
+
+void SCULPT_brush_batch_free(SculptBrushBatch *batch)
+{
+  MEM_SAFE_FREE(batch->node_vert);
+  MEM_SAFE_FREE(batch->vert_index);
+  MEM_SAFE_FREE(batch->co);
+  MEM_SAFE_FREE(batch->no);
+  MEM_SAFE_FREE(batch->dist);
+  MEM_SAFE_FREE(batch->mask);
+  MEM_SAFE_FREE(batch->vert_co);
+  MEM_SAFE_FREE(batch->vert_mask);
+  MEM_SAFE_FREE(batch->factor);
+  batch->capacity = 0;
+}
+
 /* Test AABB against sphere. */
 bool SCULPT_search_sphere_cb(PBVHNode *node, void *data_v)
 {
@@ -3273,7 +3473,6 @@ static void do_draw_brush_task_cb_ex(void *__restrict userdata,
   const Brush *brush = data->brush;
   const float *offset = data->offset;
 
-  PBVHVertexIter vd;
   float(*proxy)[3];
 
   proxy = BKE_pbvh_node_add_proxy(ss->pbvh, data->nodes[n])->co;
@@ -3283,29 +3482,16 @@ static void do_draw_brush_task_cb_ex(void *__restrict userdata,
       ss, &test, data->brush->falloff_shape);
   const int thread_id = BLI_task_parallel_thread_id(tls);
 
-  BKE_pbvh_vertex_iter_begin(ss->pbvh, data->nodes[n], vd, PBVH_ITER_UNIQUE)
-  {
-    if (!sculpt_brush_test_sq_fn(&test, vd.co)) {
-      continue;
-    }
-    /* Offset vertex. */
-    const float fade = SCULPT_brush_strength_factor(ss,
-                                                    brush,
-                                                    vd.co,
-                                                    sqrtf(test.dist),
-                                                    vd.no,
-                                                    vd.fno,
-                                                    vd.mask ? *vd.mask : 0.0f,
-                                                    vd.index,
-                                                    thread_id);
+  SculptBrushBatch *batch = SCULPT_brush_batch_gather(
+      ss, data->nodes[n], &test, sculpt_brush_test_sq_fn, thread_id);
+  SCULPT_brush_batch_strength_factors(ss, brush, batch, thread_id);
 
-    mul_v3_v3fl(proxy[vd.i], offset, fade);
-
-    if (vd.mvert) {
-      vd.mvert->flag |= ME_VERT_PBVH_UPDATE;
-    }
+  /* Offset vertices. */
+  for (int i = 0; i < batch->totvert; i++) {
+    mul_v3_v3fl(proxy[batch->node_vert[i]], offset, batch->factor[i]);
   }
-  BKE_pbvh_vertex_iter_end;
+
+  SCULPT_brush_batch_tag_update(batch);
 }
 
 static void do_draw_brush(Sculpt *sd, Object *ob, PBVHNode **nodes, int totnode)
@@ -3987,13 +4173,9 @@ static void do_grab_brush_task_cb_ex(void *__restrict userdata,
   const Brush *brush = data->brush;
   const float *grab_delta = data->grab_delta;
 
-  PBVHVertexIter vd;
-  SculptOrigVertData orig_data;
   float(*proxy)[3];
   const float bstrength = ss->cache->bstrength;
 
-  SCULPT_orig_vert_data_init(&orig_data, data->ob, data->nodes[n]);
-
   proxy = BKE_pbvh_node_add_proxy(ss->pbvh, data->nodes[n])->co;
 
   SculptBrushTest test;
@@ -4003,41 +4185,29 @@ static void do_grab_brush_task_cb_ex(void *__restrict userdata,
 
   const bool grab_silhouette = brush->flag2 & BRUSH_GRAB_SILHOUETTE;
 
-  BKE_pbvh_vertex_iter_begin(ss->pbvh, data->nodes[n], vd, PBVH_ITER_UNIQUE)
-  {
-    SCULPT_orig_vert_data_update(&orig_data, &vd);
+  SculptBrushBatch *batch = SCULPT_brush_batch_gather_orig(
+      ss, data->ob, data->nodes[n], &test, sculpt_brush_test_sq_fn, thread_id);
+  SCULPT_brush_batch_strength_factors(ss, brush, batch, thread_id);
 
-    if (!sculpt_brush_test_sq_fn(&test, orig_data.co)) {
-      continue;
+  float silhouette_test_dir[3];
+  if (grab_silhouette) {
+    normalize_v3_v3(silhouette_test_dir, grab_delta);
+    if (dot_v3v3(ss->cache->initial_normal, ss->cache->grab_delta_symmetry) < 0.0f) {
+      mul_v3_fl(silhouette_test_dir, -1.0f);
     }
-    float fade = bstrength * SCULPT_brush_strength_factor(ss,
-                                                          brush,
-                                                          orig_data.co,
-                                                          sqrtf(test.dist),
-                                                          orig_data.no,
-                                                          NULL,
-                                                          vd.mask ? *vd.mask : 0.0f,
-                                                          vd.index,
-                                                          thread_id);
+  }
+
+  for (int i = 0; i < batch->totvert; i++) {
+    float fade = bstrength * batch->factor[i];
 
     if (grab_silhouette) {
-      float silhouette_test_dir[3];
-      normalize_v3_v3(silhouette_test_dir, grab_delta);
-      if (dot_v3v3(ss->cache->initial_normal, ss->cache->grab_delta_symmetry) < 0.0f) {
-        mul_v3_fl(silhouette_test_dir, -1.0f);
-      }
-      float vno[3];
-      normal_short_to_float_v3(vno, orig_data.no);
-      fade *= max_ff(dot_v3v3(vno, silhouette_test_dir), 0.0f);
+      fade *= max_ff(dot_v3v3(batch->no[i], silhouette_test_dir), 0.0f);
     }
 
-    mul_v3_v3fl(proxy[vd.i], grab_delta, fade);
-
-    if (vd.mvert) {
-      vd.mvert->flag |= ME_VERT_PBVH_UPDATE;
-    }
+    mul_v3_v3fl(proxy[batch->node_vert[i]], grab_delta, fade);
   }
-  BKE_pbvh_vertex_iter_end;
+
+  SCULPT_brush_batch_tag_update(batch);
 }
 
 static void do_grab_brush(Sculpt *sd, Object *ob, PBVHNode **nodes, int totnode)
@@ -4805,7 +4975,6 @@ static void do_inflate_brush_task_cb_ex(void *__restrict userdata,
   SculptSession *ss = data->ob->sculpt;
   const Brush *brush = data->brush;
 
-  PBVHVertexIter vd;
   float(*proxy)[3];
   const float bstrength = ss->cache->bstrength;
 
@@ -4816,37 +4985,19 @@ static void do_inflate_brush_task_cb_ex(void *__restrict userdata,
       ss, &test, data->brush->falloff_shape);
   const int thread_id = BLI_task_parallel_thread_id(tls);
 
-  BKE_pbvh_vertex_iter_begin(ss->pbvh, data->nodes[n], vd, PBVH_ITER_UNIQUE)
-  {
-    if (!sculpt_brush_test_sq_fn(&test, vd.co)) {
-      continue;
-    }
-    const float fade = bstrength * SCULPT_brush_strength_factor(ss,
-                                                                brush,
-                                                                vd.co,
-                                                                sqrtf(test.dist),
-                                                                vd.no,
-                                                                vd.fno,
-                                                                vd.mask ? *vd.mask : 0.0f,
-                                                                vd.index,
-                                                                thread_id);
-    float val[3];
-
-    if (vd.fno) {
-      copy_v3_v3(val, vd.fno);
-    }
-    else {
-      normal_short_to_float_v3(val, vd.no);
-    }
+  SculptBrushBatch *batch = SCULPT_brush_batch_gather(
+      ss, data->nodes[n], &test, sculpt_brush_test_sq_fn, thread_id);
+  SCULPT_brush_batch_strength_factors(ss, brush, batch, thread_id);
 
-    mul_v3_fl(val, fade * ss->cache->radius);
-    mul_v3_v3v3(proxy[vd.i], val, ss->cache->scale);
+  for (int i = 0; i < batch->totvert; i++) {
+    const float fade = bstrength * batch->factor[i];
+    float val[3];
 
-    if (vd.mvert) {
-      vd.mvert->flag |= ME_VERT_PBVH_UPDATE;
-    }
+    mul_v3_v3fl(val, batch->no[i], fade * ss->cache->radius);
+    mul_v3_v3v3(proxy[batch->node_vert[i]], val, ss->cache->scale);
   }
-  BKE_pbvh_vertex_iter_end;
+
+  SCULPT_brush_batch_tag_update(batch);
 }
 
 static void do_inflate_brush(Sculpt *sd, Object *ob, PBVHNode **nodes, int totnode)
@@ -5067,7 +5218,6 @@ static void do_clay_brush_task_cb_ex(void *__restrict userdata,
   const float *area_no = data->area_no;
   const float *area_co = data->area_co;
 
-  PBVHVertexIter vd;
   float(*proxy)[3];
   const float bstrength = fabsf(ss->cache->bstrength);
 
@@ -5080,35 +5230,23 @@ static void do_clay_brush_task_cb_ex(void *__restrict userdata,
 
   plane_from_point_normal_v3(test.plane_tool, area_co, area_no);
 
-  BKE_pbvh_vertex_iter_begin(ss->pbvh, data->nodes[n], vd, PBVH_ITER_UNIQUE)
-  {
-    if (!sculpt_brush_test_sq_fn(&test, vd.co)) {
-      continue;
-    }
+  SculptBrushBatch *batch = SCULPT_brush_batch_gather(
+      ss, data->nodes[n], &test, sculpt_brush_test_sq_fn, thread_id);
+  SCULPT_brush_batch_strength_factors(ss, brush, batch, thread_id);
 
+  for (int i = 0; i < batch->totvert; i++) {
     float intr[3];
     float val[3];
-    closest_to_plane_normalized_v3(intr, test.plane_tool, vd.co);
-
-    sub_v3_v3v3(val, intr, vd.co);
+    closest_to_plane_normalized_v3(intr, test.plane_tool, batch->co[i]);
 
-    const float fade = bstrength * SCULPT_brush_strength_factor(ss,
-                                                                brush,
-                                                                vd.co,
-                                                                sqrtf(test.dist),
-                                                                vd.no,
-                                                                vd.fno,
-                                                                vd.mask ? *vd.mask : 0.0f,
-                                                                vd.index,
-                                                                thread_id);
+    sub_v3_v3v3(val, intr, batch->co[i]);
 
-    mul_v3_v3fl(proxy[vd.i], val, fade);
+    const float fade = bstrength * batch->factor[i];
 
-    if (vd.mvert) {
-      vd.mvert->flag |= ME_VERT_PBVH_UPDATE;
-    }
+    mul_v3_v3fl(proxy[batch->node_vert[i]], val, fade);
   }
-  BKE_pbvh_vertex_iter_end;
+
+  SCULPT_brush_batch_tag_update(batch);
 }
 
 static void do_clay_brush(Sculpt *sd, Object *ob, PBVHNode **nodes, int totnode)
@@ -6739,6 +6877,16 @@ void SCULPT_cache_free(StrokeCache *cache)
     SCULPT_cloth_simulation_free(cache->cloth_sim);
   }
 
+  if (cache->brush_batches) {
+    for (int i = 0; i < BLENDER_MAX_THREADS; i++) {
+      if (cache->brush_batches[i]) {
+        SCULPT_brush_batch_free(cache->brush_batches[i]);
+        MEM_freeN(cache->brush_batches[i]);
+      }
+    }
+    MEM_freeN(cache->brush_batches);
+  }
+
   MEM_freeN(cache);
 }
 
@@ -6790,6 +6938,10 @@ static void sculpt_update_cache_invariants(
 
   ss->cache = cache;
 
+  /* Allocated here since brush tasks only fill in the batch of their own thread. */
+  cache->brush_batches = MEM_callocN(sizeof(*cache->brush_batches) * BLENDER_MAX_THREADS,
+                                     "sculpt brush batches");
+
   /* Set scaling adjustment. */
   max_scale = 0.0f;
   for (int i = 0; i < 3; i++) {
@@ -848,6 +848,61 @@ float SCULPT_brush_strength_factor(struct SculptSession *ss,
                                    const int vertex_index,
                                    const int thread_id);
 
+/* Brush Batches.
+ *
+ * Vertices of a node affected by the brush, gathered into arrays so the brush strength is
+ * evaluated one factor at a time over all vertices instead of all factors one vertex at a
+ * time. Use it instead of #SCULPT_brush_strength_factor in brushes that touch many vertices.
+ *
+ * Each thread has its own batch in the stroke cache, which is reused for every node and step of
+ * the stroke, so the returned batch is only valid until the next gather from the same thread. */
+typedef struct SculptBrushBatch {
+  int totvert;
+  /* Number of vertices the arrays have room for. */
+  int capacity;
+
+  /* Index of the vertex in the node, as #PBVHVertexIter.i. Used to index proxies. */
+  int *node_vert;
+  /* Index of the vertex in the mesh or grids, as #PBVHVertexIter.index. */
+  int *vert_index;
+  /* Coordinates and normals the brush test was done with, original ones for
+   * #SCULPT_brush_batch_gather_orig. */
+  float (*co)[3];
+  float (*no)[3];
+  /* Distance to the brush test location. */
+  float *dist;
+  float *mask;
+  /* Vertex coordinates and mask as #PBVHVertexIter.co and #PBVHVertexIter.mask, for brushes
+   * which modify them in place. Mask pointers are NULL when there is no mask layer. */
+  float **vert_co;
+  float **vert_mask;
+
+  /* Strength of the brush for each vertex, set by #SCULPT_brush_batch_strength_factors. */
+  float *factor;
+
+  /* Mesh vertices to tag for normal updates, NULL for grids and dynamic topology. */
+  struct MVert *mverts;
+} SculptBrushBatch;
+
+SculptBrushBatch *SCULPT_brush_batch_gather(struct SculptSession *ss,
+                                            PBVHNode *node,
+                                            SculptBrushTest *test,
+                                            SculptBrushTestFn sculpt_brush_test_sq_fn,
+                                            const int thread_id);
+/* Same as #SCULPT_brush_batch_gather, testing the original coordinates of the vertices. */
+SculptBrushBatch *SCULPT_brush_batch_gather_orig(struct SculptSession *ss,
+                                                 struct Object *ob,
+                                                 PBVHNode *node,
+                                                 SculptBrushTest *test,
+                                                 SculptBrushTestFn sculpt_brush_test_sq_fn,
+                                                 const int thread_id);
+void SCULPT_brush_batch_strength_factors(struct SculptSession *ss,
+                                         const struct Brush *br,
+                                         SculptBrushBatch *batch,
+                                         const int thread_id);
+void SCULPT_brush_batch_tag_update(SculptBrushBatch *batch);
+void SCULPT_brush_batch_free(SculptBrushBatch *batch);
+
 /* Tilts a normal by the x and y tilt values using the view axis. */
 void SCULPT_tilt_apply_to_normal(float r_normal[3],
                                  struct StrokeCache *cache,
@@ -1036,6 +1091,9 @@ typedef struct StrokeCache {
   /* Auto-masking. */
   AutomaskingCache *automasking;
 
+  /* Brush batches, indexed by the thread ID of the brush tasks. */
+  struct SculptBrushBatch **brush_batches;
+
   float stroke_local_mat[4][4];
   float multiplane_scrape_angle;
 
@@ -302,8 +302,6 @@ static void do_smooth_brush_task_cb_ex(void *__restrict userdata,
   const bool smooth_mask = data->smooth_mask;
   float bstrength = data->strength;
 
-  PBVHVertexIter vd;
-
   CLAMP(bstrength, 0.0f, 1.0f);
 
   SculptBrushTest test;
@@ -312,39 +310,34 @@ static void do_smooth_brush_task_cb_ex(void *__restrict userdata,
 
   const int thread_id = BLI_task_parallel_thread_id(tls);
 
-  BKE_pbvh_vertex_iter_begin(ss->pbvh, data->nodes[n], vd, PBVH_ITER_UNIQUE)
-  {
-    if (!sculpt_brush_test_sq_fn(&test, vd.co)) {
-      continue;
-    }
-    const float fade = bstrength * SCULPT_brush_strength_factor(
-                                       ss,
-                                       brush,
-                                       vd.co,
-                                       sqrtf(test.dist),
-                                       vd.no,
-                                       vd.fno,
-                                       smooth_mask ? 0.0f : (vd.mask ? *vd.mask : 0.0f),
-                                       vd.index,
-                                       thread_id);
+  SculptBrushBatch *batch = SCULPT_brush_batch_gather(
+      ss, data->nodes[n], &test, sculpt_brush_test_sq_fn, thread_id);
+  if (smooth_mask) {
+    /* The mask itself is smoothed, it does not limit the brush. */
+    copy_vn_fl(batch->mask, batch->totvert, 0.0f);
+  }
+  SCULPT_brush_batch_strength_factors(ss, brush, batch, thread_id);
+
+  for (int i = 0; i < batch->totvert; i++) {
+    const float fade = bstrength * batch->factor[i];
     if (smooth_mask) {
-      float val = SCULPT_neighbor_mask_average(ss, vd.index) - *vd.mask;
+      float *mask = batch->vert_mask[i];
+      float val = SCULPT_neighbor_mask_average(ss, batch->vert_index[i]) - *mask;
       val *= fade * bstrength;
-      *vd.mask += val;
-      CLAMP(*vd.mask, 0.0f, 1.0f);
+      *mask += val;
+      CLAMP(*mask, 0.0f, 1.0f);
     }
     else {
+      float *co = batch->vert_co[i];
       float avg[3], val[3];
-      SCULPT_neighbor_coords_average_interior(ss, avg, vd.index);
-      sub_v3_v3v3(val, avg, vd.co);
-      madd_v3_v3v3fl(val, vd.co, val, fade);
-      SCULPT_clip(sd, ss, vd.co, val);
-    }
-    if (vd.mvert) {
-      vd.mvert->flag |= ME_VERT_PBVH_UPDATE;
+      SCULPT_neighbor_coords_average_interior(ss, avg, batch->vert_index[i]);
+      sub_v3_v3v3(val, avg, co);
+      madd_v3_v3v3fl(val, co, val, fade);
+      SCULPT_clip(sd, ss, co, val);
     }
   }
-  BKE_pbvh_vertex_iter_end;
+
+  SCULPT_brush_batch_tag_update(batch);
 }
 
 void SCULPT_smooth(Sculpt *sd,
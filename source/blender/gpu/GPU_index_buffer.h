@@ -67,6 +67,18 @@ void GPU_indexbuf_set_point_restart(GPUIndexBufBuilder *builder, uint elem);
 void GPU_indexbuf_set_line_restart(GPUIndexBufBuilder *builder, uint elem);
 void GPU_indexbuf_set_tri_restart(GPUIndexBufBuilder *builder, uint elem);
 
+/* Variant of #GPU_indexbuf_set_line_verts for lines set by several threads (e.g. edges shared by
+ * faces): both vertices are written at once, concurrent calls never mix their vertices. */
+void GPU_indexbuf_set_line_verts_shared(GPUIndexBufBuilder *builder, uint elem, uint v1, uint v2);
+
+/* Fill one index buffer from several threads: each thread sets elements using its own
+ * sub-builder, which shares the data of the parent builder. Finishing a sub-builder merges its
+ * length into the parent and is thread safe. */
+void GPU_indexbuf_subbuilder_init(const GPUIndexBufBuilder *parent_builder,
+                                  GPUIndexBufBuilder *sub_builder);
+void GPU_indexbuf_subbuilder_finish(GPUIndexBufBuilder *parent_builder,
+                                    const GPUIndexBufBuilder *sub_builder);
+
 GPUIndexBuf *GPU_indexbuf_build(GPUIndexBufBuilder *);
 void GPU_indexbuf_build_in_place(GPUIndexBufBuilder *, GPUIndexBuf *);
 
@@ -23,10 +23,14 @@
  * GPU element list (AKA index buffer)
  */
 
+#include <cstring>
+
 #include "MEM_guardedalloc.h"
 
 #include "BLI_utildefines.h"
 
+#include "atomic_ops.h"
+
 #include "gpu_backend.hh"
 
 #include "gpu_index_buffer_private.hh"
@@ -204,6 +208,50 @@ void GPU_indexbuf_set_tri_restart(GPUIndexBufBuilder *builder, uint elem)
   }
 }
 
+void GPU_indexbuf_set_line_verts_shared(GPUIndexBufBuilder *builder, uint elem, uint v1, uint v2)
+{
+  BLI_assert(builder->prim_type == GPU_PRIM_LINES);
+  BLI_assert(v1 != v2);
+  BLI_assert(v1 <= builder->max_allowed_index);
+  BLI_assert(v2 <= builder->max_allowed_index);
+  BLI_assert((elem + 1) * 2 <= builder->max_index_len);
+  const uint32_t verts[2] = {v1, v2};
+  uint64_t verts_packed;
+  memcpy(&verts_packed, verts, sizeof(verts_packed));
+
+  /* The data is allocated by the guarded allocator, line elements are 8 bytes aligned,
+   * so a single 64-bit store can't be observed half written by other threads. */
+  uint64_t *line = (uint64_t *)&builder->data[elem * 2];
+  *line = verts_packed;
+
+  const uint idx = (elem + 1) * 2;
+  if (builder->index_len < idx) {
+    builder->index_len = idx;
+  }
+}
+
+void GPU_indexbuf_subbuilder_init(const GPUIndexBufBuilder *parent_builder,
+                                  GPUIndexBufBuilder *sub_builder)
+{
+  *sub_builder = *parent_builder;
+  sub_builder->index_len = 0;
+}
+
+void GPU_indexbuf_subbuilder_finish(GPUIndexBufBuilder *parent_builder,
+                                    const GPUIndexBufBuilder *sub_builder)
+{
+  BLI_assert(parent_builder->data == sub_builder->data);
+  uint index_len = parent_builder->index_len;
+  while (index_len < sub_builder->index_len) {
+    const uint index_len_prev = atomic_cas_uint32(
+        &parent_builder->index_len, index_len, sub_builder->index_len);
+    if (index_len_prev == index_len) {
+      break;
+    }
+    index_len = index_len_prev;
+  }
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -418,6 +418,7 @@ void IMB_free_anim(struct anim *anim);
 #define FILTER_MASK_USED 2
 
 void IMB_filter(struct ImBuf *ibuf);
+void IMB_gaussian_blur(struct ImBuf *ibuf, float sigma_x, float sigma_y);
 void IMB_mask_filter_extend(char *mask, int width, int height);
 void IMB_mask_clear(struct ImBuf *ibuf, const char *mask, int val);
 void IMB_filter_extend(struct ImBuf *ibuf, char *mask, int filter);
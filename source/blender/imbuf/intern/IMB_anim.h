@@ -47,6 +47,10 @@
 #  include <dirent.h>
 #endif
 
+#include "DNA_listBase.h"
+
+#include "BLI_threads.h"
+
 #include "imbuf.h"
 
 #ifdef WITH_AVI
@@ -80,6 +84,11 @@
 
 #define MAXNUMSTREAMS 50
 
+/* Frames decoded ahead of the requested one, when frames are requested in order. */
+#define FFMPEG_DECODE_AHEAD_FRAMES 3
+/* Maximum number of horizontal slices converted to RGBA in parallel. */
+#define FFMPEG_CONVERT_SLICES_MAX 16
+
 struct IDProperty;
 struct _AviMovie;
 struct anim_index;
@@ -130,12 +139,38 @@ struct anim {
   AVFrame *pFrameRGB;
   AVFrame *pFrameDeinterlaced;
   struct SwsContext *img_convert_ctx;
+  /* Contexts converting horizontal slices of the frame, used when there is more than one.
+   * The number is -1 until the first frame is converted. Slices are converted with rows of
+   * their neighbors into `img_convert_slice_buffer`, then their own rows are copied. */
+  struct SwsContext *img_convert_ctx_slices[FFMPEG_CONVERT_SLICES_MAX];
+  int img_convert_slices_num;
+  int img_convert_slice_height;
+  uint8_t *img_convert_slice_buffer;
   int videoStream;
 
   struct ImBuf *last_frame;
   int64_t last_pts;
   int64_t next_pts;
   AVPacket next_packet;
+
+  /* Decode-ahead, the decoder state above is used by the thread which set `decode_busy`. */
+  ThreadMutex decode_mutex;
+  ThreadCondition decode_cond;
+  bool decode_task_scheduled;
+  bool decode_busy;
+  bool decode_ahead_stop;
+  /* Frames at positions `decode_ahead_position` and following. */
+  struct ImBuf *decode_ahead_frames[FFMPEG_DECODE_AHEAD_FRAMES];
+  int decode_ahead_num;
+  int decode_ahead_position;
+  IMB_Timecode_Type decode_ahead_tc;
+  /* Index and duration for `decode_ahead_tc`. Indices are only opened by the thread requesting
+   * frames, the decode-ahead task uses these. */
+  struct anim_index *decode_ahead_index;
+  int decode_ahead_duration;
+  /* Detection of playback, decoding ahead starts after a few frames requested in order. */
+  int decode_last_request;
+  int decode_sequential_requests;
 #endif
 
   char index_dir[768];
@@ -151,3 +186,8 @@ struct anim {
 
   struct IDProperty *metadata;
 };
+
+/* Stop decoding frames ahead in background, before changing state shared with the decoder. */
+void imb_anim_decode_ahead_stop(struct anim *anim);
+/* Free the task pool decoding frames ahead, all movies must be closed. */
+void imb_anim_decode_ahead_exit(void);
@@ -53,8 +53,10 @@
 #  include <io.h>
 #endif
 
+#include "BLI_math_base.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -79,6 +81,7 @@
 
 #  include <libavcodec/avcodec.h>
 #  include <libavformat/avformat.h>
+#  include <libavutil/pixdesc.h>
 #  include <libavutil/rational.h>
 #  include <libswscale/swscale.h>
 
@@ -506,6 +509,131 @@ BLI_INLINE bool need_aligned_ffmpeg_buffer(struct anim *anim)
   return (anim->x & 31) != 0;
 }
 
+/* Context converting `height` rows of decoded frames to RGBA. */
+static struct SwsContext *ffmpeg_sws_context_create(struct anim *anim, int height)
+{
+  struct SwsContext *sws_ctx = sws_getContext(anim->x,
+                                              height,
+                                              anim->pCodecCtx->pix_fmt,
+                                              anim->x,
+                                              height,
+                                              AV_PIX_FMT_RGBA,
+                                              SWS_FAST_BILINEAR | SWS_FULL_CHR_H_INT,
+                                              NULL,
+                                              NULL,
+                                              NULL);
+  if (!sws_ctx) {
+    return NULL;
+  }
+
+#  ifdef FFMPEG_SWSCALE_COLOR_SPACE_SUPPORT
+  /* The following for color space determination */
+  int srcRange, dstRange, brightness, contrast, saturation;
+  int *table;
+  const int *inv_table;
+
+  /* Try do detect if input has 0-255 YCbCR range (JFIF Jpeg MotionJpeg) */
+  if (!sws_getColorspaceDetails(sws_ctx,
+                                (int **)&inv_table,
+                                &srcRange,
+                                &table,
+                                &dstRange,
+                                &brightness,
+                                &contrast,
+                                &saturation)) {
+    srcRange = srcRange || anim->pCodecCtx->color_range == AVCOL_RANGE_JPEG;
+    inv_table = sws_getCoefficients(anim->pCodecCtx->colorspace);
+
+    if (sws_setColorspaceDetails(sws_ctx,
+                                 (int *)inv_table,
+                                 srcRange,
+                                 table,
+                                 dstRange,
+                                 brightness,
+                                 contrast,
+                                 saturation)) {
+      fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
+    }
+  }
+  else {
+    fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
+  }
+#  endif
+
+  return sws_ctx;
+}
+
+/* Rows of the neighboring slices converted with each slice. Chroma is interpolated vertically,
+ * rows at the edges of a converted slice don't have the chroma of the rows next to them. These
+ * rows are converted but not used. Also a multiple of the chroma subsampling. */
+#  define FFMPEG_CONVERT_SLICE_OVERLAP 16
+
+/* Bytes between rows of #anim.img_convert_slice_buffer, aligned for swscale. */
+BLI_INLINE int ffmpeg_convert_slice_buffer_stride(const struct anim *anim)
+{
+  return (anim->x * 4 + 31) & ~31;
+}
+
+/* Split color space conversion in horizontal slices converted in parallel. Slices start at rows
+ * which are a multiple of the chroma subsampling, and overlap so that their rows are converted
+ * the same as when converting the whole frame. */
+static void ffmpeg_sws_slices_create(struct anim *anim)
+{
+  const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(anim->pCodecCtx->pix_fmt);
+  const int min_slice_height = 64;
+  int slices_num = min_ii(BLI_system_thread_count(), FFMPEG_CONVERT_SLICES_MAX);
+
+  anim->img_convert_slices_num = 0;
+
+  /* Palette and hardware formats have data which can't be offset by rows. */
+  if (desc == NULL || (desc->flags & (AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_HWACCEL |
+                                       AV_PIX_FMT_FLAG_BITSTREAM))) {
+    return;
+  }
+
+  slices_num = min_ii(slices_num, anim->y / min_slice_height);
+  if (slices_num < 2) {
+    return;
+  }
+
+  const int row_align = 16;
+  const int slice_height = ((anim->y + slices_num - 1) / slices_num + row_align - 1) /
+                           row_align * row_align;
+  slices_num = (anim->y + slice_height - 1) / slice_height;
+
+  for (int i = 0; i < slices_num; i++) {
+    const int y = i * slice_height;
+    const int y_start = max_ii(y - FFMPEG_CONVERT_SLICE_OVERLAP, 0);
+    const int y_end = min_ii(y + slice_height + FFMPEG_CONVERT_SLICE_OVERLAP, anim->y);
+    anim->img_convert_ctx_slices[i] = ffmpeg_sws_context_create(anim, y_end - y_start);
+    if (anim->img_convert_ctx_slices[i] == NULL) {
+      for (int j = 0; j < i; j++) {
+        sws_freeContext(anim->img_convert_ctx_slices[j]);
+        anim->img_convert_ctx_slices[j] = NULL;
+      }
+      return;
+    }
+  }
+
+  anim->img_convert_slices_num = slices_num;
+  anim->img_convert_slice_height = slice_height;
+  anim->img_convert_slice_buffer = MEM_mallocN_aligned(
+      (size_t)slices_num * (slice_height + 2 * FFMPEG_CONVERT_SLICE_OVERLAP) *
+          ffmpeg_convert_slice_buffer_stride(anim),
+      32,
+      "ffmpeg convert slices");
+}
+
+static void ffmpeg_sws_slices_free(struct anim *anim)
+{
+  for (int i = 0; i < anim->img_convert_slices_num; i++) {
+    sws_freeContext(anim->img_convert_ctx_slices[i]);
+    anim->img_convert_ctx_slices[i] = NULL;
+  }
+  anim->img_convert_slices_num = 0;
+  MEM_SAFE_FREE(anim->img_convert_slice_buffer);
+}
+
 static int startffmpeg(struct anim *anim)
 {
   int i, video_stream_index;
@@ -519,13 +647,6 @@ static int startffmpeg(struct anim *anim)
   double frs_den;
   int streamcount;
 
-#  ifdef FFMPEG_SWSCALE_COLOR_SPACE_SUPPORT
-  /* The following for color space determination */
-  int srcRange, dstRange, brightness, contrast, saturation;
-  int *table;
-  const int *inv_table;
-#  endif
-
   if (anim == NULL) {
     return (-1);
   }
@@ -574,8 +695,21 @@ static int startffmpeg(struct anim *anim)
 
   pCodecCtx->workaround_bugs = 1;
 
-  pCodecCtx->thread_count = BLI_system_thread_count();
-  pCodecCtx->thread_type = FF_THREAD_SLICE;
+  /* Decode several frames at once when the codec supports it, which scales much better than
+   * slices for most codecs. */
+  if (pCodec->capabilities & AV_CODEC_CAP_AUTO_THREADS) {
+    pCodecCtx->thread_count = 0;
+  }
+  else {
+    pCodecCtx->thread_count = BLI_system_thread_count();
+  }
+
+  if (pCodec->capabilities & AV_CODEC_CAP_FRAME_THREADS) {
+    pCodecCtx->thread_type = FF_THREAD_FRAME;
+  }
+  else if (pCodec->capabilities & AV_CODEC_CAP_SLICE_THREADS) {
+    pCodecCtx->thread_type = FF_THREAD_SLICE;
+  }
 
   if (avcodec_open2(pCodecCtx, pCodec, NULL) < 0) {
     avformat_close_input(&pFormatCtx);
@@ -696,16 +830,7 @@ static int startffmpeg(struct anim *anim)
     anim->preseek = 0;
   }
 
-  anim->img_convert_ctx = sws_getContext(anim->x,
-                                         anim->y,
-                                         anim->pCodecCtx->pix_fmt,
-                                         anim->x,
-                                         anim->y,
-                                         AV_PIX_FMT_RGBA,
-                                         SWS_FAST_BILINEAR | SWS_PRINT_INFO | SWS_FULL_CHR_H_INT,
-                                         NULL,
-                                         NULL,
-                                         NULL);
+  anim->img_convert_ctx = ffmpeg_sws_context_create(anim, anim->y);
 
   if (!anim->img_convert_ctx) {
     fprintf(stderr, "Can't transform color space??? Bailing out...\n");
@@ -718,38 +843,107 @@ static int startffmpeg(struct anim *anim)
     return -1;
   }
 
-#  ifdef FFMPEG_SWSCALE_COLOR_SPACE_SUPPORT
-  /* Try do detect if input has 0-255 YCbCR range (JFIF Jpeg MotionJpeg) */
-  if (!sws_getColorspaceDetails(anim->img_convert_ctx,
-                                (int **)&inv_table,
-                                &srcRange,
-                                &table,
-                                &dstRange,
-                                &brightness,
-                                &contrast,
-                                &saturation)) {
-    srcRange = srcRange || anim->pCodecCtx->color_range == AVCOL_RANGE_JPEG;
-    inv_table = sws_getCoefficients(anim->pCodecCtx->colorspace);
+  /* Slice contexts are created on first conversion. */
+  anim->img_convert_slices_num = -1;
+  anim->img_convert_slice_buffer = NULL;
 
-    if (sws_setColorspaceDetails(anim->img_convert_ctx,
-                                 (int *)inv_table,
-                                 srcRange,
-                                 table,
-                                 dstRange,
-                                 brightness,
-                                 contrast,
-                                 saturation)) {
-      fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
-    }
+  BLI_mutex_init(&anim->decode_mutex);
+  BLI_condition_init(&anim->decode_cond);
+  anim->decode_task_scheduled = false;
+  anim->decode_busy = false;
+  anim->decode_ahead_stop = false;
+  anim->decode_ahead_num = 0;
+  anim->decode_ahead_index = NULL;
+  anim->decode_ahead_duration = 0;
+  anim->decode_last_request = -1;
+  anim->decode_sequential_requests = 0;
+
+  return 0;
+}
+
+typedef struct FFmpegConvertData {
+  struct anim *anim;
+  AVFrame *input;
+  uint8_t *dst;
+  int dst_stride;
+} FFmpegConvertData;
+
+static void ffmpeg_convert_slice(void *__restrict userdata,
+                                 const int slice,
+                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const FFmpegConvertData *data = userdata;
+  struct anim *anim = data->anim;
+  const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(anim->pCodecCtx->pix_fmt);
+  const int slice_height = anim->img_convert_slice_height;
+  const int y = slice * slice_height;
+  const int height = min_ii(slice_height, anim->y - y);
+  const int y_start = max_ii(y - FFMPEG_CONVERT_SLICE_OVERLAP, 0);
+  const int y_end = min_ii(y + slice_height + FFMPEG_CONVERT_SLICE_OVERLAP, anim->y);
+  const uint8_t *src[4] = {NULL, NULL, NULL, NULL};
+
+  for (int plane = 0; plane < 4 && data->input->data[plane]; plane++) {
+    const int plane_y = ELEM(plane, 1, 2) ? y_start >> desc->log2_chroma_h : y_start;
+    src[plane] = data->input->data[plane] + (ptrdiff_t)plane_y * data->input->linesize[plane];
+  }
+
+  const int buffer_stride = ffmpeg_convert_slice_buffer_stride(anim);
+  const size_t buffer_size = (size_t)(slice_height + 2 * FFMPEG_CONVERT_SLICE_OVERLAP) *
+                             buffer_stride;
+  uint8_t *buffer = anim->img_convert_slice_buffer + slice * buffer_size;
+  uint8_t *dst[4] = {buffer, NULL, NULL, NULL};
+  const int dst_stride[4] = {buffer_stride, 0, 0, 0};
+
+  sws_scale(anim->img_convert_ctx_slices[slice],
+            (const uint8_t *const *)src,
+            data->input->linesize,
+            0,
+            y_end - y_start,
+            dst,
+            dst_stride);
+
+  /* Copy the rows of this slice, leaving out the rows of its neighbors. */
+  const uint8_t *row = buffer + (size_t)(y - y_start) * buffer_stride;
+  for (int i = 0; i < height; i++, row += buffer_stride) {
+    memcpy(data->dst + (ptrdiff_t)(y + i) * data->dst_stride, row, (size_t)anim->x * 4);
   }
-  else {
-    fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
+}
+
+/* Convert `input` to RGBA rows starting at `dst`, with `dst_stride` bytes between rows. */
+static void ffmpeg_convert(struct anim *anim, AVFrame *input, uint8_t *dst, int dst_stride)
+{
+  if (anim->img_convert_slices_num == -1) {
+    ffmpeg_sws_slices_create(anim);
   }
-#  endif
 
-  return 0;
+  if (anim->img_convert_slices_num == 0) {
+    uint8_t *dst2[4] = {dst, NULL, NULL, NULL};
+    const int dst_stride2[4] = {dst_stride, 0, 0, 0};
+
+    sws_scale(anim->img_convert_ctx,
+              (const uint8_t *const *)input->data,
+              input->linesize,
+              0,
+              anim->y,
+              dst2,
+              dst_stride2);
+    return;
+  }
+
+  FFmpegConvertData data = {
+      .anim = anim,
+      .input = input,
+      .dst = dst,
+      .dst_stride = dst_stride,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, anim->img_convert_slices_num, &data, ffmpeg_convert_slice, &settings);
 }
 
+#  undef FFMPEG_CONVERT_SLICE_OVERLAP
+
 /* postprocess the image in anim->pFrame and do color conversion
  * and deinterlacing stuff.
  *
@@ -807,19 +1001,11 @@ static void ffmpeg_postprocess(struct anim *anim)
   if (ENDIAN_ORDER == B_ENDIAN) {
     int *dstStride = anim->pFrameRGB->linesize;
     uint8_t **dst = anim->pFrameRGB->data;
-    const int dstStride2[4] = {dstStride[0], 0, 0, 0};
-    uint8_t *dst2[4] = {dst[0], 0, 0, 0};
     int x, y, h, w;
     unsigned char *bottom;
     unsigned char *top;
 
-    sws_scale(anim->img_convert_ctx,
-              (const uint8_t *const *)input->data,
-              input->linesize,
-              0,
-              anim->y,
-              dst2,
-              dstStride2);
+    ffmpeg_convert(anim, input, dst[0], dstStride[0]);
 
     bottom = (unsigned char *)ibuf->rect;
     top = bottom + ibuf->x * (ibuf->y - 1) * 4;
@@ -853,16 +1039,9 @@ static void ffmpeg_postprocess(struct anim *anim)
   else {
     int *dstStride = anim->pFrameRGB->linesize;
     uint8_t **dst = anim->pFrameRGB->data;
-    const int dstStride2[4] = {-dstStride[0], 0, 0, 0};
-    uint8_t *dst2[4] = {dst[0] + (anim->y - 1) * dstStride[0], 0, 0, 0};
 
-    sws_scale(anim->img_convert_ctx,
-              (const uint8_t *const *)input->data,
-              input->linesize,
-              0,
-              anim->y,
-              dst2,
-              dstStride2);
+    /* Flip vertically. */
+    ffmpeg_convert(anim, input, dst[0] + (anim->y - 1) * dstStride[0], -dstStride[0]);
   }
 
   if (need_aligned_ffmpeg_buffer(anim)) {
@@ -1049,13 +1228,13 @@ static int ffmpeg_seek_by_byte(AVFormatContext *pFormatCtx)
   return false;
 }
 
-static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Type tc)
+/* `tc_index` is the opened timecode index, or NULL to seek without one. */
+static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, struct anim_index *tc_index)
 {
   int64_t pts_to_search = 0;
   double frame_rate;
   double pts_time_base;
   int64_t st_time;
-  struct anim_index *tc_index = 0;
   AVStream *v_st;
   int new_frame_index = 0; /* To quiet gcc barking... */
   int old_frame_index = 0; /* To quiet gcc barking... */
@@ -1066,10 +1245,6 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
 
   av_log(anim->pFormatCtx, AV_LOG_DEBUG, "FETCH: pos=%d\n", position);
 
-  if (tc != IMB_TC_NONE) {
-    tc_index = IMB_anim_open_index(anim, tc);
-  }
-
   v_st = anim->pFormatCtx->streams[anim->videoStream];
 
   frame_rate = av_q2d(av_guess_frame_rate(anim->pFormatCtx, v_st, NULL));
@@ -1244,6 +1419,180 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
   return anim->last_frame;
 }
 
+/* Decode-ahead
+ *
+ * Once frames are requested in order, a task decodes the following frames while the requested
+ * one is being used, so playback doesn't wait for decoding. Tasks of all movies run in a pool
+ * shared by all of them, created on first use.
+ *
+ * `anim->decode_mutex` protects the decode-ahead state, not the decoder itself. A thread claims
+ * the decoder by setting `anim->decode_busy`, and decodes without holding the mutex, so frames
+ * decoded so far can be taken meanwhile. The decoder position (`anim->curposition`) is the
+ * position of the last decoded frame. */
+
+/* Number of consecutive frames requested in order before decoding ahead. */
+#  define FFMPEG_DECODE_AHEAD_SEQUENTIAL_REQUESTS 2
+
+static TaskPool *ffmpeg_decode_ahead_pool = NULL;
+static ThreadMutex ffmpeg_decode_ahead_pool_mutex = BLI_MUTEX_INITIALIZER;
+
+static TaskPool *ffmpeg_decode_ahead_pool_ensure(void)
+{
+  BLI_mutex_lock(&ffmpeg_decode_ahead_pool_mutex);
+  if (ffmpeg_decode_ahead_pool == NULL) {
+    ffmpeg_decode_ahead_pool = BLI_task_pool_create_background(NULL, TASK_PRIORITY_LOW);
+  }
+  BLI_mutex_unlock(&ffmpeg_decode_ahead_pool_mutex);
+
+  return ffmpeg_decode_ahead_pool;
+}
+
+static void ffmpeg_decode_ahead_clear(struct anim *anim)
+{
+  for (int i = 0; i < anim->decode_ahead_num; i++) {
+    IMB_freeImBuf(anim->decode_ahead_frames[i]);
+    anim->decode_ahead_frames[i] = NULL;
+  }
+  anim->decode_ahead_num = 0;
+}
+
+static bool ffmpeg_decode_ahead_is_needed(struct anim *anim)
+{
+  if (anim->decode_ahead_stop ||
+      anim->decode_sequential_requests < FFMPEG_DECODE_AHEAD_SEQUENTIAL_REQUESTS ||
+      anim->decode_ahead_num == FFMPEG_DECODE_AHEAD_FRAMES) {
+    return false;
+  }
+
+  const int position = anim->decode_ahead_position + anim->decode_ahead_num;
+  return position < anim->decode_ahead_duration;
+}
+
+static void ffmpeg_decode_ahead_task(TaskPool *__restrict UNUSED(pool), void *anim_v)
+{
+  struct anim *anim = anim_v;
+
+  BLI_mutex_lock(&anim->decode_mutex);
+  while (!anim->decode_busy && ffmpeg_decode_ahead_is_needed(anim)) {
+    const int position = anim->decode_ahead_position + anim->decode_ahead_num;
+    const IMB_Timecode_Type tc = anim->decode_ahead_tc;
+    struct anim_index *tc_index = anim->decode_ahead_index;
+
+    anim->decode_busy = true;
+    BLI_mutex_unlock(&anim->decode_mutex);
+
+    ImBuf *ibuf = ffmpeg_fetchibuf(anim, position, tc_index);
+
+    BLI_mutex_lock(&anim->decode_mutex);
+    anim->decode_busy = false;
+
+    /* Frames may have been taken or discarded meanwhile, only keep the frame when it still
+     * follows the frames decoded ahead. */
+    if (ibuf != NULL && tc == anim->decode_ahead_tc &&
+        position == anim->decode_ahead_position + anim->decode_ahead_num &&
+        anim->decode_ahead_num < FFMPEG_DECODE_AHEAD_FRAMES) {
+      anim->decode_ahead_frames[anim->decode_ahead_num++] = ibuf;
+    }
+    else {
+      if (ibuf == NULL) {
+        /* Wait for requests to resume decoding. */
+        anim->decode_sequential_requests = 0;
+      }
+      IMB_freeImBuf(ibuf);
+    }
+    BLI_condition_notify_all(&anim->decode_cond);
+  }
+
+  anim->decode_task_scheduled = false;
+  BLI_condition_notify_all(&anim->decode_cond);
+  BLI_mutex_unlock(&anim->decode_mutex);
+}
+
+/* Take frame at `position` if it was decoded ahead, frames before it are discarded. Otherwise
+ * all frames are discarded and decoding ahead continues from `position`. */
+static ImBuf *ffmpeg_decode_ahead_take(struct anim *anim, int position)
+{
+  const int index = position - anim->decode_ahead_position;
+
+  if (index < 0 || index >= anim->decode_ahead_num) {
+    ffmpeg_decode_ahead_clear(anim);
+    anim->decode_ahead_position = position;
+    return NULL;
+  }
+
+  ImBuf *ibuf = anim->decode_ahead_frames[index];
+  for (int i = 0; i < index; i++) {
+    IMB_freeImBuf(anim->decode_ahead_frames[i]);
+  }
+  anim->decode_ahead_num -= index + 1;
+  memmove(anim->decode_ahead_frames,
+          anim->decode_ahead_frames + index + 1,
+          sizeof(*anim->decode_ahead_frames) * anim->decode_ahead_num);
+  anim->decode_ahead_position = position + 1;
+
+  return ibuf;
+}
+
+static ImBuf *ffmpeg_fetchibuf_decode_ahead(struct anim *anim,
+                                            int position,
+                                            IMB_Timecode_Type tc)
+{
+  /* Open the index on this thread, the decode-ahead task only uses what is stored here. */
+  struct anim_index *tc_index = (tc != IMB_TC_NONE) ? IMB_anim_open_index(anim, tc) : NULL;
+  const int duration = IMB_anim_get_duration(anim, tc);
+
+  BLI_mutex_lock(&anim->decode_mutex);
+
+  if (tc != anim->decode_ahead_tc) {
+    ffmpeg_decode_ahead_clear(anim);
+    anim->decode_ahead_tc = tc;
+  }
+  anim->decode_ahead_index = tc_index;
+  anim->decode_ahead_duration = duration;
+
+  if (position == anim->decode_last_request + 1) {
+    anim->decode_sequential_requests++;
+  }
+  else {
+    anim->decode_sequential_requests = 0;
+  }
+  anim->decode_last_request = position;
+
+  ImBuf *ibuf;
+  while ((ibuf = ffmpeg_decode_ahead_take(anim, position)) == NULL) {
+    if (anim->decode_busy) {
+      /* The decoder is in use by the decode-ahead task, which may be decoding the requested
+       * frame. Wait for it and check again. */
+      BLI_condition_wait(&anim->decode_cond, &anim->decode_mutex);
+      continue;
+    }
+
+    anim->decode_busy = true;
+    BLI_mutex_unlock(&anim->decode_mutex);
+
+    ibuf = ffmpeg_fetchibuf(anim, position, tc_index);
+
+    BLI_mutex_lock(&anim->decode_mutex);
+    anim->decode_busy = false;
+    ffmpeg_decode_ahead_clear(anim);
+    anim->decode_ahead_position = position + 1;
+    BLI_condition_notify_all(&anim->decode_cond);
+    break;
+  }
+
+  if (!anim->decode_task_scheduled && ffmpeg_decode_ahead_is_needed(anim)) {
+    anim->decode_task_scheduled = true;
+    BLI_task_pool_push(
+        ffmpeg_decode_ahead_pool_ensure(), ffmpeg_decode_ahead_task, anim, false, NULL);
+  }
+
+  BLI_mutex_unlock(&anim->decode_mutex);
+
+  return ibuf;
+}
+
+#  undef FFMPEG_DECODE_AHEAD_SEQUENTIAL_REQUESTS
+
 static void free_anim_ffmpeg(struct anim *anim)
 {
   if (anim == NULL) {
@@ -1251,6 +1600,10 @@ static void free_anim_ffmpeg(struct anim *anim)
   }
 
   if (anim->pCodecCtx) {
+    imb_anim_decode_ahead_stop(anim);
+    BLI_mutex_end(&anim->decode_mutex);
+    BLI_condition_end(&anim->decode_cond);
+
     avcodec_close(anim->pCodecCtx);
     avformat_close_input(&anim->pFormatCtx);
 
@@ -1273,6 +1626,7 @@ static void free_anim_ffmpeg(struct anim *anim)
     av_frame_free(&anim->pFrameDeinterlaced);
 
     sws_freeContext(anim->img_convert_ctx);
+    ffmpeg_sws_slices_free(anim);
     IMB_freeImBuf(anim->last_frame);
     if (anim->next_packet.stream_index != -1) {
       av_free_packet(&anim->next_packet);
@@ -1283,6 +1637,40 @@ static void free_anim_ffmpeg(struct anim *anim)
 
 #endif
 
+void imb_anim_decode_ahead_stop(struct anim *anim)
+{
+#ifdef WITH_FFMPEG
+  if (anim->pCodecCtx == NULL) {
+    return;
+  }
+
+  BLI_mutex_lock(&anim->decode_mutex);
+  anim->decode_ahead_stop = true;
+  while (anim->decode_task_scheduled || anim->decode_busy) {
+    BLI_condition_wait(&anim->decode_cond, &anim->decode_mutex);
+  }
+  anim->decode_ahead_stop = false;
+  /* Indices may be freed next, the next request sets it again. */
+  anim->decode_ahead_index = NULL;
+
+  ffmpeg_decode_ahead_clear(anim);
+  anim->decode_sequential_requests = 0;
+  BLI_mutex_unlock(&anim->decode_mutex);
+#else
+  UNUSED_VARS(anim);
+#endif
+}
+
+void imb_anim_decode_ahead_exit(void)
+{
+#ifdef WITH_FFMPEG
+  if (ffmpeg_decode_ahead_pool) {
+    BLI_task_pool_free(ffmpeg_decode_ahead_pool);
+    ffmpeg_decode_ahead_pool = NULL;
+  }
+#endif
+}
+
 /* Try next picture to read */
 /* No picture, try to open next animation */
 /* Succeed, remove first image from animation */
@@ -1430,10 +1818,8 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim,
 #endif
 #ifdef WITH_FFMPEG
     case ANIM_FFMPEG:
-      ibuf = ffmpeg_fetchibuf(anim, position, tc);
-      if (ibuf) {
-        anim->curposition = position;
-      }
+      /* Position of decoder is updated internally, it may be ahead of requested position. */
+      ibuf = ffmpeg_fetchibuf_decode_ahead(anim, position, tc);
       filter_y = 0; /* done internally */
       break;
 #endif
@@ -1443,7 +1829,7 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim,
     if (filter_y) {
       IMB_filtery(ibuf);
     }
-    BLI_snprintf(ibuf->name, sizeof(ibuf->name), "%s.%04d", anim->name, anim->curposition + 1);
+    BLI_snprintf(ibuf->name, sizeof(ibuf->name), "%s.%04d", anim->name, position + 1);
   }
   return ibuf;
 }
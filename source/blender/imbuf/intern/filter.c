@@ -27,6 +27,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_math_base.h"
+#include "BLI_recursive_gaussian.h"
 #include "BLI_utildefines.h"
 
 #include "IMB_filter.h"
@@ -321,6 +322,22 @@ void IMB_filter(struct ImBuf *ibuf)
   imb_filterx(ibuf);
 }
 
+/**
+ * Gaussian blur of the whole image, with standard deviations in pixels along x and y.
+ * Directions with a sigma below 0.5 or less than 3 pixels are not blurred.
+ */
+void IMB_gaussian_blur(struct ImBuf *ibuf, float sigma_x, float sigma_y)
+{
+  if (ibuf->rect_float) {
+    BLI_recursive_gaussian_blur_fl(
+        ibuf->rect_float, ibuf->x, ibuf->y, ibuf->channels, ibuf->channels, sigma_x, sigma_y);
+  }
+  else if (ibuf->rect) {
+    BLI_recursive_gaussian_blur_uchar(
+        (unsigned char *)ibuf->rect, ibuf->x, ibuf->y, 4, 4, sigma_x, sigma_y);
+  }
+}
+
 void IMB_mask_filter_extend(char *mask, int width, int height)
 {
   const char *row1, *row2, *row3;
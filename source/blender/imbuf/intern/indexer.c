@@ -29,6 +29,7 @@
 #include "BLI_ghash.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 #ifdef _WIN32
@@ -689,6 +690,27 @@ static void free_proxy_output_ffmpeg(struct proxy_output_ctx *ctx, int rollback)
   MEM_freeN(ctx);
 }
 
+/* Decoded frames waiting to be encoded into one proxy size, in presentation order. Limits how
+ * far decoding can get ahead of the slowest encoder. */
+#  define FFMPEG_PROXY_QUEUE_FRAMES 8
+
+typedef struct FFmpegIndexProxyQueue {
+  AVFrame *frames[FFMPEG_PROXY_QUEUE_FRAMES];
+  int first, num;
+  /* A task is encoding the frames of this queue. The frame at `first` is removed once it is
+   * encoded. */
+  bool encoding;
+} FFmpegIndexProxyQueue;
+
+/* Video packet sent to the decoder, waiting for its decoded frame. */
+typedef struct FFmpegIndexPendingPacket {
+  /* Presentation timestamp, the same way it is read from the decoded frame. */
+  uint64_t pts;
+  /* Position to seek to in order to decode the frame of the packet. */
+  uint64_t seek_pos;
+  uint64_t seek_pos_dts;
+} FFmpegIndexPendingPacket;
+
 typedef struct FFmpegIndexBuilderContext {
   int anim_type;
 
@@ -704,6 +726,13 @@ typedef struct FFmpegIndexBuilderContext {
   struct proxy_output_ctx *proxy_ctx[IMB_PROXY_MAX_SLOT];
   anim_index_builder *indexer[IMB_TC_MAX_SLOT];
 
+  /* Each proxy size is encoded by its own task, in parallel with the other sizes and with
+   * decoding. Decoded frames are queued per size, the queues are protected by proxy_mutex. */
+  struct TaskPool *proxy_task_pool;
+  FFmpegIndexProxyQueue proxy_queue[IMB_PROXY_MAX_SLOT];
+  ThreadMutex proxy_mutex;
+  ThreadCondition proxy_cond;
+
   IMB_Timecode_Type tcs_in_use;
   IMB_Proxy_Size proxy_sizes_in_use;
 
@@ -713,6 +742,14 @@ typedef struct FFmpegIndexBuilderContext {
   uint64_t seek_pos_pts;
   uint64_t last_seek_pos_dts;
   uint64_t start_pts;
+
+  /* Packets in decoding order. The decoder returns frames later than the packets are sent when
+   * it reorders frames or uses frame threading, so the seek position of each decoded frame is
+   * looked up from the packet it was decoded from. */
+  FFmpegIndexPendingPacket *pending_packets;
+  int num_pending_packets;
+  int pending_packets_size;
+
   double frame_rate;
   double pts_time_base;
   int frameno, frameno_gapless;
@@ -783,6 +820,23 @@ static IndexBuildContext *index_ffmpeg_create_context(struct anim *anim,
 
   context->iCodecCtx->workaround_bugs = 1;
 
+  /* Frame threading delays the output by a few frames, packets of a new GOP can be read before
+   * the last frames of the previous one are returned. Seek positions are kept per packet for
+   * this, see index_rebuild_ffmpeg_packet_push(). */
+  if (context->iCodec->capabilities & AV_CODEC_CAP_AUTO_THREADS) {
+    context->iCodecCtx->thread_count = 0;
+  }
+  else {
+    context->iCodecCtx->thread_count = BLI_system_thread_count();
+  }
+
+  if (context->iCodec->capabilities & AV_CODEC_CAP_FRAME_THREADS) {
+    context->iCodecCtx->thread_type = FF_THREAD_FRAME;
+  }
+  else if (context->iCodec->capabilities & AV_CODEC_CAP_SLICE_THREADS) {
+    context->iCodecCtx->thread_type = FF_THREAD_SLICE;
+  }
+
   if (avcodec_open2(context->iCodecCtx, context->iCodec, NULL) < 0) {
     avformat_close_input(&context->iFormatCtx);
     MEM_freeN(context);
@@ -817,13 +871,97 @@ static IndexBuildContext *index_ffmpeg_create_context(struct anim *anim,
     }
   }
 
+  context->proxy_task_pool = BLI_task_pool_create_background(context, TASK_PRIORITY_HIGH);
+  BLI_mutex_init(&context->proxy_mutex);
+  BLI_condition_init(&context->proxy_cond);
+
   return (IndexBuildContext *)context;
 }
 
+/* Encode the queued frames of one proxy size, until its queue is empty. */
+static void index_rebuild_ffmpeg_proxy_task(TaskPool *__restrict pool, void *taskdata)
+{
+  FFmpegIndexBuilderContext *context = BLI_task_pool_user_data(pool);
+  const int i = POINTER_AS_INT(taskdata);
+  FFmpegIndexProxyQueue *queue = &context->proxy_queue[i];
+
+  BLI_mutex_lock(&context->proxy_mutex);
+  while (queue->num > 0) {
+    AVFrame *frame = queue->frames[queue->first];
+    BLI_mutex_unlock(&context->proxy_mutex);
+
+    add_to_proxy_output_ffmpeg(context->proxy_ctx[i], frame);
+    av_frame_free(&frame);
+
+    BLI_mutex_lock(&context->proxy_mutex);
+    queue->frames[queue->first] = NULL;
+    queue->first = (queue->first + 1) % FFMPEG_PROXY_QUEUE_FRAMES;
+    queue->num--;
+    BLI_condition_notify_all(&context->proxy_cond);
+  }
+  queue->encoding = false;
+  BLI_mutex_unlock(&context->proxy_mutex);
+}
+
+/* Wait until all queued frames are written to the proxies. */
+static void index_rebuild_ffmpeg_proxy_wait(FFmpegIndexBuilderContext *context)
+{
+  BLI_task_pool_work_and_wait(context->proxy_task_pool);
+}
+
+static void index_rebuild_ffmpeg_proxy_add(FFmpegIndexBuilderContext *context, AVFrame *in_frame)
+{
+  int i;
+
+  /* The decoder reuses the frame buffers, keep a reference (or a copy for decoders without
+   * reference counted frames) while the frame is being encoded. Queues share its buffers. */
+  AVFrame *frame = av_frame_clone(in_frame);
+  if (frame == NULL) {
+    return;
+  }
+
+  BLI_mutex_lock(&context->proxy_mutex);
+  for (i = 0; i < context->num_proxy_sizes; i++) {
+    FFmpegIndexProxyQueue *queue = &context->proxy_queue[i];
+
+    if (context->proxy_ctx[i] == NULL) {
+      continue;
+    }
+
+    /* Only wait when the encoder of this size is a whole queue of frames behind. */
+    while (queue->num == FFMPEG_PROXY_QUEUE_FRAMES) {
+      BLI_condition_wait(&context->proxy_cond, &context->proxy_mutex);
+    }
+
+    queue->frames[(queue->first + queue->num) % FFMPEG_PROXY_QUEUE_FRAMES] = av_frame_clone(
+        frame);
+    queue->num++;
+
+    if (!queue->encoding) {
+      queue->encoding = true;
+      BLI_task_pool_push(context->proxy_task_pool,
+                         index_rebuild_ffmpeg_proxy_task,
+                         POINTER_FROM_INT(i),
+                         false,
+                         NULL);
+    }
+  }
+  BLI_mutex_unlock(&context->proxy_mutex);
+
+  av_frame_free(&frame);
+}
+
 static void index_rebuild_ffmpeg_finish(FFmpegIndexBuilderContext *context, int stop)
 {
   int i;
 
+  index_rebuild_ffmpeg_proxy_wait(context);
+  BLI_task_pool_free(context->proxy_task_pool);
+  BLI_mutex_end(&context->proxy_mutex);
+  BLI_condition_end(&context->proxy_cond);
+
+  MEM_SAFE_FREE(context->pending_packets);
+
   for (i = 0; i < context->num_indexers; i++) {
     if (context->tcs_in_use & tc_types[i]) {
       IMB_index_builder_finish(context->indexer[i], stop);
@@ -842,26 +980,29 @@ static void index_rebuild_ffmpeg_finish(FFmpegIndexBuilderContext *context, int
   MEM_freeN(context);
 }
 
-static void index_rebuild_ffmpeg_proc_decoded_frame(FFmpegIndexBuilderContext *context,
-                                                    AVPacket *curr_packet,
-                                                    AVFrame *in_frame)
+/* Remember the seek position of a video packet sent to the decoder. */
+static void index_rebuild_ffmpeg_packet_push(FFmpegIndexBuilderContext *context,
+                                             const AVPacket *packet)
 {
-  int i;
-  uint64_t s_pos = context->seek_pos;
-  uint64_t s_dts = context->seek_pos_dts;
-  uint64_t pts = av_get_pts_from_frame(context->iFormatCtx, in_frame);
+  FFmpegIndexPendingPacket *pending;
+  uint64_t pts = packet->pts;
 
-  for (i = 0; i < context->num_proxy_sizes; i++) {
-    add_to_proxy_output_ffmpeg(context->proxy_ctx[i], in_frame);
+  /* Same fallback as av_get_pts_from_frame(), so packets and frames match. */
+  if (packet->pts == AV_NOPTS_VALUE) {
+    pts = (packet->dts == AV_NOPTS_VALUE) ? 0 : packet->dts;
   }
 
-  if (!context->start_pts_set) {
-    context->start_pts = pts;
-    context->start_pts_set = true;
+  if (context->num_pending_packets == context->pending_packets_size) {
+    context->pending_packets_size = MAX2(16, context->pending_packets_size * 2);
+    context->pending_packets = MEM_reallocN(context->pending_packets,
+                                            sizeof(*context->pending_packets) *
+                                                context->pending_packets_size);
   }
 
-  context->frameno = floor(
-      (pts - context->start_pts) * context->pts_time_base * context->frame_rate + 0.5);
+  pending = &context->pending_packets[context->num_pending_packets++];
+  pending->pts = pts;
+  pending->seek_pos = context->seek_pos;
+  pending->seek_pos_dts = context->seek_pos_dts;
 
   /* decoding starts *always* on I-Frames,
    * so: P-Frames won't work, even if all the
@@ -871,10 +1012,64 @@ static void index_rebuild_ffmpeg_proc_decoded_frame(FFmpegIndexBuilderContext *c
    * the stream */
 
   if (pts < context->seek_pos_pts) {
-    s_pos = context->last_seek_pos;
-    s_dts = context->last_seek_pos_dts;
+    pending->seek_pos = context->last_seek_pos;
+    pending->seek_pos_dts = context->last_seek_pos_dts;
+  }
+}
+
+/* Find the seek position of the packet a decoded frame comes from, and forget about it. Frames
+ * are returned in presentation order, so pending packets presented earlier than this frame did
+ * not give a frame and are dropped as well. Without a matching packet the position of the
+ * current GOP is used. */
+static void index_rebuild_ffmpeg_packet_pop(FFmpegIndexBuilderContext *context,
+                                            const uint64_t pts,
+                                            uint64_t *r_seek_pos,
+                                            uint64_t *r_seek_pos_dts)
+{
+  int i, num_kept = 0;
+  bool found = false;
+
+  *r_seek_pos = context->seek_pos;
+  *r_seek_pos_dts = context->seek_pos_dts;
+
+  for (i = 0; i < context->num_pending_packets; i++) {
+    const FFmpegIndexPendingPacket *pending = &context->pending_packets[i];
+
+    if (!found && pending->pts == pts) {
+      *r_seek_pos = pending->seek_pos;
+      *r_seek_pos_dts = pending->seek_pos_dts;
+      found = true;
+      continue;
+    }
+    if (pending->pts < pts) {
+      continue;
+    }
+    context->pending_packets[num_kept++] = *pending;
+  }
+
+  context->num_pending_packets = num_kept;
+}
+
+static void index_rebuild_ffmpeg_proc_decoded_frame(FFmpegIndexBuilderContext *context,
+                                                    AVPacket *curr_packet,
+                                                    AVFrame *in_frame)
+{
+  int i;
+  uint64_t s_pos, s_dts;
+  uint64_t pts = av_get_pts_from_frame(context->iFormatCtx, in_frame);
+
+  index_rebuild_ffmpeg_proxy_add(context, in_frame);
+
+  if (!context->start_pts_set) {
+    context->start_pts = pts;
+    context->start_pts_set = true;
   }
 
+  context->frameno = floor(
+      (pts - context->start_pts) * context->pts_time_base * context->frame_rate + 0.5);
+
+  index_rebuild_ffmpeg_packet_pop(context, pts, &s_pos, &s_dts);
+
   for (i = 0; i < context->num_indexers; i++) {
     if (context->tcs_in_use & tc_types[i]) {
       int tc_frameno = context->frameno;
@@ -938,6 +1133,8 @@ static int index_rebuild_ffmpeg(FFmpegIndexBuilderContext *context,
         context->seek_pos_pts = next_packet.pts;
       }
 
+      index_rebuild_ffmpeg_packet_push(context, &next_packet);
+
       avcodec_decode_video2(context->iCodecCtx, in_frame, &frame_finished, &next_packet);
     }
 
@@ -969,6 +1166,8 @@ static int index_rebuild_ffmpeg(FFmpegIndexBuilderContext *context,
     } while (frame_finished);
   }
 
+  index_rebuild_ffmpeg_proxy_wait(context);
+
   av_free(in_frame);
 
   return 1;
@@ -1273,6 +1472,9 @@ void IMB_free_indices(struct anim *anim)
 {
   int i;
 
+  /* Decoder may be using the indices. */
+  imb_anim_decode_ahead_stop(anim);
+
   for (i = 0; i < IMB_PROXY_MAX_SLOT; i++) {
     if (anim->proxy_anim[i]) {
       IMB_close_anim(anim->proxy_anim[i]);
@@ -23,6 +23,7 @@
 #include "BLI_utildefines.h"
 
 #include "IMB_allocimbuf.h"
+#include "IMB_anim.h"
 #include "IMB_colormanagement_intern.h"
 #include "IMB_filetype.h"
 #include "IMB_imbuf.h"
@@ -39,6 +40,7 @@ void IMB_init(void)
 void IMB_exit(void)
 {
   imb_tile_cache_exit();
+  imb_anim_decode_ahead_exit();
   imb_filetypes_exit();
   colormanagement_exit();
   imb_mmap_lock_exit();
@@ -86,7 +86,8 @@ typedef struct Mesh_Runtime {
   void *batch_cache;
 
   struct SubdivCCG *subdiv_ccg;
-  void *_pad1;
+  /** Compact copy of the vertex weights used by armature deform, see 'armature_deform.c'. */
+  struct ArmatureDeformWeights *armature_deform_weights;
   int subdiv_ccg_tot_level;
   char _pad2[4];
 
@@ -103,6 +104,9 @@ typedef struct Mesh_Runtime {
   /** Non-manifold boundary data for Shrinkwrap Target Project. */
   struct ShrinkwrapBoundaryData *shrinkwrap_data;
 
+  /** Adjacency maps shared by modifiers, see #BKE_mesh_runtime_topology_map_ensure. */
+  struct MeshTopologyCache *topology_cache;
+
   /** Set by modifier stack if only deformed from original. */
   char deformed_only;
   /**
@@ -122,7 +126,13 @@ typedef struct Mesh_Runtime {
    */
   char wrapper_type_finalize;
 
-  char _pad[4];
+  /**
+   * Set when the batch cache was taken over from the previous evaluated mesh of the object,
+   * which had the same topology. Only the deformed data has to be extracted again for drawing.
+   */
+  char batch_cache_deform_only;
+
+  char _pad[3];
 
   /** Needed in case we need to lazily initialize the mesh. */
   CustomData_MeshMasks cd_mask_extra;
@@ -526,6 +526,7 @@ typedef struct bNodeTree {
 
 /* tree is localized copy, free when deleting node groups */
 /* #define NTREE_IS_LOCALIZED           (1 << 5) */
+#define NTREE_COM_FULL_FRAME (1 << 6) /* execute a full frame at a time */
 
 /* ntree->update */
 typedef enum eNodeTreeUpdate {
@@ -695,6 +695,8 @@ enum {
 
   SEQ_CACHE_PREFETCH_ENABLE = (1 << 10),
   SEQ_CACHE_DISK_CACHE_ENABLE = (1 << 11),
+  /* Store float images with half precision. */
+  SEQ_CACHE_HALF_FLOAT = (1 << 12),
 };
 
 #ifdef __cplusplus
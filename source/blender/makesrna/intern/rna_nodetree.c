@@ -11046,6 +11046,13 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
                            "Use two pass execution during editing: first calculate fast nodes, "
                            "second pass calculate all nodes");
 
+  prop = RNA_def_property(srna, "use_full_frame", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_FULL_FRAME);
+  RNA_def_property_ui_text(prop,
+                           "Full Frame",
+                           "Execute nodes one after the other on full frame buffers instead of "
+                           "per tile, when all nodes of the tree support it");
+
   prop = RNA_def_property(srna, "use_viewer_border", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_VIEWER_BORDER);
   RNA_def_property_ui_text(
@@ -2095,6 +2095,14 @@ static void rna_def_editor(BlenderRNA *brna)
   RNA_def_property_boolean_sdna(prop, NULL, "cache_flag", SEQ_CACHE_STORE_FINAL_OUT);
   RNA_def_property_ui_text(prop, "Cache Final", "Cache final image for each frame");
 
+  prop = RNA_def_property(srna, "use_cache_half_float", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "cache_flag", SEQ_CACHE_HALF_FLOAT);
+  RNA_def_property_ui_text(prop,
+                           "Half Float",
+                           "Store float images with half precision in the memory and disk "
+                           "cache, fitting twice as many frames at the cost of precision");
+  RNA_def_property_update(prop, NC_SCENE | ND_SEQUENCER, NULL);
+
   prop = RNA_def_property(srna, "use_prefetch", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "cache_flag", SEQ_CACHE_PREFETCH_ENABLE);
   RNA_def_property_ui_text(
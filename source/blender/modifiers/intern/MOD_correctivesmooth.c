@@ -43,6 +43,8 @@
 #include "BKE_editmesh.h"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
+#include "BKE_mesh_runtime.h"
 #include "BKE_mesh_wrapper.h"
 #include "BKE_screen.h"
 
@@ -144,37 +146,22 @@ static void mesh_get_weights(MDeformVert *dvert,
   }
 }
 
-static void mesh_get_boundaries(Mesh *mesh, float *smooth_weights)
+static void mesh_get_boundaries(Mesh *mesh, Mesh *topology_mesh, float *smooth_weights)
 {
-  const MPoly *mpoly = mesh->mpoly;
-  const MLoop *mloop = mesh->mloop;
   const MEdge *medge = mesh->medge;
-  uint mpoly_num, medge_num, i;
-  ushort *boundaries;
-
-  mpoly_num = (uint)mesh->totpoly;
-  medge_num = (uint)mesh->totedge;
+  const uint medge_num = (uint)mesh->totedge;
+  uint i;
 
-  boundaries = MEM_calloc_arrayN(medge_num, sizeof(*boundaries), __func__);
-
-  /* count the number of adjacent faces */
-  for (i = 0; i < mpoly_num; i++) {
-    const MPoly *p = &mpoly[i];
-    const int totloop = p->totloop;
-    int j;
-    for (j = 0; j < totloop; j++) {
-      boundaries[mloop[p->loopstart + j].e]++;
-    }
-  }
+  /* the number of adjacent faces of each edge */
+  const MeshElemMap *edge_polys = BKE_mesh_runtime_topology_map_ensure(
+      topology_mesh, MESH_TOPOLOGY_MAP_EDGE_POLY);
 
   for (i = 0; i < medge_num; i++) {
-    if (boundaries[i] == 1) {
+    if (edge_polys[i].count == 1) {
       smooth_weights[medge[i].v1] = 0.0f;
       smooth_weights[medge[i].v2] = 0.0f;
     }
   }
-
-  MEM_freeN(boundaries);
 }
 
 /* -------------------------------------------------------------------- */
@@ -184,6 +171,7 @@ static void mesh_get_boundaries(Mesh *mesh, float *smooth_weights)
  */
 static void smooth_iter__simple(CorrectiveSmoothModifierData *csmd,
                                 Mesh *mesh,
+                                const MeshElemMap *vert_edges,
                                 float (*vertexCos)[3],
                                 uint numVerts,
                                 const float *smooth_weights,
@@ -200,12 +188,11 @@ static void smooth_iter__simple(CorrectiveSmoothModifierData *csmd,
     float delta[3];
   } *smooth_data = MEM_calloc_arrayN(numVerts, sizeof(*smooth_data), __func__);
 
-  vertex_edge_count_div = MEM_calloc_arrayN(numVerts, sizeof(float), __func__);
+  vertex_edge_count_div = MEM_malloc_arrayN(numVerts, sizeof(float), __func__);
 
   /* calculate as floats to avoid int->float conversion in #smooth_iter */
-  for (i = 0; i < numEdges; i++) {
-    vertex_edge_count_div[edges[i].v1] += 1.0f;
-    vertex_edge_count_div[edges[i].v2] += 1.0f;
+  for (i = 0; i < numVerts; i++) {
+    vertex_edge_count_div[i] = (float)vert_edges[i].count;
   }
 
   /* a little confusing, but we can include 'lambda' and smoothing weight
@@ -260,6 +247,7 @@ static void smooth_iter__simple(CorrectiveSmoothModifierData *csmd,
  */
 static void smooth_iter__length_weight(CorrectiveSmoothModifierData *csmd,
                                        Mesh *mesh,
+                                       const MeshElemMap *vert_edges,
                                        float (*vertexCos)[3],
                                        uint numVerts,
                                        const float *smooth_weights,
@@ -280,10 +268,9 @@ static void smooth_iter__length_weight(CorrectiveSmoothModifierData *csmd,
   } *smooth_data = MEM_calloc_arrayN(numVerts, sizeof(*smooth_data), __func__);
 
   /* calculate as floats to avoid int->float conversion in #smooth_iter */
-  vertex_edge_count = MEM_calloc_arrayN(numVerts, sizeof(float), __func__);
-  for (i = 0; i < numEdges; i++) {
-    vertex_edge_count[edges[i].v1] += 1.0f;
-    vertex_edge_count[edges[i].v2] += 1.0f;
+  vertex_edge_count = MEM_malloc_arrayN(numVerts, sizeof(float), __func__);
+  for (i = 0; i < numVerts; i++) {
+    vertex_edge_count[i] = (float)vert_edges[i].count;
   }
 
   /* -------------------------------------------------------------------- */
@@ -354,6 +341,7 @@ static void smooth_iter__length_weight(CorrectiveSmoothModifierData *csmd,
 
 static void smooth_iter(CorrectiveSmoothModifierData *csmd,
                         Mesh *mesh,
+                        const MeshElemMap *vert_edges,
                         float (*vertexCos)[3],
                         uint numVerts,
                         const float *smooth_weights,
@@ -361,18 +349,20 @@ static void smooth_iter(CorrectiveSmoothModifierData *csmd,
 {
   switch (csmd->smooth_type) {
     case MOD_CORRECTIVESMOOTH_SMOOTH_LENGTH_WEIGHT:
-      smooth_iter__length_weight(csmd, mesh, vertexCos, numVerts, smooth_weights, iterations);
+      smooth_iter__length_weight(
+          csmd, mesh, vert_edges, vertexCos, numVerts, smooth_weights, iterations);
       break;
 
     /* case MOD_CORRECTIVESMOOTH_SMOOTH_SIMPLE: */
     default:
-      smooth_iter__simple(csmd, mesh, vertexCos, numVerts, smooth_weights, iterations);
+      smooth_iter__simple(csmd, mesh, vert_edges, vertexCos, numVerts, smooth_weights, iterations);
       break;
   }
 }
 
 static void smooth_verts(CorrectiveSmoothModifierData *csmd,
                          Mesh *mesh,
+                         Mesh *topology_mesh,
                          MDeformVert *dvert,
                          const int defgrp_index,
                          float (*vertexCos)[3],
@@ -396,11 +386,14 @@ static void smooth_verts(CorrectiveSmoothModifierData *csmd,
     }
 
     if (csmd->flag & MOD_CORRECTIVESMOOTH_PIN_BOUNDARY) {
-      mesh_get_boundaries(mesh, smooth_weights);
+      mesh_get_boundaries(mesh, topology_mesh, smooth_weights);
     }
   }
 
-  smooth_iter(csmd, mesh, vertexCos, numVerts, smooth_weights, (uint)csmd->repeat);
+  const MeshElemMap *vert_edges = BKE_mesh_runtime_topology_map_ensure(
+      topology_mesh, MESH_TOPOLOGY_MAP_VERT_EDGE);
+
+  smooth_iter(csmd, mesh, vert_edges, vertexCos, numVerts, smooth_weights, (uint)csmd->repeat);
 
   if (smooth_weights) {
     MEM_freeN(smooth_weights);
@@ -534,6 +527,7 @@ static bool cache_settings_equal(CorrectiveSmoothModifierData *csmd)
  */
 static void calc_deltas(CorrectiveSmoothModifierData *csmd,
                         Mesh *mesh,
+                        Mesh *topology_mesh,
                         MDeformVert *dvert,
                         const int defgrp_index,
                         const float (*rest_coords)[3],
@@ -555,7 +549,7 @@ static void calc_deltas(CorrectiveSmoothModifierData *csmd,
     csmd->delta_cache.deltas = MEM_malloc_arrayN(numVerts, sizeof(float[3]), __func__);
   }
 
-  smooth_verts(csmd, mesh, dvert, defgrp_index, smooth_vertex_coords, numVerts);
+  smooth_verts(csmd, mesh, topology_mesh, dvert, defgrp_index, smooth_vertex_coords, numVerts);
 
   calc_tangent_spaces(mesh, smooth_vertex_coords, tangent_spaces);
 
@@ -599,6 +593,9 @@ static void correctivesmooth_modifier_do(ModifierData *md,
 
   MOD_get_vgroup(ob, mesh, csmd->defgrp_name, &dvert, &defgrp_index);
 
+  /* Mesh the topology dependent data is cached on, shared with other modifiers. */
+  Mesh *topology_mesh = MOD_topology_cache_mesh_get(ob, mesh);
+
   /* if rest bind_coords not are defined, set them (only run during bind) */
   if ((csmd->rest_source == MOD_CORRECTIVESMOOTH_RESTSOURCE_BIND) &&
       /* signal to recalculate, whoever sets MUST also free bind coords */
@@ -620,7 +617,7 @@ static void correctivesmooth_modifier_do(ModifierData *md,
   }
 
   if (UNLIKELY(use_only_smooth)) {
-    smooth_verts(csmd, mesh, dvert, defgrp_index, vertexCos, numVerts);
+    smooth_verts(csmd, mesh, topology_mesh, dvert, defgrp_index, vertexCos, numVerts);
     return;
   }
 
@@ -680,7 +677,7 @@ static void correctivesmooth_modifier_do(ModifierData *md,
     TIMEIT_START(corrective_smooth_deltas);
 #endif
 
-    calc_deltas(csmd, mesh, dvert, defgrp_index, rest_coords, numVerts);
+    calc_deltas(csmd, mesh, topology_mesh, dvert, defgrp_index, rest_coords, numVerts);
 
 #ifdef DEBUG_TIME
     TIMEIT_END(corrective_smooth_deltas);
@@ -700,7 +697,7 @@ static void correctivesmooth_modifier_do(ModifierData *md,
 #endif
 
   /* do the actual delta mush */
-  smooth_verts(csmd, mesh, dvert, defgrp_index, vertexCos, numVerts);
+  smooth_verts(csmd, mesh, topology_mesh, dvert, defgrp_index, vertexCos, numVerts);
 
   {
     uint i;
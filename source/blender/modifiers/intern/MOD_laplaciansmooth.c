@@ -40,6 +40,8 @@
 #include "BKE_editmesh.h"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
+#include "BKE_mesh_runtime.h"
 #include "BKE_mesh_wrapper.h"
 #include "BKE_modifier.h"
 #include "BKE_screen.h"
@@ -64,10 +66,12 @@ struct BLaplacianSystem {
   int numLoops;         /* Number of edges*/
   int numPolys;         /* Number of faces*/
   int numVerts;         /* Number of verts*/
-  short *numNeFa;       /* Number of neighbors faces around vertice*/
-  short *numNeEd;       /* Number of neighbors Edges around vertice*/
   short *zerola;        /* Is zero area or length*/
 
+  /* Topology maps cached on the mesh, the counts are the number of neighbors around vertices */
+  const MeshElemMap *vert_loops; /* Faces around vertice */
+  const MeshElemMap *vert_edges; /* Edges around vertice */
+
   /* Pointers to data*/
   float (*vertexCos)[3];
   const MPoly *mpoly;
@@ -104,8 +108,6 @@ static void delete_laplacian_system(LaplacianSystem *sys)
 {
   MEM_SAFE_FREE(sys->eweights);
   MEM_SAFE_FREE(sys->fweights);
-  MEM_SAFE_FREE(sys->numNeEd);
-  MEM_SAFE_FREE(sys->numNeFa);
   MEM_SAFE_FREE(sys->ring_areas);
   MEM_SAFE_FREE(sys->vlengths);
   MEM_SAFE_FREE(sys->vweights);
@@ -125,8 +127,6 @@ static void memset_laplacian_system(LaplacianSystem *sys, int val)
 {
   memset(sys->eweights, val, sizeof(float) * sys->numEdges);
   memset(sys->fweights, val, sizeof(float[3]) * sys->numLoops);
-  memset(sys->numNeEd, val, sizeof(short) * sys->numVerts);
-  memset(sys->numNeFa, val, sizeof(short) * sys->numVerts);
   memset(sys->ring_areas, val, sizeof(float) * sys->numVerts);
   memset(sys->vlengths, val, sizeof(float) * sys->numVerts);
   memset(sys->vweights, val, sizeof(float) * sys->numVerts);
@@ -147,8 +147,6 @@ static LaplacianSystem *init_laplacian_system(int a_numEdges,
 
   sys->eweights = MEM_calloc_arrayN(sys->numEdges, sizeof(float), __func__);
   sys->fweights = MEM_calloc_arrayN(sys->numLoops, sizeof(float[3]), __func__);
-  sys->numNeEd = MEM_calloc_arrayN(sys->numVerts, sizeof(short), __func__);
-  sys->numNeFa = MEM_calloc_arrayN(sys->numVerts, sizeof(short), __func__);
   sys->ring_areas = MEM_calloc_arrayN(sys->numVerts, sizeof(float), __func__);
   sys->vlengths = MEM_calloc_arrayN(sys->numVerts, sizeof(float), __func__);
   sys->vweights = MEM_calloc_arrayN(sys->numVerts, sizeof(float), __func__);
@@ -206,6 +204,12 @@ static void volume_preservation(LaplacianSystem *sys, float vini, float vend, sh
   }
 }
 
+/* Vertices with less faces than edges around them are on a boundary. */
+BLI_INLINE bool laplacian_vert_is_boundary(const LaplacianSystem *sys, const uint v)
+{
+  return sys->vert_edges[v].count != sys->vert_loops[v].count;
+}
+
 static void init_laplacian_matrix(LaplacianSystem *sys)
 {
   float *v1, *v2;
@@ -221,8 +225,6 @@ static void init_laplacian_matrix(LaplacianSystem *sys)
     v1 = sys->vertexCos[idv1];
     v2 = sys->vertexCos[idv2];
 
-    sys->numNeEd[idv1] = sys->numNeEd[idv1] + 1;
-    sys->numNeEd[idv2] = sys->numNeEd[idv2] + 1;
     w1 = len_v3v3(v1, v2);
     if (w1 < sys->min_area) {
       sys->zerola[idv1] = 1;
@@ -248,8 +250,6 @@ static void init_laplacian_matrix(LaplacianSystem *sys)
       const float *v_next = sys->vertexCos[l_next->v];
       const uint l_curr_index = l_curr - sys->mloop;
 
-      sys->numNeFa[l_curr->v] += 1;
-
       areaf = area_tri_v3(v_prev, v_curr, v_next);
 
       if (areaf < sys->min_area) {
@@ -277,7 +277,7 @@ static void init_laplacian_matrix(LaplacianSystem *sys)
     idv1 = sys->medges[i].v1;
     idv2 = sys->medges[i].v2;
     /* if is boundary, apply scale-dependent umbrella operator only with neighbors in boundary */
-    if (sys->numNeEd[idv1] != sys->numNeFa[idv1] && sys->numNeEd[idv2] != sys->numNeFa[idv2]) {
+    if (laplacian_vert_is_boundary(sys, idv1) && laplacian_vert_is_boundary(sys, idv2)) {
       sys->vlengths[idv1] += sys->eweights[i];
       sys->vlengths[idv2] += sys->eweights[i];
     }
@@ -300,7 +300,7 @@ static void fill_laplacian_matrix(LaplacianSystem *sys)
       const uint l_curr_index = l_curr - sys->mloop;
 
       /* Is ring if number of faces == number of edges around vertice*/
-      if (sys->numNeEd[l_curr->v] == sys->numNeFa[l_curr->v] && sys->zerola[l_curr->v] == 0) {
+      if (!laplacian_vert_is_boundary(sys, l_curr->v) && sys->zerola[l_curr->v] == 0) {
         EIG_linear_solver_matrix_add(sys->context,
                                      l_curr->v,
                                      l_next->v,
@@ -310,7 +310,7 @@ static void fill_laplacian_matrix(LaplacianSystem *sys)
                                      l_prev->v,
                                      sys->fweights[l_curr_index][1] * sys->vweights[l_curr->v]);
       }
-      if (sys->numNeEd[l_next->v] == sys->numNeFa[l_next->v] && sys->zerola[l_next->v] == 0) {
+      if (!laplacian_vert_is_boundary(sys, l_next->v) && sys->zerola[l_next->v] == 0) {
         EIG_linear_solver_matrix_add(sys->context,
                                      l_next->v,
                                      l_curr->v,
@@ -320,7 +320,7 @@ static void fill_laplacian_matrix(LaplacianSystem *sys)
                                      l_prev->v,
                                      sys->fweights[l_curr_index][0] * sys->vweights[l_next->v]);
       }
-      if (sys->numNeEd[l_prev->v] == sys->numNeFa[l_prev->v] && sys->zerola[l_prev->v] == 0) {
+      if (!laplacian_vert_is_boundary(sys, l_prev->v) && sys->zerola[l_prev->v] == 0) {
         EIG_linear_solver_matrix_add(sys->context,
                                      l_prev->v,
                                      l_curr->v,
@@ -337,7 +337,7 @@ static void fill_laplacian_matrix(LaplacianSystem *sys)
     idv1 = sys->medges[i].v1;
     idv2 = sys->medges[i].v2;
     /* Is boundary */
-    if (sys->numNeEd[idv1] != sys->numNeFa[idv1] && sys->numNeEd[idv2] != sys->numNeFa[idv2] &&
+    if (laplacian_vert_is_boundary(sys, idv1) && laplacian_vert_is_boundary(sys, idv2) &&
         sys->zerola[idv1] == 0 && sys->zerola[idv2] == 0) {
       EIG_linear_solver_matrix_add(
           sys->context, idv1, idv2, sys->eweights[i] * sys->vlengths[idv1]);
@@ -359,8 +359,8 @@ static void validate_solution(LaplacianSystem *sys, short flag, float lambda, fl
   }
   for (i = 0; i < sys->numVerts; i++) {
     if (sys->zerola[i] == 0) {
-      lam = sys->numNeEd[i] == sys->numNeFa[i] ? (lambda >= 0.0f ? 1.0f : -1.0f) :
-                                                 (lambda_border >= 0.0f ? 1.0f : -1.0f);
+      lam = !laplacian_vert_is_boundary(sys, i) ? (lambda >= 0.0f ? 1.0f : -1.0f) :
+                                                  (lambda_border >= 0.0f ? 1.0f : -1.0f);
       if (flag & MOD_LAPLACIANSMOOTH_X) {
         sys->vertexCos[i][0] += lam * ((float)EIG_linear_solver_variable_get(sys->context, 0, i) -
                                        sys->vertexCos[i][0]);
@@ -403,6 +403,13 @@ static void laplaciansmoothModifier_do(
   sys->medges = mesh->medge;
   sys->vertexCos = vertexCos;
   sys->min_area = 0.00001f;
+
+  Mesh *topology_mesh = MOD_topology_cache_mesh_get(ob, mesh);
+  sys->vert_edges = BKE_mesh_runtime_topology_map_ensure(topology_mesh,
+                                                         MESH_TOPOLOGY_MAP_VERT_EDGE);
+  sys->vert_loops = BKE_mesh_runtime_topology_map_ensure(topology_mesh,
+                                                         MESH_TOPOLOGY_MAP_VERT_LOOP);
+
   MOD_get_vgroup(ob, mesh, smd->defgrp_name, &dvert, &defgrp_index);
 
   sys->vert_centroid[0] = 0.0f;
@@ -448,7 +455,7 @@ static void laplaciansmoothModifier_do(
             sys->vweights[i] = (w == 0.0f) ? 0.0f : -fabsf(smd->lambda) * wpaint / w;
             w = sys->vlengths[i];
             sys->vlengths[i] = (w == 0.0f) ? 0.0f : -fabsf(smd->lambda_border) * wpaint * 2.0f / w;
-            if (sys->numNeEd[i] == sys->numNeFa[i]) {
+            if (!laplacian_vert_is_boundary(sys, i)) {
               EIG_linear_solver_matrix_add(sys->context, i, i, 1.0f + fabsf(smd->lambda) * wpaint);
             }
             else {
@@ -462,7 +469,7 @@ static void laplaciansmoothModifier_do(
             w = sys->vlengths[i];
             sys->vlengths[i] = (w == 0.0f) ? 0.0f : -fabsf(smd->lambda_border) * wpaint * 2.0f / w;
 
-            if (sys->numNeEd[i] == sys->numNeFa[i]) {
+            if (!laplacian_vert_is_boundary(sys, i)) {
               EIG_linear_solver_matrix_add(sys->context,
                                            i,
                                            i,
@@ -495,65 +495,94 @@ static void deformVertsEM(ModifierData *md,
 
 #define MESHDEFORM_MIN_INFLUENCE 0.00001f
 
-void BKE_modifier_mdef_compact_influences(ModifierData *md)
+typedef struct MeshDeformCompactData {
+  MeshDeformModifierData *mmd;
+  const float *weights;
+} MeshDeformCompactData;
+
+static void meshdeform_compact_count_task(void *__restrict userdata,
+                                          const int b,
+                                          const TaskParallelTLS *__restrict UNUSED(tls))
 {
-  MeshDeformModifierData *mmd = (MeshDeformModifierData *)md;
-  float weight, *weights, totweight;
-  int totinfluence, totvert, totcagevert, a, b;
+  MeshDeformCompactData *data = userdata;
+  const int totcagevert = data->mmd->totcagevert;
+  const float *weights = data->weights + b * totcagevert;
+  int totinfluence = 0;
 
-  weights = mmd->bindweights;
-  if (!weights) {
-    return;
+  /* count number of influences above threshold */
+  for (int a = 0; a < totcagevert; a++) {
+    if (weights[a] > MESHDEFORM_MIN_INFLUENCE) {
+      totinfluence++;
+    }
   }
 
-  totvert = mmd->totvert;
-  totcagevert = mmd->totcagevert;
+  data->mmd->bindoffsets[b] = totinfluence;
+}
 
-  /* count number of influences above threshold */
-  for (b = 0; b < totvert; b++) {
-    for (a = 0; a < totcagevert; a++) {
-      weight = weights[a + b * totcagevert];
+static void meshdeform_compact_write_task(void *__restrict userdata,
+                                          const int b,
+                                          const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  MeshDeformCompactData *data = userdata;
+  const int totcagevert = data->mmd->totcagevert;
+  const float *weights = data->weights + b * totcagevert;
+  MDefInfluence *influence = data->mmd->bindinfluences + data->mmd->bindoffsets[b];
+  float totweight = 0.0f;
+
+  /* sum total weight */
+  for (int a = 0; a < totcagevert; a++) {
+    if (weights[a] > MESHDEFORM_MIN_INFLUENCE) {
+      totweight += weights[a];
+    }
+  }
 
-      if (weight > MESHDEFORM_MIN_INFLUENCE) {
-        mmd->totinfluence++;
-      }
+  /* assign weights normalized */
+  for (int a = 0; a < totcagevert; a++) {
+    if (weights[a] > MESHDEFORM_MIN_INFLUENCE) {
+      influence->weight = weights[a] / totweight;
+      influence->vertex = a;
+      influence++;
     }
   }
+}
 
-  /* allocate bind influences */
-  mmd->bindinfluences = MEM_calloc_arrayN(
-      mmd->totinfluence, sizeof(MDefInfluence), "MDefBindInfluence");
-  mmd->bindoffsets = MEM_calloc_arrayN((totvert + 1), sizeof(int), "MDefBindOffset");
+void BKE_modifier_mdef_compact_influences(ModifierData *md)
+{
+  MeshDeformModifierData *mmd = (MeshDeformModifierData *)md;
+  const float *weights = mmd->bindweights;
+  int totvert, b;
 
-  /* write influences */
-  totinfluence = 0;
+  if (!weights) {
+    return;
+  }
 
-  for (b = 0; b < totvert; b++) {
-    mmd->bindoffsets[b] = totinfluence;
-    totweight = 0.0f;
+  totvert = mmd->totvert;
 
-    /* sum total weight */
-    for (a = 0; a < totcagevert; a++) {
-      weight = weights[a + b * totcagevert];
+  MeshDeformCompactData data = {
+      .mmd = mmd,
+      .weights = weights,
+  };
 
-      if (weight > MESHDEFORM_MIN_INFLUENCE) {
-        totweight += weight;
-      }
-    }
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
 
-    /* assign weights normalized */
-    for (a = 0; a < totcagevert; a++) {
-      weight = weights[a + b * totcagevert];
+  /* count influences of each vertex, then turn the counts into offsets */
+  mmd->bindoffsets = MEM_calloc_arrayN((totvert + 1), sizeof(int), "MDefBindOffset");
+  BLI_task_parallel_range(0, totvert, &data, meshdeform_compact_count_task, &settings);
 
-      if (weight > MESHDEFORM_MIN_INFLUENCE) {
-        mmd->bindinfluences[totinfluence].weight = weight / totweight;
-        mmd->bindinfluences[totinfluence].vertex = a;
-        totinfluence++;
-      }
-    }
+  mmd->totinfluence = 0;
+  for (b = 0; b < totvert; b++) {
+    const int totinfluence = mmd->bindoffsets[b];
+    mmd->bindoffsets[b] = mmd->totinfluence;
+    mmd->totinfluence += totinfluence;
   }
+  mmd->bindoffsets[b] = mmd->totinfluence;
 
-  mmd->bindoffsets[b] = totinfluence;
+  /* allocate and write bind influences */
+  mmd->bindinfluences = MEM_calloc_arrayN(
+      mmd->totinfluence, sizeof(MDefInfluence), "MDefBindInfluence");
+  BLI_task_parallel_range(0, totvert, &data, meshdeform_compact_write_task, &settings);
 
   /* free */
   MEM_freeN(mmd->bindweights);
@@ -40,6 +40,8 @@
 #include "BKE_editmesh.h"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
+#include "BKE_mesh_runtime.h"
 #include "BKE_mesh_wrapper.h"
 #include "BKE_particle.h"
 #include "BKE_screen.h"
@@ -103,12 +105,9 @@ static void smoothModifier_do(
     return;
   }
 
-  uint *num_accumulated_vecs = MEM_calloc_arrayN(
-      (size_t)numVerts, sizeof(*num_accumulated_vecs), __func__);
-  if (!num_accumulated_vecs) {
-    MEM_freeN(accumulated_vecs);
-    return;
-  }
+  /* The number of edges of each vertex only depends on the topology, use the cached map. */
+  const MeshElemMap *vert_edges = BKE_mesh_runtime_topology_map_ensure(
+      MOD_topology_cache_mesh_get(ob, mesh), MESH_TOPOLOGY_MAP_VERT_EDGE);
 
   const float fac_new = smd->fac;
   const float fac_orig = 1.0f - fac_new;
@@ -124,7 +123,6 @@ static void smoothModifier_do(
   for (int j = 0; j < smd->repeat; j++) {
     if (j != 0) {
       memset(accumulated_vecs, 0, sizeof(*accumulated_vecs) * (size_t)numVerts);
-      memset(num_accumulated_vecs, 0, sizeof(*num_accumulated_vecs) * (size_t)numVerts);
     }
 
     for (int i = 0; i < num_edges; i++) {
@@ -134,10 +132,7 @@ static void smoothModifier_do(
 
       mid_v3_v3v3(fvec, vertexCos[idx1], vertexCos[idx2]);
 
-      num_accumulated_vecs[idx1]++;
       add_v3_v3(accumulated_vecs[idx1], fvec);
-
-      num_accumulated_vecs[idx2]++;
       add_v3_v3(accumulated_vecs[idx2], fvec);
     }
 
@@ -146,8 +141,8 @@ static void smoothModifier_do(
       MDeformVert *dv = dvert;
       for (int i = 0; i < numVerts; i++, dv++) {
         float *vco_orig = vertexCos[i];
-        if (num_accumulated_vecs[i] > 0) {
-          mul_v3_fl(accumulated_vecs[i], 1.0f / (float)num_accumulated_vecs[i]);
+        if (vert_edges[i].count > 0) {
+          mul_v3_fl(accumulated_vecs[i], 1.0f / (float)vert_edges[i].count);
         }
         float *vco_new = accumulated_vecs[i];
 
@@ -173,8 +168,8 @@ static void smoothModifier_do(
     else { /* no vertex group */
       for (int i = 0; i < numVerts; i++) {
         float *vco_orig = vertexCos[i];
-        if (num_accumulated_vecs[i] > 0) {
-          mul_v3_fl(accumulated_vecs[i], 1.0f / (float)num_accumulated_vecs[i]);
+        if (vert_edges[i].count > 0) {
+          mul_v3_fl(accumulated_vecs[i], 1.0f / (float)vert_edges[i].count);
         }
         float *vco_new = accumulated_vecs[i];
 
@@ -192,7 +187,6 @@ static void smoothModifier_do(
   }
 
   MEM_freeN(accumulated_vecs);
-  MEM_freeN(num_accumulated_vecs);
 }
 
 static void deformVerts(ModifierData *md,
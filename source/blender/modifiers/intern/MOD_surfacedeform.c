@@ -1235,9 +1235,10 @@ static bool surfacedeformBind(Object *ob,
     mul_v3_m4v3(data.targetCos[i], smd_orig->mat, mvert[i].co);
   }
 
+  /* Binding a vertex takes much longer than deforming it, so thread even small meshes. */
   TaskParallelSettings settings;
   BLI_parallel_range_settings_defaults(&settings);
-  settings.use_threading = (numverts > 10000);
+  settings.min_iter_per_thread = 16;
   BLI_task_parallel_range(0, numverts, &data, bindVert, &settings);
 
   MEM_freeN(data.targetCos);
@@ -251,6 +251,30 @@ Mesh *MOD_deform_mesh_eval_get(Object *ob,
   return mesh;
 }
 
+/**
+ * Mesh to use for #BKE_mesh_runtime_topology_map_ensure. The mesh passed to a modifier is often a
+ * temporary copy referencing the topology of the evaluated object data, in that case the object
+ * data is returned, so the cached maps are shared with other modifiers and kept between
+ * evaluations.
+ */
+Mesh *MOD_topology_cache_mesh_get(Object *ob, Mesh *mesh)
+{
+  if (mesh == NULL || ob->type != OB_MESH || !DEG_is_evaluated_object(ob)) {
+    return mesh;
+  }
+  Mesh *mesh_data = (ob->runtime.data_orig != NULL) ? (Mesh *)ob->runtime.data_orig : ob->data;
+  if (mesh_data == NULL || mesh_data == mesh) {
+    return mesh;
+  }
+  if (mesh_data->medge == mesh->medge && mesh_data->mpoly == mesh->mpoly &&
+      mesh_data->mloop == mesh->mloop && mesh_data->totvert == mesh->totvert &&
+      mesh_data->totedge == mesh->totedge && mesh_data->totpoly == mesh->totpoly &&
+      mesh_data->totloop == mesh->totloop) {
+    return mesh_data;
+  }
+  return mesh;
+}
+
 void MOD_get_vgroup(
     Object *ob, struct Mesh *mesh, const char *name, MDeformVert **dvert, int *defgrp_index)
 {
@@ -49,6 +49,8 @@ struct Mesh *MOD_deform_mesh_eval_get(struct Object *ob,
                                       const bool use_normals,
                                       const bool use_orco);
 
+struct Mesh *MOD_topology_cache_mesh_get(struct Object *ob, struct Mesh *mesh);
+
 void MOD_get_vgroup(struct Object *ob,
                     struct Mesh *mesh,
                     const char *name,
@@ -32,9 +32,14 @@ struct Main;
 struct Scene;
 struct Sequence;
 
+/* Maximum number of threads rendering frames ahead of the current frame. */
+#define SEQ_PREFETCH_MAX_WORKERS 4
+
 typedef enum eSeqTaskId {
   SEQ_TASK_MAIN_RENDER,
+  /* Each prefetch worker uses its own ID, starting with this one. */
   SEQ_TASK_PREFETCH_RENDER,
+  SEQ_TASK_MAX = SEQ_TASK_PREFETCH_RENDER + SEQ_PREFETCH_MAX_WORKERS,
 } eSeqTaskId;
 
 typedef struct SeqRenderData {
@@ -3411,6 +3411,16 @@ static int early_out_gaussian_blur(Sequence *seq, float UNUSED(facf0), float UNU
   return EARLY_DO_EFFECT;
 }
 
+/* Blurs from this size on use the recursive gaussian of imbuf, whose cost doesn't grow with the
+ * size, instead of the convolution below. */
+#define GAUSSIAN_BLUR_RECURSIVE_MIN_SIZE 32.0f
+
+static bool gaussian_blur_use_recursive(const GaussianBlurVars *data)
+{
+  return (data->size_x == 0.0f || data->size_x >= GAUSSIAN_BLUR_RECURSIVE_MIN_SIZE) &&
+         (data->size_y == 0.0f || data->size_y >= GAUSSIAN_BLUR_RECURSIVE_MIN_SIZE);
+}
+
 /* TODO(sergey): De-duplicate with compositor. */
 static float *make_gaussian_blur_kernel(float rad, int size)
 {
@@ -3764,6 +3774,19 @@ static ImBuf *do_gaussian_blur_effect(const SeqRenderData *context,
 {
   ImBuf *out = prepare_effect_imbufs(context, ibuf1, NULL, NULL);
 
+  if (gaussian_blur_use_recursive(seq->effectdata)) {
+    GaussianBlurVars *data = seq->effectdata;
+    if (out->rect_float) {
+      memcpy(out->rect_float, ibuf1->rect_float, sizeof(float[4]) * out->x * out->y);
+    }
+    else {
+      memcpy(out->rect, ibuf1->rect, sizeof(*out->rect) * out->x * out->y);
+    }
+    /* Same standard deviation as the kernel of make_gaussian_blur_kernel. */
+    IMB_gaussian_blur(out, data->size_x / 3.0f, data->size_y / 3.0f);
+    return out;
+  }
+
   RenderGaussianBlurEffectInitData init_data;
 
   init_data.context = context;
@@ -3795,6 +3818,8 @@ static ImBuf *do_gaussian_blur_effect(const SeqRenderData *context,
 
 /*********************** text *************************/
 
+static ThreadMutex text_effect_font_mutex = BLI_MUTEX_INITIALIZER;
+
 static void init_text_effect(Sequence *seq)
 {
   TextVars *data;
@@ -3917,6 +3942,9 @@ static ImBuf *do_text_effect(const SeqRenderData *context,
   int y_ofs, x, y;
   double proxy_size_comp;
 
+  /* Fonts keep their size and buffer as state, prefetch workers can draw text concurrently. */
+  BLI_mutex_lock(&text_effect_font_mutex);
+
   if (data->text_blf_id == SEQ_FONT_NOT_LOADED) {
     data->text_blf_id = -1;
 
@@ -4030,6 +4058,8 @@ static ImBuf *do_text_effect(const SeqRenderData *context,
 
   BLF_disable(font, BLF_WORD_WRAP);
 
+  BLI_mutex_unlock(&text_effect_font_mutex);
+
   return out;
 }
 
@@ -24,8 +24,16 @@
 #include <stddef.h>
 #include <time.h>
 
+#ifdef __F16C__
+#  include <immintrin.h>
+#endif
+
+#include "CLG_log.h"
+
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h" /* for FILE_MAX. */
@@ -33,6 +41,7 @@
 #include "IMB_colormanagement.h"
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
+#include "IMB_metadata.h"
 
 #include "BLI_blenlib.h"
 #include "BLI_endian_switch.h"
@@ -42,8 +51,11 @@
 #include "BLI_listbase.h"
 #include "BLI_mempool.h"
 #include "BLI_path_util.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
+#include "PIL_time.h"
+
 #include "BKE_global.h"
 #include "BKE_main.h"
 #include "BKE_scene.h"
@@ -57,6 +69,16 @@
 #include "prefetch.h"
 #include "strip_time.h"
 
+#ifdef WITH_LZO
+#  ifdef WITH_SYSTEM_LZO
+#    include <lzo/lzo1x.h>
+#  else
+#    include "minilzo.h"
+#  endif
+#endif
+
+static CLG_LogRef LOG = {"seq.disk_cache"};
+
 /**
  * Sequencer Cache Design Notes
  * ============================
@@ -89,24 +111,41 @@
  * For each cached non-temp image, image data and supplementary info are written to HDD.
  * Multiple(DCACHE_IMAGES_PER_FILE) images share the same file.
  * Each of these files contains header DiskCacheHeader followed by image data.
- * Zlib compression with user definable level can be used to compress image data(per image)
- * Images are written in order in which they are rendered.
+ * Image data is compressed per image with a codec chosen by the compression level in user
+ * preferences: none, LZO (fast, when available) or Zlib.
+ * Images are written in order in which they are rendered, by a background I/O thread. Images
+ * waiting to be written are still found by reads.
  * Overwriting of individual entry is not possible.
  * Stored images are deleted by invalidation, or when size of all files exceeds maximum
  * size specified in user preferences.
  * To distinguish 2 blend files with same name, scene->ed->disk_cache_timestamp
  * is used as UID. Blend file can still be copied manually which may cause conflict.
+ * Files are indexed in memory by path and ordered by last access, the cache directory is only
+ * scanned when the disk cache is created.
  *
  */
 
 /* <cache type>-<resolution X>x<resolution Y>-<rendersize>%(<view_id>)-<frame no>.dcf */
 #define DCACHE_FNAME_FORMAT "%d-%dx%d-%d%%(%d)-%d.dcf"
 #define DCACHE_IMAGES_PER_FILE 100
-#define DCACHE_CURRENT_VERSION 1
+#define DCACHE_CURRENT_VERSION 2
 #define COLORSPACE_NAME_MAX 64 /* XXX: defined in imb intern */
+/* Images waiting to be written, before renders wait for the I/O thread. */
+#define DCACHE_WRITE_QUEUE_MAX 8
+/* Don't update modification time of files more often when reading them (in seconds). */
+#define DCACHE_TOUCH_INTERVAL 60
+
+/* Codecs of #DiskCacheHeaderEntry.codec. */
+#define DCACHE_CODEC_ZLIB 0
+#define DCACHE_CODEC_LZO 1
+#define DCACHE_CODEC_NONE 2
+#define DCACHE_CODEC_NUM 3
+
+#define LZO_OUT_LEN(size) ((size) + (size) / 16 + 64 + 3)
 
 typedef struct DiskCacheHeaderEntry {
   unsigned char encoding;
+  unsigned char codec;
   uint64_t frameno;
   uint64_t size_compressed;
   uint64_t size_raw;
@@ -118,14 +157,44 @@ typedef struct DiskCacheHeader {
   DiskCacheHeaderEntry entry[DCACHE_IMAGES_PER_FILE];
 } DiskCacheHeader;
 
+typedef struct DiskCacheCodecStats {
+  uint64_t bytes_written;
+  uint64_t bytes_read;
+  double time_write;
+  double time_read;
+} DiskCacheCodecStats;
+
 typedef struct SeqDiskCache {
   Main *bmain;
   int64_t timestamp;
+  /* Least recently used file first. */
   ListBase files;
+  /* #DiskCacheFile by path. */
+  struct GHash *files_by_path;
   ThreadMutex read_write_mutex;
   size_t size_total;
+
+  /* #DiskCacheWrite items, written in order by the I/O thread. */
+  ListBase write_queue;
+  int write_queue_len;
+  ThreadMutex write_queue_mutex;
+  ThreadCondition write_queue_cond;
+  ListBase write_thread;
+  bool write_thread_stop;
+
+  /* Raw image data size and time spent per codec, logged when the cache is freed. */
+  DiskCacheCodecStats codec_stats[DCACHE_CODEC_NUM];
 } SeqDiskCache;
 
+typedef struct DiskCacheWrite {
+  struct DiskCacheWrite *next, *prev;
+  char path[FILE_MAX];
+  ImBuf *ibuf;
+  float frame_index;
+  int cache_type;
+  bool use_half_float;
+} DiskCacheWrite;
+
 typedef struct DiskCacheFile {
   struct DiskCacheFile *next, *prev;
   char path[FILE_MAX];
@@ -146,15 +215,28 @@ typedef struct SeqCache {
   ThreadMutex iterator_mutex;
   struct BLI_mempool *keys_pool;
   struct BLI_mempool *items_pool;
-  struct SeqCacheKey *last_key;
+  /* Last permanent key put by each task, for linking the items of the frame it renders. */
+  struct SeqCacheKey *last_key[SEQ_TASK_MAX];
   SeqDiskCache *disk_cache;
 } SeqCache;
 
 typedef struct SeqCacheItem {
   struct SeqCache *cache_owner;
+  /* Without pixels when they are stored in #rect_half. */
   struct ImBuf *ibuf;
+  /* Float pixels stored with half precision. */
+  unsigned short *rect_half;
+  /* Memory owned by the item, counted in #seq_cache_mem_used. Zero when it references `ibuf`,
+   * which is counted once for all items referencing it, see #seq_cache_ibuf_users. */
+  size_t size;
 } SeqCacheItem;
 
+/* Number of cache items referencing an image, and its memory when it was first stored. */
+typedef struct SeqCacheImBufUsers {
+  int users;
+  size_t size;
+} SeqCacheImBufUsers;
+
 typedef struct SeqCacheKey {
   struct SeqCache *cache_owner;
   void *userkey;
@@ -172,6 +254,13 @@ typedef struct SeqCacheKey {
 } SeqCacheKey;
 
 static ThreadMutex cache_create_lock = BLI_MUTEX_INITIALIZER;
+/* Memory used by the items of the caches of all scenes. */
+static size_t seq_cache_mem_used = 0;
+/* The same image can be stored as several cache types, for example as raw and preprocessed image
+ * of a strip without modifiers. Maps each stored ImBuf to its #SeqCacheImBufUsers, so its memory
+ * is counted only once. */
+static GHash *seq_cache_ibuf_users = NULL;
+static ThreadMutex seq_cache_ibuf_users_lock = BLI_MUTEX_INITIALIZER;
 static float seq_cache_timeline_frame_to_frame_index(Sequence *seq,
                                                      float timeline_frame,
                                                      int type);
@@ -227,6 +316,7 @@ static DiskCacheFile *seq_disk_cache_add_file_to_list(SeqDiskCache *disk_cache,
          &cache_file->start_frame);
   cache_file->start_frame *= DCACHE_IMAGES_PER_FILE;
   BLI_addtail(&disk_cache->files, cache_file);
+  BLI_ghash_insert(disk_cache->files_by_path, cache_file->path, cache_file);
   return cache_file;
 }
 
@@ -234,7 +324,6 @@ static void seq_disk_cache_get_files(SeqDiskCache *disk_cache, char *path)
 {
   struct direntry *filelist, *fl;
   uint nbr, i;
-  disk_cache->size_total = 0;
 
   i = nbr = BLI_filelist_dir_contents(path, &filelist);
   fl = filelist;
@@ -270,85 +359,77 @@ static void seq_disk_cache_get_files(SeqDiskCache *disk_cache, char *path)
   BLI_filelist_free(filelist, nbr);
 }
 
-static DiskCacheFile *seq_disk_cache_get_oldest_file(SeqDiskCache *disk_cache)
+static void seq_disk_cache_files_clear(SeqDiskCache *disk_cache)
 {
-  DiskCacheFile *oldest_file = disk_cache->files.first;
-  if (oldest_file == NULL) {
-    return NULL;
-  }
-  for (DiskCacheFile *cache_file = oldest_file->next; cache_file; cache_file = cache_file->next) {
-    if (cache_file->fstat.st_mtime < oldest_file->fstat.st_mtime) {
-      oldest_file = cache_file;
-    }
-  }
+  BLI_ghash_clear(disk_cache->files_by_path, NULL, NULL);
+  BLI_freelistN(&disk_cache->files);
+  disk_cache->size_total = 0;
+}
 
-  return oldest_file;
+static int seq_disk_cache_file_cmp_mtime(const void *a, const void *b)
+{
+  const DiskCacheFile *file_a = a;
+  const DiskCacheFile *file_b = b;
+  return file_a->fstat.st_mtime > file_b->fstat.st_mtime;
+}
+
+/* Build index of files in cache directory. */
+static void seq_disk_cache_scan(SeqDiskCache *disk_cache)
+{
+  seq_disk_cache_files_clear(disk_cache);
+  seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
+  BLI_listbase_sort(&disk_cache->files, seq_disk_cache_file_cmp_mtime);
 }
 
 static void seq_disk_cache_delete_file(SeqDiskCache *disk_cache, DiskCacheFile *file)
 {
   disk_cache->size_total -= file->fstat.st_size;
   BLI_delete(file->path, false, false);
+  BLI_ghash_remove(disk_cache->files_by_path, file->path, NULL, NULL);
   BLI_remlink(&disk_cache->files, file);
   MEM_freeN(file);
 }
 
-static bool seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache)
+/* Delete least recently used files until cache fits in size limit. Disk cache must be locked. */
+static void seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache)
 {
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
   while (disk_cache->size_total > seq_disk_cache_size_limit()) {
-    DiskCacheFile *oldest_file = seq_disk_cache_get_oldest_file(disk_cache);
+    DiskCacheFile *oldest_file = disk_cache->files.first;
 
     if (!oldest_file) {
       /* We shouldn't enforce limits with no files, do re-scan. */
-      seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
-      continue;
-    }
-
-    if (BLI_exists(oldest_file->path) == 0) {
-      /* File may have been manually deleted during runtime, do re-scan. */
-      BLI_freelistN(&disk_cache->files);
-      seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
+      seq_disk_cache_scan(disk_cache);
+      if (disk_cache->files.first == NULL) {
+        break;
+      }
       continue;
     }
 
+    /* File may have been manually deleted during runtime, deleting it again is harmless. */
     seq_disk_cache_delete_file(disk_cache, oldest_file);
   }
-  BLI_mutex_unlock(&disk_cache->read_write_mutex);
-
-  return true;
 }
 
 static DiskCacheFile *seq_disk_cache_get_file_entry_by_path(SeqDiskCache *disk_cache, char *path)
 {
-  DiskCacheFile *cache_file = disk_cache->files.first;
-
-  for (; cache_file; cache_file = cache_file->next) {
-    if (BLI_strcasecmp(cache_file->path, path) == 0) {
-      return cache_file;
-    }
-  }
-
-  return NULL;
+  return BLI_ghash_lookup(disk_cache->files_by_path, path);
 }
 
-/* Update file size and timestamp. */
-static void seq_disk_cache_update_file(SeqDiskCache *disk_cache, char *path)
+/* Update file size and access time, without querying the file system.
+ * `size` is the new minimum size of the file. */
+static void seq_disk_cache_update_file(SeqDiskCache *disk_cache,
+                                       DiskCacheFile *cache_file,
+                                       int64_t size)
 {
-  DiskCacheFile *cache_file;
-  int64_t size_before;
-  int64_t size_after;
-
-  cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, path);
-  size_before = cache_file->fstat.st_size;
-
-  if (BLI_stat(path, &cache_file->fstat) == -1) {
-    BLI_assert(false);
-    memset(&cache_file->fstat, 0, sizeof(BLI_stat_t));
+  if (size > cache_file->fstat.st_size) {
+    disk_cache->size_total += size - cache_file->fstat.st_size;
+    cache_file->fstat.st_size = size;
   }
+  cache_file->fstat.st_mtime = time(NULL);
 
-  size_after = cache_file->fstat.st_size;
-  disk_cache->size_total += size_after - size_before;
+  /* Keep list ordered by access time. */
+  BLI_remlink(&disk_cache->files, cache_file);
+  BLI_addtail(&disk_cache->files, cache_file);
 }
 
 /* Path format:
@@ -442,6 +523,12 @@ static void seq_disk_cache_handle_versioning(SeqDiskCache *disk_cache)
   }
 }
 
+static void seq_disk_cache_write_free(DiskCacheWrite *write)
+{
+  IMB_freeImBuf(write->ibuf);
+  MEM_freeN(write);
+}
+
 static void seq_disk_cache_delete_invalid_files(SeqDiskCache *disk_cache,
                                                 Scene *scene,
                                                 Sequence *seq,
@@ -467,6 +554,23 @@ static void seq_disk_cache_delete_invalid_files(SeqDiskCache *disk_cache,
     }
     cache_file = next_file;
   }
+
+  /* Don't write invalidated images. Pending writes of the strip are dropped regardless of their
+   * frame, which only costs a re-render. */
+  BLI_mutex_lock(&disk_cache->write_queue_mutex);
+  DiskCacheWrite *next_write, *write = disk_cache->write_queue.first;
+  while (write) {
+    next_write = write->next;
+    if ((write->cache_type & invalidate_types) &&
+        BLI_path_ncmp(write->path, cache_dir, strlen(cache_dir)) == 0) {
+      BLI_remlink(&disk_cache->write_queue, write);
+      disk_cache->write_queue_len--;
+      seq_disk_cache_write_free(write);
+    }
+    write = next_write;
+  }
+  BLI_condition_notify_all(&disk_cache->write_queue_cond);
+  BLI_mutex_unlock(&disk_cache->write_queue_mutex);
 }
 
 static void seq_disk_cache_invalidate(Scene *scene,
@@ -488,29 +592,292 @@ static void seq_disk_cache_invalidate(Scene *scene,
   BLI_mutex_unlock(&disk_cache->read_write_mutex);
 }
 
-static size_t deflate_imbuf_to_file(ImBuf *ibuf,
-                                    FILE *file,
-                                    int level,
-                                    DiskCacheHeaderEntry *header_entry)
+/* -------------------------------------------------------------------- */
+/** \name Half Float Storage
+ *
+ * Float images can be stored with half precision, which halves the memory and disk space they
+ * use. The conversion uses F16C instructions when the build targets them.
+ * \{ */
+
+static unsigned short seq_cache_float_to_half(float f)
 {
-  if (ibuf->rect) {
-    return BLI_gzip_mem_to_file_at_pos(
-        ibuf->rect, header_entry->size_raw, file, header_entry->offset, level);
+  /* Round to nearest even, see "half <-> float conversions" by Fabian Giesen. */
+  union {
+    float f;
+    uint32_t u;
+  } in = {f};
+  const union {
+    uint32_t u;
+    float f;
+  } denorm_magic = {((127 - 15) + (23 - 10) + 1) << 23};
+  const uint32_t sign = in.u & 0x80000000u;
+  unsigned short out;
+
+  in.u ^= sign;
+  if (in.u >= (127 + 16) << 23) {
+    /* Overflow to infinity, NaN stays NaN. */
+    out = (in.u > 255u << 23) ? 0x7e00 : 0x7c00;
+  }
+  else if (in.u < 113u << 23) {
+    /* Denormals and zero. */
+    in.f += denorm_magic.f;
+    out = (unsigned short)(in.u - denorm_magic.u);
+  }
+  else {
+    const uint32_t mant_odd = (in.u >> 13) & 1;
+    in.u += ((uint32_t)(15 - 127) << 23) + 0xfff + mant_odd;
+    out = (unsigned short)(in.u >> 13);
+  }
+  return out | (unsigned short)(sign >> 16);
+}
+
+static float seq_cache_half_to_float(unsigned short h)
+{
+  const union {
+    uint32_t u;
+    float f;
+  } magic = {113 << 23};
+  const uint32_t shifted_exp = 0x7c00 << 13;
+  union {
+    uint32_t u;
+    float f;
+  } out;
+
+  out.u = (uint32_t)(h & 0x7fff) << 13;
+  const uint32_t exp = shifted_exp & out.u;
+  out.u += (127 - 15) << 23;
+  if (exp == shifted_exp) {
+    /* Infinity and NaN. */
+    out.u += (128 - 16) << 23;
+  }
+  else if (exp == 0) {
+    /* Denormals and zero. */
+    out.u += 1 << 23;
+    out.f -= magic.f;
+  }
+  out.u |= (uint32_t)(h & 0x8000) << 16;
+  return out.f;
+}
+
+typedef struct HalfConvertData {
+  float *rect_float;
+  unsigned short *rect_half;
+  /* Number of values in a row. */
+  size_t row_len;
+} HalfConvertData;
+
+static void seq_cache_float_to_half_task(void *__restrict userdata,
+                                         const int y,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const HalfConvertData *data = userdata;
+  const float *src = data->rect_float + y * data->row_len;
+  unsigned short *dst = data->rect_half + y * data->row_len;
+  size_t i = 0;
+
+#ifdef __F16C__
+  for (; i + 4 <= data->row_len; i += 4) {
+    _mm_storel_epi64((__m128i *)(dst + i),
+                     _mm_cvtps_ph(_mm_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+  }
+#endif
+  for (; i < data->row_len; i++) {
+    dst[i] = seq_cache_float_to_half(src[i]);
+  }
+}
+
+static void seq_cache_half_to_float_task(void *__restrict userdata,
+                                         const int y,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const HalfConvertData *data = userdata;
+  const unsigned short *src = data->rect_half + y * data->row_len;
+  float *dst = data->rect_float + y * data->row_len;
+  size_t i = 0;
+
+#ifdef __F16C__
+  for (; i + 4 <= data->row_len; i += 4) {
+    _mm_storeu_ps(dst + i, _mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(src + i))));
+  }
+#endif
+  for (; i < data->row_len; i++) {
+    dst[i] = seq_cache_half_to_float(src[i]);
+  }
+}
+
+static size_t seq_cache_half_size(const ImBuf *ibuf)
+{
+  return sizeof(unsigned short) * ibuf->x * ibuf->y * ibuf->channels;
+}
+
+/* Convert the float pixels of `ibuf` to the half float buffer `rect_half`, or back. */
+static void seq_cache_convert_half(ImBuf *ibuf, unsigned short *rect_half, bool to_half)
+{
+  HalfConvertData data = {
+      .rect_float = ibuf->rect_float,
+      .rect_half = rect_half,
+      .row_len = (size_t)ibuf->x * ibuf->channels,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 32;
+  BLI_task_parallel_range(0,
+                          ibuf->y,
+                          &data,
+                          to_half ? seq_cache_float_to_half_task : seq_cache_half_to_float_task,
+                          &settings);
+}
+
+static bool seq_cache_use_half_float(Scene *scene, const ImBuf *ibuf)
+{
+  return (scene->ed->cache_flag & SEQ_CACHE_HALF_FLOAT) && ibuf->rect_float != NULL &&
+         ibuf->rect == NULL && ibuf->channels == 4;
+}
+
+/* Image without pixels, holding the properties of `ibuf` needed to restore it. */
+static ImBuf *seq_cache_ibuf_header_copy(ImBuf *ibuf)
+{
+  ImBuf *header = IMB_allocImBuf(ibuf->x, ibuf->y, ibuf->planes, 0);
+  header->channels = ibuf->channels;
+  header->flags = ibuf->flags & ~IB_rectfloat;
+  header->float_colorspace = ibuf->float_colorspace;
+  header->rect_colorspace = ibuf->rect_colorspace;
+  IMB_metadata_copy(header, ibuf);
+  return header;
+}
+
+/** \} */
+
+static int seq_disk_cache_codec(void)
+{
+  switch (U.sequencer_disk_cache_compression) {
+    case USER_SEQ_DISK_CACHE_COMPRESSION_NONE:
+      return DCACHE_CODEC_NONE;
+    case USER_SEQ_DISK_CACHE_COMPRESSION_LOW:
+#ifdef WITH_LZO
+      return DCACHE_CODEC_LZO;
+#else
+      return DCACHE_CODEC_ZLIB;
+#endif
+  }
+
+  return DCACHE_CODEC_ZLIB;
+}
+
+/* Returns number of bytes written to file. */
+static size_t seq_disk_cache_compress_to_file(const void *data,
+                                              FILE *file,
+                                              DiskCacheHeaderEntry *header_entry)
+{
+  const size_t size = header_entry->size_raw;
+
+  switch (header_entry->codec) {
+    case DCACHE_CODEC_NONE:
+      if (BLI_fseek(file, header_entry->offset, SEEK_SET) != 0 ||
+          fwrite(data, 1, size, file) != size) {
+        return 0;
+      }
+      return size;
+#ifdef WITH_LZO
+    case DCACHE_CODEC_LZO: {
+      lzo_uint size_compressed = LZO_OUT_LEN(size);
+      unsigned char *data_compressed = MEM_mallocN(size_compressed, __func__);
+      void *wrkmem = MEM_mallocN(LZO1X_MEM_COMPRESS, __func__);
+      size_t bytes_written = 0;
+
+      if (lzo1x_1_compress(data, size, data_compressed, &size_compressed, wrkmem) == LZO_E_OK &&
+          BLI_fseek(file, header_entry->offset, SEEK_SET) == 0 &&
+          fwrite(data_compressed, 1, size_compressed, file) == size_compressed) {
+        bytes_written = size_compressed;
+      }
+
+      MEM_freeN(wrkmem);
+      MEM_freeN(data_compressed);
+      return bytes_written;
+    }
+#endif
   }
 
   return BLI_gzip_mem_to_file_at_pos(
-      ibuf->rect_float, header_entry->size_raw, file, header_entry->offset, level);
+      (void *)data, size, file, header_entry->offset, seq_disk_cache_compression_level());
+}
+
+/* Returns number of bytes of image data read from file. */
+static size_t seq_disk_cache_decompress_from_file(void *data,
+                                                  FILE *file,
+                                                  DiskCacheHeaderEntry *header_entry)
+{
+  const size_t size = header_entry->size_raw;
+
+  switch (header_entry->codec) {
+    case DCACHE_CODEC_NONE:
+      if (BLI_fseek(file, header_entry->offset, SEEK_SET) != 0) {
+        return 0;
+      }
+      return fread(data, 1, size, file);
+#ifdef WITH_LZO
+    case DCACHE_CODEC_LZO: {
+      const size_t size_compressed = header_entry->size_compressed;
+      unsigned char *data_compressed = MEM_mallocN(size_compressed, __func__);
+      lzo_uint bytes_read = size;
+
+      if (BLI_fseek(file, header_entry->offset, SEEK_SET) != 0 ||
+          fread(data_compressed, 1, size_compressed, file) != size_compressed ||
+          lzo1x_decompress_safe(data_compressed, size_compressed, data, &bytes_read, NULL) !=
+              LZO_E_OK) {
+        bytes_read = 0;
+      }
+
+      MEM_freeN(data_compressed);
+      return bytes_read;
+    }
+#endif
+    case DCACHE_CODEC_ZLIB:
+      return BLI_ungzip_file_to_mem_at_pos(data, size, file, header_entry->offset);
+  }
+
+  /* Written by a build with different codecs. */
+  return 0;
 }
 
-static size_t inflate_file_to_imbuf(ImBuf *ibuf, FILE *file, DiskCacheHeaderEntry *header_entry)
+static size_t seq_disk_cache_write_imbuf(ImBuf *ibuf,
+                                         FILE *file,
+                                         DiskCacheHeaderEntry *header_entry)
 {
   if (ibuf->rect) {
-    return BLI_ungzip_file_to_mem_at_pos(
-        ibuf->rect, header_entry->size_raw, file, header_entry->offset);
+    return seq_disk_cache_compress_to_file(ibuf->rect, file, header_entry);
   }
 
-  return BLI_ungzip_file_to_mem_at_pos(
-      ibuf->rect_float, header_entry->size_raw, file, header_entry->offset);
+  if (header_entry->size_raw == seq_cache_half_size(ibuf)) {
+    unsigned short *rect_half = MEM_mallocN(header_entry->size_raw, __func__);
+    seq_cache_convert_half(ibuf, rect_half, true);
+    size_t size = seq_disk_cache_compress_to_file(rect_half, file, header_entry);
+    MEM_freeN(rect_half);
+    return size;
+  }
+
+  return seq_disk_cache_compress_to_file(ibuf->rect_float, file, header_entry);
+}
+
+static size_t seq_disk_cache_read_imbuf(ImBuf *ibuf,
+                                        FILE *file,
+                                        DiskCacheHeaderEntry *header_entry)
+{
+  if (ibuf->rect) {
+    return seq_disk_cache_decompress_from_file(ibuf->rect, file, header_entry);
+  }
+
+  if (header_entry->size_raw == seq_cache_half_size(ibuf)) {
+    unsigned short *rect_half = MEM_mallocN(header_entry->size_raw, __func__);
+    size_t size = seq_disk_cache_decompress_from_file(rect_half, file, header_entry);
+    if (size == header_entry->size_raw) {
+      seq_cache_convert_half(ibuf, rect_half, false);
+    }
+    MEM_freeN(rect_half);
+    return size;
+  }
+
+  return seq_disk_cache_decompress_from_file(ibuf->rect_float, file, header_entry);
 }
 
 static bool seq_disk_cache_read_header(FILE *file, DiskCacheHeader *header)
@@ -541,10 +908,11 @@ static size_t seq_disk_cache_write_header(FILE *file, DiskCacheHeader *header)
   return fwrite(header, sizeof(*header), 1, file);
 }
 
-static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCacheHeader *header)
+static int seq_disk_cache_add_header_entry(DiskCacheWrite *write, DiskCacheHeader *header)
 {
   int i;
   uint64_t offset = sizeof(*header);
+  ImBuf *ibuf = write->ibuf;
 
   /* Lookup free entry, get offset for new data. */
   for (i = 0; i < DCACHE_IMAGES_PER_FILE; i++) {
@@ -573,8 +941,9 @@ static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCa
     header->entry[i].encoding = 0;
   }
 
+  header->entry[i].codec = seq_disk_cache_codec();
   header->entry[i].offset = offset;
-  header->entry[i].frameno = key->frame_index;
+  header->entry[i].frameno = write->frame_index;
 
   /* Store colorspace name of ibuf. */
   const char *colorspace_name;
@@ -582,6 +951,10 @@ static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCa
     header->entry[i].size_raw = ibuf->x * ibuf->y * ibuf->channels;
     colorspace_name = IMB_colormanagement_get_rect_colorspace(ibuf);
   }
+  else if (write->use_half_float) {
+    header->entry[i].size_raw = seq_cache_half_size(ibuf);
+    colorspace_name = IMB_colormanagement_get_float_colorspace(ibuf);
+  }
   else {
     header->entry[i].size_raw = ibuf->x * ibuf->y * ibuf->channels * 4;
     colorspace_name = IMB_colormanagement_get_float_colorspace(ibuf);
@@ -603,11 +976,11 @@ static int seq_disk_cache_get_header_entry(SeqCacheKey *key, DiskCacheHeader *he
   return -1;
 }
 
-static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+/* Disk cache must be locked. */
+static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, DiskCacheWrite *write)
 {
-  char path[FILE_MAX];
+  char *path = write->path;
 
-  seq_disk_cache_get_file_path(disk_cache, key, path, sizeof(path));
   BLI_make_existing_file(path);
 
   FILE *file = BLI_fopen(path, "rb+");
@@ -616,10 +989,17 @@ static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key
     if (!file) {
       return false;
     }
-    seq_disk_cache_add_file_to_list(disk_cache, path);
   }
 
   DiskCacheFile *cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, path);
+  if (cache_file == NULL) {
+    cache_file = seq_disk_cache_add_file_to_list(disk_cache, path);
+    if (BLI_stat(path, &cache_file->fstat) == -1) {
+      memset(&cache_file->fstat, 0, sizeof(BLI_stat_t));
+    }
+    disk_cache->size_total += cache_file->fstat.st_size;
+  }
+
   DiskCacheHeader header;
   memset(&header, 0, sizeof(header));
   /* #BLI_make_existing_file() above may create an empty file. This is fine, don't attempt reading
@@ -629,10 +1009,10 @@ static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key
     seq_disk_cache_delete_file(disk_cache, cache_file);
     return false;
   }
-  int entry_index = seq_disk_cache_add_header_entry(key, ibuf, &header);
+  int entry_index = seq_disk_cache_add_header_entry(write, &header);
 
-  size_t bytes_written = deflate_imbuf_to_file(
-      ibuf, file, seq_disk_cache_compression_level(), &header.entry[entry_index]);
+  const double time_start = PIL_check_seconds_timer();
+  size_t bytes_written = seq_disk_cache_write_imbuf(write->ibuf, file, &header.entry[entry_index]);
 
   if (bytes_written != 0) {
     /* Last step is writing header, as image data can be overwritten,
@@ -640,22 +1020,58 @@ static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key
      */
     header.entry[entry_index].size_compressed = bytes_written;
     seq_disk_cache_write_header(file, &header);
-    seq_disk_cache_update_file(disk_cache, path);
     fclose(file);
 
+    DiskCacheCodecStats *stats = &disk_cache->codec_stats[header.entry[entry_index].codec];
+    stats->bytes_written += header.entry[entry_index].size_raw;
+    stats->time_write += PIL_check_seconds_timer() - time_start;
+    seq_disk_cache_update_file(
+        disk_cache, cache_file, header.entry[entry_index].offset + bytes_written);
+
     return true;
   }
 
+  fclose(file);
   return false;
 }
 
+/* Image waiting to be written to given file. Disk cache must be locked. */
+static ImBuf *seq_disk_cache_find_pending_write(SeqDiskCache *disk_cache,
+                                                const char *path,
+                                                float frame_index)
+{
+  ImBuf *ibuf = NULL;
+
+  BLI_mutex_lock(&disk_cache->write_queue_mutex);
+  LISTBASE_FOREACH (DiskCacheWrite *, write, &disk_cache->write_queue) {
+    if (write->frame_index == frame_index && STREQ(write->path, path)) {
+      ibuf = write->ibuf;
+      IMB_refImBuf(ibuf);
+      break;
+    }
+  }
+  BLI_mutex_unlock(&disk_cache->write_queue_mutex);
+
+  return ibuf;
+}
+
+/* Disk cache must be locked. */
 static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
 {
   char path[FILE_MAX];
   DiskCacheHeader header;
 
   seq_disk_cache_get_file_path(disk_cache, key, path, sizeof(path));
-  BLI_make_existing_file(path);
+
+  ImBuf *ibuf = seq_disk_cache_find_pending_write(disk_cache, path, key->frame_index);
+  if (ibuf != NULL) {
+    return ibuf;
+  }
+
+  DiskCacheFile *cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, path);
+  if (cache_file == NULL) {
+    return NULL;
+  }
 
   FILE *file = BLI_fopen(path, "rb");
   if (!file) {
@@ -674,8 +1090,8 @@ static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *ke
     return NULL;
   }
 
-  ImBuf *ibuf;
   uint64_t size_char = (uint64_t)key->context.rectx * key->context.recty * 4;
+  uint64_t size_half = (uint64_t)key->context.rectx * key->context.recty * 8;
   uint64_t size_float = (uint64_t)key->context.rectx * key->context.recty * 16;
   size_t expected_size;
 
@@ -684,8 +1100,8 @@ static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *ke
     ibuf = IMB_allocImBuf(key->context.rectx, key->context.recty, 32, IB_rect);
     IMB_colormanagement_assign_rect_colorspace(ibuf, header.entry[entry_index].colorspace_name);
   }
-  else if (header.entry[entry_index].size_raw == size_float) {
-    expected_size = size_float;
+  else if (ELEM(header.entry[entry_index].size_raw, size_half, size_float)) {
+    expected_size = header.entry[entry_index].size_raw;
     ibuf = IMB_allocImBuf(key->context.rectx, key->context.recty, 32, IB_rectfloat);
     IMB_colormanagement_assign_float_colorspace(ibuf, header.entry[entry_index].colorspace_name);
   }
@@ -694,25 +1110,152 @@ static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *ke
     return NULL;
   }
 
-  size_t bytes_read = inflate_file_to_imbuf(ibuf, file, &header.entry[entry_index]);
+  const double time_start = PIL_check_seconds_timer();
+  size_t bytes_read = seq_disk_cache_read_imbuf(ibuf, file, &header.entry[entry_index]);
+  fclose(file);
 
   /* Sanity check. */
   if (bytes_read != expected_size) {
-    fclose(file);
     IMB_freeImBuf(ibuf);
     return NULL;
   }
-  BLI_file_touch(path);
-  seq_disk_cache_update_file(disk_cache, path);
-  fclose(file);
+
+  DiskCacheCodecStats *stats = &disk_cache->codec_stats[header.entry[entry_index].codec];
+  stats->bytes_read += bytes_read;
+  stats->time_read += PIL_check_seconds_timer() - time_start;
+
+  /* Modification time orders files for deletion in later sessions, don't touch the file for
+   * every read. */
+  if (time(NULL) - cache_file->fstat.st_mtime >= DCACHE_TOUCH_INTERVAL) {
+    BLI_file_touch(path);
+  }
+  seq_disk_cache_update_file(disk_cache, cache_file, 0);
 
   return ibuf;
 }
 
+/* Writes images of the queue in background, so rendering doesn't wait for compression and I/O. */
+static void *seq_disk_cache_write_thread(void *disk_cache_v)
+{
+  SeqDiskCache *disk_cache = disk_cache_v;
+
+  while (true) {
+    BLI_mutex_lock(&disk_cache->write_queue_mutex);
+    while (BLI_listbase_is_empty(&disk_cache->write_queue) && !disk_cache->write_thread_stop) {
+      BLI_condition_wait(&disk_cache->write_queue_cond, &disk_cache->write_queue_mutex);
+    }
+    const bool stop = disk_cache->write_thread_stop;
+    BLI_mutex_unlock(&disk_cache->write_queue_mutex);
+
+    if (stop) {
+      break;
+    }
+
+    /* Lock disk cache before taking the image from queue, so invalidation can't happen between
+     * taking and writing it. */
+    BLI_mutex_lock(&disk_cache->read_write_mutex);
+    BLI_mutex_lock(&disk_cache->write_queue_mutex);
+    DiskCacheWrite *write = BLI_pophead(&disk_cache->write_queue);
+    if (write) {
+      disk_cache->write_queue_len--;
+    }
+    BLI_mutex_unlock(&disk_cache->write_queue_mutex);
+
+    if (write) {
+      seq_disk_cache_write_file(disk_cache, write);
+      seq_disk_cache_enforce_limits(disk_cache);
+    }
+    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+
+    if (write) {
+      seq_disk_cache_write_free(write);
+
+      /* Wake up renders waiting for space in queue. */
+      BLI_mutex_lock(&disk_cache->write_queue_mutex);
+      BLI_condition_notify_all(&disk_cache->write_queue_cond);
+      BLI_mutex_unlock(&disk_cache->write_queue_mutex);
+    }
+  }
+
+  return NULL;
+}
+
+static void seq_disk_cache_write_async(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+{
+  DiskCacheWrite *write = MEM_callocN(sizeof(DiskCacheWrite), "DiskCacheWrite");
+  seq_disk_cache_get_file_path(disk_cache, key, write->path, sizeof(write->path));
+  write->frame_index = key->frame_index;
+  write->cache_type = key->type;
+  write->use_half_float = seq_cache_use_half_float(key->context.scene, ibuf);
+  write->ibuf = ibuf;
+  IMB_refImBuf(ibuf);
+
+  BLI_mutex_lock(&disk_cache->write_queue_mutex);
+  /* Limit memory used by images waiting to be written. */
+  while (disk_cache->write_queue_len >= DCACHE_WRITE_QUEUE_MAX && !disk_cache->write_thread_stop) {
+    BLI_condition_wait(&disk_cache->write_queue_cond, &disk_cache->write_queue_mutex);
+  }
+  BLI_addtail(&disk_cache->write_queue, write);
+  disk_cache->write_queue_len++;
+  BLI_condition_notify_all(&disk_cache->write_queue_cond);
+  BLI_mutex_unlock(&disk_cache->write_queue_mutex);
+}
+
+static void seq_disk_cache_log_statistics(SeqDiskCache *disk_cache)
+{
+  const char *codec_names[DCACHE_CODEC_NUM] = {"zlib", "LZO", "none"};
+  const double mb = 1024.0 * 1024.0;
+
+  for (int codec = 0; codec < DCACHE_CODEC_NUM; codec++) {
+    const DiskCacheCodecStats *stats = &disk_cache->codec_stats[codec];
+    if (stats->bytes_written == 0 && stats->bytes_read == 0) {
+      continue;
+    }
+    CLOG_INFO(&LOG,
+              1,
+              "codec %s: written %.1f MB (%.1f MB/s), read %.1f MB (%.1f MB/s)",
+              codec_names[codec],
+              stats->bytes_written / mb,
+              stats->time_write > 0.0 ? stats->bytes_written / mb / stats->time_write : 0.0,
+              stats->bytes_read / mb,
+              stats->time_read > 0.0 ? stats->bytes_read / mb / stats->time_read : 0.0);
+  }
+}
+
+/* Images waiting to be written are discarded. */
+static void seq_disk_cache_free(SeqDiskCache *disk_cache)
+{
+  BLI_mutex_lock(&disk_cache->write_queue_mutex);
+  disk_cache->write_thread_stop = true;
+  BLI_condition_notify_all(&disk_cache->write_queue_cond);
+  BLI_mutex_unlock(&disk_cache->write_queue_mutex);
+  BLI_threadpool_end(&disk_cache->write_thread);
+
+  LISTBASE_FOREACH_MUTABLE (DiskCacheWrite *, write, &disk_cache->write_queue) {
+    seq_disk_cache_write_free(write);
+  }
+
+  seq_disk_cache_log_statistics(disk_cache);
+
+  BLI_ghash_free(disk_cache->files_by_path, NULL, NULL);
+  BLI_freelistN(&disk_cache->files);
+  BLI_mutex_end(&disk_cache->read_write_mutex);
+  BLI_mutex_end(&disk_cache->write_queue_mutex);
+  BLI_condition_end(&disk_cache->write_queue_cond);
+  MEM_freeN(disk_cache);
+}
+
 #undef DCACHE_FNAME_FORMAT
 #undef DCACHE_IMAGES_PER_FILE
 #undef COLORSPACE_NAME_MAX
 #undef DCACHE_CURRENT_VERSION
+#undef DCACHE_WRITE_QUEUE_MAX
+#undef DCACHE_TOUCH_INTERVAL
+#undef DCACHE_CODEC_ZLIB
+#undef DCACHE_CODEC_LZO
+#undef DCACHE_CODEC_NONE
+#undef DCACHE_CODEC_NUM
+#undef LZO_OUT_LEN
 
 static bool seq_cmp_render_data(const SeqRenderData *a, const SeqRenderData *b)
 {
@@ -807,19 +1350,66 @@ static size_t seq_cache_get_mem_total(void)
   return ((size_t)U.memcachelimit) * 1024 * 1024;
 }
 
+static void seq_cache_reset_linking(SeqCache *cache)
+{
+  memset(cache->last_key, 0, sizeof(cache->last_key));
+}
+
 static void seq_cache_keyfree(void *val)
 {
   SeqCacheKey *key = val;
   BLI_mempool_free(key->cache_owner->keys_pool, key);
 }
 
+static void seq_cache_ibuf_users_add(ImBuf *ibuf)
+{
+  void **users_p;
+
+  BLI_mutex_lock(&seq_cache_ibuf_users_lock);
+  if (seq_cache_ibuf_users == NULL) {
+    seq_cache_ibuf_users = BLI_ghash_ptr_new("seq_cache_ibuf_users");
+  }
+  if (!BLI_ghash_ensure_p(seq_cache_ibuf_users, ibuf, &users_p)) {
+    SeqCacheImBufUsers *users = MEM_mallocN(sizeof(SeqCacheImBufUsers), "SeqCacheImBufUsers");
+    users->users = 0;
+    users->size = IMB_get_size_in_memory(ibuf);
+    atomic_add_and_fetch_z(&seq_cache_mem_used, users->size);
+    *users_p = users;
+  }
+  ((SeqCacheImBufUsers *)*users_p)->users++;
+  BLI_mutex_unlock(&seq_cache_ibuf_users_lock);
+}
+
+static void seq_cache_ibuf_users_remove(ImBuf *ibuf)
+{
+  BLI_mutex_lock(&seq_cache_ibuf_users_lock);
+  SeqCacheImBufUsers *users = BLI_ghash_lookup(seq_cache_ibuf_users, ibuf);
+  BLI_assert(users != NULL);
+  if (--users->users == 0) {
+    atomic_sub_and_fetch_z(&seq_cache_mem_used, users->size);
+    BLI_ghash_remove(seq_cache_ibuf_users, ibuf, NULL, MEM_freeN);
+    if (BLI_ghash_len(seq_cache_ibuf_users) == 0) {
+      BLI_ghash_free(seq_cache_ibuf_users, NULL, NULL);
+      seq_cache_ibuf_users = NULL;
+    }
+  }
+  BLI_mutex_unlock(&seq_cache_ibuf_users_lock);
+}
+
 static void seq_cache_valfree(void *val)
 {
   SeqCacheItem *item = (SeqCacheItem *)val;
 
   if (item->ibuf) {
+    if (!item->rect_half) {
+      seq_cache_ibuf_users_remove(item->ibuf);
+    }
     IMB_freeImBuf(item->ibuf);
   }
+  if (item->rect_half) {
+    MEM_freeN(item->rect_half);
+  }
+  atomic_sub_and_fetch_z(&seq_cache_mem_used, item->size);
 
   BLI_mempool_free(item->cache_owner->items_pool, item);
 }
@@ -847,23 +1437,40 @@ static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
   item = BLI_mempool_alloc(cache->items_pool);
   item->cache_owner = cache;
   item->ibuf = ibuf;
+  item->rect_half = NULL;
 
   const int stored_types_flag = get_stored_types_flag(scene, key);
 
   /* Item stored for later use. */
   if (stored_types_flag & key->type) {
     key->is_temp_cache = false;
-    key->link_prev = cache->last_key;
+    key->link_prev = cache->last_key[key->task_id];
+  }
+
+  /* Temporary items are used again while rendering the current frame, keep them in float. */
+  if (!key->is_temp_cache && seq_cache_use_half_float(scene, ibuf)) {
+    item->rect_half = MEM_mallocN(seq_cache_half_size(ibuf), "seq cache half float");
+    seq_cache_convert_half(ibuf, item->rect_half, true);
+    item->ibuf = seq_cache_ibuf_header_copy(ibuf);
+    item->size = IMB_get_size_in_memory(item->ibuf) + seq_cache_half_size(ibuf);
+    atomic_add_and_fetch_z(&seq_cache_mem_used, item->size);
+  }
+  else {
+    item->size = 0;
+    seq_cache_ibuf_users_add(ibuf);
   }
 
   /* Store pointer to last cached key. */
-  SeqCacheKey *temp_last_key = cache->last_key;
+  SeqCacheKey *temp_last_key = cache->last_key[key->task_id];
 
   if (BLI_ghash_reinsert(cache->hash, key, item, seq_cache_keyfree, seq_cache_valfree)) {
-    IMB_refImBuf(ibuf);
+    /* Half float items own a copy of the image header instead of a reference to `ibuf`. */
+    if (item->ibuf == ibuf) {
+      IMB_refImBuf(ibuf);
+    }
 
     if (!key->is_temp_cache) {
-      cache->last_key = key;
+      cache->last_key[key->task_id] = key;
     }
   }
 
@@ -871,12 +1478,12 @@ static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
    * Item is already put in cache, so cache->last_key points to current key.
    */
   if (!key->is_temp_cache && temp_last_key) {
-    temp_last_key->link_next = cache->last_key;
+    temp_last_key->link_next = cache->last_key[key->task_id];
   }
 
   /* Reset linking. */
   if (key->type == SEQ_CACHE_STORE_FINAL_OUT) {
-    cache->last_key = NULL;
+    cache->last_key[key->task_id] = NULL;
   }
 }
 
@@ -884,6 +1491,19 @@ static ImBuf *seq_cache_get_ex(SeqCache *cache, SeqCacheKey *key)
 {
   SeqCacheItem *item = BLI_ghash_lookup(cache->hash, key);
 
+  if (item && item->rect_half) {
+    /* Restore a float image owned by the caller. */
+    ImBuf *ibuf = IMB_allocImBuf(item->ibuf->x, item->ibuf->y, item->ibuf->planes, IB_rectfloat);
+    ibuf->channels = item->ibuf->channels;
+    ibuf->flags |= item->ibuf->flags;
+    ibuf->float_colorspace = item->ibuf->float_colorspace;
+    ibuf->rect_colorspace = item->ibuf->rect_colorspace;
+    IMB_metadata_copy(ibuf, item->ibuf);
+    seq_cache_convert_half(ibuf, item->rect_half, false);
+
+    return ibuf;
+  }
+
   if (item && item->ibuf) {
     IMB_refImBuf(item->ibuf);
 
@@ -1101,20 +1721,25 @@ static void seq_disk_cache_create(Main *bmain, Scene *scene)
   BLI_mutex_lock(&cache_create_lock);
   SeqCache *cache = seq_cache_get_from_scene(scene);
 
-  if (cache == NULL) {
+  if (cache == NULL || cache->disk_cache != NULL) {
+    BLI_mutex_unlock(&cache_create_lock);
     return;
   }
 
-  if (cache->disk_cache != NULL) {
-    return;
-  }
+  SeqDiskCache *disk_cache = MEM_callocN(sizeof(SeqDiskCache), "SeqDiskCache");
+  disk_cache->bmain = bmain;
+  disk_cache->files_by_path = BLI_ghash_str_new("SeqDiskCache files");
+  BLI_mutex_init(&disk_cache->read_write_mutex);
+  BLI_mutex_init(&disk_cache->write_queue_mutex);
+  BLI_condition_init(&disk_cache->write_queue_cond);
+  seq_disk_cache_handle_versioning(disk_cache);
+  seq_disk_cache_scan(disk_cache);
+  disk_cache->timestamp = scene->ed->disk_cache_timestamp;
+
+  BLI_threadpool_init(&disk_cache->write_thread, seq_disk_cache_write_thread, 1);
+  BLI_threadpool_insert(&disk_cache->write_thread, disk_cache);
 
-  cache->disk_cache = MEM_callocN(sizeof(SeqDiskCache), "SeqDiskCache");
-  cache->disk_cache->bmain = bmain;
-  BLI_mutex_init(&cache->disk_cache->read_write_mutex);
-  seq_disk_cache_handle_versioning(cache->disk_cache);
-  seq_disk_cache_get_files(cache->disk_cache, seq_disk_cache_base_dir());
-  cache->disk_cache->timestamp = scene->ed->disk_cache_timestamp;
+  cache->disk_cache = disk_cache;
   BLI_mutex_unlock(&cache_create_lock);
 }
 
@@ -1126,7 +1751,7 @@ static void seq_cache_create(Main *bmain, Scene *scene)
     cache->keys_pool = BLI_mempool_create(sizeof(SeqCacheKey), 0, 64, BLI_MEMPOOL_NOP);
     cache->items_pool = BLI_mempool_create(sizeof(SeqCacheItem), 0, 64, BLI_MEMPOOL_NOP);
     cache->hash = BLI_ghash_new(seq_cache_hashhash, seq_cache_hashcmp, "SeqCache hash");
-    cache->last_key = NULL;
+    seq_cache_reset_linking(cache);
     cache->bmain = bmain;
     BLI_mutex_init(&cache->iterator_mutex);
     scene->ed->cache = cache;
@@ -1210,9 +1835,7 @@ void seq_cache_destruct(Scene *scene)
   BLI_mutex_end(&cache->iterator_mutex);
 
   if (cache->disk_cache != NULL) {
-    BLI_freelistN(&cache->disk_cache->files);
-    BLI_mutex_end(&cache->disk_cache->read_write_mutex);
-    MEM_freeN(cache->disk_cache);
+    seq_disk_cache_free(cache->disk_cache);
   }
 
   MEM_freeN(cache);
@@ -1244,7 +1867,7 @@ void SEQ_cache_cleanup(Scene *scene)
     BLI_ghashIterator_step(&gh_iter);
     BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
   }
-  cache->last_key = NULL;
+  seq_cache_reset_linking(cache);
   seq_cache_unlock(scene);
 }
 
@@ -1308,7 +1931,7 @@ void seq_cache_cleanup_sequence(Scene *scene,
       BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
     }
   }
-  cache->last_key = NULL;
+  seq_cache_reset_linking(cache);
   seq_cache_unlock(scene);
 }
 
@@ -1398,8 +2021,8 @@ bool seq_cache_put_if_possible(
     return true;
   }
 
-  seq_cache_set_temp_cache_linked(scene, scene->ed->cache->last_key);
-  scene->ed->cache->last_key = NULL;
+  seq_cache_set_temp_cache_linked(scene, scene->ed->cache->last_key[context->task_id]);
+  scene->ed->cache->last_key[context->task_id] = NULL;
   return false;
 }
 
@@ -1442,10 +2065,7 @@ void seq_cache_put(
         seq_disk_cache_create(context->bmain, context->scene);
       }
 
-      BLI_mutex_lock(&cache->disk_cache->read_write_mutex);
-      seq_disk_cache_write_file(cache->disk_cache, key, i);
-      BLI_mutex_unlock(&cache->disk_cache->read_write_mutex);
-      seq_disk_cache_enforce_limits(cache->disk_cache);
+      seq_disk_cache_write_async(cache->disk_cache, key, i);
     }
   }
 }
@@ -1474,11 +2094,11 @@ void SEQ_cache_iterate(
     interrupt = callback_iter(userdata, key->seq, key->timeline_frame, key->type);
   }
 
-  cache->last_key = NULL;
+  seq_cache_reset_linking(cache);
   seq_cache_unlock(scene);
 }
 
 bool seq_cache_is_full(void)
 {
-  return seq_cache_get_mem_total() < MEM_get_memory_in_use();
+  return seq_cache_get_mem_total() < seq_cache_mem_used;
 }
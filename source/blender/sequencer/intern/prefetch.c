@@ -31,9 +31,11 @@
 #include "DNA_scene_types.h"
 #include "DNA_screen_types.h"
 #include "DNA_sequence_types.h"
+#include "DNA_userdef_types.h"
 #include "DNA_windowmanager_types.h"
 
 #include "BLI_listbase.h"
+#include "BLI_math_base.h"
 #include "BLI_threads.h"
 
 #include "IMB_imbuf.h"
@@ -61,31 +63,44 @@
 #include "prefetch.h"
 #include "render.h"
 
+/* Thread rendering frames using its own evaluated copy of the scene. */
+typedef struct PrefetchWorker {
+  struct PrefetchJob *pfjob;
+
+  struct Scene *scene_eval;
+  struct Depsgraph *depsgraph;
+
+  /* context */
+  struct SeqRenderData context;
+  struct SeqRenderData context_cpy;
+
+  /* frame being rendered */
+  float cfra;
+} PrefetchWorker;
+
 typedef struct PrefetchJob {
   struct PrefetchJob *next, *prev;
 
   struct Main *bmain;
   struct Main *bmain_eval;
   struct Scene *scene;
-  struct Scene *scene_eval;
-  struct Depsgraph *depsgraph;
 
+  /* Protects prefetch area and worker counters. */
   ThreadMutex prefetch_suspend_mutex;
   ThreadCondition prefetch_suspend_cond;
 
   ListBase threads;
+  PrefetchWorker workers[SEQ_PREFETCH_MAX_WORKERS];
+  int num_workers;
 
-  /* context */
-  struct SeqRenderData context;
-  struct SeqRenderData context_cpy;
-  struct ListBase *seqbasep;
-  struct ListBase *seqbasep_cpy;
-
-  /* prefetch area */
+  /* Prefetch area. Workers take frames one by one from `cfra + num_frames_prefetched`, so frames
+   * closest to current frame are rendered first. */
   float cfra;
   int num_frames_prefetched;
 
   /* control */
+  int num_workers_running;
+  int num_workers_waiting;
   bool running;
   bool waiting;
   bool stop;
@@ -167,12 +182,19 @@ Sequence *seq_prefetch_get_original_sequence(Sequence *seq, Scene *scene)
   return sequencer_prefetch_get_original_sequence(seq, &ed->seqbase);
 }
 
+static PrefetchWorker *seq_prefetch_worker_get(PrefetchJob *pfjob, const SeqRenderData *context)
+{
+  const int index = context->task_id - SEQ_TASK_PREFETCH_RENDER;
+  BLI_assert(index >= 0 && index < pfjob->num_workers);
+  return &pfjob->workers[index];
+}
+
 /* for cache context swapping */
 SeqRenderData *seq_prefetch_get_original_context(const SeqRenderData *context)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(context->scene);
 
-  return &pfjob->context;
+  return &seq_prefetch_worker_get(pfjob, context)->context;
 }
 
 static bool seq_prefetch_is_cache_full(Scene *scene)
@@ -190,9 +212,9 @@ static float seq_prefetch_cfra(PrefetchJob *pfjob)
 {
   return pfjob->cfra + pfjob->num_frames_prefetched;
 }
-static AnimationEvalContext seq_prefetch_anim_eval_context(PrefetchJob *pfjob)
+static AnimationEvalContext seq_prefetch_anim_eval_context(PrefetchWorker *worker)
 {
-  return BKE_animsys_eval_context_construct(pfjob->depsgraph, seq_prefetch_cfra(pfjob));
+  return BKE_animsys_eval_context_construct(worker->depsgraph, worker->cfra);
 }
 
 void seq_prefetch_get_time_range(Scene *scene, int *start, int *end)
@@ -203,18 +225,61 @@ void seq_prefetch_get_time_range(Scene *scene, int *start, int *end)
   *end = seq_prefetch_cfra(pfjob);
 }
 
+/* Approximate number of frames an open movie keeps in memory, in its decoder and decoded ahead.
+ * Only used to limit the number of workers. */
+#define SEQ_PREFETCH_MOVIE_FRAMES 8
+
+static size_t seq_prefetch_movies_mem_size(const Scene *scene, ListBase *seqbase)
+{
+  size_t mem_size = 0;
+
+  LISTBASE_FOREACH (Sequence *, seq, seqbase) {
+    if (seq->type == SEQ_TYPE_META) {
+      mem_size += seq_prefetch_movies_mem_size(scene, &seq->seqbase);
+    }
+    else if (seq->type == SEQ_TYPE_MOVIE) {
+      /* Size of the movie is only known once it was rendered. */
+      const StripElem *se = seq->strip ? seq->strip->stripdata : NULL;
+      const size_t width = (se && se->orig_width) ? se->orig_width : scene->r.xsch;
+      const size_t height = (se && se->orig_height) ? se->orig_height : scene->r.ysch;
+      mem_size += width * height * 4 * SEQ_PREFETCH_MOVIE_FRAMES;
+    }
+  }
+
+  return mem_size;
+}
+
+/* Number of frames rendered at the same time. Renders are threaded themselves, so only use a
+ * fraction of the available threads. Every worker opens its own copy of the movies, so their
+ * memory is limited to a quarter of the cache memory. */
+static int seq_prefetch_num_workers(Scene *scene)
+{
+  int num_workers = min_ii(max_ii(BLI_system_thread_count() / 4, 1), SEQ_PREFETCH_MAX_WORKERS);
+
+  const size_t movies_mem_size = seq_prefetch_movies_mem_size(scene, &scene->ed->seqbase);
+  if (movies_mem_size != 0) {
+    const size_t mem_limit = (size_t)U.memcachelimit * 1024 * 1024 / 4;
+    num_workers = min_ii(num_workers, max_ii((int)(mem_limit / movies_mem_size), 1));
+  }
+
+  return num_workers;
+}
+
 static void seq_prefetch_free_depsgraph(PrefetchJob *pfjob)
 {
-  if (pfjob->depsgraph != NULL) {
-    DEG_graph_free(pfjob->depsgraph);
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    PrefetchWorker *worker = &pfjob->workers[i];
+    if (worker->depsgraph != NULL) {
+      DEG_graph_free(worker->depsgraph);
+    }
+    worker->depsgraph = NULL;
+    worker->scene_eval = NULL;
   }
-  pfjob->depsgraph = NULL;
-  pfjob->scene_eval = NULL;
 }
 
-static void seq_prefetch_update_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_update_depsgraph(PrefetchWorker *worker)
 {
-  DEG_evaluate_on_framechange(pfjob->depsgraph, seq_prefetch_cfra(pfjob));
+  DEG_evaluate_on_framechange(worker->depsgraph, worker->cfra);
 }
 
 static void seq_prefetch_init_depsgraph(PrefetchJob *pfjob)
@@ -223,17 +288,23 @@ static void seq_prefetch_init_depsgraph(PrefetchJob *pfjob)
   Scene *scene = pfjob->scene;
   ViewLayer *view_layer = BKE_view_layer_default_render(scene);
 
-  pfjob->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
-  DEG_debug_name_set(pfjob->depsgraph, "SEQUENCER PREFETCH");
+  /* Each worker evaluates its own copy of the scene, so workers can be at different frames. */
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    PrefetchWorker *worker = &pfjob->workers[i];
+
+    worker->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+    DEG_debug_name_set(worker->depsgraph, "SEQUENCER PREFETCH");
 
-  /* Make sure there is a correct evaluated scene pointer. */
-  DEG_graph_build_for_render_pipeline(pfjob->depsgraph);
+    /* Make sure there is a correct evaluated scene pointer. */
+    DEG_graph_build_for_render_pipeline(worker->depsgraph);
 
-  /* Update immediately so we have proper evaluated scene. */
-  seq_prefetch_update_depsgraph(pfjob);
+    /* Update immediately so we have proper evaluated scene. */
+    worker->cfra = seq_prefetch_cfra(pfjob);
+    seq_prefetch_update_depsgraph(worker);
 
-  pfjob->scene_eval = DEG_get_evaluated_scene(pfjob->depsgraph);
-  pfjob->scene_eval->ed->cache_flag = 0;
+    worker->scene_eval = DEG_get_evaluated_scene(worker->depsgraph);
+    worker->scene_eval->ed->cache_flag = 0;
+  }
 }
 
 static void seq_prefetch_update_area(PrefetchJob *pfjob)
@@ -281,7 +352,7 @@ void SEQ_prefetch_stop(Scene *scene)
   pfjob->stop = true;
 
   while (pfjob->running) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
   }
 }
 
@@ -290,32 +361,36 @@ static void seq_prefetch_update_context(const SeqRenderData *context)
   PrefetchJob *pfjob;
   pfjob = seq_prefetch_job_get(context->scene);
 
-  SEQ_render_new_render_data(pfjob->bmain_eval,
-                             pfjob->depsgraph,
-                             pfjob->scene_eval,
-                             context->rectx,
-                             context->recty,
-                             context->preview_render_size,
-                             false,
-                             &pfjob->context_cpy);
-  pfjob->context_cpy.is_prefetch_render = true;
-  pfjob->context_cpy.task_id = SEQ_TASK_PREFETCH_RENDER;
-
-  SEQ_render_new_render_data(pfjob->bmain,
-                             pfjob->depsgraph,
-                             pfjob->scene,
-                             context->rectx,
-                             context->recty,
-                             context->preview_render_size,
-                             false,
-                             &pfjob->context);
-  pfjob->context.is_prefetch_render = false;
-
-  /* Same ID as prefetch context, because context will be swapped, but we still
-   * want to assign this ID to cache entries created in this thread.
-   * This is to allow "temp cache" work correctly for both threads.
-   */
-  pfjob->context.task_id = SEQ_TASK_PREFETCH_RENDER;
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    PrefetchWorker *worker = &pfjob->workers[i];
+
+    SEQ_render_new_render_data(pfjob->bmain_eval,
+                               worker->depsgraph,
+                               worker->scene_eval,
+                               context->rectx,
+                               context->recty,
+                               context->preview_render_size,
+                               false,
+                               &worker->context_cpy);
+    worker->context_cpy.is_prefetch_render = true;
+    worker->context_cpy.task_id = SEQ_TASK_PREFETCH_RENDER + i;
+
+    SEQ_render_new_render_data(pfjob->bmain,
+                               worker->depsgraph,
+                               pfjob->scene,
+                               context->rectx,
+                               context->recty,
+                               context->preview_render_size,
+                               false,
+                               &worker->context);
+    worker->context.is_prefetch_render = false;
+
+    /* Same ID as prefetch context, because context will be swapped, but we still
+     * want to assign this ID to cache entries created in this thread.
+     * This is to allow "temp cache" work correctly for all threads.
+     */
+    worker->context.task_id = SEQ_TASK_PREFETCH_RENDER + i;
+  }
 }
 
 static void seq_prefetch_update_scene(Scene *scene)
@@ -328,6 +403,8 @@ static void seq_prefetch_update_scene(Scene *scene)
 
   pfjob->scene = scene;
   seq_prefetch_free_depsgraph(pfjob);
+  /* Strips may have been added or removed since the last start. */
+  pfjob->num_workers = seq_prefetch_num_workers(scene);
   seq_prefetch_init_depsgraph(pfjob);
 }
 
@@ -335,8 +412,8 @@ static void seq_prefetch_resume(Scene *scene)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(scene);
 
-  if (pfjob && pfjob->waiting) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+  if (pfjob && pfjob->num_workers_waiting > 0) {
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
   }
 }
 
@@ -349,7 +426,6 @@ void seq_prefetch_free(Scene *scene)
 
   SEQ_prefetch_stop(scene);
 
-  BLI_threadpool_remove(&pfjob->threads, pfjob);
   BLI_threadpool_end(&pfjob->threads);
   BLI_mutex_end(&pfjob->prefetch_suspend_mutex);
   BLI_condition_end(&pfjob->prefetch_suspend_cond);
@@ -361,18 +437,18 @@ void seq_prefetch_free(Scene *scene)
 
 /* Skip frame if we need to render 3D scene strip. Rendering 3D scene requires main lock or setting
  * up render job that doesn't have API to do openGL renders which can be used for sequencer. */
-static bool seq_prefetch_do_skip_frame(PrefetchJob *pfjob, ListBase *seqbase)
+static bool seq_prefetch_do_skip_frame(PrefetchWorker *worker, ListBase *seqbase)
 {
-  float cfra = seq_prefetch_cfra(pfjob);
+  float cfra = worker->cfra;
   Sequence *seq_arr[MAXSEQ + 1];
   int count = seq_get_shown_sequences(seqbase, cfra, 0, seq_arr);
-  SeqRenderData *ctx = &pfjob->context_cpy;
+  SeqRenderData *ctx = &worker->context_cpy;
   ImBuf *ibuf = NULL;
 
   /* Disable prefetching 3D scene strips, but check for disk cache. */
   for (int i = 0; i < count; i++) {
     if (seq_arr[i]->type == SEQ_TYPE_META &&
-        seq_prefetch_do_skip_frame(pfjob, &seq_arr[i]->seqbase)) {
+        seq_prefetch_do_skip_frame(worker, &seq_arr[i]->seqbase)) {
       return true;
     }
 
@@ -425,35 +501,68 @@ static bool seq_prefetch_do_skip_frame(PrefetchJob *pfjob, ListBase *seqbase)
 
 static bool seq_prefetch_need_suspend(PrefetchJob *pfjob)
 {
-  return seq_prefetch_is_cache_full(pfjob->scene) || seq_prefetch_is_scrubbing(pfjob->bmain) ||
-         (seq_prefetch_cfra(pfjob) >= pfjob->scene->r.efra);
+  return seq_render_exclusive_is_pending() || seq_prefetch_is_cache_full(pfjob->scene) ||
+         seq_prefetch_is_scrubbing(pfjob->bmain) ||
+         (seq_prefetch_cfra(pfjob) > pfjob->scene->r.efra);
 }
 
-static void seq_prefetch_do_suspend(PrefetchJob *pfjob)
+static bool seq_prefetch_is_enabled(PrefetchJob *pfjob)
 {
+  return (pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) && !pfjob->stop;
+}
+
+/* Take the next frame to be prefetched, suspend worker if there is nothing to be prefetched.
+ * Returns false if worker should exit. */
+static bool seq_prefetch_worker_next_frame(PrefetchWorker *worker)
+{
+  PrefetchJob *pfjob = worker->pfjob;
+  bool has_frame = false;
+
   BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
-  while (seq_prefetch_need_suspend(pfjob) &&
-         (pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) && !pfjob->stop) {
-    pfjob->waiting = true;
+
+  /* Avoid "collision" with main thread, but make sure to fetch at least few frames */
+  if (pfjob->num_frames_prefetched > 5 &&
+      (seq_prefetch_cfra(pfjob) - pfjob->scene->r.cfra) < 2) {
+    BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
+    return false;
+  }
+
+  seq_prefetch_update_area(pfjob);
+
+  while (seq_prefetch_need_suspend(pfjob) && seq_prefetch_is_enabled(pfjob)) {
+    pfjob->num_workers_waiting++;
+    pfjob->waiting = pfjob->num_workers_waiting == pfjob->num_workers_running;
     BLI_condition_wait(&pfjob->prefetch_suspend_cond, &pfjob->prefetch_suspend_mutex);
+    pfjob->num_workers_waiting--;
+    pfjob->waiting = false;
     seq_prefetch_update_area(pfjob);
   }
-  pfjob->waiting = false;
+
+  if (seq_prefetch_is_enabled(pfjob)) {
+    worker->cfra = seq_prefetch_cfra(pfjob);
+    pfjob->num_frames_prefetched++;
+    has_frame = true;
+  }
+
   BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
+
+  return has_frame;
 }
 
-static void *seq_prefetch_frames(void *job)
+static void *seq_prefetch_frames(void *worker_v)
 {
-  PrefetchJob *pfjob = (PrefetchJob *)job;
+  PrefetchWorker *worker = (PrefetchWorker *)worker_v;
+  PrefetchJob *pfjob = worker->pfjob;
+  Scene *scene_eval = worker->scene_eval;
 
-  while (seq_prefetch_cfra(pfjob) <= pfjob->scene->r.efra) {
-    pfjob->scene_eval->ed->prefetch_job = NULL;
+  while (seq_prefetch_worker_next_frame(worker)) {
+    scene_eval->ed->prefetch_job = NULL;
 
-    seq_prefetch_update_depsgraph(pfjob);
-    AnimData *adt = BKE_animdata_from_id(&pfjob->context_cpy.scene->id);
-    AnimationEvalContext anim_eval_context = seq_prefetch_anim_eval_context(pfjob);
+    seq_prefetch_update_depsgraph(worker);
+    AnimData *adt = BKE_animdata_from_id(&worker->context_cpy.scene->id);
+    AnimationEvalContext anim_eval_context = seq_prefetch_anim_eval_context(worker);
     BKE_animsys_evaluate_animdata(
-        &pfjob->context_cpy.scene->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
+        &worker->context_cpy.scene->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
 
     /* This is quite hacky solution:
      * We need cross-reference original scene with copy for cache.
@@ -461,38 +570,35 @@ static void *seq_prefetch_frames(void *job)
      * Scene copy don't reference original scene. Perhaps, this could be done by depsgraph.
      * Set to NULL before return!
      */
-    pfjob->scene_eval->ed->prefetch_job = pfjob;
+    scene_eval->ed->prefetch_job = pfjob;
 
     ListBase *seqbase = SEQ_active_seqbase_get(SEQ_editing_get(pfjob->scene, false));
-    if (seq_prefetch_do_skip_frame(pfjob, seqbase)) {
-      pfjob->num_frames_prefetched++;
+    if (seq_prefetch_do_skip_frame(worker, seqbase)) {
       continue;
     }
 
-    ImBuf *ibuf = SEQ_render_give_ibuf(&pfjob->context_cpy, seq_prefetch_cfra(pfjob), 0);
-    seq_cache_free_temp_cache(pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
-    IMB_freeImBuf(ibuf);
-
-    /* Suspend thread if there is nothing to be prefetched. */
-    seq_prefetch_do_suspend(pfjob);
-
-    /* Avoid "collision" with main thread, but make sure to fetch at least few frames */
-    if (pfjob->num_frames_prefetched > 5 &&
-        (seq_prefetch_cfra(pfjob) - pfjob->scene->r.cfra) < 2) {
-      break;
-    }
-
-    if (!(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) || pfjob->stop) {
-      break;
+    /* Frame may have been taken before the job was stopped or scrubbing started. */
+    if (!seq_prefetch_is_enabled(pfjob) || seq_prefetch_is_scrubbing(pfjob->bmain)) {
+      continue;
     }
 
-    seq_prefetch_update_area(pfjob);
-    pfjob->num_frames_prefetched++;
+    ImBuf *ibuf = SEQ_render_give_ibuf(&worker->context_cpy, worker->cfra, 0);
+    seq_cache_free_temp_cache(pfjob->scene, worker->context.task_id, worker->cfra);
+    IMB_freeImBuf(ibuf);
   }
 
-  seq_cache_free_temp_cache(pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
-  pfjob->running = false;
-  pfjob->scene_eval->ed->prefetch_job = NULL;
+  seq_cache_free_temp_cache(pfjob->scene, worker->context.task_id, worker->cfra);
+  scene_eval->ed->prefetch_job = NULL;
+
+  BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+  pfjob->num_workers_running--;
+  if (pfjob->num_workers_running == 0) {
+    pfjob->running = false;
+  }
+  else {
+    pfjob->waiting = pfjob->num_workers_waiting == pfjob->num_workers_running;
+  }
+  BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
 
   return NULL;
 }
@@ -506,13 +612,16 @@ static PrefetchJob *seq_prefetch_start_ex(const SeqRenderData *context, float cf
       pfjob = (PrefetchJob *)MEM_callocN(sizeof(PrefetchJob), "PrefetchJob");
       context->scene->ed->prefetch_job = pfjob;
 
-      BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, 1);
+      for (int i = 0; i < SEQ_PREFETCH_MAX_WORKERS; i++) {
+        pfjob->workers[i].pfjob = pfjob;
+      }
+
+      BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, SEQ_PREFETCH_MAX_WORKERS);
       BLI_mutex_init(&pfjob->prefetch_suspend_mutex);
       BLI_condition_init(&pfjob->prefetch_suspend_cond);
 
       pfjob->bmain_eval = BKE_main_new();
       pfjob->scene = context->scene;
-      seq_prefetch_init_depsgraph(pfjob);
     }
   }
   pfjob->bmain = context->bmain;
@@ -522,13 +631,22 @@ static PrefetchJob *seq_prefetch_start_ex(const SeqRenderData *context, float cf
 
   pfjob->waiting = false;
   pfjob->stop = false;
-  pfjob->running = true;
+  pfjob->num_workers_waiting = 0;
+
+  /* Threads of the previous run have finished, the number of workers may change. */
+  for (int i = 0; i < SEQ_PREFETCH_MAX_WORKERS; i++) {
+    BLI_threadpool_remove(&pfjob->threads, &pfjob->workers[i]);
+  }
 
   seq_prefetch_update_scene(context->scene);
   seq_prefetch_update_context(context);
 
-  BLI_threadpool_remove(&pfjob->threads, pfjob);
-  BLI_threadpool_insert(&pfjob->threads, pfjob);
+  pfjob->running = true;
+  pfjob->num_workers_running = pfjob->num_workers;
+
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    BLI_threadpool_insert(&pfjob->threads, &pfjob->workers[i]);
+  }
 
   return pfjob;
 }
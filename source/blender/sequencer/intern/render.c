@@ -28,6 +28,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "DNA_anim_types.h"
 #include "DNA_mask_types.h"
 #include "DNA_scene_types.h"
@@ -37,6 +39,8 @@
 #include "BLI_linklist.h"
 #include "BLI_listbase.h"
 #include "BLI_path_util.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "BKE_anim_data.h"
 #include "BKE_animsys.h"
@@ -86,7 +90,11 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      float timeline_frame,
                                      int chanshown);
 
-static ThreadMutex seq_render_mutex = BLI_MUTEX_INITIALIZER;
+/* Prefetch workers render frames of their own scene copies in parallel, other renders are
+ * exclusive. Exclusive renders waiting for the lock pause prefetch workers between frames, so a
+ * stream of prefetch renders can't keep them waiting. */
+static ThreadRWMutex seq_render_mutex = BLI_RWLOCK_INITIALIZER;
+static int32_t seq_render_exclusive_num = 0;
 SequencerDrawView sequencer_view3d_fn = NULL; /* NULL in background mode */
 
 /* -------------------------------------------------------------------- */
@@ -1907,6 +1915,177 @@ static ImBuf *seq_render_strip_stack_apply_effect(
   return out;
 }
 
+/* Strips of the stack which only read their own data (images, movies and colors) are rendered
+ * in parallel tasks. Meanwhile the stack is blended from the bottom up on the calling thread,
+ * as soon as the strips it needs are ready. */
+
+typedef enum eStackStripState {
+  /** Rendered by the thread blending the stack. */
+  STACK_STRIP_INLINE = 0,
+  /** Pushed to the task pool, not started yet. */
+  STACK_STRIP_QUEUED,
+  STACK_STRIP_RENDERING,
+  STACK_STRIP_DONE,
+} eStackStripState;
+
+typedef struct StackStrip {
+  Sequence *seq;
+  ImBuf *ibuf;
+  eStackStripState state;
+} StackStrip;
+
+typedef struct StackRender {
+  const SeqRenderData *context;
+  float timeline_frame;
+  StackStrip strips[MAXSEQ + 1];
+  /* NULL when all strips are rendered inline. */
+  TaskPool *task_pool;
+  ThreadMutex mutex;
+  ThreadCondition cond;
+} StackRender;
+
+static bool seq_render_stack_strip_use_task(Sequence *seq)
+{
+  if (!ELEM(seq->type, SEQ_TYPE_IMAGE, SEQ_TYPE_MOVIE, SEQ_TYPE_COLOR)) {
+    return false;
+  }
+  LISTBASE_FOREACH (SequenceModifierData *, smd, &seq->modifiers) {
+    if (smd->mask_sequence || smd->mask_id) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Masks of modifiers can render any other strip, possibly one rendered by a task. */
+static bool seq_render_stack_use_mask_sequence(Sequence **seq_arr, int count)
+{
+  for (int i = 0; i < count; i++) {
+    LISTBASE_FOREACH (SequenceModifierData *, smd, &seq_arr[i]->modifiers) {
+      if (smd->mask_sequence) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static void seq_render_stack_strip_task(TaskPool *__restrict pool, void *taskdata)
+{
+  StackRender *stack = BLI_task_pool_user_data(pool);
+  StackStrip *strip = taskdata;
+
+  BLI_mutex_lock(&stack->mutex);
+  if (strip->state != STACK_STRIP_QUEUED) {
+    /* Taken over by the thread blending the stack. */
+    BLI_mutex_unlock(&stack->mutex);
+    return;
+  }
+  strip->state = STACK_STRIP_RENDERING;
+  BLI_mutex_unlock(&stack->mutex);
+
+  SeqRenderState state;
+  seq_render_state_init(&state);
+  ImBuf *ibuf = seq_render_strip(stack->context, &state, strip->seq, stack->timeline_frame);
+
+  BLI_mutex_lock(&stack->mutex);
+  strip->ibuf = ibuf;
+  strip->state = STACK_STRIP_DONE;
+  BLI_condition_notify_all(&stack->cond);
+  BLI_mutex_unlock(&stack->mutex);
+}
+
+/* Start rendering the strips with `needs_render` set, when more than one can be rendered by
+ * tasks. */
+static void seq_render_stack_begin(StackRender *stack,
+                                   const SeqRenderData *context,
+                                   float timeline_frame,
+                                   Sequence **seq_arr,
+                                   const bool *needs_render,
+                                   int count)
+{
+  int num_tasks = 0;
+
+  memset(stack, 0, sizeof(*stack));
+  stack->context = context;
+  stack->timeline_frame = timeline_frame;
+
+  const bool use_mask_sequence = seq_render_stack_use_mask_sequence(seq_arr, count);
+  for (int i = 0; i < count; i++) {
+    stack->strips[i].seq = seq_arr[i];
+    if (needs_render[i] && !use_mask_sequence && seq_render_stack_strip_use_task(seq_arr[i])) {
+      stack->strips[i].state = STACK_STRIP_QUEUED;
+      num_tasks++;
+    }
+  }
+
+  if (num_tasks < 2) {
+    for (int i = 0; i < count; i++) {
+      stack->strips[i].state = STACK_STRIP_INLINE;
+    }
+    return;
+  }
+
+  BLI_mutex_init(&stack->mutex);
+  BLI_condition_init(&stack->cond);
+  stack->task_pool = BLI_task_pool_create(stack, TASK_PRIORITY_HIGH);
+  for (int i = 0; i < count; i++) {
+    if (stack->strips[i].state == STACK_STRIP_QUEUED) {
+      BLI_task_pool_push(
+          stack->task_pool, seq_render_stack_strip_task, &stack->strips[i], false, NULL);
+    }
+  }
+}
+
+/* Get the image of a strip, waiting for its task to finish. Strips which no task started to
+ * render yet are rendered on this thread, so a busy task pool never blocks blending. */
+static ImBuf *seq_render_stack_strip_get(StackRender *stack, SeqRenderState *state, int index)
+{
+  StackStrip *strip = &stack->strips[index];
+
+  if (stack->task_pool != NULL) {
+    ImBuf *ibuf = NULL;
+
+    BLI_mutex_lock(&stack->mutex);
+    if (strip->state == STACK_STRIP_QUEUED) {
+      strip->state = STACK_STRIP_INLINE;
+    }
+    while (strip->state == STACK_STRIP_RENDERING) {
+      BLI_condition_wait(&stack->cond, &stack->mutex);
+    }
+    if (strip->state == STACK_STRIP_DONE) {
+      ibuf = strip->ibuf;
+      strip->ibuf = NULL;
+    }
+    BLI_mutex_unlock(&stack->mutex);
+
+    if (ibuf != NULL) {
+      return ibuf;
+    }
+  }
+
+  return seq_render_strip(stack->context, state, strip->seq, stack->timeline_frame);
+}
+
+static void seq_render_stack_end(StackRender *stack)
+{
+  if (stack->task_pool == NULL) {
+    return;
+  }
+
+  BLI_task_pool_work_and_wait(stack->task_pool);
+  BLI_task_pool_free(stack->task_pool);
+
+  for (int i = 0; i <= MAXSEQ; i++) {
+    if (stack->strips[i].ibuf != NULL) {
+      IMB_freeImBuf(stack->strips[i].ibuf);
+    }
+  }
+
+  BLI_condition_end(&stack->cond);
+  BLI_mutex_end(&stack->mutex);
+}
+
 static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      SeqRenderState *state,
                                      ListBase *seqbasep,
@@ -1914,8 +2093,10 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      int chanshown)
 {
   Sequence *seq_arr[MAXSEQ + 1];
+  bool needs_render[MAXSEQ + 1] = {false};
+  int early_out_arr[MAXSEQ + 1];
   int count;
-  int i;
+  int i, base;
   ImBuf *out = NULL;
 
   count = seq_get_shown_sequences(seqbasep, timeline_frame, chanshown, (Sequence **)&seq_arr);
@@ -1924,9 +2105,10 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     return NULL;
   }
 
-  for (i = count - 1; i >= 0; i--) {
-    int early_out;
-    Sequence *seq = seq_arr[i];
+  /* Find the bottom of the stack which has to be blended: strips below it are covered, or the
+   * composite up to it is cached. */
+  for (base = count - 1; base > 0; base--) {
+    Sequence *seq = seq_arr[base];
 
     out = seq_cache_get(context, seq, timeline_frame, SEQ_CACHE_STORE_COMPOSITE);
 
@@ -1934,48 +2116,59 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
       break;
     }
     if (seq->blend_mode == SEQ_BLEND_REPLACE) {
-      out = seq_render_strip(context, state, seq, timeline_frame);
       break;
     }
+    if (ELEM(seq_get_early_out_for_blend_mode(seq), EARLY_NO_INPUT, EARLY_USE_INPUT_2)) {
+      break;
+    }
+  }
+  if (base == 0 && out == NULL) {
+    out = seq_cache_get(context, seq_arr[0], timeline_frame, SEQ_CACHE_STORE_COMPOSITE);
+  }
 
-    early_out = seq_get_early_out_for_blend_mode(seq);
-
-    switch (early_out) {
-      case EARLY_NO_INPUT:
-      case EARLY_USE_INPUT_2:
-        out = seq_render_strip(context, state, seq, timeline_frame);
-        break;
-      case EARLY_USE_INPUT_1:
-        if (i == 0) {
-          out = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
-        }
-        break;
-      case EARLY_DO_EFFECT:
-        if (i == 0) {
-          ImBuf *ibuf1 = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
-          ImBuf *ibuf2 = seq_render_strip(context, state, seq, timeline_frame);
+  for (i = base; i < count; i++) {
+    early_out_arr[i] = seq_get_early_out_for_blend_mode(seq_arr[i]);
+    if (i == base) {
+      needs_render[i] = (out == NULL) && ((seq_arr[i]->blend_mode == SEQ_BLEND_REPLACE) ||
+                                          (early_out_arr[i] != EARLY_USE_INPUT_1));
+    }
+    else {
+      needs_render[i] = (early_out_arr[i] == EARLY_DO_EFFECT);
+    }
+  }
 
-          out = seq_render_strip_stack_apply_effect(context, seq, timeline_frame, ibuf1, ibuf2);
+  StackRender stack;
+  seq_render_stack_begin(&stack, context, timeline_frame, seq_arr, needs_render, count);
 
-          seq_cache_put(context, seq_arr[i], timeline_frame, SEQ_CACHE_STORE_COMPOSITE, out);
+  if (out == NULL) {
+    Sequence *seq = seq_arr[base];
 
-          IMB_freeImBuf(ibuf1);
-          IMB_freeImBuf(ibuf2);
-        }
-        break;
+    if (seq->blend_mode == SEQ_BLEND_REPLACE ||
+        ELEM(early_out_arr[base], EARLY_NO_INPUT, EARLY_USE_INPUT_2)) {
+      out = seq_render_stack_strip_get(&stack, state, base);
     }
-    if (out) {
-      break;
+    else if (early_out_arr[base] == EARLY_USE_INPUT_1) {
+      out = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
+    }
+    else {
+      ImBuf *ibuf1 = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
+      ImBuf *ibuf2 = seq_render_stack_strip_get(&stack, state, base);
+
+      out = seq_render_strip_stack_apply_effect(context, seq, timeline_frame, ibuf1, ibuf2);
+
+      seq_cache_put(context, seq, timeline_frame, SEQ_CACHE_STORE_COMPOSITE, out);
+
+      IMB_freeImBuf(ibuf1);
+      IMB_freeImBuf(ibuf2);
     }
   }
 
-  i++;
-  for (; i < count; i++) {
+  for (i = base + 1; i < count; i++) {
     Sequence *seq = seq_arr[i];
 
-    if (seq_get_early_out_for_blend_mode(seq) == EARLY_DO_EFFECT) {
+    if (early_out_arr[i] == EARLY_DO_EFFECT) {
       ImBuf *ibuf1 = out;
-      ImBuf *ibuf2 = seq_render_strip(context, state, seq, timeline_frame);
+      ImBuf *ibuf2 = seq_render_stack_strip_get(&stack, state, i);
 
       out = seq_render_strip_stack_apply_effect(context, seq, timeline_frame, ibuf1, ibuf2);
 
@@ -1986,6 +2179,8 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     seq_cache_put(context, seq_arr[i], timeline_frame, SEQ_CACHE_STORE_COMPOSITE, out);
   }
 
+  seq_render_stack_end(&stack);
+
   return out;
 }
 
@@ -2028,7 +2223,11 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
   seq_cache_free_temp_cache(context->scene, context->task_id, timeline_frame);
 
   if (count && !out) {
-    BLI_mutex_lock(&seq_render_mutex);
+    if (!context->is_prefetch_render) {
+      atomic_add_and_fetch_int32(&seq_render_exclusive_num, 1);
+    }
+    BLI_rw_mutex_lock(&seq_render_mutex,
+                      context->is_prefetch_render ? THREAD_LOCK_READ : THREAD_LOCK_WRITE);
     out = seq_render_strip_stack(context, &state, seqbasep, timeline_frame, chanshown);
 
     if (context->is_prefetch_render) {
@@ -2038,7 +2237,10 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
       seq_cache_put_if_possible(
           context, seq_arr[count - 1], timeline_frame, SEQ_CACHE_STORE_FINAL_OUT, out);
     }
-    BLI_mutex_unlock(&seq_render_mutex);
+    BLI_rw_mutex_unlock(&seq_render_mutex);
+    if (!context->is_prefetch_render) {
+      atomic_sub_and_fetch_int32(&seq_render_exclusive_num, 1);
+    }
   }
 
   seq_prefetch_start(context, timeline_frame);
@@ -2046,6 +2248,12 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
   return out;
 }
 
+/* Prefetch workers don't start new frames while this is true. */
+bool seq_render_exclusive_is_pending(void)
+{
+  return atomic_add_and_fetch_int32(&seq_render_exclusive_num, 0) > 0;
+}
+
 ImBuf *seq_render_give_ibuf_seqbase(const SeqRenderData *context,
                                     float timeline_frame,
                                     int chan_shown,
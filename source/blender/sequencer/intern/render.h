@@ -73,6 +73,7 @@ struct ImBuf *seq_render_mask(const struct SeqRenderData *context,
                               float frame_index,
                               bool make_float);
 void seq_imbuf_assign_spaces(struct Scene *scene, struct ImBuf *ibuf);
+bool seq_render_exclusive_is_pending(void);
 
 #ifdef __cplusplus
 }